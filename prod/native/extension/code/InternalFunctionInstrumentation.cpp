@@ -39,7 +39,7 @@ static void callWithSpanHandlerPre(zend_execute_data *execute_data, WithSpanMeta
         return;
     }
 
-    bool scoped = OTEL_GL(config_)->get().scoped_deps_enabled;
+    bool scoped = OTEL_GL(config_)->get()->scoped_deps_enabled;
 
     // Parameters 0-5: standard pre-hook arguments (same as callPreHook)
     std::array<AutoZval, 8> params;
@@ -143,7 +143,7 @@ static void callWithSpanHandlerPost(zend_execute_data *execute_data, zval *retva
         return;
     }
 
-    bool scoped = OTEL_GL(config_)->get().scoped_deps_enabled;
+    bool scoped = OTEL_GL(config_)->get()->scoped_deps_enabled;
 
     std::array<AutoZval, 4> params;
     getScopeNameOrThis(params[0].get(), execute_data);
@@ -562,11 +562,11 @@ zend_observer_fcall_handlers registerObserverHandlers(zend_execute_data *execute
         }
     }
 
-    if (OTEL_GL(config_)->get().debug_instrument_all && OTEL_GL(requestScope_)->isFunctional()) {
+    if (OTEL_GL(config_)->get()->debug_instrument_all && OTEL_GL(requestScope_)->isFunctional()) {
         std::string_view filename(ZSTR_VAL(execute_data->func->op_array.filename), ZSTR_LEN(execute_data->func->op_array.filename));
         if (!(execute_data->func->common.fn_flags & ZEND_ACC_CLOSURE) && filename.find("/opentelemetry/php/distro/") == std::string_view::npos && filename.find("/open-telemetry/") == std::string_view::npos) {
-            auto preHookName = OTEL_GL(config_)->get().scoped_deps_enabled ? PHP_SCOPER_PREFIX "OpenTelemetry\\Distro\\PhpPartFacade::debugPreHook"sv : "OpenTelemetry\\Distro\\PhpPartFacade::debugPreHook"sv;
-            auto postHookName = OTEL_GL(config_)->get().scoped_deps_enabled ? PHP_SCOPER_PREFIX "OpenTelemetry\\Distro\\PhpPartFacade::debugPostHook"sv : "OpenTelemetry\\Distro\\PhpPartFacade::debugPostHook"sv;
+            auto preHookName = OTEL_GL(config_)->get()->scoped_deps_enabled ? PHP_SCOPER_PREFIX "OpenTelemetry\\Distro\\PhpPartFacade::debugPreHook"sv : "OpenTelemetry\\Distro\\PhpPartFacade::debugPreHook"sv;
+            auto postHookName = OTEL_GL(config_)->get()->scoped_deps_enabled ? PHP_SCOPER_PREFIX "OpenTelemetry\\Distro\\PhpPartFacade::debugPostHook"sv : "OpenTelemetry\\Distro\\PhpPartFacade::debugPostHook"sv;
             callbacks = reinterpret_cast<InstrumentedFunctionHooksStorage_t *>(OTEL_GL(hooksStorage_).get())->storeFront(hash, AutoZval(preHookName), AutoZval(postHookName));
         }
     }
@@ -574,7 +574,7 @@ zend_observer_fcall_handlers registerObserverHandlers(zend_execute_data *execute
     // Attribute-based hooks: register if attr_hooks_enabled and #[WithSpan] is present.
     // Works independently of user hooks registered via hook().
     bool haveAttrHook = false;
-    if (OTEL_GL(config_)->get().attr_hooks_enabled) {
+    if (OTEL_GL(config_)->get()->attr_hooks_enabled) {
         auto *func = execute_data->func;
         if (hasWithSpanAttribute(func)) {
             auto metaOpt = readWithSpanMetadata(func);
@@ -11,9 +11,12 @@
 #include "ModuleInit.h"
 
 #include "AutoZval.h"
+#include "ConfigurationManager.h"
 #include "config/OptionValueProvider.h"
 #include "coordinator/CoordinatorSharedDataQueue.h"
 #include "coordinator/CoordinatorProcess.h"
+#include "coordinator/CoordinatorStatusPage.h"
+#include "coordinator/CoordinatorSupervisor.h"
 #include "CommonUtils.h"
 #include "os/OsUtils.h"
 #include "InferredSpans.h"
@@ -41,7 +44,7 @@ PHP_RINIT_FUNCTION(opentelemetry_distro) {
     OTEL_G(globals)->requestScope_->onRequestInit();
 
     // Install inferred spans hooks if enabled (handles remote config enabling after MINIT)
-    if (OTEL_G(globals)->config_->get().inferred_spans_enabled) {
+    if (OTEL_G(globals)->config_->get()->inferred_spans_enabled) {
         opentelemetry::php::Hooking::getInstance().enableInferredSpansHooks();
     }
 
@@ -64,26 +67,21 @@ PHP_MINFO_FUNCTION(opentelemetry_distro) {
 
 namespace opentelemetry::php {
 
-void forkCoordinatorProcess(std::shared_ptr<opentelemetry::php::LoggerInterface> logger, std::function<void(opentelemetry::php::ConfigurationSnapshot const &)> loggerConfigUpdateFunc, std::shared_ptr<coordinator::CoordinatorSharedDataQueue> shareDataQueue, std::shared_ptr<opentelemetry::php::config::OptionValueProvider> optionValueProvider, std::shared_ptr<coordinator::CoordinatorConfigurationProvider> coordinatorConfigProvider, std::shared_ptr<PhpBridgeInterface> phpBridge) {
-    auto parentProcessId = getpid();
-    auto processId = fork();
-    if (processId < 0) {
-        if (logger) {
-            ELOG_DEBUG(logger, COORDINATOR, "CoordinatorProcess: fork() failed: {} ({})", strerror(errno), errno);
-        }
-    } else if (processId == 0) {
+// forks supervisor process which forks coordinator and forks it again with the same shared memory when it exits while this process is running
+void forkCoordinatorProcess(std::shared_ptr<opentelemetry::php::LoggerInterface> logger, std::function<void(opentelemetry::php::ConfigurationSnapshot const &)> loggerConfigUpdateFunc, std::shared_ptr<coordinator::CoordinatorSharedDataQueue> shareDataQueue, std::shared_ptr<opentelemetry::php::config::OptionValueProvider> optionValueProvider, std::shared_ptr<coordinator::CoordinatorConfigurationProvider> coordinatorConfigProvider, std::shared_ptr<coordinator::CoordinatorFlushStatus> coordinatorFlushStatus, std::shared_ptr<coordinator::CoordinatorPayloadArena> payloadArena, std::shared_ptr<coordinator::CoordinatorStatusPage> statusPage, std::shared_ptr<PhpBridgeInterface> phpBridge) {
+    coordinator::CoordinatorSupervisor supervisor(logger, statusPage, [=](pid_t parentProcessId) {
         ELOG_DEBUG(logger, COORDINATOR, "CoordinatorProcess starting collector process");
         registerSigSegvHandler(logger.get());
 
-        auto resourceDetector = std::make_shared<opentelemetry::php::ResourceDetector>(std::move(phpBridge));
+        auto resourceDetector = std::make_shared<opentelemetry::php::ResourceDetector>(phpBridge);
 
-        opentelemetry::php::coordinator::CoordinatorProcess(parentProcessId, processId, logger, loggerConfigUpdateFunc, ::getVendorCustomizations ? ::getVendorCustomizations() : nullptr, optionValueProvider, std::move(shareDataQueue), coordinatorConfigProvider, std::move(resourceDetector)).start();
+        opentelemetry::php::coordinator::CoordinatorProcess(parentProcessId, getpid(), logger, loggerConfigUpdateFunc, ::getVendorCustomizations ? ::getVendorCustomizations() : nullptr, optionValueProvider, shareDataQueue, coordinatorConfigProvider, coordinatorFlushStatus, payloadArena, statusPage, std::move(resourceDetector)).start();
         ELOG_DEBUG(logger, COORDINATOR, "CoordinatorProcess: collector process is going to finish");
-        std::exit(0);
-    } else {
-        if (logger) {
-            ELOG_DEBUG(logger, COORDINATOR, "CoordinatorProcess parent process continues initialization");
-        }
+    });
+
+    // supervisor process follows this process on its own, nothing has to be kept here
+    if (supervisor.start() > 0) {
+        ELOG_DEBUG(logger, COORDINATOR, "CoordinatorProcess parent process continues initialization");
     }
 }
 
@@ -116,11 +114,6 @@ static PHP_GINIT_FUNCTION(opentelemetry_distro) {
     ELOGF_DEBUG(logger, MODULE, "%s: GINIT called; parent PID: %d", __FUNCTION__, static_cast<int>(opentelemetry::osutils::getParentProcessId()));
     opentelemetry_distro_globals->globals = nullptr;
 
-    auto shareDataQueue = std::make_shared<opentelemetry::php::coordinator::CoordinatorSharedDataQueue>(logger);
-    auto coordinatorConfigProvider = std::make_shared<opentelemetry::php::coordinator::CoordinatorConfigurationProvider>(logger);
-
-    auto phpBridge = std::make_shared<opentelemetry::php::PhpBridge>(logger);
-
     auto optionValueProvider = std::make_shared<opentelemetry::php::config::OptionValueProvider>([](std::string_view iniName) -> std::optional<std::string> {
         auto val = cfg_get_entry(iniName.data(), iniName.length());
 
@@ -133,7 +126,24 @@ static PHP_GINIT_FUNCTION(opentelemetry_distro) {
         return std::string(*optStringView);
     });
 
-    forkCoordinatorProcess(logger, loggerConfigUpdateFunc, shareDataQueue, optionValueProvider, coordinatorConfigProvider, phpBridge);
+    // queue and payload arena have to be created before coordinator is forked, so their sizes are read from ini/env before AgentGlobals and its configuration exist
+    opentelemetry::php::ConfigurationSnapshot initialConfig;
+    {
+        opentelemetry::php::ConfigurationManager configManager(logger, optionValueProvider);
+        configManager.update();
+        configManager.updateIfChanged(initialConfig);
+    }
+
+    auto shareDataQueue = std::make_shared<opentelemetry::php::coordinator::CoordinatorSharedDataQueue>(logger, initialConfig.OTEL_PHP_COORDINATOR_QUEUE_SIZE);
+    auto coordinatorConfigProvider = std::make_shared<opentelemetry::php::coordinator::CoordinatorConfigurationProvider>(logger);
+    auto coordinatorFlushStatus = std::make_shared<opentelemetry::php::coordinator::CoordinatorFlushStatus>(logger);
+    auto payloadArena = initialConfig.OTEL_PHP_COORDINATOR_PAYLOAD_ARENA_SIZE > 0 ? std::make_shared<opentelemetry::php::coordinator::CoordinatorPayloadArena>(logger, initialConfig.OTEL_PHP_COORDINATOR_PAYLOAD_ARENA_SIZE) : nullptr;
+
+    auto coordinatorStatusPage = std::make_shared<opentelemetry::php::coordinator::CoordinatorStatusPage>(logger);
+
+    auto phpBridge = std::make_shared<opentelemetry::php::PhpBridge>(logger);
+
+    forkCoordinatorProcess(logger, loggerConfigUpdateFunc, shareDataQueue, optionValueProvider, coordinatorConfigProvider, coordinatorFlushStatus, payloadArena, coordinatorStatusPage, phpBridge);
 
     auto hooksStorage = std::make_shared<opentelemetry::php::InstrumentedFunctionHooksStorage_t>();
 
@@ -148,7 +158,7 @@ static PHP_GINIT_FUNCTION(opentelemetry_distro) {
     });
 
     try {
-        opentelemetry_distro_globals->globals = new opentelemetry::php::AgentGlobals(logger, loggerConfigUpdateFunc, std::move(phpBridge), std::move(hooksStorage), std::move(inferredSpans), std::move(shareDataQueue), std::move(coordinatorConfigProvider), std::move(optionValueProvider));
+        opentelemetry_distro_globals->globals = new opentelemetry::php::AgentGlobals(logger, loggerConfigUpdateFunc, std::move(phpBridge), std::move(hooksStorage), std::move(inferredSpans), std::move(shareDataQueue), std::move(coordinatorConfigProvider), std::move(coordinatorFlushStatus), std::move(payloadArena), std::move(coordinatorStatusPage), std::move(optionValueProvider));
     } catch (std::exception const &e) {
         ELOGF_CRITICAL(logger, MODULE, "Unable to allocate AgentGlobals. '%s'", e.what());
     }
@@ -188,8 +198,8 @@ PHP_MINIT_FUNCTION(opentelemetry_distro) {
 
     opentelemetry::php::moduleInit(type, module_number);
 
-    if (OTEL_G(globals)->config_->get().opentelemetry_extension_emulation_enabled) {
-        if (OTEL_G(globals)->config_->get().scoped_deps_enabled) {
+    if (OTEL_G(globals)->config_->get()->opentelemetry_extension_emulation_enabled) {
+        if (OTEL_G(globals)->config_->get()->scoped_deps_enabled) {
             opentelemetry_distro_fake.functions = opentelemetry::php::module_functions::opentelemetry_distro_fake_functions;
         }
 
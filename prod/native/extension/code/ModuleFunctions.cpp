@@ -8,6 +8,7 @@
 #include "InternalFunctionInstrumentation.h"
 #undef snprintf
 #include "coordinator/CoordinatorProcess.h"
+#include "coordinator/CoordinatorStatusPage.h"
 #include "PhpBridge.h"
 #include "OtlpExporter/LogsConverter.h"
 #include "OtlpExporter/MetricConverter.h"
@@ -139,6 +140,10 @@ ZEND_BEGIN_ARG_INFO_EX(ArgInfoInitialize, 0, 0, 3)
 ZEND_ARG_TYPE_INFO(0, endpoint, IS_STRING, 1)
 ZEND_ARG_TYPE_INFO(0, contentType, IS_STRING, 0)
 ZEND_ARG_TYPE_INFO(0, headers, IS_ARRAY, 0)
+ZEND_ARG_TYPE_INFO(0, timeout, IS_DOUBLE, 0)
+ZEND_ARG_TYPE_INFO(0, retryDelay, IS_LONG, 0)
+ZEND_ARG_TYPE_INFO(0, maxRetries, IS_LONG, 0)
+ZEND_ARG_TYPE_INFO(0, compression, IS_STRING, 1)
 ZEND_END_ARG_INFO()
 
 // TODO try to find better place for this function
@@ -196,14 +201,17 @@ PHP_FUNCTION(initialize) {
     double timeout = 0.0; // s
     long retryDelay = 0;  // ms
     long maxRetries = 0;
+    zend_string *compression = nullptr;
 
-    ZEND_PARSE_PARAMETERS_START(6, 6)
+    ZEND_PARSE_PARAMETERS_START(6, 7)
     Z_PARAM_STR(endpoint)
     Z_PARAM_STR(contentType)
     Z_PARAM_ARRAY(headers)
     Z_PARAM_DOUBLE(timeout)
     Z_PARAM_LONG(retryDelay)
     Z_PARAM_LONG(maxRetries)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_STR_OR_NULL(compression)
     ZEND_PARSE_PARAMETERS_END();
 
     HashTable *ht = Z_ARRVAL_P(headers);
@@ -220,8 +228,14 @@ PHP_FUNCTION(initialize) {
     }
     ZEND_HASH_FOREACH_END();
 
+    std::string_view compressionName = compression ? std::string_view(ZSTR_VAL(compression), ZSTR_LEN(compression)) : std::string_view{};
+    auto payloadCompression = opentelemetry::php::transport::parsePayloadCompression(compressionName);
+    if (!payloadCompression.has_value()) {
+        ELOG_WARNING(OTEL_GL(logger_), TRANSPORT, "Unknown compression '{}' for endpoint '{}', payloads will be sent uncompressed", compressionName, std::string_view(ZSTR_VAL(endpoint), ZSTR_LEN(endpoint)));
+    }
+
     opentelemetry::php::transport::HttpEndpointSSLOptions sslOptions = getSSLOptionsForSignalsEndpoint(std::string_view(ZSTR_VAL(endpoint), ZSTR_LEN(endpoint)));
-    OTEL_GL(httpTransportAsync_)->initializeConnection(std::string(ZSTR_VAL(endpoint), ZSTR_LEN(endpoint)), ZSTR_HASH(endpoint), std::string(ZSTR_VAL(contentType), ZSTR_LEN(contentType)), endpointHeaders, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<double>(timeout)), static_cast<std::size_t>(maxRetries), std::chrono::milliseconds(retryDelay), sslOptions);
+    OTEL_GL(httpTransportAsync_)->initializeConnection(std::string(ZSTR_VAL(endpoint), ZSTR_LEN(endpoint)), ZSTR_HASH(endpoint), std::string(ZSTR_VAL(contentType), ZSTR_LEN(contentType)), endpointHeaders, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<double>(timeout)), static_cast<std::size_t>(maxRetries), std::chrono::milliseconds(retryDelay), sslOptions, payloadCompression.value_or(opentelemetry::php::transport::PayloadCompression::none));
 }
 
 ZEND_BEGIN_ARG_INFO_EX(enqueue_arginfo, 0, 0, 2)
@@ -237,7 +251,26 @@ PHP_FUNCTION(enqueue) {
     Z_PARAM_STR(payload)
     ZEND_PARSE_PARAMETERS_END();
 
-    OTEL_GL(httpTransportAsync_)->enqueue(ZSTR_HASH(endpoint), std::span<std::byte>(reinterpret_cast<std::byte *>(ZSTR_VAL(payload)), ZSTR_LEN(payload)));
+    // payload is borrowed from zend_string, transport copies it only if it has to keep it after return
+    OTEL_GL(httpTransportAsync_)->enqueue(ZSTR_HASH(endpoint), opentelemetry::php::transport::PayloadBuffer::borrow({reinterpret_cast<std::byte const *>(ZSTR_VAL(payload)), ZSTR_LEN(payload)}));
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(flush_arginfo, 0, 2, _IS_BOOL, 0)
+ZEND_ARG_TYPE_INFO(0, endpoint, IS_STRING, 0)
+ZEND_ARG_TYPE_INFO(0, timeoutMs, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+// implemented as flush_endpoint, zif_flush is PHP's own flush()
+PHP_FUNCTION(flush_endpoint) {
+    zend_string *endpoint = nullptr;
+    zend_long timeoutMs = 0;
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+    Z_PARAM_STR(endpoint)
+    Z_PARAM_LONG(timeoutMs)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // waits until payloads enqueued for endpoint so far leave transport, bounded by timeout
+    RETURN_BOOL(OTEL_GL(httpTransportAsync_)->flush(ZSTR_HASH(endpoint), std::chrono::milliseconds(std::max(timeoutMs, static_cast<zend_long>(0)))));
 }
 
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(set_object_property_value_arginfo, 0, 3, _IS_BOOL, 0)
@@ -272,7 +305,7 @@ PHP_FUNCTION(convert_spans) {
     ZEND_PARSE_PARAMETERS_END();
 
     try {
-        opentelemetry::php::SpanConverter converter(OTEL_G(globals)->config_->get().scoped_deps_enabled);
+        opentelemetry::php::SpanConverter converter(OTEL_G(globals)->config_->get()->scoped_deps_enabled);
         auto res = converter.getStringSerialized(opentelemetry::php::AutoZval(batch));
         RETURN_STRINGL(res.c_str(), res.length());
     } catch (std::exception const &e) {
@@ -316,7 +349,7 @@ PHP_FUNCTION(convert_metrics) {
     ZEND_PARSE_PARAMETERS_END();
 
     try {
-        opentelemetry::php::MetricConverter converter(OTEL_G(globals)->config_->get().scoped_deps_enabled);
+        opentelemetry::php::MetricConverter converter(OTEL_G(globals)->config_->get()->scoped_deps_enabled);
         auto res = converter.getStringSerialized(opentelemetry::php::AutoZval(batch));
         RETURN_STRINGL(res.c_str(), res.length());
     } catch (std::exception const &e) {
@@ -343,9 +376,10 @@ PHP_FUNCTION(get_remote_configuration) {
         fname.emplace(ZSTR_VAL(fileName), ZSTR_LEN(fileName));
     }
 
-    auto config = OTEL_G(globals)->config_->get().remoteConfigFiles;
+    auto snapshot = OTEL_G(globals)->config_->get();
+    auto const &config = snapshot->remoteConfigFiles;
 
-    ELOG_DEBUG(OTEL_GL(logger_).get(), CONFIG, "get_remote_configuration snapshot revision: '{}', files count: '{}'", OTEL_G(globals)->config_->get().revision, config.size());
+    ELOG_DEBUG(OTEL_GL(logger_).get(), CONFIG, "get_remote_configuration snapshot revision: '{}', files count: '{}'", snapshot->revision, config.size());
 
     if (fname.has_value()) {
         if (auto cfgFound = config.find(fname.value()); cfgFound != config.end()) {
@@ -365,6 +399,39 @@ PHP_FUNCTION(get_remote_configuration) {
     RETURN_ZVAL(configFiles.get(), 1, 0);
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_get_coordinator_status, 0, 0, IS_ARRAY | IS_NULL, 0)
+ZEND_END_ARG_INFO()
+
+// returns backpressure status published by coordinator or null if coordinator didn't publish it yet
+PHP_FUNCTION(get_coordinator_status) {
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    auto const &statusPage = OTEL_GL(coordinatorStatusPage_);
+    if (!statusPage) {
+        RETURN_NULL();
+    }
+
+    auto status = statusPage->read();
+    if (status.updatedAtUnixMs == 0) {
+        RETURN_NULL();
+    }
+
+    auto levelName = opentelemetry::php::coordinator::CoordinatorStatusPage::getLevelName(status.level);
+
+    array_init(return_value);
+    add_assoc_stringl(return_value, "level", levelName.data(), levelName.length());
+    add_assoc_long(return_value, "queue_fill_percent", static_cast<zend_long>(status.queueFillPercent));
+    add_assoc_long(return_value, "transport_fill_percent", static_cast<zend_long>(status.transportFillPercent));
+    add_assoc_long(return_value, "transport_queued_bytes", static_cast<zend_long>(status.transportQueuedBytes));
+    add_assoc_long(return_value, "dropped_payloads", static_cast<zend_long>(status.droppedPayloads));
+    add_assoc_long(return_value, "dropped_bytes", static_cast<zend_long>(status.droppedBytes));
+    add_assoc_long(return_value, "exported_payloads", static_cast<zend_long>(status.exportedPayloads));
+    add_assoc_long(return_value, "export_latency_ms", static_cast<zend_long>(status.exportLatencyMs));
+    add_assoc_long(return_value, "worker_send_failures", static_cast<zend_long>(status.workerSendFailures));
+    add_assoc_long(return_value, "coordinator_restarts", static_cast<zend_long>(status.coordinatorRestarts));
+    add_assoc_long(return_value, "updated_at_ms", static_cast<zend_long>(status.updatedAtUnixMs));
+}
+
 // clang-format off
 const zend_function_entry opentelemetry_distro_functions[] = {
     ZEND_NS_FE( "OpenTelemetry\\Distro", is_enabled, no_params_arginfo )
@@ -375,6 +442,7 @@ const zend_function_entry opentelemetry_distro_functions[] = {
 
     ZEND_NS_FE( "OpenTelemetry\\Distro\\HttpTransport", initialize, ArgInfoInitialize)
     ZEND_NS_FE( "OpenTelemetry\\Distro\\HttpTransport", enqueue, enqueue_arginfo)
+    ZEND_NS_FALIAS( "OpenTelemetry\\Distro\\HttpTransport", flush, flush_endpoint, flush_arginfo)
     ZEND_NS_FE( "OpenTelemetry\\Distro\\InferredSpans", force_set_object_property_value, set_object_property_value_arginfo)
 
     ZEND_NS_FE( "OpenTelemetry\\Distro\\OtlpExporters", convert_spans, arginfo_convert_spans)
@@ -382,6 +450,7 @@ const zend_function_entry opentelemetry_distro_functions[] = {
     ZEND_NS_FE( "OpenTelemetry\\Distro\\OtlpExporters", convert_metrics, arginfo_convert_metrics)
 
     ZEND_NS_FALIAS( "OpenTelemetry\\Distro", get_remote_configuration, get_remote_configuration, arginfo_get_remote_configuration)
+    ZEND_NS_FE( "OpenTelemetry\\Distro", get_coordinator_status, arginfo_get_coordinator_status)
 
     PHP_FE_END
 };
@@ -8,7 +8,7 @@
 namespace opentelemetry::php {
 
 void getConfigOptionbyName(std::string_view optionName, zval *return_value) {
-    auto value = OTEL_GL(configManager_)->getOptionValue(optionName, OTEL_GL(config_)->get());
+    auto value = opentelemetry::php::ConfigurationManager::getOptionValue(optionName, *OTEL_GL(config_)->get());
 
     std::visit([return_value](auto &&arg) {
         using T = std::decay_t<decltype(arg)>;
@@ -26,7 +26,7 @@ void getConfigOptionbyName(std::string_view optionName, zval *return_value) {
             }
             return;
         } else if constexpr (std::is_same_v<T, std::string>) {
-            ZVAL_STRINGL(return_value, arg.c_str(), arg.length());
+            ZVAL_STRINGL(return_value, arg.data(), arg.length());
             return;
         } else if constexpr (std::is_same_v<T, std::size_t>) {
             ZVAL_LONG(return_value, arg);
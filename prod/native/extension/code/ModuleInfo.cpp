@@ -28,10 +28,9 @@ void printPhpInfo(zend_module_entry *zend_module) {
     php_info_print_table_start();
     php_info_print_table_header(2, "Configuration option", "Value");
 
-    auto const &options = OTEL_G(globals)->configManager_->getOptionMetadata();
-    for (auto const &option : options) {
-        auto value = opentelemetry::php::ConfigurationManager::accessOptionStringValueByMetadata(option.second, OTEL_GL(config_)->get());
-        php_info_print_table_row(2, option.first.c_str(), option.second.secret ? "***" : value.c_str());
+    for (auto const &option : opentelemetry::php::ConfigurationManager::getOptionMetadata()) {
+        auto value = opentelemetry::php::ConfigurationManager::accessOptionStringValueByMetadata(option, *OTEL_GL(config_)->get());
+        php_info_print_table_row(2, option.name.data(), option.secret ? "***" : value.c_str());
     }
     php_info_print_table_end();
 
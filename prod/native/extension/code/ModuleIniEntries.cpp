@@ -32,6 +32,34 @@ OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_LOG_LEVEL_SYSLOG))
 OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_DEBUG_DIAGNOSTICS_FILE))
 OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_MAX_SEND_QUEUE_SIZE))
 OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_MAX_CONCURRENT_REQUESTS))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_MAX_CONCURRENT_REQUESTS_PER_ENDPOINT))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_MAX_RETRY_DELAY))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_CIRCUIT_BREAKER_THRESHOLD))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_CIRCUIT_BREAKER_COOLDOWN))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_ENDPOINT_QUEUE_SIZE))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_QUEUE_OVERFLOW_POLICY))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_SIGNALS_PRIORITY))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_COALESCE_MAX_SIZE))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_COALESCE_LINGER))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_COALESCE_MERGE_RESOURCES))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_SPILL_DIRECTORY))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ASYNC_TRANSPORT_SPILL_MAX_SIZE))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_QUEUE_SIZE))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_PAYLOAD_ARENA_SIZE))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_PROCESSING_THREADS))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_TAIL_SAMPLING_ENABLED))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_TAIL_SAMPLING_DECISION_WAIT))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_TAIL_SAMPLING_MAX_MEMORY))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_TAIL_SAMPLING_LATENCY_THRESHOLD))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_TAIL_SAMPLING_PERCENTAGE))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_ENABLED))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_INTERVAL))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_TEMPORALITY))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_IGNORED_RESOURCE_ATTRIBUTES))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_SPAN_METRICS_ENABLED))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_SPAN_METRICS_INTERVAL))
+OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_COORDINATOR_SPAN_METRICS_DIMENSIONS))
 OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_DEBUG_INSTRUMENT_ALL))
 OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_DEBUG_PHP_HOOKS_ENABLED))
 OTEL_INI_ENTRY(STRINGIFY_HELPER(OTEL_PHP_ATTR_HOOKS_ENABLED))
@@ -63,13 +91,12 @@ bool registerIniEntries(opentelemetry::php::LoggerInterface *log, int module_num
     }
 
     // register custom displayer for secret options
-    auto options = OTEL_G(globals)->configManager_->getOptionMetadata();
-    for (auto const &option : options) {
-        if (!option.second.secret) {
+    for (auto const &option : opentelemetry::php::ConfigurationManager::getOptionMetadata()) {
+        if (!option.secret) {
             continue;
         }
 
-        auto iniName = opentelemetry::utils::getIniName(option.first);
+        auto iniName = option.iniName;
 
         if (zend_hash_str_find_ptr(EG(ini_directives), iniName.data(), iniName.length()) == nullptr) {
             continue;
@@ -85,9 +85,9 @@ void moduleInit(int moduleType, int moduleNumber) {
 
     ELOGF_DEBUG(globals->logger_, MODULE, "MINIT Replacing hooks");
     opentelemetry::php::Hooking::getInstance().fetchOriginalHooks();
-    opentelemetry::php::Hooking::getInstance().replaceHooks(globals->config_->get().inferred_spans_enabled, globals->config_->get().dependency_autoloader_guard_enabled);
+    opentelemetry::php::Hooking::getInstance().replaceHooks(globals->config_->get()->inferred_spans_enabled, globals->config_->get()->dependency_autoloader_guard_enabled);
 
-    globals->bridge_->enableScopedNamespaces(globals->config_->get().scoped_deps_enabled);
+    globals->bridge_->enableScopedNamespaces(globals->config_->get()->scoped_deps_enabled);
 
     zend_observer_activate();
     zend_observer_fcall_register(opentelemetry::php::registerObserverHandlers);
@@ -19,6 +19,8 @@
 #include "coordinator/CoordinatorProcess.h"
 #include "coordinator/CoordinatorMessagesDispatcher.h"
 #include "coordinator/CoordinatorConfigurationProvider.h"
+#include "coordinator/CoordinatorFlushStatus.h"
+#include "coordinator/CoordinatorStatusPage.h"
 #include "coordinator/CoordinatorSharedDataQueue.h"
 #include "coordinator/CoordinatorTelemetrySignalsSender.h"
 #include "coordinator/WorkerRegistrar.h"
@@ -39,6 +41,9 @@ AgentGlobals::AgentGlobals(std::shared_ptr<LoggerInterface> logger,
         std::shared_ptr<InferredSpans> inferredSpans,
         std::shared_ptr<coordinator::CoordinatorSharedDataQueue> sharedDataQueue,
         std::shared_ptr<coordinator::CoordinatorConfigurationProvider> sharedCoordinatorConfigProvider,
+        std::shared_ptr<coordinator::CoordinatorFlushStatus> sharedCoordinatorFlushStatus,
+        std::shared_ptr<coordinator::CoordinatorPayloadArena> sharedPayloadArena,
+        std::shared_ptr<coordinator::CoordinatorStatusPage> sharedCoordinatorStatusPage,
         std::shared_ptr<config::OptionValueProviderInterface> defaultOptionValueProvider) :
     vendorCustomizations_(::getVendorCustomizations ? ::getVendorCustomizations() : nullptr),
     forkableRegistry_(std::make_shared<ForkableRegistry>()),
@@ -47,13 +52,14 @@ AgentGlobals::AgentGlobals(std::shared_ptr<LoggerInterface> logger,
             {0, defaultOptionValueProvider},
             vendorCustomizations_ ? vendorCustomizations_->getOptionValueProvider() : std::pair<int, std::shared_ptr<opentelemetry::php::config::OptionValueProviderInterface>>{0, nullptr} // create dummy pair if vendor customizations or its option provider is not available, to avoid checks in PrioritizedOptionValueProviderChain
     }))),
-    config_(std::make_shared<opentelemetry::php::ConfigurationStorage>([this](ConfigurationSnapshot &cfg) { return configManager_->updateIfChanged(cfg); })),
+    config_(std::make_shared<opentelemetry::php::ConfigurationStorage>([this](ConfigurationSnapshot &cfg) { return configManager_->updateIfChanged(cfg); }, [this]() { return configManager_->getRevision(); })),
     logger_(std::move(logger)),
     bridge_(std::move(bridge)),
     sharedMemory_(std::make_shared<opentelemetry::php::SharedMemoryState>()),
     coordinatorConfigProvider_(std::move(sharedCoordinatorConfigProvider)),
-    processor_(std::make_shared<opentelemetry::php::coordinator::ChunkedMessageProcessor>(logger_, sharedDataQueue, [](const std::span<const std::byte> data) { })),
-    httpTransportAsync_(std::make_shared<opentelemetry::php::coordinator::CoordinatorTelemetrySignalsSender>(logger_, [this](std::string const &payload) { return processor_->sendPayload(payload); })),
+    coordinatorStatusPage_(std::move(sharedCoordinatorStatusPage)),
+    processor_(std::make_shared<opentelemetry::php::coordinator::ChunkedMessageProcessor>(logger_, sharedDataQueue, [](opentelemetry::php::transport::PayloadBuffer data) { })),
+    httpTransportAsync_(std::make_shared<opentelemetry::php::coordinator::CoordinatorTelemetrySignalsSender>(logger_, [this](std::span<const std::span<const std::byte>> payload) { return processor_->sendPayload(payload); }, std::move(sharedCoordinatorFlushStatus), std::move(sharedPayloadArena), coordinatorStatusPage_)),
     dependencyAutoLoaderGuard_(std::make_shared<DependencyAutoLoaderGuard>(bridge_, logger_)),
     hooksStorage_(std::move(hooksStorage)),
     sapi_(std::make_shared<opentelemetry::php::PhpSapi>(bridge_->getPhpSapiName())),
@@ -39,6 +39,9 @@ class OptionValueProviderInterface;
 }
 namespace coordinator {
 class CoordinatorConfigurationProvider;
+class CoordinatorFlushStatus;
+class CoordinatorPayloadArena;
+class CoordinatorStatusPage;
 class CoordinatorSharedDataQueue;
 class ChunkedMessageProcessor;
 class WorkerRegistrar;
@@ -59,6 +62,9 @@ public:
         std::shared_ptr<InferredSpans> inferredSpans,
         std::shared_ptr<coordinator::CoordinatorSharedDataQueue> sharedDataQueue,
         std::shared_ptr<coordinator::CoordinatorConfigurationProvider> sharedCoordinatorConfigProvider,
+        std::shared_ptr<coordinator::CoordinatorFlushStatus> sharedCoordinatorFlushStatus,
+        std::shared_ptr<coordinator::CoordinatorPayloadArena> sharedPayloadArena,
+        std::shared_ptr<coordinator::CoordinatorStatusPage> sharedCoordinatorStatusPage,
         std::shared_ptr<config::OptionValueProviderInterface> optionValueProvider);
 
     ~AgentGlobals();
@@ -76,6 +82,7 @@ public:
     std::shared_ptr<PhpBridgeInterface> bridge_;
     std::shared_ptr<SharedMemoryState> sharedMemory_;
     std::shared_ptr<coordinator::CoordinatorConfigurationProvider> coordinatorConfigProvider_;
+    std::shared_ptr<coordinator::CoordinatorStatusPage> coordinatorStatusPage_;
     std::shared_ptr<coordinator::ChunkedMessageProcessor> processor_;
     std::shared_ptr<transport::HttpTransportAsyncInterface> httpTransportAsync_;
     std::shared_ptr<DependencyAutoLoaderGuard> dependencyAutoLoaderGuard_;
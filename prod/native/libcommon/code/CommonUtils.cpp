@@ -234,7 +234,28 @@ std::optional<ParsedURL> parseUrl(std::string const &url) {
     return std::nullopt;
 }
 
+std::optional<ParsedUnixSocketURL> parseUnixSocketURL(std::string_view url) {
+    using namespace std::string_view_literals;
+    constexpr auto scheme = "unix://"sv;
+    if (!url.starts_with(scheme)) {
+        return std::nullopt;
+    }
+    url.remove_prefix(scheme.length());
+
+    auto separator = url.find(':');
+    auto socketPath = url.substr(0, separator);
+    auto requestPath = separator == std::string_view::npos ? "/"sv : url.substr(separator + 1);
+    if (socketPath.length() < 2 || !socketPath.starts_with('/') || !requestPath.starts_with('/')) {
+        return std::nullopt;
+    }
+    return ParsedUnixSocketURL{std::string(socketPath), std::string(requestPath)};
+}
+
 std::optional<std::string> getConnectionDetailsFromURL(std::string const &url) {
+    if (auto unixSocket = parseUnixSocketURL(url); unixSocket.has_value()) {
+        return "unix://" + unixSocket->socketPath;
+    }
+
     boost::regex urlPattern(R"(^((https?):\/\/([^\/:]+))(?::(\d+))?)");
     boost::smatch match;
 
@@ -394,4 +415,21 @@ std::optional<std::chrono::milliseconds> parseRetryAfter(std::string_view value)
 
     return std::chrono::duration_cast<std::chrono::milliseconds>(target_time - now_rounded);
 }
+
+std::chrono::milliseconds getRetryBackoffDelay(std::chrono::milliseconds baseDelay, std::size_t retry, std::chrono::milliseconds maxDelay, double jitter) {
+    if (baseDelay.count() <= 0) {
+        return std::chrono::milliseconds(0);
+    }
+
+    std::chrono::milliseconds delay = baseDelay;
+    for (std::size_t i = 1; i < retry && (maxDelay.count() <= 0 || delay < maxDelay); ++i) {
+        delay *= 2;
+    }
+    if (maxDelay.count() > 0 && delay > maxDelay) {
+        delay = maxDelay;
+    }
+
+    jitter = std::clamp(jitter, 0.0, 1.0);
+    return delay - std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(static_cast<double>(delay.count()) * jitter / 2));
+}
 }
\ No newline at end of file
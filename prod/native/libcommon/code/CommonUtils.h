@@ -60,6 +60,15 @@ struct ParsedURL {
 
 std::optional<ParsedURL> parseUrl(std::string const &url);
 
+// unix://<absolute socket path>[:<request path>], e.g. unix:///run/otelcol.sock:/v1/traces. Request path defaults to /
+struct ParsedUnixSocketURL {
+    std::string socketPath;
+    std::string requestPath;
+};
+
+std::optional<ParsedUnixSocketURL> parseUnixSocketURL(std::string_view url);
+
+// scheme with host and port, or unix:// with socket path. Transfers with the same connection details can share connection
 std::optional<std::string> getConnectionDetailsFromURL(std::string const &url);
 
 std::unordered_map<opentelemetry::php::LogFeature, LogLevel> parseLogFeatures(std::shared_ptr<opentelemetry::php::LoggerInterface> logger, std::string_view logFeatures);
@@ -69,4 +78,7 @@ bool isUtf8(std::string_view input);
 std::string percentDecode(std::string_view input);
 std::map<std::string, std::string> parseUrlEncodedKeyValueString(std::string_view input);
 std::optional<std::chrono::milliseconds> parseRetryAfter(std::string_view value);
+
+// exponential backoff: baseDelay * 2^(retry - 1) limited to maxDelay. jitter from range [0, 1) scales result down to at most half of it
+std::chrono::milliseconds getRetryBackoffDelay(std::chrono::milliseconds baseDelay, std::size_t retry, std::chrono::milliseconds maxDelay, double jitter);
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include <string_view>
 #include <cstdlib>
+#include <type_traits>
 
 namespace opentelemetry::php {
 
@@ -12,131 +13,114 @@ using namespace std::string_view_literals;
 
 
 std::string ConfigurationManager::accessOptionStringValueByMetadata(OptionMetadata const &metadata, ConfigurationSnapshot const &snapshot) {
-    switch (metadata.type) {
-        case OptionMetadata::type::string: {
-            std::string *value = reinterpret_cast<std::string *>((std::byte *)&snapshot + metadata.offset);
-            return *value;
-        }
-        case OptionMetadata::type::boolean: {
-            bool *value = reinterpret_cast<bool *>((std::byte *)&snapshot + metadata.offset);
-            return *value ? "true"s : "false"s;
-        }
-        case OptionMetadata::type::duration: {
-            auto value = reinterpret_cast<std::chrono::milliseconds *>((std::byte *)&snapshot + metadata.offset);
-            return std::to_string(value->count());
-        }
-        case OptionMetadata::type::loglevel: {
-           LogLevel *value = reinterpret_cast<LogLevel *>((std::byte *)&snapshot + metadata.offset);
-           std::string_view level = utils::trim(getLogLevelName(*value));
-           return {level.data(), level.length()};
-        }
-        case OptionMetadata::type::bytes: {
-            std::size_t *value = reinterpret_cast<std::size_t *>((std::byte *)&snapshot + metadata.offset);
-            return std::to_string(*value);
-        }
-        default:
-            return {};
-    }
+    return std::visit(
+        [&snapshot](auto member) -> std::string {
+            auto const &value = snapshot.*member;
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (std::is_same_v<T, std::string>) {
+                return value;
+            } else if constexpr (std::is_same_v<T, bool>) {
+                return value ? "true"s : "false"s;
+            } else if constexpr (std::is_same_v<T, std::chrono::milliseconds>) {
+                return std::to_string(value.count());
+            } else if constexpr (std::is_same_v<T, LogLevel>) {
+                std::string_view level = utils::trim(getLogLevelName(value));
+                return {level.data(), level.length()};
+            } else {
+                return std::to_string(value);
+            }
+        },
+        metadata.member);
 }
 
-ConfigurationManager::optionValue_t ConfigurationManager::getOptionValue(std::string_view optionName, ConfigurationSnapshot const &snapshot) const {
-    auto option = options_.find(std::string(optionName));
-    if (option == std::end(options_)) {
+ConfigurationManager::optionValue_t ConfigurationManager::getOptionValue(std::string_view optionName, ConfigurationSnapshot const &snapshot) {
+    auto metadata = findOptionMetadata(optionName);
+    if (!metadata) {
         return std::nullopt;
     }
 
-    auto const &metadata = option->second;
-    switch (metadata.type) {
-        case opentelemetry::php::ConfigurationManager::OptionMetadata::type::string: {
-            std::string *value = reinterpret_cast<std::string *>((std::byte *)&snapshot + metadata.offset);
-            return std::string(value->data(), value->length());
-        }
-        case opentelemetry::php::ConfigurationManager::OptionMetadata::type::boolean: {
-            bool *value = reinterpret_cast<bool *>((std::byte *)&snapshot + metadata.offset);
-            return *value;
-        }
-        case opentelemetry::php::ConfigurationManager::OptionMetadata::type::duration: {
-            auto value = reinterpret_cast<std::chrono::milliseconds *>((std::byte *)&snapshot + metadata.offset);
-            return *value;
-        }
-        case opentelemetry::php::ConfigurationManager::OptionMetadata::type::loglevel: {
-            LogLevel *value = reinterpret_cast<LogLevel *>((std::byte *)&snapshot + metadata.offset);
-            return *value;
-        }
-        case opentelemetry::php::ConfigurationManager::OptionMetadata::type::bytes: {
-            size_t *value = reinterpret_cast<size_t *>((std::byte *)&snapshot + metadata.offset);
-            return *value;
-        }
-        default:
-            return std::nullopt;
-    }
+    return std::visit(
+        [&snapshot](auto member) -> optionValue_t { return snapshot.*member; },
+        metadata->member);
 }
 
 void ConfigurationManager::update(configFiles_t configFiles) {
-    ConfigurationSnapshot newConfig;
+    std::lock_guard<std::mutex> lock(updateMutex_);
+
+    // options which raw value didn't change keep value parsed into current snapshot
+    ConfigurationSnapshot newConfig = *getSnapshot();
     newConfig.revision = getNextRevision();
     newConfig.remoteConfigFiles = std::move(configFiles);
     ELOG_DEBUG(logger_, CONFIG, "ConfigurationManager::update new revision: {} configFiles: {}", newConfig.revision, newConfig.remoteConfigFiles.size());
 
     optionValueProvider_->update(newConfig.remoteConfigFiles);
 
-    for (auto const &entry : options_) {
-        auto optionVal = fetchStringValue(entry.first, entry.second.otelNativeOption);
+    static ConfigurationSnapshot const defaults;
+    rawValues_.resize(options_.size());
+    std::size_t index = 0;
+    std::size_t parsedOptions = 0;
+    for (auto const &option : options_) {
+        auto optionVal = fetchStringValue(option);
+        auto &rawValue = rawValues_[index++];
+        if (optionVal == rawValue) {
+            continue;
+        }
+        rawValue = optionVal;
+        parsedOptions++;
+
         if (!optionVal.has_value()) {
-            continue; // keep default from snapshot
+            copyOptionValue(option, defaults, newConfig);
+            continue;
         }
         auto &optionValue = optionVal.value();
 
         try {
-            switch (entry.second.type) {
-                case OptionMetadata::type::string: {
-                    std::string *value = (std::string *)((std::byte *)&newConfig + entry.second.offset);
-                    value->swap(optionValue);
-                    break;
-                }
-                case OptionMetadata::type::boolean: {
-                    bool *value = (bool *)((std::byte *)&newConfig + entry.second.offset);
-                    *value = utils::parseBoolean(optionValue);
-                    break;
-                }
-                case OptionMetadata::type::duration: {
-                    auto value = reinterpret_cast<std::chrono::milliseconds *>((std::byte *)&newConfig + entry.second.offset);
-                    *value = utils::convertDurationWithUnit(optionValue);
-                    break;
-                }
-                case OptionMetadata::type::loglevel: {
-                    LogLevel *value = (LogLevel *)((std::byte *)&newConfig + entry.second.offset);
-                    *value = utils::parseLogLevel(optionValue);
-                    break;
-                }
-                case OptionMetadata::type::bytes: {
-                    std::size_t *value = (std::size_t *)((std::byte *)&newConfig + entry.second.offset);
-                    *value = utils::parseByteUnits(optionValue);
-                    break;
-                }
-            }
-
+            std::visit(
+                [&newConfig, &optionValue](auto member) {
+                    auto &value = newConfig.*member;
+                    using T = std::decay_t<decltype(value)>;
+                    if constexpr (std::is_same_v<T, std::string>) {
+                        value.swap(optionValue);
+                    } else if constexpr (std::is_same_v<T, bool>) {
+                        value = utils::parseBoolean(optionValue);
+                    } else if constexpr (std::is_same_v<T, std::chrono::milliseconds>) {
+                        value = utils::convertDurationWithUnit(optionValue);
+                    } else if constexpr (std::is_same_v<T, LogLevel>) {
+                        value = utils::parseLogLevel(optionValue);
+                    } else {
+                        value = utils::parseByteUnits(optionValue);
+                    }
+                },
+                option.member);
         } catch (std::invalid_argument const &e) {
             ELOGF_NF_ERROR(logger_, "ConfigurationManager::update exception: '%s'", e.what());
+            copyOptionValue(option, defaults, newConfig);
         }
     }
+    ELOG_DEBUG(logger_, CONFIG, "ConfigurationManager::update revision: {} parsed {} changed options", newConfig.revision, parsedOptions);
+
+    auto revision = newConfig.revision;
+    current_.store(std::make_shared<ConfigurationSnapshot const>(std::move(newConfig)), std::memory_order_release);
+    currentRevision_.store(revision, std::memory_order_release);
+}
 
-    current_ = std::move(newConfig);
+void ConfigurationManager::copyOptionValue(OptionMetadata const &metadata, ConfigurationSnapshot const &source, ConfigurationSnapshot &target) {
+    std::visit([&source, &target](auto member) { target.*member = source.*member; }, metadata.member);
 }
 
-std::optional<std::string> ConfigurationManager::fetchStringValue(std::string_view name, bool isOtelNativeOption) {
-    auto dynamicValue = optionValueProvider_->getDynamicOptionValue(name);
+// option names are precomputed and null terminated, nothing is allocated unless option has a value
+std::optional<std::string> ConfigurationManager::fetchStringValue(OptionMetadata const &metadata) {
+    auto dynamicValue = optionValueProvider_->getDynamicOptionValue(metadata.name);
     if (dynamicValue.has_value()) {
         return dynamicValue;
     }
 
-    auto iniName = isOtelNativeOption ? std::string(name) : utils::getIniName(name);
-    auto value = optionValueProvider_->getIniOptionValue(iniName);
+    auto value = optionValueProvider_->getIniOptionValue(metadata.iniName);
     if (value.has_value()) {
         return value;
     }
 
-    return optionValueProvider_->getEnvironmentOptionValue(isOtelNativeOption ? std::string(name).c_str() : utils::getEnvName(name).c_str());
+    return optionValueProvider_->getEnvironmentOptionValue(metadata.envName);
 }
 
 uint64_t ConfigurationManager::getNextRevision() {
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include "config/OptionRegistry.h"
 #include "config/OptionValueProviderInterface.h"
 #include "ConfigurationSnapshot.h"
 #include "LoggerInterface.h"
@@ -8,11 +9,12 @@
 
 #include <atomic>
 #include <chrono>
-#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <variant>
+#include <vector>
 
 namespace opentelemetry::php {
 
@@ -22,143 +24,172 @@ class ConfigurationManager {
 public:
     using configFiles_t = config::OptionValueProviderInterface::configFiles_t;
 
-    struct OptionMetadata  {
-        enum type { boolean, string, duration, loglevel, bytes } type;
-        size_t offset;
-        bool secret = false;
-        bool otelNativeOption = false;
-    };
+    using OptionMetadata = config::OptionMetadata;
 
+    // string value is copied, so it outlives snapshot replaced by concurrent update
     using optionValue_t = std::variant<std::chrono::milliseconds, LogLevel, bool, std::string, std::size_t, std::nullopt_t>;
 
     ConfigurationManager(std::shared_ptr<LoggerInterface> logger, std::shared_ptr<config::OptionValueProviderInterface> optionValueProvider) : logger_(std::move(logger)), optionValueProvider_(std::move(optionValueProvider)) {
-        current_.revision = getNextRevision();
+        auto initial = std::make_shared<ConfigurationSnapshot>();
+        initial->revision = getNextRevision();
+        currentRevision_.store(initial->revision, std::memory_order_release);
+        current_.store(std::move(initial), std::memory_order_release);
     }
 
     void update(configFiles_t configFiles = {});
 
+    // revision of last published snapshot, cheap to poll from request path
+    uint64_t getRevision() const noexcept {
+        return currentRevision_.load(std::memory_order_acquire);
+    }
+
+    std::shared_ptr<ConfigurationSnapshot const> getSnapshot() const {
+        return current_.load(std::memory_order_acquire);
+    }
+
     bool updateIfChanged(ConfigurationSnapshot &snapshot) {
-        if (snapshot.revision != current_.revision) {
-            snapshot = current_;
-            return true;
+        if (snapshot.revision == getRevision()) {
+            return false;
         }
-        return false;
+        auto current = getSnapshot();
+        if (snapshot.revision == current->revision) {
+            return false;
+        }
+        snapshot = *current;
+        return true;
     }
 
-    std::map<std::string, OptionMetadata> const &getOptionMetadata() {
+    static constexpr auto const &getOptionMetadata() {
         return options_;
     }
 
-    optionValue_t getOptionValue(std::string_view optionName, ConfigurationSnapshot const &snapshot) const;
+    static constexpr OptionMetadata const *findOptionMetadata(std::string_view optionName) {
+        auto index = optionIndex_.find(options_, optionName);
+        return index < options_.size() ? &options_[index] : nullptr;
+    }
+
+    static optionValue_t getOptionValue(std::string_view optionName, ConfigurationSnapshot const &snapshot);
 
     static std::string accessOptionStringValueByMetadata(OptionMetadata const &metadata, ConfigurationSnapshot const &snapshot);
 
 private:
-    std::optional<std::string> fetchStringValue(std::string_view name, bool isOtelNativeOption);
+    std::optional<std::string> fetchStringValue(OptionMetadata const &metadata);
     uint64_t getNextRevision();
+    static void copyOptionValue(OptionMetadata const &metadata, ConfigurationSnapshot const &source, ConfigurationSnapshot &target);
 
 private:
     std::atomic_uint64_t upcomingConfigRevision_ = 0;
-    ConfigurationSnapshot current_;
+    std::atomic_uint64_t currentRevision_ = 0;
+    std::atomic<std::shared_ptr<ConfigurationSnapshot const>> current_; // published snapshot is never modified
+    std::mutex updateMutex_;
+    std::vector<std::optional<std::string>> rawValues_; // raw value of each option parsed into current snapshot, in options_ order
 
     std::shared_ptr<LoggerInterface> logger_;
     std::shared_ptr<config::OptionValueProviderInterface> optionValueProvider_;
 
-    // Custom offset calculation for non-standard-layout types
-    template <typename T, typename M>
-    static constexpr size_t memberOffset(M T::*member) {
-        constexpr T object{};
-        return reinterpret_cast<size_t>(&(object.*member)) - reinterpret_cast<size_t>(&object);
-    }
-
-#define MEMBER_OFFSET(type, member) (reinterpret_cast<size_t>(&((type *)nullptr)->member))
-
-#define BUILD_OTEL_PHP_OPTION_METADATA(optname, type, secret)                  \
-    {                                                                          \
-        STRINGIFY_HELPER(optname), {                                           \
-            type, MEMBER_OFFSET(ConfigurationSnapshot, optname), secret, false \
-        }                                                                      \
-    }
-#define BUILD_OPTION_METADATA(optname, type, secret)                          \
-    {                                                                         \
-        STRINGIFY_HELPER(optname), {                                          \
-            type, MEMBER_OFFSET(ConfigurationSnapshot, optname), secret, true \
-        }                                                                     \
-    }
-
     // clang-format off
-    std::map<std::string, OptionMetadata> options_ = {
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_BOOTSTRAP_PHP_PART_FILE, OptionMetadata::type::string, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ENABLED, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_FILE, OptionMetadata::type::string, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_LEVEL, OptionMetadata::type::loglevel, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_LEVEL_FILE, OptionMetadata::type::loglevel, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_LEVEL_STDERR, OptionMetadata::type::loglevel, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_LEVEL_SYSLOG, OptionMetadata::type::loglevel, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_FEATURES, OptionMetadata::type::string, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_DEBUG_DIAGNOSTICS_FILE, OptionMetadata::type::string, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_MAX_SEND_QUEUE_SIZE, OptionMetadata::type::bytes, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_SHUTDOWN_TIMEOUT, OptionMetadata::type::duration, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_DEBUG_INSTRUMENT_ALL, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_DEBUG_PHP_HOOKS_ENABLED, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ATTR_HOOKS_ENABLED, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_SCOPED_DEPS_ENABLED, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_INFERRED_SPANS_ENABLED, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_INFERRED_SPANS_REDUCTION_ENABLED, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_INFERRED_SPANS_STACKTRACE_ENABLED, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_INFERRED_SPANS_SAMPLING_INTERVAL, OptionMetadata::type::duration, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_INFERRED_SPANS_MIN_DURATION, OptionMetadata::type::duration, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_DEPENDENCY_AUTOLOADER_GUARD_ENABLED, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_USER_BOOTSTRAP_PHP_FILE, OptionMetadata::type::string, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPENTELEMETRY_EXTENSION_EMULATION_ENABLED, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_NATIVE_OTLP_SERIALIZER_ENABLED, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_HEADERS, OptionMetadata::type::string, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_ENDPOINT, OptionMetadata::type::string, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_HEARTBEAT_INTERVAL, OptionMetadata::type::duration, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_POLLING_INTERVAL, OptionMetadata::type::duration, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_SEND_TIMEOUT, OptionMetadata::type::duration, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_SEND_MAX_RETRIES, OptionMetadata::type::bytes, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_SEND_RETRY_DELAY, OptionMetadata::type::duration, false),
-
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_INSECURE, OptionMetadata::type::boolean, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_CERTIFICATE, OptionMetadata::type::string, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_CLIENT_CERTIFICATE, OptionMetadata::type::string, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_CLIENT_KEY, OptionMetadata::type::string, false),
-        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_CLIENT_KEYPASS, OptionMetadata::type::string, true),
+    static constexpr auto options_ = std::to_array<OptionMetadata>({
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_BOOTSTRAP_PHP_PART_FILE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_FILE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_LEVEL, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_LEVEL_FILE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_LEVEL_STDERR, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_LEVEL_SYSLOG, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_LOG_FEATURES, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_DEBUG_DIAGNOSTICS_FILE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_MAX_SEND_QUEUE_SIZE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_SHUTDOWN_TIMEOUT, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_MAX_CONCURRENT_REQUESTS, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_MAX_CONCURRENT_REQUESTS_PER_ENDPOINT, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_MAX_RETRY_DELAY, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_CIRCUIT_BREAKER_THRESHOLD, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_CIRCUIT_BREAKER_COOLDOWN, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_ENDPOINT_QUEUE_SIZE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_QUEUE_OVERFLOW_POLICY, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_SIGNALS_PRIORITY, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_COALESCE_MAX_SIZE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_COALESCE_LINGER, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_COALESCE_MERGE_RESOURCES, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_SPILL_DIRECTORY, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ASYNC_TRANSPORT_SPILL_MAX_SIZE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_QUEUE_SIZE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_PAYLOAD_ARENA_SIZE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_PROCESSING_THREADS, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_TAIL_SAMPLING_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_TAIL_SAMPLING_DECISION_WAIT, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_TAIL_SAMPLING_MAX_MEMORY, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_TAIL_SAMPLING_LATENCY_THRESHOLD, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_TAIL_SAMPLING_PERCENTAGE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_INTERVAL, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_TEMPORALITY, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_IGNORED_RESOURCE_ATTRIBUTES, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_SPAN_METRICS_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_SPAN_METRICS_INTERVAL, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_COORDINATOR_SPAN_METRICS_DIMENSIONS, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_DEBUG_INSTRUMENT_ALL, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_DEBUG_PHP_HOOKS_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_ATTR_HOOKS_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_SCOPED_DEPS_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_INFERRED_SPANS_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_INFERRED_SPANS_REDUCTION_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_INFERRED_SPANS_STACKTRACE_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_INFERRED_SPANS_SAMPLING_INTERVAL, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_INFERRED_SPANS_MIN_DURATION, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_DEPENDENCY_AUTOLOADER_GUARD_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_USER_BOOTSTRAP_PHP_FILE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPENTELEMETRY_EXTENSION_EMULATION_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_NATIVE_OTLP_SERIALIZER_ENABLED, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_HEADERS, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_ENDPOINT, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_HEARTBEAT_INTERVAL, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_POLLING_INTERVAL, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_SEND_TIMEOUT, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_SEND_MAX_RETRIES, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_SEND_RETRY_DELAY, false),
+
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_INSECURE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_CERTIFICATE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_CLIENT_CERTIFICATE, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_CLIENT_KEY, false),
+        BUILD_OTEL_PHP_OPTION_METADATA(OTEL_PHP_OPAMP_CLIENT_KEYPASS, true),
 
         // otel native options
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_INSECURE, OptionMetadata::type::boolean, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_CERTIFICATE, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_CLIENT_CERTIFICATE, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_CLIENT_KEY, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_CLIENT_KEYPASS, OptionMetadata::type::string, true),
-
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_INSECURE, OptionMetadata::type::boolean, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_CERTIFICATE, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_CLIENT_CERTIFICATE, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_CLIENT_KEY, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_CLIENT_KEYPASS, OptionMetadata::type::string, true),
-
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_INSECURE, OptionMetadata::type::boolean, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_CERTIFICATE, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_CLIENT_CERTIFICATE, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_CLIENT_KEY, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_CLIENT_KEYPASS, OptionMetadata::type::string, true),
-
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_INSECURE, OptionMetadata::type::boolean, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_CERTIFICATE, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_CLIENT_CERTIFICATE, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_CLIENT_KEY, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_CLIENT_KEYPASS, OptionMetadata::type::string, true),
-
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_ENDPOINT, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_ENDPOINT, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_ENDPOINT, OptionMetadata::type::string, false),
-        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_ENDPOINT, OptionMetadata::type::string, false),
-        };
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_INSECURE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_CERTIFICATE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_CLIENT_CERTIFICATE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_CLIENT_KEY, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_CLIENT_KEYPASS, true),
+
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_INSECURE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_CERTIFICATE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_CLIENT_CERTIFICATE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_CLIENT_KEY, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_CLIENT_KEYPASS, true),
+
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_INSECURE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_CERTIFICATE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_CLIENT_CERTIFICATE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_CLIENT_KEY, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_CLIENT_KEYPASS, true),
+
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_INSECURE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_CERTIFICATE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_CLIENT_CERTIFICATE, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_CLIENT_KEY, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_CLIENT_KEYPASS, true),
+
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_ENDPOINT, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_TRACES_ENDPOINT, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_METRICS_ENDPOINT, false),
+        BUILD_OPTION_METADATA(OTEL_EXPORTER_OTLP_LOGS_ENDPOINT, false),
+        });
 
     // clang-format on
+
+    static constexpr config::OptionIndex<options_.size()> optionIndex_{options_};
 };
 
 } // namespace opentelemetry::php
@@ -18,6 +18,34 @@
 #define OTEL_PHP_MAX_SEND_QUEUE_SIZE max_send_queue_size
 #define OTEL_PHP_ASYNC_TRANSPORT async_transport
 #define OTEL_PHP_ASYNC_TRANSPORT_SHUTDOWN_TIMEOUT async_transport_shutdown_timeout
+#define OTEL_PHP_ASYNC_TRANSPORT_MAX_CONCURRENT_REQUESTS async_transport_max_concurrent_requests
+#define OTEL_PHP_ASYNC_TRANSPORT_MAX_CONCURRENT_REQUESTS_PER_ENDPOINT async_transport_max_concurrent_requests_per_endpoint
+#define OTEL_PHP_ASYNC_TRANSPORT_MAX_RETRY_DELAY async_transport_max_retry_delay
+#define OTEL_PHP_ASYNC_TRANSPORT_CIRCUIT_BREAKER_THRESHOLD async_transport_circuit_breaker_threshold
+#define OTEL_PHP_ASYNC_TRANSPORT_CIRCUIT_BREAKER_COOLDOWN async_transport_circuit_breaker_cooldown
+#define OTEL_PHP_ASYNC_TRANSPORT_ENDPOINT_QUEUE_SIZE async_transport_endpoint_queue_size
+#define OTEL_PHP_ASYNC_TRANSPORT_QUEUE_OVERFLOW_POLICY async_transport_queue_overflow_policy
+#define OTEL_PHP_ASYNC_TRANSPORT_SIGNALS_PRIORITY async_transport_signals_priority
+#define OTEL_PHP_ASYNC_TRANSPORT_COALESCE_MAX_SIZE async_transport_coalesce_max_size
+#define OTEL_PHP_ASYNC_TRANSPORT_COALESCE_LINGER async_transport_coalesce_linger
+#define OTEL_PHP_ASYNC_TRANSPORT_COALESCE_MERGE_RESOURCES async_transport_coalesce_merge_resources
+#define OTEL_PHP_ASYNC_TRANSPORT_SPILL_DIRECTORY async_transport_spill_directory
+#define OTEL_PHP_ASYNC_TRANSPORT_SPILL_MAX_SIZE async_transport_spill_max_size
+#define OTEL_PHP_COORDINATOR_QUEUE_SIZE coordinator_queue_size
+#define OTEL_PHP_COORDINATOR_PAYLOAD_ARENA_SIZE coordinator_payload_arena_size
+#define OTEL_PHP_COORDINATOR_PROCESSING_THREADS coordinator_processing_threads
+#define OTEL_PHP_COORDINATOR_TAIL_SAMPLING_ENABLED coordinator_tail_sampling_enabled
+#define OTEL_PHP_COORDINATOR_TAIL_SAMPLING_DECISION_WAIT coordinator_tail_sampling_decision_wait
+#define OTEL_PHP_COORDINATOR_TAIL_SAMPLING_MAX_MEMORY coordinator_tail_sampling_max_memory
+#define OTEL_PHP_COORDINATOR_TAIL_SAMPLING_LATENCY_THRESHOLD coordinator_tail_sampling_latency_threshold
+#define OTEL_PHP_COORDINATOR_TAIL_SAMPLING_PERCENTAGE coordinator_tail_sampling_percentage
+#define OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_ENABLED coordinator_metrics_aggregation_enabled
+#define OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_INTERVAL coordinator_metrics_aggregation_interval
+#define OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_TEMPORALITY coordinator_metrics_aggregation_temporality
+#define OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_IGNORED_RESOURCE_ATTRIBUTES coordinator_metrics_aggregation_ignored_resource_attributes
+#define OTEL_PHP_COORDINATOR_SPAN_METRICS_ENABLED coordinator_span_metrics_enabled
+#define OTEL_PHP_COORDINATOR_SPAN_METRICS_INTERVAL coordinator_span_metrics_interval
+#define OTEL_PHP_COORDINATOR_SPAN_METRICS_DIMENSIONS coordinator_span_metrics_dimensions
 
 #define OTEL_PHP_DEBUG_INSTRUMENT_ALL debug_instrument_all
 #define OTEL_PHP_DEBUG_PHP_HOOKS_ENABLED debug_php_hooks_enabled
@@ -103,6 +131,34 @@ struct ConfigurationSnapshot {
     std::size_t OTEL_PHP_MAX_SEND_QUEUE_SIZE = 2 * 1024 * 1204;
     bool OTEL_PHP_ASYNC_TRANSPORT = true;
     std::chrono::milliseconds OTEL_PHP_ASYNC_TRANSPORT_SHUTDOWN_TIMEOUT = std::chrono::seconds(30);
+    std::size_t OTEL_PHP_ASYNC_TRANSPORT_MAX_CONCURRENT_REQUESTS = 8;
+    std::size_t OTEL_PHP_ASYNC_TRANSPORT_MAX_CONCURRENT_REQUESTS_PER_ENDPOINT = 4;
+    std::chrono::milliseconds OTEL_PHP_ASYNC_TRANSPORT_MAX_RETRY_DELAY = std::chrono::seconds(30);
+    std::size_t OTEL_PHP_ASYNC_TRANSPORT_CIRCUIT_BREAKER_THRESHOLD = 5;
+    std::chrono::milliseconds OTEL_PHP_ASYNC_TRANSPORT_CIRCUIT_BREAKER_COOLDOWN = std::chrono::seconds(30);
+    std::size_t OTEL_PHP_ASYNC_TRANSPORT_ENDPOINT_QUEUE_SIZE = 0;
+    std::string OTEL_PHP_ASYNC_TRANSPORT_QUEUE_OVERFLOW_POLICY = "drop_newest";
+    std::string OTEL_PHP_ASYNC_TRANSPORT_SIGNALS_PRIORITY = "opamp,traces,metrics,logs";
+    std::size_t OTEL_PHP_ASYNC_TRANSPORT_COALESCE_MAX_SIZE = 1024 * 1024;
+    std::chrono::milliseconds OTEL_PHP_ASYNC_TRANSPORT_COALESCE_LINGER = std::chrono::milliseconds(0);
+    bool OTEL_PHP_ASYNC_TRANSPORT_COALESCE_MERGE_RESOURCES = true;
+    std::string OTEL_PHP_ASYNC_TRANSPORT_SPILL_DIRECTORY;
+    std::size_t OTEL_PHP_ASYNC_TRANSPORT_SPILL_MAX_SIZE = 64 * 1024 * 1024;
+    std::size_t OTEL_PHP_COORDINATOR_QUEUE_SIZE = 8 * 1024 * 1024;
+    std::size_t OTEL_PHP_COORDINATOR_PAYLOAD_ARENA_SIZE = 32 * 1024 * 1024;
+    std::size_t OTEL_PHP_COORDINATOR_PROCESSING_THREADS = 0;
+    bool OTEL_PHP_COORDINATOR_TAIL_SAMPLING_ENABLED = false;
+    std::chrono::milliseconds OTEL_PHP_COORDINATOR_TAIL_SAMPLING_DECISION_WAIT = std::chrono::milliseconds(5000);
+    std::size_t OTEL_PHP_COORDINATOR_TAIL_SAMPLING_MAX_MEMORY = 32 * 1024 * 1024;
+    std::chrono::milliseconds OTEL_PHP_COORDINATOR_TAIL_SAMPLING_LATENCY_THRESHOLD = std::chrono::milliseconds(1000);
+    std::size_t OTEL_PHP_COORDINATOR_TAIL_SAMPLING_PERCENTAGE = 10;
+    bool OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_ENABLED = false;
+    std::chrono::milliseconds OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_INTERVAL = std::chrono::milliseconds(60000);
+    std::string OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_TEMPORALITY = "cumulative";
+    std::string OTEL_PHP_COORDINATOR_METRICS_AGGREGATION_IGNORED_RESOURCE_ATTRIBUTES = "process.pid";
+    bool OTEL_PHP_COORDINATOR_SPAN_METRICS_ENABLED = false;
+    std::chrono::milliseconds OTEL_PHP_COORDINATOR_SPAN_METRICS_INTERVAL = std::chrono::milliseconds(60000);
+    std::string OTEL_PHP_COORDINATOR_SPAN_METRICS_DIMENSIONS = "http.request.method,http.response.status_code,http.route";
     bool OTEL_PHP_DEBUG_INSTRUMENT_ALL = false;
     bool OTEL_PHP_DEBUG_PHP_HOOKS_ENABLED = false;
     bool OTEL_PHP_ATTR_HOOKS_ENABLED = false;
@@ -6,42 +6,56 @@
 #include <boost/signals2.hpp>
 #undef snprintf
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 
 namespace opentelemetry::php {
 
-// local, per worker configuration holder - no need to be synchronized, need to be stored in worker globals
+// local, per worker configuration holder, stored in worker globals
+// Configuration is published as immutable snapshots, update builds new snapshot and swaps it. get() returns pinned snapshot which stays unchanged while it is held,
+// operator-> and get(member) pin snapshot for duration of expression. Snapshot is swapped through std::atomic<std::shared_ptr>, which may take internal lock
 class ConfigurationStorage {
 public:
     using configUpdate_t = std::function<bool(ConfigurationSnapshot &)>;
     using configUpdated_t = boost::signals2::signal<void(ConfigurationSnapshot const &)>;
+    using getRevision_t = std::function<uint64_t()>;
 
-    ConfigurationStorage(configUpdate_t configUpdate) : configUpdate_(configUpdate) {
+    // getRevision returns revision of global source, update is skipped while it matches revision of current snapshot
+    ConfigurationStorage(configUpdate_t configUpdate, getRevision_t getRevision = {}) : configUpdate_(std::move(configUpdate)), getRevision_(std::move(getRevision)) {
+        snapshot_.store(std::make_shared<ConfigurationSnapshot const>(), std::memory_order_release);
     }
 
     // it will fetch configuration from global source
     void update() {
+        if (getRevision_ && getRevision_() == get()->revision) {
+            return;
+        }
+
         std::lock_guard<std::mutex> lock(mutex_);
-        bool changed = configUpdate_(config_);
-        if (changed) {
-            configUpdated_(config_);
+        auto config = std::make_shared<ConfigurationSnapshot>(*get());
+        if (!configUpdate_(*config)) {
+            return;
         }
+
+        std::shared_ptr<ConfigurationSnapshot const> published = std::move(config);
+        snapshot_.store(published, std::memory_order_release);
+        configUpdated_(*published);
     }
 
-    // fully thread safe, have no idea where to use it
     // example usage: get(&ConfigurationSnapshot::debug_diagnostic_file);
-    template <typename Member> auto get(Member member) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return this->config_.*member;
+    template <typename Member> auto get(Member member) const {
+        return (*get()).*member;
     }
 
-    ConfigurationSnapshot const *operator->() const noexcept {
-        return &config_;
+    std::shared_ptr<ConfigurationSnapshot const> operator->() const {
+        return get();
     }
 
-    ConfigurationSnapshot const &get() {
-        return config_;
+    std::shared_ptr<ConfigurationSnapshot const> get() const {
+        return snapshot_.load(std::memory_order_acquire);
     }
 
     boost::signals2::connection addConfigUpdateWatcher(configUpdated_t::slot_function_type watcher) {
@@ -57,8 +71,9 @@ public:
     }
 
 private:
-    ConfigurationSnapshot config_;
+    std::atomic<std::shared_ptr<ConfigurationSnapshot const>> snapshot_;
     configUpdate_t configUpdate_;
+    getRevision_t getRevision_;
     configUpdated_t configUpdated_;
     std::mutex mutex_;
 };
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "ConfigurationSnapshot.h"
+#include "basic_macros.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <variant>
+
+namespace opentelemetry::php::config {
+
+// Compile time description of option stored in ConfigurationSnapshot. Names are views of static, null terminated strings
+struct OptionMetadata {
+    using member_t = std::variant<std::string ConfigurationSnapshot::*, bool ConfigurationSnapshot::*, std::chrono::milliseconds ConfigurationSnapshot::*, LogLevel ConfigurationSnapshot::*, std::size_t ConfigurationSnapshot::*>;
+
+    std::string_view name;
+    std::string_view iniName;
+    std::string_view envName;
+    member_t member;
+    bool secret = false;
+    bool otelNativeOption = false;
+};
+
+template <std::size_t N>
+struct OptionName {
+    constexpr OptionName(char const (&text)[N]) {
+        std::copy_n(text, N, name);
+    }
+    char name[N]{};
+};
+
+// INI and environment variable names of distro option, built by compiler. Same as utils::getIniName and utils::getEnvName
+template <OptionName option>
+struct OptionNames {
+    static constexpr std::string_view iniPrefix = "opentelemetry_distro.";
+    static constexpr std::string_view envPrefix = "OTEL_PHP_";
+
+    static constexpr auto ini = []() {
+        std::array<char, iniPrefix.size() + sizeof(option.name)> result{};
+        auto end = std::copy(iniPrefix.begin(), iniPrefix.end(), result.begin());
+        std::copy_n(option.name, sizeof(option.name), end);
+        return result;
+    }();
+
+    static constexpr auto env = []() {
+        std::array<char, envPrefix.size() + sizeof(option.name)> result{};
+        auto end = std::copy(envPrefix.begin(), envPrefix.end(), result.begin());
+        std::transform(option.name, option.name + sizeof(option.name), end, [](char c) { return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c; });
+        return result;
+    }();
+
+    static constexpr std::string_view iniName{ini.data(), ini.size() - 1};
+    static constexpr std::string_view envName{env.data(), env.size() - 1};
+};
+
+// Perfect hash of option names, seed is searched by compiler until every name gets its own slot
+template <std::size_t Count>
+class OptionIndex {
+public:
+    static constexpr std::size_t slotsCount = std::bit_ceil(Count * 16);
+    static constexpr uint16_t emptySlot = UINT16_MAX;
+    static_assert(Count < emptySlot);
+
+    constexpr OptionIndex(std::array<OptionMetadata, Count> const &options) {
+        while (!tryBuild(options)) {
+            seed_++;
+        }
+    }
+
+    // returns Count if there is no option with given name
+    constexpr std::size_t find(std::array<OptionMetadata, Count> const &options, std::string_view name) const {
+        auto index = slots_[hash(name, seed_) & (slotsCount - 1)];
+        if (index == emptySlot || options[index].name != name) {
+            return Count;
+        }
+        return index;
+    }
+
+private:
+    static constexpr uint64_t hash(std::string_view name, uint64_t seed) {
+        uint64_t result = 14695981039346656037ull ^ (seed * 0x9e3779b97f4a7c15ull);
+        for (char c : name) {
+            result ^= static_cast<unsigned char>(c);
+            result *= 1099511628211ull;
+        }
+        return result ^ (result >> 29);
+    }
+
+    constexpr bool tryBuild(std::array<OptionMetadata, Count> const &options) {
+        slots_.fill(emptySlot);
+        for (std::size_t index = 0; index < Count; ++index) {
+            auto &slot = slots_[hash(options[index].name, seed_) & (slotsCount - 1)];
+            if (slot != emptySlot) {
+                return false;
+            }
+            slot = static_cast<uint16_t>(index);
+        }
+        return true;
+    }
+
+    uint64_t seed_ = 0;
+    std::array<uint16_t, slotsCount> slots_{};
+};
+
+} // namespace opentelemetry::php::config
+
+#define BUILD_OTEL_PHP_OPTION_METADATA(optname, secret)                                                                                                                                                                                   \
+    opentelemetry::php::config::OptionMetadata {                                                                                                                                                                                          \
+        STRINGIFY_HELPER(optname), opentelemetry::php::config::OptionNames<STRINGIFY_HELPER(optname)>::iniName, opentelemetry::php::config::OptionNames<STRINGIFY_HELPER(optname)>::envName, &ConfigurationSnapshot::optname, secret, false \
+    }
+
+// otel native options are read by their own name from INI and environment
+#define BUILD_OPTION_METADATA(optname, secret)                                                                                       \
+    opentelemetry::php::config::OptionMetadata {                                                                                     \
+        STRINGIFY_HELPER(optname), STRINGIFY_HELPER(optname), STRINGIFY_HELPER(optname), &ConfigurationSnapshot::optname, secret, true \
+    }
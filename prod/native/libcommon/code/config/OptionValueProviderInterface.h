@@ -12,6 +12,8 @@ public:
     using configFiles_t = std::unordered_map<std::string, std::string>; // filename->content
 
     virtual ~OptionValueProviderInterface() = default;
+
+    // option names aren't guaranteed to be null terminated, providers forward views they got from callers
     virtual std::optional<std::string> getEnvironmentOptionValue(std::string_view name) = 0;
     virtual std::optional<std::string> getIniOptionValue(std::string_view name) = 0;
     virtual std::optional<std::string> getDynamicOptionValue(std::string_view name) = 0;
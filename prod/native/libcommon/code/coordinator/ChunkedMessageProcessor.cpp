@@ -1,76 +1,115 @@
 #include "ChunkedMessageProcessor.h"
 #include "os/OsUtils.h"
 
+#include <boost/container/small_vector.hpp>
+
 namespace opentelemetry::php::coordinator {
 
 bool ChunkedMessageProcessor::sendPayload(const std::string &payload) {
+    std::span<const std::byte> segment(reinterpret_cast<const std::byte *>(payload.data()), payload.size());
+    return sendPayload(payloadSegments_t(&segment, 1));
+}
+
+bool ChunkedMessageProcessor::sendPayload(payloadSegments_t segments) {
     msgId_++;
-    std::size_t dataPayloadSize = sizeof(CoordinatorPayload::payload);
+    std::size_t maxChunkSize = sharedDataQueue_->getMaxRecordSize() - sizeof(CoordinatorPayloadHeader);
 
-    CoordinatorPayload chunk;
-    chunk.senderProcessId = opentelemetry::osutils::getCurrentProcessId();
-    chunk.msgId = msgId_;
-    chunk.payloadTotalSize = payload.size();
-    chunk.payloadOffset = 0;
+    std::size_t totalSize = 0;
+    for (auto const &segment : segments) {
+        totalSize += segment.size();
+    }
 
-    while (chunk.payloadOffset < payload.size()) {
-        size_t chunkSize = std::min(dataPayloadSize, payload.size() - chunk.payloadOffset);
+    CoordinatorPayloadHeader header;
+    header.senderProcessId = opentelemetry::osutils::getCurrentProcessId();
+    header.msgId = msgId_;
+    header.payloadTotalSize = totalSize;
+    header.payloadOffset = 0;
 
-        ELOG_TRACE(logger_, COORDINATOR, "ChunkedMessageProcessor: sending chunked message. msgId: {}, offset: {}, size: {}, totalSize: {}, data size in chunk: {}", msgId_, chunk.payloadOffset, chunkSize, payload.size(), chunkSize + offsetof(CoordinatorPayload, payload));
+    auto segment = segments.begin();
+    std::size_t segmentOffset = 0;
+    boost::container::small_vector<std::span<const std::byte>, 4> recordSegments;
 
-        std::memcpy(chunk.payload.data(), payload.data() + chunk.payloadOffset, chunkSize);
+    while (header.payloadOffset < totalSize) {
+        size_t chunkSize = std::min(maxChunkSize, totalSize - header.payloadOffset);
+
+        ELOG_TRACE(logger_, COORDINATOR, "ChunkedMessageProcessor: sending message. msgId: {}, offset: {}, size: {}, totalSize: {}", msgId_, header.payloadOffset, chunkSize, totalSize);
+
+        recordSegments.clear();
+        recordSegments.emplace_back(reinterpret_cast<const std::byte *>(&header), sizeof(header));
+        for (std::size_t added = 0; added < chunkSize;) {
+            if (segmentOffset == segment->size()) {
+                ++segment;
+                segmentOffset = 0;
+                continue;
+            }
+            std::size_t size = std::min(chunkSize - added, segment->size() - segmentOffset);
+            recordSegments.emplace_back(segment->subspan(segmentOffset, size));
+            added += size;
+            segmentOffset += size;
+        }
 
-        if (!sharedDataQueue_->enqueueMessage(&chunk, chunkSize + offsetof(CoordinatorPayload, payload))) {
-            ELOG_WARNING(logger_, COORDINATOR, "ChunkedMessageProcessor: failed to send chunked message. msgId: {}, offset: {}", msgId_, chunk.payloadOffset);
+        if (!sharedDataQueue_->enqueueMessage({recordSegments.data(), recordSegments.size()})) {
+            ELOG_WARNING(logger_, COORDINATOR, "ChunkedMessageProcessor: failed to send message. msgId: {}, offset: {}, size: {}", msgId_, header.payloadOffset, chunkSize);
             return false;
         }
 
-        chunk.payloadOffset += chunkSize;
+        header.payloadOffset += chunkSize;
     }
     return true;
 }
 
-void ChunkedMessageProcessor::processReceivedChunk(const CoordinatorPayload *chunk, size_t chunkSize) {
-    ELOG_TRACE(logger_, COORDINATOR, "ChunkedMessageProcessor: received chunked message. pid: {}, msgId: {}, offset: {}, chunkSize: {}, totalSize: {}", chunk->senderProcessId, chunk->msgId, chunk->payloadOffset, chunkSize, chunk->payloadTotalSize);
+void ChunkedMessageProcessor::processReceivedChunk(std::span<const std::byte> record) {
+    if (record.size() < sizeof(CoordinatorPayloadHeader)) {
+        throw std::runtime_error(std::format("ChunkedMessageProcessor: received record of size {} is smaller than header", record.size()));
+    }
+
+    CoordinatorPayloadHeader chunk;
+    std::memcpy(&chunk, record.data(), sizeof(chunk));
+    std::span<const std::byte> chunkData = record.subspan(sizeof(chunk));
+
+    ELOG_TRACE(logger_, COORDINATOR, "ChunkedMessageProcessor: received message. pid: {}, msgId: {}, offset: {}, chunkSize: {}, totalSize: {}", chunk.senderProcessId, chunk.msgId, chunk.payloadOffset, chunkData.size(), chunk.payloadTotalSize);
+
+    // message sent in single record doesn't need reassembly
+    if (chunk.payloadOffset == 0 && chunkData.size() == chunk.payloadTotalSize) {
+        processMessage_(bufferPool_->copy(chunkData));
+        return;
+    }
+
     std::unique_lock<std::mutex> lock(mutex_);
 
-    auto &messagesForSender = recievedMessages_[chunk->senderProcessId];
-    auto it = messagesForSender.find(chunk->msgId);
+    auto &messagesForSender = recievedMessages_[chunk.senderProcessId];
+    auto it = messagesForSender.find(chunk.msgId);
     if (it == messagesForSender.end()) {
-        it = messagesForSender.emplace(chunk->msgId, ChunkedMessage(chunk->payloadTotalSize)).first;
+        it = messagesForSender.emplace(chunk.msgId, ChunkedMessage(chunk.payloadTotalSize, *bufferPool_)).first;
     }
 
     ChunkedMessage &message = it->second;
 
-    std::size_t payloadSize = chunkSize - offsetof(CoordinatorPayload, payload); // actual payload size in this chunk
-    std::span<const std::byte> chunkData(chunk->payload.data(), payloadSize);
-
     // Validate offset
-    if (message.getCurrentSize() != chunk->payloadOffset) {
-        throw std::runtime_error(std::format("ChunkedMessageProcessor: received chunk with unexpected offset: {}, expected: {}. pid: {}, msgId: {}", chunk->payloadOffset, message.getCurrentSize(), chunk->senderProcessId, chunk->msgId));
+    if (message.getCurrentSize() != chunk.payloadOffset) {
+        throw std::runtime_error(std::format("ChunkedMessageProcessor: received chunk with unexpected offset: {}, expected: {}. pid: {}, msgId: {}", chunk.payloadOffset, message.getCurrentSize(), chunk.senderProcessId, chunk.msgId));
     }
 
     // Validate offset + size does not exceed total size
-    if (chunk->payloadOffset + payloadSize > chunk->payloadTotalSize) {
-        throw std::runtime_error(std::format("ChunkedMessageProcessor: received chunk exceeds total payload size. Size: {}, offset: {},  expected: {}", payloadSize, chunk->payloadOffset, chunk->payloadTotalSize));
+    if (chunk.payloadOffset + chunkData.size() > chunk.payloadTotalSize) {
+        throw std::runtime_error(std::format("ChunkedMessageProcessor: received chunk exceeds total payload size. Size: {}, offset: {},  expected: {}", chunkData.size(), chunk.payloadOffset, chunk.payloadTotalSize));
     }
 
     if (message.addNextChunk(chunkData)) {
-        ELOG_TRACE(logger_, COORDINATOR, "ChunkedMessageProcessor: received chunked message. pid: {}, msgId: {}, offset: {}, receivedSize: {}, totalSize: {}. Message complete, processing.", chunk->senderProcessId, chunk->msgId, chunk->payloadOffset, message.getData().size(), chunk->payloadTotalSize);
+        ELOG_TRACE(logger_, COORDINATOR, "ChunkedMessageProcessor: received chunked message. pid: {}, msgId: {}, offset: {}, receivedSize: {}, totalSize: {}. Message complete, processing.", chunk.senderProcessId, chunk.msgId, chunk.payloadOffset, message.getCurrentSize(), chunk.payloadTotalSize);
 
-        std::vector<std::byte> data;
-        message.swapData(data);
+        auto data = message.releaseData();
 
         messagesForSender.erase(it);
         if (messagesForSender.empty()) {
-            recievedMessages_.erase(chunk->senderProcessId);
+            recievedMessages_.erase(chunk.senderProcessId);
         }
 
         lock.unlock();
-        processMessage_(data);
+        processMessage_(std::move(data));
 
     } else {
-        ELOG_TRACE(logger_, COORDINATOR, "ChunkedMessageProcessor: received chunked message. msgId: {}, offset: {}, receivedSize: {}, totalSize: {}", chunk->msgId, chunk->payloadOffset, message.getData().size(), chunk->payloadTotalSize);
+        ELOG_TRACE(logger_, COORDINATOR, "ChunkedMessageProcessor: received chunked message. msgId: {}, offset: {}, receivedSize: {}, totalSize: {}", chunk.msgId, chunk.payloadOffset, message.getCurrentSize(), chunk.payloadTotalSize);
     }
 }
 
@@ -95,13 +134,38 @@ void ChunkedMessageProcessor::cleanupAbandonedMessages(std::chrono::steady_clock
     }
 }
 
-bool ChunkedMessageProcessor::tryReceiveMessage(char *buffer, size_t bufferSize) {
-    size_t receivedSize = 0;
-    if (sharedDataQueue_->tryReceiveMessage(buffer, bufferSize, receivedSize)) {
-        processReceivedChunk(reinterpret_cast<const CoordinatorPayload *>(buffer), receivedSize);
-        return true;
+void ChunkedMessageProcessor::releaseSender(pid_t senderProcessId) {
+    auto position = sharedDataQueue_->getReservedPosition();
+    std::lock_guard<std::mutex> lock(mutex_);
+    releasedSenders_[senderProcessId] = position;
+}
+
+std::size_t ChunkedMessageProcessor::dropReleasedSenders() {
+    auto consumedPosition = sharedDataQueue_->getConsumedPosition();
+    std::size_t dropped = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto senderIt = releasedSenders_.begin(); senderIt != releasedSenders_.end();) {
+        if (senderIt->second > consumedPosition) {
+            ++senderIt;
+            continue;
+        }
+
+        if (auto messagesForSender = recievedMessages_.find(senderIt->first); messagesForSender != recievedMessages_.end()) {
+            ELOG_DEBUG(logger_, COORDINATOR, "ChunkedMessageProcessor: dropping {} partially received messages of exited sender pid {}", messagesForSender->second.size(), senderIt->first);
+            dropped += messagesForSender->second.size();
+            recievedMessages_.erase(messagesForSender);
+        }
+        senderIt = releasedSenders_.erase(senderIt);
     }
-    return false;
+    return dropped;
+}
+
+bool ChunkedMessageProcessor::tryReceiveMessage(std::chrono::milliseconds maxWait) {
+    return sharedDataQueue_->tryReceiveMessage([this](std::span<const std::byte> record) { processReceivedChunk(record); }, maxWait);
+}
+
+std::size_t ChunkedMessageProcessor::receiveMessages(std::chrono::milliseconds maxWait) {
+    return sharedDataQueue_->receiveMessages([this](std::span<const std::byte> record) { processReceivedChunk(record); }, maxWait);
 }
 
 } // namespace opentelemetry::php::coordinator
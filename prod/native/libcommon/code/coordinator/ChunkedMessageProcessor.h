@@ -1,12 +1,14 @@
 #pragma once
 
 #include "LoggerInterface.h"
+#include "transport/PayloadBuffer.h"
 
 #include <chrono>
 #include <cstring>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <unordered_map>
 #include <stdexcept>
 #include <vector>
@@ -15,29 +17,36 @@
 
 namespace opentelemetry::php::coordinator {
 
+// prepended to every queue record. Message which doesn't fit into single record is split into chunks reassembled by coordinator
+struct CoordinatorPayloadHeader {
+    pid_t senderProcessId;
+    uint64_t msgId;
+    std::size_t payloadTotalSize;
+    std::size_t payloadOffset;
+};
+
+// message is assembled directly in pooled buffer which is later handed over to transport without copying
 class ChunkedMessage {
 public:
-    ChunkedMessage(std::size_t totalSize) : totalSize_(totalSize) {
-        data_.reserve(totalSize_);
+    ChunkedMessage(std::size_t totalSize, transport::PayloadBufferPool &pool) : totalSize_(totalSize), data_(pool.allocate(totalSize)) {
     }
 
     // return true if message is complete
     bool addNextChunk(const std::span<const std::byte> chunkData) {
-        if (data_.size() + chunkData.size_bytes() > totalSize_) {
+        if (currentSize_ + chunkData.size_bytes() > totalSize_) {
             throw std::runtime_error("ChunkedMessage: chunk exceeds total size");
         }
 
-        data_.insert(data_.end(), chunkData.begin(), chunkData.end());
+        if (!chunkData.empty()) {
+            std::memcpy(data_.data() + currentSize_, chunkData.data(), chunkData.size_bytes());
+        }
+        currentSize_ += chunkData.size_bytes();
         lastUpdated_ = std::chrono::steady_clock::now();
-        return data_.size() == totalSize_;
+        return currentSize_ == totalSize_;
     }
 
-    const std::vector<std::byte> &getData() const {
-        return data_;
-    }
-
-    void swapData(std::vector<std::byte> &second) {
-        data_.swap(second);
+    transport::PayloadBuffer releaseData() {
+        return std::move(data_).freeze();
     }
 
     const std::chrono::steady_clock::time_point &getLastUpdated() const {
@@ -49,19 +58,20 @@ public:
     }
 
     size_t getCurrentSize() const {
-        return data_.size();
+        return currentSize_;
     }
 
 private:
     std::size_t totalSize_;
-    std::vector<std::byte> data_;
+    std::size_t currentSize_ = 0;
+    transport::WritablePayloadBuffer data_;
     std::chrono::steady_clock::time_point lastUpdated_;
 };
 
 class ChunkedMessageProcessor {
 public:
-    using sendBuffer_t = std::function<bool(const void *, size_t)>;
-    using processMessage_t = std::function<void(const std::span<const std::byte>)>;
+    using processMessage_t = std::function<void(transport::PayloadBuffer)>;
+    using payloadSegments_t = std::span<const std::span<const std::byte>>;
 
     using msgId_t = uint64_t;
 
@@ -69,20 +79,42 @@ public:
     }
 
     bool sendPayload(const std::string &payload);
-    void processReceivedChunk(const CoordinatorPayload *chunk, size_t chunkSize);
+    // sends segments as one message, e.g. command header followed by payload, without joining them into intermediate buffer.
+    // Segments are copied straight into shared queue, message is chunked only if it exceeds queue max record size
+    bool sendPayload(payloadSegments_t segments);
+    // record consists of CoordinatorPayloadHeader followed by chunk data
+    void processReceivedChunk(std::span<const std::byte> record);
     void cleanupAbandonedMessages(std::chrono::steady_clock::time_point now, std::chrono::milliseconds maxAge);
 
-    bool tryReceiveMessage(char *buffer, size_t bufferSize);
+    // marks sender as exited. Its last chunks may still wait in queue, so partially received messages are dropped only after queue is consumed up to position it had now
+    void releaseSender(pid_t senderProcessId);
+    // drops partially received messages of released senders whose records were all consumed, returns number of dropped messages
+    std::size_t dropReleasedSenders();
 
-private:
-    bool sendBuffer(const void *data, size_t size);
+    bool tryReceiveMessage(std::chrono::milliseconds maxWait);
+    // drains all records available after wakeup, returns number of processed records
+    std::size_t receiveMessages(std::chrono::milliseconds maxWait);
+
+    void interruptReceive() {
+        sharedDataQueue_->notifyConsumer();
+    }
+
+    CoordinatorSharedDataQueue::Statistics getQueueStatistics() const {
+        return sharedDataQueue_->getStatistics();
+    }
+
+    uint32_t getQueueFillPercent() const {
+        return sharedDataQueue_->getUsedBytes() * 100 / sharedDataQueue_->getCapacity();
+    }
 
 protected:
     std::mutex mutex_;
     std::shared_ptr<LoggerInterface> logger_;
     std::shared_ptr<CoordinatorSharedDataQueue> sharedDataQueue_;
     processMessage_t processMessage_;
+    std::shared_ptr<transport::PayloadBufferPool> bufferPool_ = std::make_shared<transport::PayloadBufferPool>();
     std::unordered_map<pid_t, std::unordered_map<msgId_t, ChunkedMessage>> recievedMessages_;
+    std::unordered_map<pid_t, uint64_t> releasedSenders_; // queue position which has to be consumed before messages of exited sender are dropped
     msgId_t msgId_ = 0; // it is not protected by mutex, because it is only used for sending messages and sending is single-threaded in current implementation
 };
 
@@ -2,8 +2,12 @@
 
 #include "LoggerInterface.h"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 
 #include <boost/interprocess/anonymous_shared_memory.hpp>
@@ -28,14 +32,22 @@ public:
     using configFiles_t = std::unordered_map<std::string, std::string>; // filename->content
     using configUpdated_t = boost::signals2::signal<void(configFiles_t const &)>;
 
+    // Config files are stored with revision in which they changed, revision of whole configuration is atomic and polled by workers without taking the lock.
+    // Worker copies only files changed since revision it has seen, storing files with unchanged content doesn't change revision
     struct SharedData {
         using SegmentManager = boost::interprocess::managed_external_buffer::segment_manager;
         using ShmemString = boost::container::basic_string<char, std::char_traits<char>, boost::interprocess::allocator<char, SegmentManager>>;
-        using ShmemAllocator = boost::interprocess::allocator<std::pair<const ShmemString, ShmemString>, SegmentManager>;
-        using ConfigFilesMap = boost::container::map<ShmemString, ShmemString, std::less<ShmemString>, ShmemAllocator>;
+        struct ConfigFile {
+            ShmemString content;
+            uint64_t revision;
+        };
+        using ShmemAllocator = boost::interprocess::allocator<std::pair<const ShmemString, ConfigFile>, SegmentManager>;
+        using ConfigFilesMap = boost::container::map<ShmemString, ConfigFile, std::less<ShmemString>, ShmemAllocator>;
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "revision must be lock free to be shared between processes");
 
         boost::interprocess::interprocess_upgradable_mutex mutex;
-        uint64_t configRevision;
+        std::atomic<uint64_t> configRevision;
         ConfigFilesMap configFiles;
         SharedData(const ShmemAllocator &alloc) : configFiles(std::less<ShmemString>(), alloc) {
             configRevision = 1;
@@ -52,19 +64,32 @@ public:
     ~CoordinatorConfigurationProvider() {
     }
 
+    // called on every request, takes the lock only when revision changed
     bool triggerUpdateIfChanged() {
-        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorConfigurationProvider: checking for config updates");
-        boost::interprocess::sharable_lock<boost::interprocess::interprocess_upgradable_mutex> lock(sharedData_->mutex);
-        if (sharedData_->configRevision != localConfigRevision_) {
-            localConfigRevision_ = sharedData_->configRevision;
-            configFiles_t configFiles = getConfigurationNoLock();
-            ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorConfigurationProvider: detected config update to revision {}, notifying {} watchers. Config files: {}", localConfigRevision_, configUpdatedWatchers_.num_slots(), configFiles.size());
+        if (sharedData_->configRevision.load(std::memory_order_acquire) == localConfigRevision_) {
+            return false;
+        }
 
-            configUpdatedWatchers_(configFiles);
+        std::size_t changedFiles = 0;
+        {
+            boost::interprocess::sharable_lock<boost::interprocess::interprocess_upgradable_mutex> lock(sharedData_->mutex);
+            auto revision = sharedData_->configRevision.load(std::memory_order_relaxed);
+            for (auto const &[fileName, file] : sharedData_->configFiles) {
+                if (file.revision > localConfigRevision_) {
+                    localConfigFiles_.insert_or_assign(std::string(fileName.data(), fileName.size()), std::string(file.content.data(), file.content.size()));
+                    changedFiles++;
+                }
+            }
+            localConfigRevision_ = revision;
+        }
 
-            return true;
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorConfigurationProvider: detected config update to revision {}, changed files: {}, notifying {} watchers. Config files: {}", localConfigRevision_, changedFiles, configUpdatedWatchers_.num_slots(), localConfigFiles_.size());
+        if (changedFiles == 0) {
+            return false;
         }
-        return false;
+
+        configUpdatedWatchers_(localConfigFiles_);
+        return true;
     }
 
     boost::signals2::connection addConfigUpdateWatcher(configUpdated_t::slot_function_type watcher) {
@@ -84,37 +109,47 @@ public:
 
     std::unordered_map<std::string, std::string> getConfiguration() {
         boost::interprocess::sharable_lock<boost::interprocess::interprocess_upgradable_mutex> lock(sharedData_->mutex);
-        return getConfigurationNoLock();
+        std::unordered_map<std::string, std::string> result;
+        for (auto const &[fileName, file] : sharedData_->configFiles) {
+            result.emplace(std::string(fileName.data(), fileName.size()), std::string(file.content.data(), file.content.size()));
+        }
+        return result;
     }
 
     // stores config files on coordinator process side
     void storeConfigFiles(std::unordered_map<std::string, std::string> const &configFiles) {
         boost::interprocess::scoped_lock<boost::interprocess::interprocess_upgradable_mutex> lock(sharedData_->mutex);
-        sharedData_->configRevision++;
+        auto revision = sharedData_->configRevision.load(std::memory_order_relaxed) + 1;
+        std::size_t changedFiles = 0;
+        SharedData::ShmemAllocator alloc = managedRegion_.get_segment_manager();
         for (const auto &pair : configFiles) {
-            SharedData::ShmemAllocator alloc = managedRegion_.get_segment_manager();
             SharedData::ShmemString shmemFileName(std::string_view(pair.first), alloc);
-            SharedData::ShmemString shmemFileContent(std::string_view(pair.second), alloc);
-            sharedData_->configFiles.insert_or_assign(std::move(shmemFileName), std::move(shmemFileContent));
+            auto file = sharedData_->configFiles.find(shmemFileName);
+            if (file == sharedData_->configFiles.end()) {
+                sharedData_->configFiles.emplace(std::move(shmemFileName), SharedData::ConfigFile{SharedData::ShmemString(std::string_view(pair.second), alloc), revision});
+            } else if (std::string_view(file->second.content.data(), file->second.content.size()) != pair.second) {
+                file->second.content.assign(pair.second.data(), pair.second.size());
+                file->second.revision = revision;
+            } else {
+                continue;
+            }
+            changedFiles++;
         }
-        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorConfigurationProvider: stored {} config files, revision: {}", configFiles.size(), sharedData_->configRevision);
-    }
 
-private:
-    std::unordered_map<std::string, std::string> getConfigurationNoLock() {
-        std::unordered_map<std::string, std::string> result;
-        for (const auto &pair : sharedData_->configFiles) {
-            result.emplace(std::string(pair.first.c_str()), std::string(pair.second.c_str()));
+        if (changedFiles > 0) {
+            sharedData_->configRevision.store(revision, std::memory_order_release);
         }
-        return result;
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorConfigurationProvider: stored {} config files, changed: {}, revision: {}", configFiles.size(), changedFiles, sharedData_->configRevision.load(std::memory_order_relaxed));
     }
 
+private:
     std::shared_ptr<LoggerInterface> logger_;
 
     boost::interprocess::mapped_region region_;
     boost::interprocess::managed_external_buffer managedRegion_;
     SharedData *sharedData_{nullptr};
     uint64_t localConfigRevision_ = 0;
+    configFiles_t localConfigFiles_; // worker copy of files up to localConfigRevision_
     configUpdated_t configUpdatedWatchers_;
 
 };
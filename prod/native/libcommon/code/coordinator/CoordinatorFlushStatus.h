@@ -0,0 +1,70 @@
+#pragma once
+
+#include "LoggerInterface.h"
+#include "SharedMemoryFutex.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include <boost/interprocess/anonymous_shared_memory.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace opentelemetry::php::coordinator {
+
+// Acknowledgements of flush requests sent by workers to coordinator. Shared memory is created before coordinator is forked, so it is visible to coordinator and all workers.
+// Worker takes request id, sends FLUSH_ENDPOINT command and waits until coordinator marks request completed. Each request id has its slot, slots are reused after slotsCount requests,
+// so worker which waited too long may miss its acknowledgement and time out. Table is lock free and waiters sleep on futex, so process which dies at any point leaves nothing locked
+class CoordinatorFlushStatus : public boost::noncopyable {
+public:
+    static constexpr std::size_t slotsCount = 256;
+
+    struct SharedData {
+        std::atomic<uint64_t> lastRequestId = 0;
+        std::atomic<uint32_t> completedSequence = 0; // futex word, changed with every acknowledgement
+        std::array<std::atomic<uint64_t>, slotsCount> completedRequests{}; // id of last completed request of slot
+    };
+
+    CoordinatorFlushStatus(std::shared_ptr<LoggerInterface> logger) : logger_(std::move(logger)), region_(boost::interprocess::anonymous_shared_memory(sizeof(SharedData))) {
+        sharedData_ = new (region_.get_address()) SharedData();
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorFlushStatus initialized with shared memory region of size {}", region_.get_size());
+    }
+
+    uint64_t beginRequest() {
+        return sharedData_->lastRequestId.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // called by coordinator
+    void markCompleted(uint64_t requestId) {
+        sharedData_->completedRequests[requestId % slotsCount].store(requestId, std::memory_order_release);
+        sharedData_->completedSequence.fetch_add(1, std::memory_order_release);
+        futexWakeAll(&sharedData_->completedSequence);
+    }
+
+    bool waitForCompletion(uint64_t requestId, std::chrono::milliseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            // sequence is read before slot, so acknowledgement stored after the check changes it and futex doesn't sleep
+            auto sequence = sharedData_->completedSequence.load(std::memory_order_acquire);
+            if (sharedData_->completedRequests[requestId % slotsCount].load(std::memory_order_acquire) == requestId) {
+                return true;
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                return false;
+            }
+            futexWait(&sharedData_->completedSequence, sequence, deadline - now);
+        }
+    }
+
+private:
+    std::shared_ptr<LoggerInterface> logger_;
+    boost::interprocess::mapped_region region_;
+    SharedData *sharedData_{nullptr};
+};
+
+} // namespace opentelemetry::php::coordinator
@@ -1,10 +1,17 @@
 #include "CoordinatorMessagesDispatcher.h"
 #include "LoggerInterface.h"
+#include "SendEndpointPayloadCodec.h"
 #include "coordinator/proto/CoordinatorCommands.pb.h"
 
 namespace opentelemetry::php::coordinator {
 
-void CoordinatorMessagesDispatcher::processRecievedMessage(const std::span<const std::byte> data) {
+void CoordinatorMessagesDispatcher::processRecievedMessage(transport::PayloadBuffer data) {
+    // payload frames are checked before protobuf parsing, received buffer is handed over to transport without copying
+    if (auto payload = SendEndpointPayloadCodec::decode(data); payload.has_value()) {
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorMessagesDispatcher: SendEndpointPayload: hash={} payload_size={}", payload->endpointHash, payload->payload.size());
+        enqueuePayload(payload->endpointHash, std::move(payload->payload));
+        return;
+    }
 
     coordinator::CoordinatorCommand command;
     if (!command.ParseFromArray(data.data(), data.size())) {
@@ -31,14 +38,19 @@ void CoordinatorMessagesDispatcher::processRecievedMessage(const std::span<const
                 sslOptions.certKeyPassword = sslOpts.cert_key_password();
             }
 
-            ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorMessagesDispatcher: EstablishConnection: url='{}' hash={} content_type='{}' headers={} timeout_ms={} max_retries={} retry_delay_ms={} SSL options[insecure_skip_verify={}, ca_info='{}', cert='{}', cert_key='{}', cert_key_password='{}']", c.endpoint_url(), c.endpoint_hash(), c.content_type(), c.endpoint_headers_size(), c.timeout_ms(), c.max_retries(), c.retry_delay_ms(), sslOptions.insecureSkipVerify, sslOptions.caInfo, sslOptions.cert, sslOptions.certKey, sslOptions.certKeyPassword.empty() ? "" : "<redacted>");
+            ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorMessagesDispatcher: EstablishConnection: url='{}' hash={} content_type='{}' headers={} timeout_ms={} max_retries={} retry_delay_ms={} compression='{}' SSL options[insecure_skip_verify={}, ca_info='{}', cert='{}', cert_key='{}', cert_key_password='{}']", c.endpoint_url(), c.endpoint_hash(), c.content_type(), c.endpoint_headers_size(), c.timeout_ms(), c.max_retries(), c.retry_delay_ms(), c.compression(), sslOptions.insecureSkipVerify, sslOptions.caInfo, sslOptions.cert, sslOptions.certKey, sslOptions.certKeyPassword.empty() ? "" : "<redacted>");
 
             std::vector<std::pair<std::string_view, std::string_view>> headers;
             for (const auto &h : c.endpoint_headers()) {
                 headers.emplace_back(h.first, h.second);
             }
 
-            httpTransport_->initializeConnection(c.endpoint_url(), c.endpoint_hash(), c.content_type(), headers, std::chrono::milliseconds(c.timeout_ms()), c.max_retries(), std::chrono::milliseconds(c.retry_delay_ms()), sslOptions);
+            auto compression = opentelemetry::php::transport::parsePayloadCompression(c.compression());
+            if (!compression.has_value()) {
+                ELOG_WARNING(logger_, COORDINATOR, "CoordinatorMessagesDispatcher: EstablishConnection: unknown compression '{}', sending uncompressed", c.compression());
+            }
+
+            httpTransport_->initializeConnection(c.endpoint_url(), c.endpoint_hash(), c.content_type(), headers, std::chrono::milliseconds(c.timeout_ms()), c.max_retries(), std::chrono::milliseconds(c.retry_delay_ms()), sslOptions, compression.value_or(opentelemetry::php::transport::PayloadCompression::none));
 
             break;
         }
@@ -48,17 +60,25 @@ void CoordinatorMessagesDispatcher::processRecievedMessage(const std::span<const
                 ELOG_ERROR(logger_, COORDINATOR, "CoordinatorMessagesDispatcher: Missing send_endpoint_payload");
                 return;
             }
-            const auto &p = command.send_endpoint_payload();
+            auto *p = command.mutable_send_endpoint_payload();
             ELOG_DEBUG(logger_, COORDINATOR,
                        "CoordinatorMessagesDispatcher: SendEndpointPayload: hash={} payload_size={}",
-                       p.endpoint_hash(),
-                       p.payload().size());
+                       p->endpoint_hash(),
+                       p->payload().size());
 
+            enqueuePayload(p->endpoint_hash(), transport::PayloadBuffer::adopt(std::move(*p->mutable_payload())));
+            break;
+        }
+        case coordinator::CoordinatorCommand::SEND_ENDPOINT_ARENA_PAYLOAD: {
+            auto const &p = command.send_endpoint_arena_payload();
+            ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorMessagesDispatcher: SendEndpointArenaPayload: hash={} offset={} payload_size={}", p.endpoint_hash(), p.offset(), p.size());
 
-            const std::string &raw = p.payload();
-            std::span<std::byte> buf(reinterpret_cast<std::byte *>(const_cast<char *>(raw.data())), raw.size());
-
-            httpTransport_->enqueue(p.endpoint_hash(), buf);
+            auto payload = payloadArena_ ? payloadArena_->adopt({p.offset(), p.size()}) : std::nullopt;
+            if (!payload.has_value()) {
+                ELOG_ERROR(logger_, COORDINATOR, "CoordinatorMessagesDispatcher: SendEndpointArenaPayload: invalid payload descriptor, offset={} payload_size={}", p.offset(), p.size());
+                return;
+            }
+            enqueuePayload(p.endpoint_hash(), std::move(*payload));
             break;
         }
         case coordinator::CoordinatorCommand::WORKER_STARTED: {
@@ -71,6 +91,15 @@ void CoordinatorMessagesDispatcher::processRecievedMessage(const std::span<const
             workerRegistry_->unregisterWorker(command.worker_is_going_to_shutdown().process_id());
             break;
         }
+        case coordinator::CoordinatorCommand::FLUSH_ENDPOINT: {
+            ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorMessagesDispatcher: FlushEndpoint: hash={} request_id={}", command.flush_endpoint().endpoint_hash(), command.flush_endpoint().request_id());
+            if (processingPool_) {
+                processingPool_->submitBarrier([flushEndpoint = flushEndpoint_, endpointHash = command.flush_endpoint().endpoint_hash(), requestId = command.flush_endpoint().request_id()]() { flushEndpoint(endpointHash, requestId); });
+            } else {
+                flushEndpoint_(command.flush_endpoint().endpoint_hash(), command.flush_endpoint().request_id());
+            }
+            break;
+        }
 
         default:
             ELOG_WARNING(logger_, COORDINATOR, "CoordinatorMessagesDispatcher: Unknown CoordinatorCommand type={}", static_cast<int>(command.type()));
@@ -79,4 +108,14 @@ void CoordinatorMessagesDispatcher::processRecievedMessage(const std::span<const
 
 }
 
-} // namespace opentelemetry::php
\ No newline at end of file
+// connection setup and worker registration stay on coordinator loop, so payloads submitted later find their endpoint initialized.
+// Payloads of one endpoint are processed by the same pool thread, so they reach transport in order they were received
+void CoordinatorMessagesDispatcher::enqueuePayload(std::size_t endpointHash, transport::PayloadBuffer payload) {
+    if (!processingPool_) {
+        httpTransport_->enqueue(endpointHash, std::move(payload));
+        return;
+    }
+    processingPool_->submit(endpointHash, [httpTransport = httpTransport_, endpointHash, payload = std::move(payload)]() mutable { httpTransport->enqueue(endpointHash, std::move(payload)); });
+}
+
+} // namespace opentelemetry::php
@@ -2,10 +2,13 @@
 
 
 
+#include "CoordinatorPayloadArena.h"
+#include "CoordinatorProcessingPool.h"
 #include "LoggerInterface.h"
 #include "transport/HttpTransportAsyncInterface.h"
 #include "WorkerRegistry.h"
 
+#include <functional>
 #include <memory>
 #include <span>
 
@@ -15,17 +18,26 @@ namespace opentelemetry::php::coordinator {
 
 class CoordinatorMessagesDispatcher {
 public:
-    CoordinatorMessagesDispatcher(std::shared_ptr<LoggerInterface> logger, std::shared_ptr<transport::HttpTransportAsyncInterface> httpTransport, std::shared_ptr<WorkerRegistry> workerRegistry) : logger_(std::move(logger)), httpTransport_(std::move(httpTransport)), workerRegistry_(std::move(workerRegistry)) {
+    // starts flush of endpoint, request has to be acknowledged once payloads enqueued so far are flushed. Must not block, commands of other workers are waiting
+    using flushEndpoint_t = std::function<void(std::size_t endpointHash, uint64_t requestId)>;
+
+    // payloads are passed to transport by processingPool threads if it is available. Flush starts once payloads received before it are passed to transport
+    CoordinatorMessagesDispatcher(std::shared_ptr<LoggerInterface> logger, std::shared_ptr<transport::HttpTransportAsyncInterface> httpTransport, std::shared_ptr<WorkerRegistry> workerRegistry, std::shared_ptr<CoordinatorPayloadArena> payloadArena, flushEndpoint_t flushEndpoint, std::shared_ptr<CoordinatorProcessingPool> processingPool = nullptr) : logger_(std::move(logger)), httpTransport_(std::move(httpTransport)), workerRegistry_(std::move(workerRegistry)), payloadArena_(std::move(payloadArena)), flushEndpoint_(std::move(flushEndpoint)), processingPool_(std::move(processingPool)) {
     }
 
     ~CoordinatorMessagesDispatcher() = default;
 
-    void processRecievedMessage(const std::span<const std::byte> data);
+    void processRecievedMessage(transport::PayloadBuffer data);
 
 private:
+    void enqueuePayload(std::size_t endpointHash, transport::PayloadBuffer payload);
+
     std::shared_ptr<LoggerInterface> logger_;
     std::shared_ptr<transport::HttpTransportAsyncInterface> httpTransport_;
     std::shared_ptr<WorkerRegistry> workerRegistry_;
+    std::shared_ptr<CoordinatorPayloadArena> payloadArena_;
+    flushEndpoint_t flushEndpoint_;
+    std::shared_ptr<CoordinatorProcessingPool> processingPool_;
 };
 
 }
\ No newline at end of file
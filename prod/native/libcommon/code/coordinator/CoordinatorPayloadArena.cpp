@@ -0,0 +1,172 @@
+#include "CoordinatorPayloadArena.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <new>
+#include <boost/interprocess/anonymous_shared_memory.hpp>
+#include <signal.h>
+#include <unistd.h>
+
+namespace opentelemetry::php::coordinator {
+
+namespace {
+std::size_t getOwnersSize(std::size_t slabsCount) {
+    return (slabsCount * sizeof(std::atomic<uint32_t>) + 63) & ~std::size_t(63);
+}
+} // namespace
+
+CoordinatorPayloadArena::CoordinatorPayloadArena(std::shared_ptr<LoggerInterface> logger, std::size_t capacity) : logger_(std::move(logger)), slabsCount_(std::max<std::size_t>(capacity / slabSize, 1)), region_(boost::interprocess::anonymous_shared_memory(sizeof(SharedHeader) + getOwnersSize(slabsCount_) + slabsCount_ * slabSize)) {
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "slab owners have to be lock free to be shared between processes");
+
+    auto *address = static_cast<std::byte *>(region_.get_address());
+    header_ = new (address) SharedHeader{};
+    slabOwners_ = reinterpret_cast<std::atomic<uint32_t> *>(address + sizeof(SharedHeader));
+    for (std::size_t slab = 0; slab < slabsCount_; ++slab) {
+        new (slabOwners_ + slab) std::atomic<uint32_t>(slabFree);
+    }
+    data_ = address + sizeof(SharedHeader) + getOwnersSize(slabsCount_);
+
+    if (logger_) {
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorPayloadArena initialized with {} slabs of size {}", slabsCount_, slabSize);
+    }
+}
+
+std::optional<CoordinatorPayloadArena::Allocation> CoordinatorPayloadArena::allocate(std::size_t size) {
+    auto count = getSlabsCount(size);
+    if (count == 0 || count > slabsCount_) {
+        return std::nullopt;
+    }
+
+    auto owner = static_cast<uint32_t>(::getpid());
+    std::size_t start = header_->nextSlab.load(std::memory_order_relaxed) % slabsCount_;
+    for (std::size_t scanned = 0; scanned < slabsCount_;) {
+        if (start + count > slabsCount_) {
+            scanned += slabsCount_ - start;
+            start = 0;
+            continue;
+        }
+
+        std::size_t acquired = 0;
+        for (; acquired < count; ++acquired) {
+            uint32_t expected = slabFree;
+            if (!slabOwners_[start + acquired].compare_exchange_strong(expected, owner, std::memory_order_acquire, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        if (acquired == count) {
+            header_->nextSlab.store(static_cast<uint32_t>((start + count) % slabsCount_), std::memory_order_relaxed);
+            return Allocation{start * slabSize, size};
+        }
+
+        // run is interrupted by slab owned by someone else, continue after it
+        for (std::size_t slab = 0; slab < acquired; ++slab) {
+            slabOwners_[start + slab].store(slabFree, std::memory_order_release);
+        }
+        scanned += acquired + 1;
+        start = (start + acquired + 1) % slabsCount_;
+    }
+    return std::nullopt;
+}
+
+void CoordinatorPayloadArena::handOver(Allocation const &allocation) {
+    auto first = allocation.offset / slabSize;
+    for (std::size_t slab = first; slab < first + getSlabsCount(allocation.size); ++slab) {
+        slabOwners_[slab].store(slabHandedOver, std::memory_order_release);
+    }
+}
+
+void CoordinatorPayloadArena::release(Allocation const &allocation) {
+    auto first = allocation.offset / slabSize;
+    for (std::size_t slab = first; slab < first + getSlabsCount(allocation.size); ++slab) {
+        slabOwners_[slab].store(slabFree, std::memory_order_release);
+    }
+}
+
+std::optional<transport::PayloadBuffer> CoordinatorPayloadArena::adopt(Allocation const &allocation) {
+    if (allocation.size == 0 || allocation.offset % slabSize != 0 || allocation.offset > getCapacity() || allocation.size > getCapacity() - allocation.offset) {
+        return std::nullopt;
+    }
+
+    auto first = allocation.offset / slabSize;
+    auto last = first + getSlabsCount(allocation.size);
+    auto adopted = slabAdopted | generation_;
+    for (std::size_t slab = first; slab < last; ++slab) {
+        auto expected = slabHandedOver;
+        if (!slabOwners_[slab].compare_exchange_strong(expected, adopted, std::memory_order_acquire, std::memory_order_relaxed)) {
+            // descriptor overlaps slabs it doesn't own, e.g. it was already adopted
+            for (std::size_t adoptedSlab = first; adoptedSlab < slab; ++adoptedSlab) {
+                slabOwners_[adoptedSlab].store(slabHandedOver, std::memory_order_relaxed);
+            }
+            return std::nullopt;
+        }
+    }
+
+    std::shared_ptr<std::byte const> data(data_ + allocation.offset, [arena = shared_from_this(), allocation](std::byte const *) { arena->release(allocation); });
+    return transport::PayloadBuffer(std::move(data), allocation.size);
+}
+
+std::size_t CoordinatorPayloadArena::beginCoordinatorGeneration() {
+    auto generation = header_->coordinatorGeneration.load(std::memory_order_relaxed);
+    do {
+        generation_ = generation % maxGeneration + 1;
+    } while (!header_->coordinatorGeneration.compare_exchange_weak(generation, generation_, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    std::size_t reclaimed = 0;
+    for (std::size_t slab = 0; slab < slabsCount_; ++slab) {
+        auto owner = slabOwners_[slab].load(std::memory_order_relaxed);
+        if ((owner & slabAdopted) && owner != slabHandedOver && owner != (slabAdopted | generation_) && slabOwners_[slab].compare_exchange_strong(owner, slabFree, std::memory_order_release, std::memory_order_relaxed)) {
+            reclaimed++;
+        }
+    }
+
+    if (reclaimed > 0 && logger_) {
+        ELOG_WARNING(logger_, COORDINATOR, "CoordinatorPayloadArena: coordinator generation {} reclaimed {} slabs adopted by previous coordinator", generation_, reclaimed);
+    }
+    return reclaimed;
+}
+
+std::size_t CoordinatorPayloadArena::reclaimAbandoned() {
+    std::size_t reclaimed = 0;
+    for (std::size_t slab = 0; slab < slabsCount_; ++slab) {
+        auto owner = slabOwners_[slab].load(std::memory_order_relaxed);
+        if (!isWorkerOwner(owner)) {
+            continue;
+        }
+        if (::kill(static_cast<pid_t>(owner), 0) != 0 && errno == ESRCH && slabOwners_[slab].compare_exchange_strong(owner, slabFree, std::memory_order_release, std::memory_order_relaxed)) {
+            reclaimed++;
+        }
+    }
+
+    if (reclaimed > 0 && logger_) {
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorPayloadArena: reclaimed {} slabs abandoned by exited workers", reclaimed);
+    }
+    return reclaimed;
+}
+
+std::size_t CoordinatorPayloadArena::reclaimAbandoned(pid_t processId) {
+    std::size_t reclaimed = 0;
+    for (std::size_t slab = 0; slab < slabsCount_; ++slab) {
+        auto owner = static_cast<uint32_t>(processId);
+        if (slabOwners_[slab].load(std::memory_order_relaxed) == owner && slabOwners_[slab].compare_exchange_strong(owner, slabFree, std::memory_order_release, std::memory_order_relaxed)) {
+            reclaimed++;
+        }
+    }
+
+    if (reclaimed > 0 && logger_) {
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorPayloadArena: reclaimed {} slabs abandoned by worker {}", reclaimed, processId);
+    }
+    return reclaimed;
+}
+
+std::size_t CoordinatorPayloadArena::getUsedSlabsCount() const {
+    std::size_t used = 0;
+    for (std::size_t slab = 0; slab < slabsCount_; ++slab) {
+        if (slabOwners_[slab].load(std::memory_order_relaxed) != slabFree) {
+            used++;
+        }
+    }
+    return used;
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "LoggerInterface.h"
+#include "transport/PayloadBuffer.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/noncopyable.hpp>
+#include <sys/types.h>
+
+namespace opentelemetry::php::coordinator {
+
+// Slab arena in anonymous shared memory, created before coordinator is forked. Worker copies payload into contiguous run of slabs and sends only
+// descriptor (endpoint hash, offset, size) to coordinator, which posts payload straight from shared memory and releases slabs once transport drops it.
+// Every slab has its owner: free, pid of worker which is filling it, handed over to coordinator or adopted by coordinator of given generation.
+// Slabs of worker which died before handing them over are reclaimed by coordinator. Restarted coordinator starts new generation and reclaims slabs adopted by its dead predecessor,
+// slabs only handed over are still referenced by descriptors waiting in queue
+class CoordinatorPayloadArena : public boost::noncopyable, public std::enable_shared_from_this<CoordinatorPayloadArena> {
+public:
+    static constexpr std::size_t slabSize = 16 * 1024;
+    // smaller payloads are cheaper to copy into queue record than to allocate slab for them
+    static constexpr std::size_t minPayloadSize = 4 * 1024;
+
+    struct Allocation {
+        std::size_t offset = 0;
+        std::size_t size = 0;
+    };
+
+    // capacity is rounded down to slab size. Arena must be created by std::make_shared. throws boost::interprocess::interprocess_exception if shared memory can't be created
+    CoordinatorPayloadArena(std::shared_ptr<LoggerInterface> logger, std::size_t capacity);
+
+    // called by worker. Returns std::nullopt if there is no contiguous run of free slabs large enough
+    std::optional<Allocation> allocate(std::size_t size);
+
+    std::span<std::byte> getData(Allocation const &allocation) {
+        return {data_ + allocation.offset, allocation.size};
+    }
+
+    // called by worker once payload is written, before descriptor is sent. From now on slabs are released only by coordinator
+    void handOver(Allocation const &allocation);
+
+    // returns slabs to arena
+    void release(Allocation const &allocation);
+
+    // called by coordinator. Marks handed over slabs as adopted by current generation and returns buffer viewing them which releases them when its last copy is destroyed.
+    // Returns std::nullopt if descriptor doesn't point to handed over allocation
+    std::optional<transport::PayloadBuffer> adopt(Allocation const &allocation);
+
+    // called by coordinator when it starts. Releases slabs adopted by previous coordinators, which died with their buffers, returns number of released slabs
+    std::size_t beginCoordinatorGeneration();
+
+    // called by coordinator. Releases slabs of workers which died before handing them over, returns number of released slabs
+    std::size_t reclaimAbandoned();
+
+    // called by coordinator once worker exit is observed. Releases slabs which worker didn't hand over, returns number of released slabs
+    std::size_t reclaimAbandoned(pid_t processId);
+
+    std::size_t getCapacity() const {
+        return slabsCount_ * slabSize;
+    }
+
+    std::size_t getUsedSlabsCount() const;
+
+protected:
+    static constexpr uint32_t slabFree = 0;
+    static constexpr uint32_t slabHandedOver = UINT32_MAX;
+    // adopted slab stores generation of coordinator in lower bits, pids never reach this bit
+    static constexpr uint32_t slabAdopted = 0x80000000;
+    static constexpr uint32_t maxGeneration = slabHandedOver - slabAdopted - 1;
+
+    struct SharedHeader {
+        alignas(64) std::atomic<uint32_t> nextSlab; // where next allocation starts looking for free slabs
+        std::atomic<uint32_t> coordinatorGeneration;
+    };
+
+    static bool isWorkerOwner(uint32_t owner) {
+        return owner != slabFree && owner < slabAdopted;
+    }
+
+    std::size_t getSlabsCount(std::size_t size) const {
+        return (size + slabSize - 1) / slabSize;
+    }
+
+    std::shared_ptr<LoggerInterface> logger_;
+    std::size_t slabsCount_;
+    boost::interprocess::mapped_region region_;
+    SharedHeader *header_ = nullptr;
+    std::atomic<uint32_t> *slabOwners_ = nullptr;
+    std::byte *data_ = nullptr;
+    uint32_t generation_ = 0; // generation of coordinator running in this process
+};
+
+} // namespace opentelemetry::php::coordinator
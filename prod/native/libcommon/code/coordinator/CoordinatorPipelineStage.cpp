@@ -0,0 +1,44 @@
+#include "CoordinatorPipelineStage.h"
+#include "transport/OtlpEndpoint.h"
+
+namespace opentelemetry::php::coordinator {
+
+void CoordinatorPipelineStage::initializeConnection(std::string endpointUrl, std::size_t endpointHash, std::string contentType, enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, transport::HttpEndpointSSLOptions sslOptions, transport::PayloadCompression compression) {
+    auto signal = transport::getEndpointSignal(endpointUrl);
+    {
+        std::lock_guard<std::mutex> lock(endpointsMutex_);
+        handledEndpoints_[endpointHash] = signal == handledSignal_ && transport::isOtlpProtobufEndpoint(signal, contentType);
+    }
+    next_->initializeConnection(std::move(endpointUrl), endpointHash, std::move(contentType), endpointHeaders, timeout, maxRetries, retryDelay, std::move(sslOptions), compression);
+}
+
+void CoordinatorPipelineStage::enqueue(std::size_t endpointHash, transport::PayloadBuffer payload, responseCallback_t callback) {
+    // payloads awaiting response are sent as they are, response belongs to request built by sender
+    if (callback || !isHandledEndpoint(endpointHash)) {
+        next_->enqueue(endpointHash, std::move(payload), std::move(callback));
+        return;
+    }
+    processPayload(endpointHash, std::move(payload));
+}
+
+void CoordinatorPipelineStage::processTimers(time_point_t now) {
+    onTimer(now);
+    if (auto nextStage = getNextStage(); nextStage) {
+        nextStage->processTimers(now);
+    }
+}
+
+void CoordinatorPipelineStage::flushPipeline() {
+    onFlush();
+    if (auto nextStage = getNextStage(); nextStage) {
+        nextStage->flushPipeline();
+    }
+}
+
+bool CoordinatorPipelineStage::isHandledEndpoint(std::size_t endpointHash) {
+    std::lock_guard<std::mutex> lock(endpointsMutex_);
+    auto found = handledEndpoints_.find(endpointHash);
+    return found != handledEndpoints_.end() && found->second;
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "LoggerInterface.h"
+#include "transport/HttpTransportAsyncInterface.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace opentelemetry::php::coordinator {
+
+// Stage of coordinator pipeline placed between CoordinatorMessagesDispatcher and transport. Stage forwards everything to next stage or transport,
+// derived stage gets payloads of OTLP protobuf endpoints of signal it handles and decides what is passed on. Stages are chained, timers and flush are propagated down the chain.
+// Stage is called concurrently from coordinator processing threads and from coordinator periodic task, so derived stages have to synchronize their state
+class CoordinatorPipelineStage : public transport::HttpTransportAsyncInterface {
+public:
+    using time_point_t = std::chrono::steady_clock::time_point;
+
+    CoordinatorPipelineStage(std::shared_ptr<LoggerInterface> logger, std::shared_ptr<transport::HttpTransportAsyncInterface> next, std::string_view handledSignal) : logger_(std::move(logger)), next_(std::move(next)), handledSignal_(handledSignal) {
+    }
+
+    void initializeConnection(std::string endpointUrl, std::size_t endpointHash, std::string contentType, enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, transport::HttpEndpointSSLOptions sslOptions, transport::PayloadCompression compression) override;
+    void enqueue(std::size_t endpointHash, transport::PayloadBuffer payload, responseCallback_t callback = {}) override;
+
+    void updateRetryDelay(size_t endpointHash, std::chrono::milliseconds retryDelay) override {
+        next_->updateRetryDelay(endpointHash, retryDelay);
+    }
+
+    // covers only payloads already passed to transport - what stages hold leaves on their timers, so flush requests don't cut sampling and aggregation windows short
+    bool flush(std::size_t endpointHash, std::chrono::milliseconds timeout) override {
+        return next_->flush(endpointHash, timeout);
+    }
+
+    // called periodically by coordinator
+    void processTimers(time_point_t now);
+
+    // passes everything held by this and following stages to transport, called when coordinator exits
+    void flushPipeline();
+
+protected:
+    // payload of endpoint of handled signal, sent without response callback. Payload may be borrowed
+    virtual void processPayload(std::size_t endpointHash, transport::PayloadBuffer payload) = 0;
+    virtual void onTimer([[maybe_unused]] time_point_t now) {
+    }
+    virtual void onFlush() {
+    }
+
+    bool isHandledEndpoint(std::size_t endpointHash);
+
+    std::shared_ptr<LoggerInterface> logger_;
+    std::shared_ptr<transport::HttpTransportAsyncInterface> next_;
+
+private:
+    CoordinatorPipelineStage *getNextStage() const {
+        return dynamic_cast<CoordinatorPipelineStage *>(next_.get());
+    }
+
+    std::string_view handledSignal_;
+    std::mutex endpointsMutex_;
+    std::unordered_map<std::size_t, bool> handledEndpoints_;
+};
+
+} // namespace opentelemetry::php::coordinator
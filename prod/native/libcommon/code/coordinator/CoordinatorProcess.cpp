@@ -1,6 +1,9 @@
 #include "CoordinatorProcess.h"
 #include "CoordinatorMessagesDispatcher.h"
 #include "WorkerRegistry.h"
+#include "MetricAggregationStage.h"
+#include "SpanMetricsStage.h"
+#include "TailSamplingStage.h"
 
 #include "ConfigurationManager.h"
 #include "ConfigurationStorage.h"
@@ -9,7 +12,6 @@
 #include "ResourceDetector.h"
 #include "coordinator/WorkerRegistry.h"
 #include "transport/OpAmp.h"
-#include "transport/HttpTransportAsync.h"
 #include "VendorCustomizationsInterface.h"
 #include <exception>
 
@@ -25,6 +27,9 @@ CoordinatorProcess::CoordinatorProcess(
         std::shared_ptr<config::OptionValueProviderInterface> defaultOptionValueProvider,
         std::shared_ptr<CoordinatorSharedDataQueue> sharedDataQueue,
         std::shared_ptr<CoordinatorConfigurationProvider> configProvider,
+        std::shared_ptr<CoordinatorFlushStatus> flushStatus,
+        std::shared_ptr<CoordinatorPayloadArena> payloadArena,
+        std::shared_ptr<CoordinatorStatusPage> statusPage,
         std::shared_ptr<opentelemetry::php::ResourceDetector> resourceDetector) :
             processId_(processId),
             parentProcessId_(parentProcessId),
@@ -32,7 +37,7 @@ CoordinatorProcess::CoordinatorProcess(
             configManager_(std::make_shared<ConfigurationManager>(logger_, std::make_shared<config::PrioritizedOptionValueProviderChain>(std::initializer_list<std::pair<int, std::shared_ptr<config::OptionValueProviderInterface>>>{
                 {0, defaultOptionValueProvider}, vendorCustomizations_ ? vendorCustomizations_->getOptionValueProvider() : std::pair<int, std::shared_ptr<opentelemetry::php::config::OptionValueProviderInterface>>{0, nullptr} // create dummy pair if vendor customizations or its option provider is not available, to avoid checks in PrioritizedOptionValueProviderChain
             }))),
-            config_(std::make_shared<opentelemetry::php::ConfigurationStorage>([this](ConfigurationSnapshot &cfg) { return configManager_->updateIfChanged(cfg); })),
+            config_(std::make_shared<opentelemetry::php::ConfigurationStorage>([this](ConfigurationSnapshot &cfg) { return configManager_->updateIfChanged(cfg); }, [this]() { return configManager_->getRevision(); })),
             workerRegistry_(std::make_shared<WorkerRegistry>(logger_)),
             httpTransport_(std::make_shared<transport::HttpTransportAsync<>>(logger_, config_)),
             opAmp_(std::make_shared<opentelemetry::php::transport::OpAmp>(logger_, config_, httpTransport_, [&]() {
@@ -41,8 +46,16 @@ CoordinatorProcess::CoordinatorProcess(
                 }
                 return std::move(resourceDetector);
             }())),
-            messagesDispatcher_(std::make_shared<CoordinatorMessagesDispatcher>(logger_, httpTransport_, workerRegistry_)),
-            processor_{logger_, sharedDataQueue, [this](const std::span<const std::byte> data) { messagesDispatcher_->processRecievedMessage(data); }},
+            flushStatus_(std::move(flushStatus)),
+            payloadArena_(std::move(payloadArena)),
+            statusPage_(std::move(statusPage)),
+            // span metrics are derived from all spans, before traces are sampled
+            pipeline_(std::make_shared<SpanMetricsStage>(logger_, config_, std::make_shared<TailSamplingStage>(logger_, config_, std::make_shared<MetricAggregationStage>(logger_, config_, httpTransport_)))),
+            processingPool_(std::make_shared<CoordinatorProcessingPool>(logger_)),
+            messagesDispatcher_(std::make_shared<CoordinatorMessagesDispatcher>(logger_, pipeline_, workerRegistry_, payloadArena_, [this](std::size_t endpointHash, uint64_t requestId) {
+                httpTransport_->flushAsync(endpointHash, [flushStatus = flushStatus_, requestId]() { flushStatus->markCompleted(requestId); });
+            }, processingPool_)),
+            processor_{logger_, sharedDataQueue, [this](transport::PayloadBuffer data) { messagesDispatcher_->processRecievedMessage(std::move(data)); }},
             configProvider_(std::move(configProvider)) {
 
         if (vendorCustomizations_) {
@@ -62,6 +75,10 @@ CoordinatorProcess::CoordinatorProcess(
 
         configManager_->update();
         config_->update();
+
+        if (payloadArena_) {
+            payloadArena_->beginCoordinatorGeneration();
+        }
     }
 // clang-format on
 
@@ -73,48 +90,68 @@ CoordinatorProcess::~CoordinatorProcess() {
 
 void CoordinatorProcess::prefork() {
     periodicTaskExecutor_->prefork();
+    processingPool_->prefork();
     opAmp_->prefork();
-    static_cast<transport::HttpTransportAsync<> *>(httpTransport_.get())->prefork();
+    httpTransport_->prefork();
 }
 
 void CoordinatorProcess::postfork([[maybe_unused]] bool child) {
     periodicTaskExecutor_->postfork(child);
+    processingPool_->postfork(child);
     opAmp_->postfork(child);
-    static_cast<transport::HttpTransportAsync<> *>(httpTransport_.get())->postfork(child);
+    httpTransport_->postfork(child);
 }
 
 void CoordinatorProcess::coordinatorLoop() {
     opAmp_->startCommunication();
     setupPeriodicTasks();
     periodicTaskExecutor_->resumePeriodicTasks();
+    processingPool_->start(CoordinatorProcessingPool::getThreadsCount(config_->get()->coordinator_processing_threads));
 
-    char buffer[CoordinatorSharedDataQueue::maxMqPayloadSize];
     while (working_.load()) {
         try {
-            processor_.tryReceiveMessage(buffer, CoordinatorSharedDataQueue::maxMqPayloadSize);
+            // producers wake us up, timeout only bounds reaction to stop request and records abandoned by dead workers
+            processor_.receiveMessages(std::chrono::seconds(1));
         } catch (std::exception const &ex) {
             ELOG_WARNING(logger_, COORDINATOR, "CoordinatorProcess: exception in coordinator loop: '{}'", ex.what());
         }
     }
+    processingPool_->stop();
+    pipeline_->flushPipeline();
     ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorProcess coordinator loop exiting");
 }
 
 void CoordinatorProcess::setupPeriodicTasks() {
     periodicTaskExecutor_ = std::make_unique<PeriodicTaskExecutor>(std::vector<PeriodicTaskExecutor::task_t>{[this, registry = workerRegistry_](PeriodicTaskExecutor::time_point_t now) {
+        releaseExitedWorkers(registry->collectExitedWorkers());
+        processor_.dropReleasedSenders();
+
         // Check parent process is alive
         if (getppid() != parentProcessId_) {
             ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorProcess: parent process has exited. Checking if workers are still alive.");
-            registry->verifyWorkersAlive();
+            releaseExitedWorkers(registry->verifyWorkersAlive());
             if (registry->getWorkerCount() > 0) {
                 ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorProcess: there are still {} alive workers, continuing work", registry->getWorkerCount());
             } else {
                 working_ = false;
+                processor_.interruptReceive();
             }
         }
 
+        pipeline_->processTimers(now);
+        publishStatus();
+
         static auto lastCleanupTime = std::chrono::steady_clock::now();
         if (now - lastCleanupTime >= cleanUpLostMessagesInterval) {
+            // exits of workers which aren't watched through pidfd and of senders which never registered are found here
+            releaseExitedWorkers(registry->verifyWorkersAlive());
             processor_.cleanupAbandonedMessages(now, std::chrono::seconds(10));
+            if (payloadArena_) {
+                payloadArena_->reclaimAbandoned();
+            }
+
+            auto queueStatistics = processor_.getQueueStatistics();
+            ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorProcess: queue wakeups: {}, records: {}, max records per wakeup: {}, high-water mark: {} bytes", queueStatistics.wakeups, queueStatistics.records, queueStatistics.maxRecordsPerWakeup, queueStatistics.highWaterMark);
             lastCleanupTime = now;
 
             ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorProcess: there are still {} alive workers, continuing work", registry->getWorkerCount());
@@ -123,4 +160,37 @@ void CoordinatorProcess::setupPeriodicTasks() {
     periodicTaskExecutor_->setInterval(std::chrono::milliseconds(100));
 }
 
+void CoordinatorProcess::releaseExitedWorkers(std::vector<pid_t> const &processIds) {
+    for (auto processId : processIds) {
+        processor_.releaseSender(processId);
+        if (payloadArena_) {
+            payloadArena_->reclaimAbandoned(processId);
+        }
+    }
+}
+
+void CoordinatorProcess::publishStatus() {
+    if (!statusPage_) {
+        return;
+    }
+
+    auto statistics = httpTransport_->getStatistics();
+    auto workerSendFailures = statusPage_->read().workerSendFailures;
+    bool droppedSinceLastStatus = statistics.droppedPayloads != lastDroppedPayloads_ || workerSendFailures != lastWorkerSendFailures_;
+    lastDroppedPayloads_ = statistics.droppedPayloads;
+    lastWorkerSendFailures_ = workerSendFailures;
+
+    CoordinatorStatusPage::Status status;
+    status.updatedAtUnixMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    status.queueFillPercent = processor_.getQueueFillPercent();
+    status.transportFillPercent = statistics.queueLimit > 0 ? std::min<uint64_t>(statistics.queuedBytes * 100 / statistics.queueLimit, 100) : 0;
+    status.level = CoordinatorStatusPage::getLevel(status.queueFillPercent, status.transportFillPercent, droppedSinceLastStatus);
+    status.transportQueuedBytes = statistics.queuedBytes;
+    status.droppedPayloads = statistics.droppedPayloads;
+    status.droppedBytes = statistics.droppedBytes;
+    status.exportedPayloads = statistics.exportedPayloads;
+    status.exportLatencyMs = statistics.exportLatency.count();
+    statusPage_->publish(status);
+}
+
 } // namespace opentelemetry::php::coordinator
@@ -6,14 +6,20 @@
 #include "PeriodicTaskExecutor.h"
 #include "ChunkedMessageProcessor.h"
 #include "CoordinatorConfigurationProvider.h"
+#include "CoordinatorFlushStatus.h"
+#include "CoordinatorPayloadArena.h"
+#include "CoordinatorPipelineStage.h"
+#include "CoordinatorProcessingPool.h"
+#include "CoordinatorStatusPage.h"
 #include "VendorCustomizationsInterface.h"
-#include "transport/HttpTransportAsyncInterface.h"
+#include "transport/HttpTransportAsync.h"
 
 #include <boost/noncopyable.hpp>
 
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <vector>
 
 namespace opentelemetry::php {
 class ConfigurationManager;
@@ -51,6 +57,9 @@ public:
                         std::shared_ptr<config::OptionValueProviderInterface> defaultOptionValueProvider,
                         std::shared_ptr<CoordinatorSharedDataQueue> sharedDataQueue,
                         std::shared_ptr<CoordinatorConfigurationProvider> configProvider,
+                        std::shared_ptr<CoordinatorFlushStatus> flushStatus,
+                        std::shared_ptr<CoordinatorPayloadArena> payloadArena,
+                        std::shared_ptr<CoordinatorStatusPage> statusPage,
                         std::shared_ptr<opentelemetry::php::ResourceDetector> resourceDetector);
     // clang-format on
     ~CoordinatorProcess();
@@ -65,6 +74,9 @@ public:
 private:
     void coordinatorLoop();
     void setupPeriodicTasks();
+    // frees partially received messages and arena slabs of exited workers
+    void releaseExitedWorkers(std::vector<pid_t> const &processIds);
+    void publishStatus();
 
 private:
     std::atomic_bool working_ = true;
@@ -76,9 +88,16 @@ private:
     std::shared_ptr<ConfigurationStorage> config_;
     std::shared_ptr<WorkerRegistry> workerRegistry_;
 
-    std::shared_ptr<transport::HttpTransportAsyncInterface> httpTransport_;
+    std::shared_ptr<transport::HttpTransportAsync<>> httpTransport_;
     std::shared_ptr<transport::OpAmp> opAmp_;
-
+    std::shared_ptr<CoordinatorFlushStatus> flushStatus_;
+    std::shared_ptr<CoordinatorPayloadArena> payloadArena_;
+    std::shared_ptr<CoordinatorStatusPage> statusPage_;
+    uint64_t lastDroppedPayloads_ = 0;
+    uint64_t lastWorkerSendFailures_ = 0;
+    std::shared_ptr<CoordinatorPipelineStage> pipeline_; // first stage, telemetry of workers passes all stages before it reaches transport
+
+    std::shared_ptr<CoordinatorProcessingPool> processingPool_; // passes payloads through pipeline, coordinator loop only receives them
     std::shared_ptr<CoordinatorMessagesDispatcher> messagesDispatcher_;
     ChunkedMessageProcessor processor_;
 
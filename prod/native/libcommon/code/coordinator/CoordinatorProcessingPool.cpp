@@ -0,0 +1,170 @@
+#include "CoordinatorProcessingPool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace opentelemetry::php::coordinator {
+
+CoordinatorProcessingPool::CoordinatorProcessingPool(std::shared_ptr<LoggerInterface> logger, std::size_t ringCapacity) : logger_(std::move(logger)), ringCapacity_(std::max(ringCapacity, static_cast<std::size_t>(2))) {
+}
+
+CoordinatorProcessingPool::~CoordinatorProcessingPool() {
+    stop();
+}
+
+std::size_t CoordinatorProcessingPool::getThreadsCount(std::size_t configuredThreadsCount) {
+    if (configuredThreadsCount > 0) {
+        return std::min(configuredThreadsCount, maxThreadsCount);
+    }
+    std::size_t cores = std::thread::hardware_concurrency();
+    return std::clamp(cores > 2 ? cores - 2 : static_cast<std::size_t>(1), static_cast<std::size_t>(1), maxThreadsCount);
+}
+
+void CoordinatorProcessingPool::start(std::size_t threadsCount) {
+    stop();
+    threadsCount_ = threadsCount;
+    for (std::size_t i = 0; i < threadsCount; ++i) {
+        rings_.emplace_back(std::make_unique<Ring>(ringCapacity_));
+    }
+    for (auto &ring : rings_) {
+        ring->thread = std::thread([this, ring = ring.get()]() { work(*ring); });
+    }
+    ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorProcessingPool: started {} threads, ring capacity {}", threadsCount, ringCapacity_);
+}
+
+void CoordinatorProcessingPool::stop() {
+    if (rings_.empty()) {
+        return;
+    }
+    // stop task is processed after tasks submitted before
+    for (auto &ring : rings_) {
+        push(*ring, {});
+    }
+    for (auto &ring : rings_) {
+        if (ring->thread.joinable()) {
+            ring->thread.join();
+        }
+    }
+    rings_.clear();
+    nextRing_ = 0;
+    ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorProcessingPool: stopped");
+}
+
+void CoordinatorProcessingPool::submit(task_t task) {
+    if (rings_.empty()) {
+        task();
+        return;
+    }
+
+    for (;;) {
+        for (std::size_t i = 0; i < rings_.size(); ++i) {
+            auto &ring = *rings_[(nextRing_ + i) % rings_.size()];
+            if (tryPush(ring, task)) {
+                nextRing_ = (nextRing_ + i + 1) % rings_.size();
+                return;
+            }
+        }
+
+        // all rings are full, wait until thread of next ring takes a task
+        waitForSpace(*rings_[nextRing_]);
+    }
+}
+
+void CoordinatorProcessingPool::submit(std::size_t key, task_t task) {
+    if (rings_.empty()) {
+        task();
+        return;
+    }
+
+    auto &ring = *rings_[key % rings_.size()];
+    while (!tryPush(ring, task)) {
+        waitForSpace(ring);
+    }
+}
+
+void CoordinatorProcessingPool::waitForSpace(Ring &ring) {
+    auto head = ring.head.load(std::memory_order_acquire);
+    if (ring.tail.load(std::memory_order_relaxed) - head >= ringCapacity_) {
+        ring.head.wait(head, std::memory_order_acquire);
+    }
+}
+
+void CoordinatorProcessingPool::submitBarrier(task_t callback) {
+    if (rings_.empty()) {
+        callback();
+        return;
+    }
+
+    struct Barrier {
+        std::atomic<std::size_t> remaining;
+        task_t callback;
+    };
+    auto barrier = std::make_shared<Barrier>(rings_.size(), std::move(callback));
+
+    // every thread reaches barrier after tasks submitted to its ring before, the last one runs callback
+    for (auto &ring : rings_) {
+        push(*ring, [barrier]() {
+            if (barrier->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                barrier->callback();
+            }
+        });
+    }
+}
+
+bool CoordinatorProcessingPool::tryPush(Ring &ring, task_t &task) {
+    auto tail = ring.tail.load(std::memory_order_relaxed);
+    if (tail - ring.head.load(std::memory_order_acquire) >= ringCapacity_) {
+        return false;
+    }
+    ring.slots[tail % ringCapacity_] = std::move(task);
+    ring.tail.store(tail + 1, std::memory_order_release);
+    ring.tail.notify_one();
+    return true;
+}
+
+void CoordinatorProcessingPool::push(Ring &ring, task_t task) {
+    while (!tryPush(ring, task)) {
+        auto head = ring.head.load(std::memory_order_acquire);
+        if (ring.tail.load(std::memory_order_relaxed) - head >= ringCapacity_) {
+            ring.head.wait(head, std::memory_order_acquire);
+        }
+    }
+}
+
+void CoordinatorProcessingPool::work(Ring &ring) {
+    for (;;) {
+        auto head = ring.head.load(std::memory_order_relaxed);
+        auto tail = ring.tail.load(std::memory_order_acquire);
+        if (head == tail) {
+            ring.tail.wait(tail, std::memory_order_acquire);
+            continue;
+        }
+
+        auto task = std::move(ring.slots[head % ringCapacity_]);
+        ring.slots[head % ringCapacity_] = nullptr;
+        ring.head.store(head + 1, std::memory_order_release);
+        ring.head.notify_one();
+
+        if (!task) {
+            return;
+        }
+
+        try {
+            task();
+        } catch (std::exception const &ex) {
+            ELOG_WARNING(logger_, COORDINATOR, "CoordinatorProcessingPool: exception while processing task: '{}'", ex.what());
+        }
+    }
+}
+
+void CoordinatorProcessingPool::prefork() {
+    stop();
+}
+
+void CoordinatorProcessingPool::postfork([[maybe_unused]] bool child) {
+    if (threadsCount_ > 0) {
+        start(threadsCount_);
+    }
+}
+
+} // namespace opentelemetry::php::coordinator
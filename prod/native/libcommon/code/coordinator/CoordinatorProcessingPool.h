@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ForkableInterface.h"
+#include "LoggerInterface.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+namespace opentelemetry::php::coordinator {
+
+// Threads decoding and transforming payloads received by coordinator loop, between receiver (coordinator loop) and sender (transport thread).
+// Each thread has its own bounded lock-free single-producer/single-consumer ring of tasks, producer is always the coordinator loop. Tasks are spread round robin,
+// producer waits only when all rings are full, which leaves records in shared memory queue and lets workers see backpressure.
+// Tasks of different rings run in any order, tasks submitted with the same key go to the same ring and keep their order.
+// Barrier task runs once all tasks submitted before it are processed. Until pool is started tasks run inline
+class CoordinatorProcessingPool : public boost::noncopyable, public ForkableInterface {
+public:
+    using task_t = std::function<void()>;
+
+    static constexpr std::size_t defaultRingCapacity = 1024;
+    static constexpr std::size_t maxThreadsCount = 16;
+
+    CoordinatorProcessingPool(std::shared_ptr<LoggerInterface> logger, std::size_t ringCapacity = defaultRingCapacity);
+    ~CoordinatorProcessingPool();
+
+    // one thread per core left by coordinator loop and sender thread, at least one
+    static std::size_t getThreadsCount(std::size_t configuredThreadsCount);
+
+    // starts threadsCount threads, 0 keeps processing inline
+    void start(std::size_t threadsCount);
+
+    // processes all submitted tasks and joins threads
+    void stop();
+
+    // called by coordinator loop only
+    void submit(task_t task);
+
+    // tasks of the same key, e.g. payloads of one endpoint, are processed one by one in submission order
+    void submit(std::size_t key, task_t task);
+
+    // callback runs on one of pool threads once all tasks submitted before it are processed. Producer doesn't wait for it
+    void submitBarrier(task_t callback);
+
+    std::size_t getStartedThreadsCount() const {
+        return rings_.size();
+    }
+
+    void prefork() final;
+    void postfork([[maybe_unused]] bool child) final;
+
+private:
+    struct Ring {
+        Ring(std::size_t capacity) : slots(capacity) {
+        }
+
+        alignas(64) std::atomic<uint64_t> head = 0; // next task to process, advanced by pool thread
+        alignas(64) std::atomic<uint64_t> tail = 0; // next free slot, advanced by producer
+        std::vector<task_t> slots; // empty task stops thread
+        std::thread thread;
+    };
+
+    bool tryPush(Ring &ring, task_t &task);
+    void push(Ring &ring, task_t task);
+    // blocks producer until pool thread takes a task from full ring
+    void waitForSpace(Ring &ring);
+    void work(Ring &ring);
+
+    std::shared_ptr<LoggerInterface> logger_;
+    std::size_t ringCapacity_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+    std::size_t nextRing_ = 0;
+    std::size_t threadsCount_ = 0; // started again after fork
+};
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,295 @@
+#include "CoordinatorSharedDataQueue.h"
+#include "SharedMemoryFutex.h"
+#include "os/OsUtils.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <boost/interprocess/anonymous_shared_memory.hpp>
+#include <signal.h>
+#include <unistd.h>
+
+namespace opentelemetry::php::coordinator {
+
+namespace {
+constexpr std::size_t sharedHeaderSize = 192; // keeps head, tail and futex word in separate cache lines before records
+
+std::size_t alignCapacity(std::size_t capacity) {
+    return std::max(capacity, CoordinatorSharedDataQueue::minCapacity) & ~(CoordinatorSharedDataQueue::recordAlignment - 1);
+}
+
+void updateMax(std::atomic<uint64_t> &max, uint64_t value) {
+    auto current = max.load(std::memory_order_relaxed);
+    while (current < value && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+} // namespace
+
+CoordinatorSharedDataQueue::CoordinatorSharedDataQueue(std::shared_ptr<LoggerInterface> logger, std::size_t capacity) : logger_(std::move(logger)), capacity_(alignCapacity(capacity)), region_(boost::interprocess::anonymous_shared_memory(sharedHeaderSize + capacity_)) {
+    static_assert(sizeof(SharedHeader) <= sharedHeaderSize);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free, "ring positions have to be lock free to be shared between processes");
+
+    header_ = new (region_.get_address()) SharedHeader{};
+    data_ = static_cast<std::byte *>(region_.get_address()) + sharedHeaderSize;
+    // pages are mapped before workers are forked, so producer never faults between reservation and record header
+    std::memset(data_, 0, capacity_);
+    if (logger_) {
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorSharedDataQueue initialized with shared memory ring of size {}, max record size {}", capacity_, getMaxRecordSize());
+    }
+}
+
+bool CoordinatorSharedDataQueue::enqueueMessage(recordSegments_t segments) {
+    std::size_t length = 0;
+    for (auto const &segment : segments) {
+        length += segment.size();
+    }
+    if (length > getMaxRecordSize()) {
+        if (logger_) {
+            ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorSharedDataQueue: record of size {} exceeds max record size {}", length, getMaxRecordSize());
+        }
+        return false;
+    }
+
+    auto recordSize = getRecordSize(length);
+    uint64_t tail = header_->tail.load(std::memory_order_acquire);
+    uint64_t head = 0;
+    std::size_t padding = 0;
+    for (;;) {
+        head = header_->head.load(std::memory_order_acquire);
+        if (head > tail) {
+            // consumer passed tail we loaded before, it is stale anyway
+            tail = header_->tail.load(std::memory_order_acquire);
+            continue;
+        }
+        auto offset = tail % capacity_;
+        padding = offset + recordSize > capacity_ ? capacity_ - offset : 0;
+        if (tail + padding + recordSize - head > capacity_) {
+            if (logger_) {
+                ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorSharedDataQueue: no space for record of size {}, used {} of {} bytes", length, tail - head, capacity_);
+            }
+            return false;
+        }
+        if (header_->tail.compare_exchange_weak(tail, tail + padding + recordSize, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            break;
+        }
+    }
+    updateMax(header_->highWaterMark, tail + padding + recordSize - head);
+
+    // writer identity is published together with state, so consumer can always tell whether reserved record is abandoned
+    auto identity = getCurrentProcessIdentity();
+    auto processId = static_cast<pid_t>(identity >> 32);
+    auto startTime = static_cast<uint32_t>(identity);
+    if (padding > 0) {
+        auto paddingHeader = getRecordHeader(tail);
+        paddingHeader->writerProcessId = processId;
+        paddingHeader->writerStartTime = startTime;
+        paddingHeader->state.store(makeRecordState(tail, padding - sizeof(RecordHeader), statePadding), std::memory_order_release);
+    }
+
+    auto position = tail + padding;
+    auto record = getRecordHeader(position);
+    record->writerProcessId = processId;
+    record->writerStartTime = startTime;
+    record->state.store(makeRecordState(position, length, stateReserved), std::memory_order_release);
+
+    auto *data = reinterpret_cast<std::byte *>(record + 1);
+    for (auto const &segment : segments) {
+        if (!segment.empty()) {
+            std::memcpy(data, segment.data(), segment.size());
+            data += segment.size();
+        }
+    }
+
+    record->state.store(makeRecordState(position, length, stateCommitted), std::memory_order_release);
+
+    // pairs with fence in waitForRecord - either consumer sees committed record or we see it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header_->consumerWaiting.load(std::memory_order_relaxed)) {
+        wakeUpConsumer();
+    }
+    return true;
+}
+
+uint64_t CoordinatorSharedDataQueue::getCurrentProcessIdentity() {
+    // workers are forked from process which may already have cached its own identity
+    static std::atomic<uint64_t> identity = 0;
+    auto processId = osutils::getCurrentProcessId();
+    auto current = identity.load(std::memory_order_relaxed);
+    if (static_cast<pid_t>(current >> 32) != processId) {
+        current = getProcessIdentity(processId, static_cast<uint32_t>(osutils::getProcessStartTime(processId).value_or(0)));
+        identity.store(current, std::memory_order_relaxed);
+    }
+    return current;
+}
+
+bool CoordinatorSharedDataQueue::isProcessAlive(pid_t processId, uint32_t startTime) {
+    if (::kill(processId, 0) != 0 && errno == ESRCH) {
+        return false;
+    }
+    // process with the same pid but different start time reused pid of dead writer. If start time can't be read, existence of pid has to be enough
+    auto currentStartTime = osutils::getProcessStartTime(processId);
+    return !currentStartTime.has_value() || static_cast<uint32_t>(*currentStartTime) == startTime;
+}
+
+CoordinatorSharedDataQueue::RecordState CoordinatorSharedDataQueue::getRecordState(uint64_t position, std::size_t &length) const {
+    auto state = getRecordHeader(position)->state.load(std::memory_order_acquire);
+    // header left from previous round of the ring or record data which happen to be there
+    if (static_cast<uint32_t>(state >> 32) != static_cast<uint32_t>(position / recordAlignment)) {
+        return stateFree;
+    }
+    length = (state >> 2) & maxRecordLength;
+    return static_cast<RecordState>(state & 3);
+}
+
+bool CoordinatorSharedDataQueue::tryReceiveMessage(processRecord_t const &processRecord, std::chrono::milliseconds maxWait) {
+    return receive(processRecord, maxWait, 1) > 0;
+}
+
+std::size_t CoordinatorSharedDataQueue::receiveMessages(processRecord_t const &processRecord, std::chrono::milliseconds maxWait) {
+    return receive(processRecord, maxWait, SIZE_MAX);
+}
+
+std::size_t CoordinatorSharedDataQueue::receive(processRecord_t const &processRecord, std::chrono::milliseconds maxWait, std::size_t maxRecords) {
+    auto deadline = std::chrono::steady_clock::now() + maxWait;
+    std::size_t processedCount = 0;
+    bool waited = false;
+
+    while (processedCount < maxRecords) {
+        auto head = header_->head.load(std::memory_order_relaxed);
+        if (head != header_->tail.load(std::memory_order_acquire)) {
+            bool processed = false;
+            if (auto size = consumeRecord(head, processRecord, processed); size > 0) {
+                // only header has to be cleared, position tag tells record data apart from headers
+                getRecordHeader(head)->state.store(0, std::memory_order_relaxed);
+                header_->head.store(head + size, std::memory_order_release);
+                if (processed) {
+                    processedCount++;
+                }
+                continue;
+            }
+        }
+
+        // everything committed so far is drained. After wakeup without record, e.g. by notifyConsumer, caller decides whether to wait again
+        if (processedCount > 0 || waited || !waitForRecord(head, deadline)) {
+            break;
+        }
+        waited = true;
+    }
+
+    if (processedCount > 0) {
+        wakeups_.fetch_add(1, std::memory_order_relaxed);
+        records_.fetch_add(processedCount, std::memory_order_relaxed);
+        updateMax(maxRecordsPerWakeup_, processedCount);
+    }
+    return processedCount;
+}
+
+bool CoordinatorSharedDataQueue::waitForRecord(uint64_t head, std::chrono::steady_clock::time_point deadline) {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+        return false;
+    }
+
+    auto sequence = header_->wakeupSequence.load(std::memory_order_acquire);
+    header_->consumerWaiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // record committed before producer could see us waiting. Reserved record of dead producer is rechecked after timeout
+    std::size_t length = 0;
+    auto state = getRecordState(head, length);
+    if (state != stateCommitted && state != statePadding) {
+        futexWait(&header_->wakeupSequence, sequence, deadline - now);
+    }
+
+    header_->consumerWaiting.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void CoordinatorSharedDataQueue::wakeUpConsumer() {
+    header_->wakeupSequence.fetch_add(1, std::memory_order_release);
+    futexWake(&header_->wakeupSequence);
+}
+
+void CoordinatorSharedDataQueue::notifyConsumer() {
+    wakeUpConsumer();
+}
+
+std::size_t CoordinatorSharedDataQueue::consumeRecord(uint64_t head, processRecord_t const &processRecord, bool &processed) {
+    auto record = getRecordHeader(head);
+    std::size_t length = 0;
+    switch (getRecordState(head, length)) {
+        case stateCommitted:
+            processed = true;
+            try {
+                processRecord({reinterpret_cast<std::byte const *>(record + 1), length});
+            } catch (std::exception const &e) {
+                // record is consumed anyway, otherwise it would block the ring forever
+                if (logger_) {
+                    ELOG_WARNING(logger_, COORDINATOR, "CoordinatorSharedDataQueue: processing of record of size {} from process {} failed: {}", length, record->writerProcessId, e.what());
+                }
+            }
+            return getRecordSize(length);
+        case statePadding:
+            return capacity_ - head % capacity_;
+        case stateReserved:
+            if (!isProcessAlive(record->writerProcessId, record->writerStartTime)) {
+                if (logger_) {
+                    ELOG_WARNING(logger_, COORDINATOR, "CoordinatorSharedDataQueue: skipping record of size {} abandoned by process {}", length, record->writerProcessId);
+                }
+                return getRecordSize(length);
+            }
+            return 0;
+        default:
+            // producer advanced tail and didn't write record header yet
+            return skipAbandonedReservation(head);
+    }
+}
+
+std::size_t CoordinatorSharedDataQueue::skipAbandonedReservation(uint64_t head) {
+    auto now = std::chrono::steady_clock::now();
+    if (stalledHead_ != head) {
+        stalledHead_ = head;
+        stalledTail_ = header_->tail.load(std::memory_order_acquire);
+        stalledSince_ = now;
+    }
+    if (now - stalledSince_ < abandonedReservationTimeout_) {
+        return 0;
+    }
+
+    // producers which reserved space before stalledTail_ had enough time to write their headers, so abandoned space ends at first written header
+    for (auto position = head + recordAlignment; position < stalledTail_; position += recordAlignment) {
+        std::size_t length = 0;
+        auto state = getRecordState(position, length);
+        if (state == stateFree) {
+            continue;
+        }
+        auto end = position + (state == statePadding ? capacity_ - position % capacity_ : getRecordSize(length));
+        if (end <= stalledTail_) {
+            if (logger_) {
+                ELOG_WARNING(logger_, COORDINATOR, "CoordinatorSharedDataQueue: skipping {} bytes reserved by process which didn't write record header", position - head);
+            }
+            return position - head;
+        }
+    }
+    if (logger_) {
+        ELOG_WARNING(logger_, COORDINATOR, "CoordinatorSharedDataQueue: skipping {} bytes reserved by process which didn't write record header", stalledTail_ - head);
+    }
+    return stalledTail_ - head;
+}
+
+CoordinatorSharedDataQueue::Statistics CoordinatorSharedDataQueue::getStatistics() const {
+    Statistics statistics;
+    statistics.wakeups = wakeups_.load(std::memory_order_relaxed);
+    statistics.records = records_.load(std::memory_order_relaxed);
+    statistics.maxRecordsPerWakeup = maxRecordsPerWakeup_.load(std::memory_order_relaxed);
+    statistics.highWaterMark = header_->highWaterMark.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+std::size_t CoordinatorSharedDataQueue::getUsedBytes() const {
+    return header_->tail.load(std::memory_order_acquire) - header_->head.load(std::memory_order_acquire);
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -1,54 +1,155 @@
 #pragma once
 
 #include "LoggerInterface.h"
-#include <boost/interprocess/ipc/message_queue.hpp>
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <span>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/noncopyable.hpp>
+#include <sys/types.h>
 
 namespace opentelemetry::php::coordinator {
 
-struct CoordinatorPayload {
-    pid_t senderProcessId;
-    uint64_t msgId;
-    std::size_t payloadTotalSize;
-    std::size_t payloadOffset;
-    std::array<std::byte, 4064> payload; // it must be last field in the struct. sizeof(CoordinatorPayload) = 4096 bytes with current payload size
-};
-
-struct CoordinatorSharedDataQueue {
+// Multi-producer/single-consumer ring of variable-length records in anonymous shared memory, created before coordinator is forked.
+// Workers reserve space by compare-and-swap of tail and publish record through state word in its header, which holds position tag, length and state of the record.
+// Header written in previous round of the ring has different position tag, so consumer can tell whether producer already wrote header of reserved record.
+// Coordinator consumes committed records in order, clears their state words and advances head. Record which doesn't fit before end of ring is preceded by padding record
+// and stored at the beginning. Record reserved by worker which died before commit is skipped, pid reuse is detected by process start time. Space reserved by worker
+// which died before it wrote record header is skipped once it stays unwritten for abandonedReservationTimeout.
+// Idle coordinator sleeps on futex in shared memory, producer wakes it up only if it announced it is going to sleep
+class CoordinatorSharedDataQueue : public boost::noncopyable {
 public:
-    constexpr static size_t maxMqPayloadSize = sizeof(CoordinatorPayload);
-    constexpr static size_t maxQueueSize = 100;
-
-    CoordinatorSharedDataQueue(std::shared_ptr<LoggerInterface> logger) : logger_(std::move(logger)) {
-    }
-
-    bool enqueueMessage(const void *data, size_t size) {
-        try {
-            queue_->try_send(data, size, 0);
-            return true;
-        } catch (boost::interprocess::interprocess_exception &ex) {
-            if (logger_) {
-                ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorProcess: message_queue send failed: {}", ex.what());
-            }
-            return false;
-        }
-    }
-
-    bool tryReceiveMessage(char *buffer, size_t bufferSize, size_t &receivedSize) {
-        try {
-            unsigned int priority = 0;
-            return queue_->timed_receive(buffer, bufferSize, receivedSize, priority, std::chrono::system_clock::now() + std::chrono::milliseconds(100));
-        } catch (std::exception &ex) {
-            if (logger_) {
-                ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorProcess: message_queue receive failed: '{}'", ex.what());
-            }
-            return false;
-        }
-    }
-private:
-    std::shared_ptr<boost::interprocess::message_queue> queue_{std::make_shared<boost::interprocess::message_queue>(maxQueueSize, maxMqPayloadSize)};
+    using recordSegments_t = std::span<const std::span<const std::byte>>;
+    using processRecord_t = std::function<void(std::span<const std::byte>)>;
+
+    static constexpr std::size_t defaultCapacity = 8 * 1024 * 1024;
+    static constexpr std::size_t minCapacity = 64 * 1024;
+    static constexpr std::size_t recordAlignment = 16;
+    static constexpr std::size_t maxRecordLength = (1u << 30) - 1; // limited by length field of state word
+    static constexpr std::chrono::milliseconds abandonedReservationTimeout{10000};
+
+    struct Statistics {
+        uint64_t wakeups = 0; // number of batches drained by consumer
+        uint64_t records = 0;
+        uint64_t maxRecordsPerWakeup = 0;
+        uint64_t highWaterMark = 0; // max bytes used by records reserved and not yet consumed
+    };
+
+    // capacity is rounded to record alignment and limited by minCapacity. throws boost::interprocess::interprocess_exception if shared memory can't be created
+    CoordinatorSharedDataQueue(std::shared_ptr<LoggerInterface> logger, std::size_t capacity = defaultCapacity);
+
+    // copies segments into single record. Returns false if there is no space or record is larger than getMaxRecordSize()
+    bool enqueueMessage(recordSegments_t segments);
+
+    // consumes single record. Record data passed to callback is valid only during the call. Waits up to maxWait for record to be committed.
+    // Only one process may consume records
+    bool tryReceiveMessage(processRecord_t const &processRecord, std::chrono::milliseconds maxWait);
+
+    // waits up to maxWait for first record and then consumes all committed records without sleeping. Returns number of processed records
+    std::size_t receiveMessages(processRecord_t const &processRecord, std::chrono::milliseconds maxWait);
+
+    // wakes up consumer waiting for records, e.g. to let it stop
+    void notifyConsumer();
+
+    Statistics getStatistics() const;
+
+    // largest record which always fits into empty ring
+    std::size_t getMaxRecordSize() const {
+        return std::min(capacity_ / 2 - sizeof(RecordHeader), maxRecordLength);
+    }
+
+    std::size_t getCapacity() const {
+        return capacity_;
+    }
+
+    // bytes reserved by producers and not yet consumed, including padding
+    std::size_t getUsedBytes() const;
+
+    // monotonic position after last reserved record. Every record reserved so far is consumed once getConsumedPosition() reaches it
+    uint64_t getReservedPosition() const {
+        return header_->tail.load(std::memory_order_acquire);
+    }
+
+    uint64_t getConsumedPosition() const {
+        return header_->head.load(std::memory_order_acquire);
+    }
+
+protected:
+    enum RecordState : uint32_t {
+        stateFree = 0, // zeroed memory, no record was reserved here yet
+        stateReserved = 1,
+        stateCommitted = 2,
+        statePadding = 3,
+    };
+
+    struct RecordHeader {
+        std::atomic<uint64_t> state; // position tag in upper half, length and RecordState in lower half
+        pid_t writerProcessId;
+        uint32_t writerStartTime; // low bits of process start time, distinguish writer from process which reused its pid
+    };
+    static_assert(sizeof(RecordHeader) == recordAlignment);
+
+    struct SharedHeader {
+        alignas(64) std::atomic<uint64_t> head; // position of next record to consume, positions are monotonic byte counters
+        alignas(64) std::atomic<uint64_t> tail; // position of next record to reserve
+        std::atomic<uint64_t> highWaterMark;
+        alignas(64) std::atomic<uint32_t> wakeupSequence; // futex word, changed by producer waking up consumer
+        std::atomic<uint32_t> consumerWaiting;
+    };
+
+    static std::size_t getRecordSize(std::size_t length) {
+        return (sizeof(RecordHeader) + length + recordAlignment - 1) & ~(recordAlignment - 1);
+    }
+
+    RecordHeader *getRecordHeader(uint64_t position) const {
+        return reinterpret_cast<RecordHeader *>(data_ + position % capacity_);
+    }
+
+    static uint64_t makeRecordState(uint64_t position, std::size_t length, RecordState state) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(position / recordAlignment)) << 32) | (static_cast<uint64_t>(length) << 2) | state;
+    }
+
+    // state of record header at position, stateFree if header wasn't written since the position was reserved
+    RecordState getRecordState(uint64_t position, std::size_t &length) const;
+
+    // process identity, pid in upper and start time in lower half
+    static uint64_t getProcessIdentity(pid_t processId, uint32_t startTime) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(processId)) << 32) | startTime;
+    }
+    static uint64_t getCurrentProcessIdentity();
+    static bool isProcessAlive(pid_t processId, uint32_t startTime);
+
+    // returns size of consumed record or padding, 0 if there is no record ready at head. processed is set if record was passed to callback
+    std::size_t consumeRecord(uint64_t head, processRecord_t const &processRecord, bool &processed);
+    // returns size of space at head reserved by producer which didn't write record header within abandonedReservationTimeout, 0 while it may still be written
+    std::size_t skipAbandonedReservation(uint64_t head);
+    std::size_t receive(processRecord_t const &processRecord, std::chrono::milliseconds maxWait, std::size_t maxRecords);
+    // sleeps until producer commits record at head or deadline passes. Returns false if deadline already passed
+    bool waitForRecord(uint64_t head, std::chrono::steady_clock::time_point deadline);
+    void wakeUpConsumer();
+
     std::shared_ptr<LoggerInterface> logger_;
+    std::size_t capacity_;
+    boost::interprocess::mapped_region region_;
+    SharedHeader *header_ = nullptr;
+    std::byte *data_ = nullptr;
+
+    // updated only by consumer
+    std::atomic<uint64_t> wakeups_ = 0;
+    std::atomic<uint64_t> records_ = 0;
+    std::atomic<uint64_t> maxRecordsPerWakeup_ = 0;
+
+    // reservation without record header found at head by consumer, every record reserved before stalledTail_ is older than the stall
+    std::chrono::milliseconds abandonedReservationTimeout_ = abandonedReservationTimeout;
+    uint64_t stalledHead_ = UINT64_MAX;
+    uint64_t stalledTail_ = 0;
+    std::chrono::steady_clock::time_point stalledSince_;
 };
 
-} // namespace opentelemetry::php::coordinator
\ No newline at end of file
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "LoggerInterface.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string_view>
+
+#include <boost/interprocess/anonymous_shared_memory.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace opentelemetry::php::coordinator {
+
+// Backpressure status of coordinator published in shared memory created before coordinator is forked. Coordinator publishes it periodically, workers read it
+// without locking, so PHP code can shed load (lower sampling ratio, skip low priority signals) before it serializes telemetry which would be dropped.
+// Status is written under sequence lock, reader retries while sequence is odd or changes during read. Failed sends to coordinator are counted by workers
+// and coordinator restarts by its supervisor directly
+class CoordinatorStatusPage : public boost::noncopyable {
+public:
+    enum class Level : uint32_t {
+        normal = 0,
+        elevated = 1, // queues are half full or payloads were dropped since last status
+        critical = 2, // queues are almost full
+    };
+
+    static constexpr uint32_t elevatedFillPercent = 50;
+    static constexpr uint32_t criticalFillPercent = 90;
+
+    struct Status {
+        uint64_t updatedAtUnixMs = 0; // 0 until coordinator publishes first status
+        Level level = Level::normal;
+        uint32_t queueFillPercent = 0;     // shared memory queue between workers and coordinator
+        uint32_t transportFillPercent = 0; // coordinator send buffer, OTEL_PHP_MAX_SEND_QUEUE_SIZE
+        uint64_t transportQueuedBytes = 0;
+        uint64_t droppedPayloads = 0; // dropped by coordinator since it started
+        uint64_t droppedBytes = 0;
+        uint64_t exportedPayloads = 0;
+        uint64_t exportLatencyMs = 0; // moving average of time from enqueue to successful export
+        uint64_t workerSendFailures = 0; // payloads workers failed to pass to coordinator
+        uint64_t coordinatorRestarts = 0;
+    };
+
+    CoordinatorStatusPage(std::shared_ptr<LoggerInterface> logger) : logger_(std::move(logger)), region_(boost::interprocess::anonymous_shared_memory(sizeof(SharedData))) {
+        sharedData_ = new (region_.get_address()) SharedData();
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorStatusPage initialized with shared memory region of size {}", region_.get_size());
+    }
+
+    static Level getLevel(uint32_t queueFillPercent, uint32_t transportFillPercent, bool droppedSinceLastStatus) {
+        auto fill = std::max(queueFillPercent, transportFillPercent);
+        if (fill >= criticalFillPercent) {
+            return Level::critical;
+        }
+        return fill >= elevatedFillPercent || droppedSinceLastStatus ? Level::elevated : Level::normal;
+    }
+
+    static std::string_view getLevelName(Level level) {
+        switch (level) {
+            case Level::elevated:
+                return "elevated";
+            case Level::critical:
+                return "critical";
+            default:
+                return "normal";
+        }
+    }
+
+    // called by coordinator only. workerSendFailures and coordinatorRestarts are counted by other processes and not overwritten
+    void publish(Status const &status) {
+        auto sequence = sharedData_->sequence.load(std::memory_order_relaxed);
+        sharedData_->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        sharedData_->updatedAtUnixMs.store(status.updatedAtUnixMs, std::memory_order_relaxed);
+        sharedData_->level.store(static_cast<uint32_t>(status.level), std::memory_order_relaxed);
+        sharedData_->queueFillPercent.store(status.queueFillPercent, std::memory_order_relaxed);
+        sharedData_->transportFillPercent.store(status.transportFillPercent, std::memory_order_relaxed);
+        sharedData_->transportQueuedBytes.store(status.transportQueuedBytes, std::memory_order_relaxed);
+        sharedData_->droppedPayloads.store(status.droppedPayloads, std::memory_order_relaxed);
+        sharedData_->droppedBytes.store(status.droppedBytes, std::memory_order_relaxed);
+        sharedData_->exportedPayloads.store(status.exportedPayloads, std::memory_order_relaxed);
+        sharedData_->exportLatencyMs.store(status.exportLatencyMs, std::memory_order_relaxed);
+
+        sharedData_->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    Status read() const {
+        Status status;
+        for (;;) {
+            auto sequence = sharedData_->sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                continue;
+            }
+            status.updatedAtUnixMs = sharedData_->updatedAtUnixMs.load(std::memory_order_relaxed);
+            status.level = static_cast<Level>(sharedData_->level.load(std::memory_order_relaxed));
+            status.queueFillPercent = sharedData_->queueFillPercent.load(std::memory_order_relaxed);
+            status.transportFillPercent = sharedData_->transportFillPercent.load(std::memory_order_relaxed);
+            status.transportQueuedBytes = sharedData_->transportQueuedBytes.load(std::memory_order_relaxed);
+            status.droppedPayloads = sharedData_->droppedPayloads.load(std::memory_order_relaxed);
+            status.droppedBytes = sharedData_->droppedBytes.load(std::memory_order_relaxed);
+            status.exportedPayloads = sharedData_->exportedPayloads.load(std::memory_order_relaxed);
+            status.exportLatencyMs = sharedData_->exportLatencyMs.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sharedData_->sequence.load(std::memory_order_relaxed) == sequence) {
+                break;
+            }
+        }
+        status.workerSendFailures = sharedData_->workerSendFailures.load(std::memory_order_relaxed);
+        status.coordinatorRestarts = sharedData_->coordinatorRestarts.load(std::memory_order_relaxed);
+        return status;
+    }
+
+    // called by workers
+    void recordWorkerSendFailure() {
+        sharedData_->workerSendFailures.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // called by CoordinatorSupervisor
+    void recordCoordinatorRestart() {
+        sharedData_->coordinatorRestarts.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    struct SharedData {
+        std::atomic<uint64_t> sequence = 0;
+        std::atomic<uint64_t> updatedAtUnixMs = 0;
+        std::atomic<uint32_t> level = 0;
+        std::atomic<uint32_t> queueFillPercent = 0;
+        std::atomic<uint32_t> transportFillPercent = 0;
+        std::atomic<uint64_t> transportQueuedBytes = 0;
+        std::atomic<uint64_t> droppedPayloads = 0;
+        std::atomic<uint64_t> droppedBytes = 0;
+        std::atomic<uint64_t> exportedPayloads = 0;
+        std::atomic<uint64_t> exportLatencyMs = 0;
+        alignas(64) std::atomic<uint64_t> workerSendFailures = 0; // written by workers, kept apart from coordinator data
+        std::atomic<uint64_t> coordinatorRestarts = 0;
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "status page is shared between processes");
+
+    std::shared_ptr<LoggerInterface> logger_;
+    boost::interprocess::mapped_region region_;
+    SharedData *sharedData_{nullptr};
+};
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,180 @@
+#include "CoordinatorSupervisor.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace opentelemetry::php::coordinator {
+
+namespace {
+
+// how often supervisor checks whether server process is still running
+constexpr std::chrono::milliseconds serverCheckInterval{1000};
+
+int openPidFd(pid_t processId) {
+#ifdef SYS_pidfd_open
+    return static_cast<int>(::syscall(SYS_pidfd_open, processId, 0));
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+bool isServerRunning(pid_t serverProcessId) {
+    return getppid() == serverProcessId;
+}
+
+} // namespace
+
+CoordinatorSupervisor::CoordinatorSupervisor(std::shared_ptr<LoggerInterface> logger, std::shared_ptr<CoordinatorStatusPage> statusPage, runCoordinator_t runCoordinator, CoordinatorRestartPolicy restartPolicy) : logger_(std::move(logger)), statusPage_(std::move(statusPage)), runCoordinator_(std::move(runCoordinator)), restartPolicy_(restartPolicy) {
+    if (pthread_sigmask(SIG_BLOCK, nullptr, &coordinatorSignalMask_) != 0) {
+        sigemptyset(&coordinatorSignalMask_);
+    }
+}
+
+pid_t CoordinatorSupervisor::start() {
+    auto serverProcessId = getpid();
+    auto processId = fork();
+    if (processId == 0) {
+        // signals sent to server are handled by server, supervisor only follows its exit
+        sigset_t allSignals;
+        sigfillset(&allSignals);
+        pthread_sigmask(SIG_SETMASK, &allSignals, nullptr);
+        supervise(serverProcessId);
+    }
+
+    if (processId < 0) {
+        ELOG_WARNING(logger_, COORDINATOR, "CoordinatorSupervisor: fork() of supervisor process failed: {} ({})", std::strerror(errno), errno);
+    } else {
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorSupervisor: supervisor process {} forked", processId);
+    }
+    supervisorProcessId_ = processId;
+    return processId;
+}
+
+void CoordinatorSupervisor::stop() {
+    if (supervisorProcessId_ <= 0) {
+        return;
+    }
+    ::kill(supervisorProcessId_, SIGKILL);
+    ::waitpid(supervisorProcessId_, nullptr, 0);
+    supervisorProcessId_ = -1;
+}
+
+std::chrono::milliseconds CoordinatorSupervisor::getRestartDelay(CoordinatorRestartPolicy const &policy, std::chrono::milliseconds previousDelay, std::chrono::steady_clock::duration runTime) {
+    if (previousDelay.count() == 0 || runTime >= policy.maxDelay) {
+        return policy.minDelay;
+    }
+    return std::min(previousDelay * 2, policy.maxDelay);
+}
+
+void CoordinatorSupervisor::supervise(pid_t serverProcessId) {
+    auto processId = forkCoordinator();
+    std::chrono::milliseconds delay{0};
+    uint32_t earlyRestarts = 0;
+    while (true) {
+        auto started = std::chrono::steady_clock::now();
+        if (processId > 0 && !waitForExit(processId, serverProcessId)) {
+            break;
+        }
+
+        auto runTime = std::chrono::steady_clock::now() - started;
+        if (runTime >= restartPolicy_.maxDelay) {
+            earlyRestarts = 0;
+        }
+        if (earlyRestarts >= restartPolicy_.maxRestarts) {
+            ELOG_ERROR(logger_, COORDINATOR, "CoordinatorSupervisor: coordinator process {} exited after {} restarts in a row, it won't be restarted again", processId, earlyRestarts);
+            break;
+        }
+
+        delay = getRestartDelay(restartPolicy_, delay, runTime);
+        if (!waitWhileServerRuns(delay, serverProcessId)) {
+            break;
+        }
+
+        auto exitedProcessId = processId;
+        processId = forkCoordinator();
+        earlyRestarts++;
+        if (processId > 0) {
+            if (statusPage_) {
+                statusPage_->recordCoordinatorRestart();
+            }
+            ELOG_WARNING(logger_, COORDINATOR, "CoordinatorSupervisor: coordinator process {} exited, restarted as {} after {}ms. Restarts in a row: {}", exitedProcessId, processId, delay.count(), earlyRestarts);
+        }
+    }
+    std::_Exit(0);
+}
+
+pid_t CoordinatorSupervisor::forkCoordinator() {
+    auto supervisorProcessId = getpid();
+    auto processId = fork();
+    if (processId == 0) {
+        pthread_sigmask(SIG_SETMASK, &coordinatorSignalMask_, nullptr);
+        runCoordinator_(supervisorProcessId);
+        std::exit(0);
+    }
+
+    if (processId < 0) {
+        ELOG_WARNING(logger_, COORDINATOR, "CoordinatorSupervisor: fork() failed: {} ({})", std::strerror(errno), errno);
+    } else {
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorSupervisor: coordinator process {} forked", processId);
+    }
+    return processId;
+}
+
+bool CoordinatorSupervisor::waitForExit(pid_t processId, pid_t serverProcessId) {
+    int pidFd = openPidFd(processId);
+    if (pidFd < 0) {
+        // kernel without pidfd support, exit is checked periodically
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorSupervisor: unable to open pidfd of coordinator process {}: {}", processId, std::strerror(errno));
+        while (::waitpid(processId, nullptr, WNOHANG) == 0) {
+            if (!waitWhileServerRuns(serverCheckInterval, serverProcessId)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    pollfd fd{pidFd, POLLIN, 0};
+    while (true) {
+        int result = ::poll(&fd, 1, static_cast<int>(serverCheckInterval.count()));
+        if (result > 0) {
+            break;
+        }
+        if ((result < 0 && errno != EINTR) || !isServerRunning(serverProcessId)) {
+            ::close(pidFd);
+            return false;
+        }
+    }
+    ::close(pidFd);
+
+    int status = 0;
+    if (::waitpid(processId, &status, 0) == processId) {
+        if (WIFSIGNALED(status)) {
+            ELOG_WARNING(logger_, COORDINATOR, "CoordinatorSupervisor: coordinator process {} was terminated by signal {}", processId, WTERMSIG(status));
+        } else {
+            ELOG_WARNING(logger_, COORDINATOR, "CoordinatorSupervisor: coordinator process {} exited with status {}", processId, WEXITSTATUS(status));
+        }
+    }
+    return true;
+}
+
+bool CoordinatorSupervisor::waitWhileServerRuns(std::chrono::milliseconds timeout, pid_t serverProcessId) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (isServerRunning(serverProcessId)) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(deadline - now, serverCheckInterval));
+    }
+    return false;
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "LoggerInterface.h"
+#include "CoordinatorStatusPage.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <boost/noncopyable.hpp>
+#include <signal.h>
+#include <sys/types.h>
+
+namespace opentelemetry::php::coordinator {
+
+struct CoordinatorRestartPolicy {
+    std::chrono::milliseconds minDelay{1000};
+    std::chrono::milliseconds maxDelay{60000}; // coordinator which ran at least that long is considered stable, backoff starts over
+    uint32_t maxRestarts = 10;                 // restarts in a row after which supervision is given up
+};
+
+// Forks coordinator process and forks it again when it exits while the server process is running, e.g. after crash or OOM kill.
+// Coordinator is forked by supervisor process - single threaded child forked by main thread of server before agent starts any thread, so it can fork
+// safely at any time while the server process runs threads of agent and of server itself. Supervisor and coordinator inherit shared memory queue,
+// payload arena and configuration provider, so new coordinator takes over records which workers enqueued while there was no coordinator.
+// Restarts are delayed with exponential backoff, supervision is given up after maxRestarts restarts of coordinator which kept exiting early.
+// Supervisor process exits with the server process, restarts are counted in status page
+class CoordinatorSupervisor : public boost::noncopyable {
+public:
+    // runs coordinator in forked process, parentProcessId is pid of supervisor process
+    using runCoordinator_t = std::function<void(pid_t parentProcessId)>;
+
+    // has to be created by thread which signal mask coordinator should inherit
+    CoordinatorSupervisor(std::shared_ptr<LoggerInterface> logger, std::shared_ptr<CoordinatorStatusPage> statusPage, runCoordinator_t runCoordinator, CoordinatorRestartPolicy restartPolicy = {});
+
+    // forks supervisor process which forks coordinator, returns its pid or -1 if fork failed. Has to be called while process is single threaded
+    pid_t start();
+
+    // kills supervisor process, coordinator keeps running
+    void stop();
+
+    pid_t getSupervisorProcessId() const {
+        return supervisorProcessId_;
+    }
+
+    // delay before restart of coordinator which exited after runTime, previousDelay is zero for first restart
+    static std::chrono::milliseconds getRestartDelay(CoordinatorRestartPolicy const &policy, std::chrono::milliseconds previousDelay, std::chrono::steady_clock::duration runTime);
+
+private:
+    // runs in supervisor process, never returns
+    [[noreturn]] void supervise(pid_t serverProcessId);
+    pid_t forkCoordinator();
+    // returns false if server process exited before coordinator
+    bool waitForExit(pid_t processId, pid_t serverProcessId);
+    // returns false if server process exited during the wait
+    bool waitWhileServerRuns(std::chrono::milliseconds timeout, pid_t serverProcessId);
+
+    std::shared_ptr<LoggerInterface> logger_;
+    std::shared_ptr<CoordinatorStatusPage> statusPage_;
+    runCoordinator_t runCoordinator_;
+    CoordinatorRestartPolicy restartPolicy_;
+    sigset_t coordinatorSignalMask_;
+    pid_t supervisorProcessId_ = -1;
+};
+
+} // namespace opentelemetry::php::coordinator
@@ -1,5 +1,8 @@
 #include "CoordinatorTelemetrySignalsSender.h"
+#include "SendEndpointPayloadCodec.h"
 
+#include <array>
+#include <cstring>
 #include <functional>
 #include <string>
 
@@ -7,7 +10,7 @@
 
 namespace opentelemetry::php::coordinator {
 
-void CoordinatorTelemetrySignalsSender::initializeConnection(std::string endpointUrl, std::size_t endpointHash, std::string contentType, enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, opentelemetry::php::transport::HttpEndpointSSLOptions sslOptions) {
+void CoordinatorTelemetrySignalsSender::initializeConnection(std::string endpointUrl, std::size_t endpointHash, std::string contentType, enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, opentelemetry::php::transport::HttpEndpointSSLOptions sslOptions, opentelemetry::php::transport::PayloadCompression compression) {
 
     coordinator::EstablishConnectionCommand command;
     command.set_endpoint_url(std::move(endpointUrl));
@@ -25,6 +28,7 @@ void CoordinatorTelemetrySignalsSender::initializeConnection(std::string endpoin
     command.mutable_ssl_options()->set_cert(sslOptions.cert);
     command.mutable_ssl_options()->set_cert_key(sslOptions.certKey);
     command.mutable_ssl_options()->set_cert_key_password(sslOptions.certKeyPassword);
+    command.set_compression(std::string(opentelemetry::php::transport::getContentEncoding(compression)));
 
     coordinator::CoordinatorCommand coordCommand;
     coordCommand.set_type(coordinator::CoordinatorCommand::ESTABLISH_CONNECTION);
@@ -38,31 +42,86 @@ void CoordinatorTelemetrySignalsSender::initializeConnection(std::string endpoin
         return;
     }
 
-    if (!sendPayload_(serializedCommand)) {
+    std::span<const std::byte> segment(reinterpret_cast<const std::byte *>(serializedCommand.data()), serializedCommand.size());
+    if (!sendPayload_({&segment, 1})) {
         ELOG_WARNING(logger_, COORDINATOR, "CoordinatorTelemetrySignalsSender: failed to send EstablishConnectionCommand, endpoint hash: {}", endpointHash);
     }
 }
 
-void CoordinatorTelemetrySignalsSender::enqueue(uint64_t endpointHash, std::span<std::byte> payload, responseCallback_t callback) {
-    coordinator::SendEndpointPayloadCommand command;
-    command.set_endpoint_hash(endpointHash);
-    command.set_payload(payload.data(), payload.size());
+// payload is not wrapped in protobuf message - only frame header is encoded and payload is chunked directly from caller memory
+void CoordinatorTelemetrySignalsSender::enqueue(uint64_t endpointHash, opentelemetry::php::transport::PayloadBuffer payload, responseCallback_t callback) {
+    if (payloadArena_ && payload.size() >= CoordinatorPayloadArena::minPayloadSize && enqueueInArena(endpointHash, payload)) {
+        return;
+    }
+
+    SendEndpointPayloadCodec::header_t header;
+    std::array<std::span<const std::byte>, 2> segments{SendEndpointPayloadCodec::encodeHeader(header, endpointHash, payload.size()), payload};
+
+    if (!sendPayload_(segments)) {
+        ELOG_WARNING(logger_, COORDINATOR, "CoordinatorTelemetrySignalsSender: Dropping payload. Endpoint hash: %zu, payload size: {}", endpointHash, payload.size());
+        if (statusPage_) {
+            statusPage_->recordWorkerSendFailure();
+        }
+    }
+}
+
+// payload is copied once into shared memory and coordinator gets only its descriptor
+bool CoordinatorTelemetrySignalsSender::enqueueInArena(std::size_t endpointHash, opentelemetry::php::transport::PayloadBuffer const &payload) {
+    auto allocation = payloadArena_->allocate(payload.size());
+    if (!allocation.has_value()) {
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorTelemetrySignalsSender: no free slabs in payload arena for payload of size {}, sending it through queue", payload.size());
+        return false;
+    }
+
+    std::memcpy(payloadArena_->getData(*allocation).data(), payload.data(), payload.size());
+    payloadArena_->handOver(*allocation);
 
     coordinator::CoordinatorCommand coordCommand;
-    coordCommand.set_type(coordinator::CoordinatorCommand::SEND_ENDPOINT_PAYLOAD);
-    *coordCommand.mutable_send_endpoint_payload() = command;
+    coordCommand.set_type(coordinator::CoordinatorCommand::SEND_ENDPOINT_ARENA_PAYLOAD);
+    auto *command = coordCommand.mutable_send_endpoint_arena_payload();
+    command->set_endpoint_hash(endpointHash);
+    command->set_offset(allocation->offset);
+    command->set_size(allocation->size);
 
     std::string serializedCommand;
-    if (!coordCommand.SerializeToString(&serializedCommand)) {
-        if (logger_) {
-            ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorSender: failed to serialize SendEndpointDataCommand");
+    if (coordCommand.SerializeToString(&serializedCommand)) {
+        std::span<const std::byte> segment(reinterpret_cast<const std::byte *>(serializedCommand.data()), serializedCommand.size());
+        if (sendPayload_({&segment, 1})) {
+            return true;
         }
-        return;
     }
 
-    if (!sendPayload_(serializedCommand)) {
-        ELOG_WARNING(logger_, COORDINATOR, "CoordinatorTelemetrySignalsSender: Dropping payload. Endpoint hash: %zu, payload size: {}", endpointHash, payload.size());
+    // descriptor didn't reach coordinator, slabs are still ours
+    payloadArena_->release(*allocation);
+    ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorTelemetrySignalsSender: failed to send SendEndpointArenaPayloadCommand, endpoint hash: {}", endpointHash);
+    return false;
+}
+
+bool CoordinatorTelemetrySignalsSender::flush(std::size_t endpointHash, std::chrono::milliseconds timeout) {
+    auto requestId = flushStatus_->beginRequest();
+
+    coordinator::CoordinatorCommand coordCommand;
+    coordCommand.set_type(coordinator::CoordinatorCommand::FLUSH_ENDPOINT);
+    coordCommand.mutable_flush_endpoint()->set_endpoint_hash(endpointHash);
+    coordCommand.mutable_flush_endpoint()->set_request_id(requestId);
+
+    std::string serializedCommand;
+    if (!coordCommand.SerializeToString(&serializedCommand)) {
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorTelemetrySignalsSender: failed to serialize FlushEndpointCommand");
+        return false;
+    }
+
+    std::span<const std::byte> segment(reinterpret_cast<const std::byte *>(serializedCommand.data()), serializedCommand.size());
+    if (!sendPayload_({&segment, 1})) {
+        ELOG_WARNING(logger_, COORDINATOR, "CoordinatorTelemetrySignalsSender: failed to send FlushEndpointCommand, endpoint hash: {}", endpointHash);
+        return false;
+    }
+
+    if (!flushStatus_->waitForCompletion(requestId, timeout)) {
+        ELOG_DEBUG(logger_, COORDINATOR, "CoordinatorTelemetrySignalsSender: flush request {} of endpoint hash: {} not acknowledged within {}ms", requestId, endpointHash, timeout.count());
+        return false;
     }
+    return true;
 }
 
 } // namespace opentelemetry::php
@@ -1,32 +1,45 @@
 
 #pragma once
 
+#include "CoordinatorFlushStatus.h"
+#include "CoordinatorPayloadArena.h"
+#include "CoordinatorStatusPage.h"
 #include "LoggerInterface.h"
 #include "transport/HttpTransportAsyncInterface.h"
 
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 
 namespace opentelemetry::php::coordinator {
 
 class CoordinatorTelemetrySignalsSender : public transport::HttpTransportAsyncInterface {
 public:
-    using sendPayload_t = std::function<bool(std::string const &payload)>;
+    using sendPayload_t = std::function<bool(std::span<const std::span<const std::byte>> payload)>;
 
-    CoordinatorTelemetrySignalsSender(std::shared_ptr<LoggerInterface> logger, sendPayload_t sendPayload)
-        : logger_(std::move(logger)), sendPayload_(std::move(sendPayload)) {
+    // payloads are passed through payloadArena if it is available and has free slabs, otherwise they are copied into queue records.
+    // Payloads which can't be passed to coordinator are counted in statusPage
+    CoordinatorTelemetrySignalsSender(std::shared_ptr<LoggerInterface> logger, sendPayload_t sendPayload, std::shared_ptr<CoordinatorFlushStatus> flushStatus, std::shared_ptr<CoordinatorPayloadArena> payloadArena = nullptr, std::shared_ptr<CoordinatorStatusPage> statusPage = nullptr)
+        : logger_(std::move(logger)), sendPayload_(std::move(sendPayload)), flushStatus_(std::move(flushStatus)), payloadArena_(std::move(payloadArena)), statusPage_(std::move(statusPage)) {
     }
 
     ~CoordinatorTelemetrySignalsSender() = default;
 
-    void initializeConnection(std::string endpointUrl, std::size_t endpointHash, std::string contentType, enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, opentelemetry::php::transport::HttpEndpointSSLOptions sslOptions) override;
-    void enqueue(std::size_t endpointHash, std::span<std::byte> payload, responseCallback_t callback = {}) override;
+    void initializeConnection(std::string endpointUrl, std::size_t endpointHash, std::string contentType, enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, opentelemetry::php::transport::HttpEndpointSSLOptions sslOptions, opentelemetry::php::transport::PayloadCompression compression) override;
+    void enqueue(std::size_t endpointHash, opentelemetry::php::transport::PayloadBuffer payload, responseCallback_t callback = {}) override;
     void updateRetryDelay(size_t endpointHash, std::chrono::milliseconds retryDelay) override {
     }
+    // payloads sent before flush command are already enqueued in coordinator transport when command is processed, coordinator acknowledges request once they are flushed
+    bool flush(std::size_t endpointHash, std::chrono::milliseconds timeout) override;
 
 private:
+    bool enqueueInArena(std::size_t endpointHash, opentelemetry::php::transport::PayloadBuffer const &payload);
+
     std::shared_ptr<LoggerInterface> logger_;
     sendPayload_t sendPayload_;
+    std::shared_ptr<CoordinatorFlushStatus> flushStatus_;
+    std::shared_ptr<CoordinatorPayloadArena> payloadArena_;
+    std::shared_ptr<CoordinatorStatusPage> statusPage_;
 };
 }
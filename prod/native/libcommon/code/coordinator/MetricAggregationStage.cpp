@@ -0,0 +1,343 @@
+#include "MetricAggregationStage.h"
+#include "CiCharTraits.h"
+
+#include <algorithm>
+#include <map>
+#include <type_traits>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::coordinator {
+
+using opentelemetry::proto::collector::metrics::v1::ExportMetricsServiceRequest;
+using opentelemetry::proto::metrics::v1::AggregationTemporality;
+using opentelemetry::proto::metrics::v1::HistogramDataPoint;
+using opentelemetry::proto::metrics::v1::Metric;
+using opentelemetry::proto::metrics::v1::NumberDataPoint;
+
+namespace {
+
+// keeps elements for which keep returns true, preserving their order
+template <typename T, typename Keep>
+void retainIf(google::protobuf::RepeatedPtrField<T> &field, Keep keep) {
+    int kept = 0;
+    for (int i = 0; i < field.size(); ++i) {
+        if (keep(*field.Mutable(i))) {
+            if (kept != i) {
+                field.SwapElements(kept, i);
+            }
+            ++kept;
+        }
+    }
+    field.DeleteSubrange(kept, field.size() - kept);
+}
+
+void appendAttributes(std::string &key, google::protobuf::RepeatedPtrField<opentelemetry::proto::common::v1::KeyValue> const &attributes) {
+    for (auto const &attribute : attributes) {
+        appendKeyPart(key, attribute.SerializeAsString());
+    }
+}
+
+// metric without data points, aggregated streams of the same metric share it
+Metric getMetricDescriptor(Metric const &metric) {
+    Metric descriptor;
+    descriptor.set_name(metric.name());
+    descriptor.set_description(metric.description());
+    descriptor.set_unit(metric.unit());
+    *descriptor.mutable_metadata() = metric.metadata();
+    if (metric.has_sum()) {
+        descriptor.mutable_sum()->set_aggregation_temporality(metric.sum().aggregation_temporality());
+        descriptor.mutable_sum()->set_is_monotonic(metric.sum().is_monotonic());
+    } else if (metric.has_histogram()) {
+        descriptor.mutable_histogram()->set_aggregation_temporality(metric.histogram().aggregation_temporality());
+    }
+    return descriptor;
+}
+
+double getValue(NumberDataPoint const &point) {
+    return point.value_case() == NumberDataPoint::kAsInt ? static_cast<double>(point.as_int()) : point.as_double();
+}
+
+void merge(NumberDataPoint &aggregated, NumberDataPoint const &point) {
+    if (aggregated.value_case() == NumberDataPoint::kAsInt && point.value_case() == NumberDataPoint::kAsInt) {
+        aggregated.set_as_int(aggregated.as_int() + point.as_int());
+    } else {
+        aggregated.set_as_double(getValue(aggregated) + getValue(point));
+    }
+}
+
+void merge(HistogramDataPoint &aggregated, HistogramDataPoint const &point) {
+    aggregated.set_count(aggregated.count() + point.count());
+    if (aggregated.has_sum() && point.has_sum()) {
+        aggregated.set_sum(aggregated.sum() + point.sum());
+    } else {
+        aggregated.clear_sum();
+    }
+    for (int i = 0; i < point.bucket_counts_size(); ++i) {
+        aggregated.set_bucket_counts(i, aggregated.bucket_counts(i) + point.bucket_counts(i));
+    }
+    if (point.has_min() && (!aggregated.has_min() || point.min() < aggregated.min())) {
+        aggregated.set_min(point.min());
+    }
+    if (point.has_max() && (!aggregated.has_max() || point.max() > aggregated.max())) {
+        aggregated.set_max(point.max());
+    }
+}
+
+bool canMerge(NumberDataPoint const &, NumberDataPoint const &) {
+    return true;
+}
+
+bool canMerge(HistogramDataPoint const &aggregated, HistogramDataPoint const &point) {
+    return aggregated.bucket_counts_size() == point.bucket_counts_size();
+}
+
+} // namespace
+
+void MetricAggregationStage::processPayload(std::size_t endpointHash, transport::PayloadBuffer payload) {
+    if (!config_->get()->coordinator_metrics_aggregation_enabled) {
+        next_->enqueue(endpointHash, std::move(payload));
+        return;
+    }
+
+    ExportMetricsServiceRequest request;
+    if (!request.ParseFromArray(payload.data(), static_cast<int>(payload.size()))) {
+        ELOG_WARNING(logger_, COORDINATOR, "MetricAggregationStage: unable to parse metrics export request of endpoint {}, size {}. Sending it unaggregated", endpointHash, payload.size());
+        next_->enqueue(endpointHash, std::move(payload));
+        return;
+    }
+
+    std::size_t aggregated = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        updateIgnoredResourceAttributes();
+
+        std::size_t passedThrough = 0;
+        retainIf(*request.mutable_resource_metrics(), [&](auto &resourceMetrics) {
+            auto resource = resourceMetrics.resource();
+            retainIf(*resource.mutable_attributes(), [this](auto const &attribute) { return !ignoredResourceAttributes_.contains(attribute.key()); });
+
+            std::string resourceKey;
+            appendKeyPart(resourceKey, std::to_string(endpointHash));
+            appendKeyPart(resourceKey, resource.SerializeAsString());
+            appendKeyPart(resourceKey, resourceMetrics.schema_url());
+            auto &resourceContext = resources_[resourceKey];
+            if (!resourceContext) {
+                resourceContext = std::make_shared<ResourceContext const>(ResourceContext{std::move(resource), resourceMetrics.schema_url()});
+            }
+
+            retainIf(*resourceMetrics.mutable_scope_metrics(), [&](auto &scopeMetrics) {
+                std::string scopeKey;
+                appendKeyPart(scopeKey, scopeMetrics.scope().SerializeAsString());
+                appendKeyPart(scopeKey, scopeMetrics.schema_url());
+                auto &scopeContext = scopes_[scopeKey];
+                if (!scopeContext) {
+                    scopeContext = std::make_shared<ScopeContext const>(ScopeContext{scopeMetrics.scope(), scopeMetrics.schema_url()});
+                }
+
+                retainIf(*scopeMetrics.mutable_metrics(), [&](Metric &metric) {
+                    bool deltaSum = metric.has_sum() && metric.sum().aggregation_temporality() == AggregationTemporality::AGGREGATION_TEMPORALITY_DELTA;
+                    bool deltaHistogram = metric.has_histogram() && metric.histogram().aggregation_temporality() == AggregationTemporality::AGGREGATION_TEMPORALITY_DELTA;
+                    if (!deltaSum && !deltaHistogram) {
+                        passedThrough++;
+                        return true;
+                    }
+
+                    auto descriptor = getMetricDescriptor(metric);
+                    std::string metricKey = descriptor.SerializeAsString();
+                    auto &metricContext = metrics_[metricKey];
+                    if (!metricContext) {
+                        metricContext = std::make_shared<Metric const>(std::move(descriptor));
+                    }
+
+                    std::string baseKey;
+                    appendKeyPart(baseKey, resourceKey);
+                    appendKeyPart(baseKey, scopeKey);
+                    appendKeyPart(baseKey, metricKey);
+
+                    auto aggregatePoint = [&](auto &point) {
+                        if (point.flags() & opentelemetry::proto::metrics::v1::DATA_POINT_FLAGS_NO_RECORDED_VALUE_MASK) {
+                            passedThrough++;
+                            return true;
+                        }
+                        std::string streamKey = baseKey;
+                        appendAttributes(streamKey, point.attributes());
+                        if constexpr (std::is_same_v<std::decay_t<decltype(point)>, HistogramDataPoint>) {
+                            appendKeyPart(streamKey, std::string_view(reinterpret_cast<char const *>(point.explicit_bounds().data()), point.explicit_bounds_size() * sizeof(double)));
+                        }
+                        if (aggregate(streamKey, endpointHash, resourceContext, scopeContext, metricContext, point)) {
+                            aggregated++;
+                            return false;
+                        }
+                        passedThrough++;
+                        return true;
+                    };
+
+                    if (deltaSum) {
+                        retainIf(*metric.mutable_sum()->mutable_data_points(), aggregatePoint);
+                        return metric.sum().data_points_size() > 0;
+                    }
+                    retainIf(*metric.mutable_histogram()->mutable_data_points(), aggregatePoint);
+                    return metric.histogram().data_points_size() > 0;
+                });
+                return scopeMetrics.metrics_size() > 0;
+            });
+            return resourceMetrics.scope_metrics_size() > 0;
+        });
+
+        statistics_.aggregatedDataPoints += aggregated;
+        statistics_.passedThroughDataPoints += passedThrough;
+    }
+
+    if (aggregated == 0) {
+        next_->enqueue(endpointHash, std::move(payload));
+        return;
+    }
+
+    if (request.resource_metrics_size() > 0) {
+        sendExportRequest(logger_, *next_, "MetricAggregationStage"sv, endpointHash, request);
+    }
+}
+
+template <typename DataPoint>
+bool MetricAggregationStage::aggregate(std::string const &streamKey, std::size_t endpointHash, std::shared_ptr<ResourceContext const> const &resource, std::shared_ptr<ScopeContext const> const &scope, std::shared_ptr<Metric const> const &metric, DataPoint &point) {
+    auto found = streams_.find(streamKey);
+    if (found == streams_.end()) {
+        if (streams_.size() >= maxStreams) {
+            return false;
+        }
+        point.clear_exemplars();
+        streams_.emplace(streamKey, Stream{endpointHash, resource, scope, metric, std::move(point), true});
+        return true;
+    }
+
+    auto &stream = found->second;
+    auto &aggregated = std::get<DataPoint>(stream.point);
+    if (!canMerge(aggregated, point)) {
+        return false;
+    }
+    merge(aggregated, point);
+    aggregated.set_start_time_unix_nano(std::min(aggregated.start_time_unix_nano(), point.start_time_unix_nano()));
+    aggregated.set_time_unix_nano(std::max(aggregated.time_unix_nano(), point.time_unix_nano()));
+    stream.updated = true;
+    return true;
+}
+
+void MetricAggregationStage::onTimer(time_point_t now) {
+    std::unordered_map<std::size_t, ExportMetricsServiceRequest> requests;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto config = config_->get();
+        bool enabled = config->coordinator_metrics_aggregation_enabled;
+        if (enabled && now - lastExportTime_ < config->coordinator_metrics_aggregation_interval) {
+            return;
+        }
+        lastExportTime_ = now;
+        requests = collect();
+        if (!enabled) {
+            // aggregation was disabled in the meantime, streams of workers are sent as they are from now on
+            streams_.clear();
+            resources_.clear();
+            scopes_.clear();
+            metrics_.clear();
+        }
+    }
+    send(std::move(requests));
+}
+
+void MetricAggregationStage::onFlush() {
+    std::unordered_map<std::size_t, ExportMetricsServiceRequest> requests;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests = collect();
+    }
+    send(std::move(requests));
+}
+
+std::unordered_map<std::size_t, ExportMetricsServiceRequest> MetricAggregationStage::collect() {
+    bool cumulative = opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>(std::string_view(config_->get()->coordinator_metrics_aggregation_temporality)) != opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("delta"sv);
+    auto temporality = cumulative ? AggregationTemporality::AGGREGATION_TEMPORALITY_CUMULATIVE : AggregationTemporality::AGGREGATION_TEMPORALITY_DELTA;
+
+    struct Request {
+        ExportRequestBuilder<ExportMetricsServiceRequest> builder;
+        std::map<std::pair<opentelemetry::proto::metrics::v1::ScopeMetrics const *, Metric const *>, Metric *> metrics;
+    };
+    std::unordered_map<std::size_t, Request> requests;
+
+    for (auto it = streams_.begin(); it != streams_.end();) {
+        auto &stream = it->second;
+        if (!stream.updated) {
+            ++it;
+            continue;
+        }
+
+        auto &request = requests[stream.endpointHash];
+        auto &scope = request.builder.getScope(*stream.resource, *stream.scope);
+        auto [metric, metricInserted] = request.metrics.try_emplace({&scope, stream.metric.get()}, nullptr);
+        if (metricInserted) {
+            metric->second = scope.add_metrics();
+            *metric->second = *stream.metric;
+            if (metric->second->has_sum()) {
+                metric->second->mutable_sum()->set_aggregation_temporality(temporality);
+            } else {
+                metric->second->mutable_histogram()->set_aggregation_temporality(temporality);
+            }
+        }
+
+        // cumulative stream keeps its start time and accumulated values, delta stream starts again with next data point
+        std::visit(
+            [&](auto &point) {
+                using DataPoint = std::decay_t<decltype(point)>;
+                DataPoint *output = nullptr;
+                if constexpr (std::is_same_v<DataPoint, NumberDataPoint>) {
+                    output = metric->second->mutable_sum()->add_data_points();
+                } else {
+                    output = metric->second->mutable_histogram()->add_data_points();
+                }
+                if (cumulative) {
+                    *output = point;
+                } else {
+                    *output = std::move(point);
+                }
+            },
+            stream.point);
+        statistics_.exportedDataPoints++;
+
+        if (cumulative) {
+            stream.updated = false;
+            ++it;
+        } else {
+            it = streams_.erase(it);
+        }
+    }
+
+    // contexts no longer used by any stream
+    std::erase_if(resources_, [](auto const &entry) { return entry.second.use_count() == 1; });
+    std::erase_if(scopes_, [](auto const &entry) { return entry.second.use_count() == 1; });
+    std::erase_if(metrics_, [](auto const &entry) { return entry.second.use_count() == 1; });
+
+    std::unordered_map<std::size_t, ExportMetricsServiceRequest> builtRequests;
+    for (auto &[endpointHash, request] : requests) {
+        builtRequests.emplace(endpointHash, std::move(request.builder.getRequest()));
+    }
+    return builtRequests;
+}
+
+// requests are serialized outside of stage lock
+void MetricAggregationStage::send(std::unordered_map<std::size_t, ExportMetricsServiceRequest> requests) {
+    for (auto const &[endpointHash, request] : requests) {
+        sendExportRequest(logger_, *next_, "MetricAggregationStage"sv, endpointHash, request);
+    }
+}
+
+void MetricAggregationStage::updateIgnoredResourceAttributes() {
+    auto config = config_->get();
+    if (ignoredResourceAttributesConfig_ == config->coordinator_metrics_aggregation_ignored_resource_attributes) {
+        return;
+    }
+    ignoredResourceAttributesConfig_ = config->coordinator_metrics_aggregation_ignored_resource_attributes;
+    auto attributes = splitList(ignoredResourceAttributesConfig_);
+    ignoredResourceAttributes_ = {attributes.begin(), attributes.end()};
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "ConfigurationStorage.h"
+#include "CoordinatorPipelineStage.h"
+#include "PipelineStageUtils.h"
+
+#include "opentelemetry/proto/collector/metrics/v1/metrics_service.pb.h"
+#include "opentelemetry/proto/metrics/v1/metrics.pb.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+
+namespace opentelemetry::php::coordinator {
+
+// Aggregates delta metrics exported by all workers into one stream per host. Data points of delta sums and explicit bucket histograms with identical resource, scope, metric
+// and attributes are summed over aggregation interval and exported as delta or cumulative stream. Resource attributes which differ between workers of the same host
+// (like process.pid) can be ignored, so workers share streams. Other data points (gauges, cumulative sums, exponential histograms, summaries) are passed through immediately
+class MetricAggregationStage : public CoordinatorPipelineStage {
+public:
+    // data points of new streams are passed through once this limit is reached
+    static constexpr std::size_t maxStreams = 16 * 1024;
+
+    struct Statistics {
+        uint64_t aggregatedDataPoints = 0;
+        uint64_t passedThroughDataPoints = 0;
+        uint64_t exportedDataPoints = 0;
+    };
+
+    MetricAggregationStage(std::shared_ptr<LoggerInterface> logger, std::shared_ptr<ConfigurationStorage> config, std::shared_ptr<transport::HttpTransportAsyncInterface> next) : CoordinatorPipelineStage(std::move(logger), std::move(next), "metrics"), config_(std::move(config)) {
+    }
+
+    Statistics getStatistics() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return statistics_;
+    }
+
+    std::size_t getStreamsCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return streams_.size();
+    }
+
+protected:
+    struct Stream {
+        std::size_t endpointHash;
+        std::shared_ptr<ResourceContext const> resource;
+        std::shared_ptr<ScopeContext const> scope;
+        std::shared_ptr<opentelemetry::proto::metrics::v1::Metric const> metric; // metric without data points
+        std::variant<opentelemetry::proto::metrics::v1::NumberDataPoint, opentelemetry::proto::metrics::v1::HistogramDataPoint> point;
+        bool updated = false; // since last export
+    };
+
+    void processPayload(std::size_t endpointHash, transport::PayloadBuffer payload) override;
+    void onTimer(time_point_t now) override;
+    void onFlush() override;
+
+    // returns false if data point has to be passed through
+    template <typename DataPoint>
+    bool aggregate(std::string const &streamKey, std::size_t endpointHash, std::shared_ptr<ResourceContext const> const &resource, std::shared_ptr<ScopeContext const> const &scope, std::shared_ptr<opentelemetry::proto::metrics::v1::Metric const> const &metric, DataPoint &point);
+
+    // builds export requests of aggregated streams and resets delta streams. Called with mutex locked
+    std::unordered_map<std::size_t, opentelemetry::proto::collector::metrics::v1::ExportMetricsServiceRequest> collect();
+    void send(std::unordered_map<std::size_t, opentelemetry::proto::collector::metrics::v1::ExportMetricsServiceRequest> requests);
+    void updateIgnoredResourceAttributes();
+
+    std::shared_ptr<ConfigurationStorage> config_;
+
+    mutable std::mutex mutex_;
+    time_point_t lastExportTime_ = std::chrono::steady_clock::now();
+    std::unordered_map<std::string, Stream> streams_;
+    // contexts shared by streams, keyed by their identity
+    std::unordered_map<std::string, std::shared_ptr<ResourceContext const>> resources_;
+    std::unordered_map<std::string, std::shared_ptr<ScopeContext const>> scopes_;
+    std::unordered_map<std::string, std::shared_ptr<opentelemetry::proto::metrics::v1::Metric const>> metrics_;
+    std::string ignoredResourceAttributesConfig_;
+    std::unordered_set<std::string> ignoredResourceAttributes_;
+    Statistics statistics_;
+};
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "CommonUtils.h"
+#include "LoggerInterface.h"
+#include "transport/HttpTransportAsyncInterface.h"
+
+#include "opentelemetry/proto/collector/metrics/v1/metrics_service.pb.h"
+#include "opentelemetry/proto/collector/trace/v1/trace_service.pb.h"
+#include "opentelemetry/proto/common/v1/common.pb.h"
+#include "opentelemetry/proto/resource/v1/resource.pb.h"
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Helpers shared by coordinator pipeline stages which decode OTLP export requests and build their own
+namespace opentelemetry::php::coordinator {
+
+// length prefixed, so concatenated parts can't be confused
+inline void appendKeyPart(std::string &key, std::string_view part) {
+    key.append(std::to_string(part.size()));
+    key.push_back(':');
+    key.append(part);
+}
+
+// comma separated list of configuration option, items are trimmed and empty items are skipped
+inline std::vector<std::string> splitList(std::string_view list) {
+    std::vector<std::string> items;
+    for (auto item : std::views::split(list, ',')) {
+        auto name = opentelemetry::utils::trim(std::string_view(item.begin(), item.end()));
+        if (!name.empty()) {
+            items.emplace_back(name);
+        }
+    }
+    return items;
+}
+
+// resource and scope of received telemetry, shared by everything a stage holds of them
+struct ResourceContext {
+    opentelemetry::proto::resource::v1::Resource resource;
+    std::string schemaUrl;
+};
+
+struct ScopeContext {
+    opentelemetry::proto::common::v1::InstrumentationScope scope;
+    std::string schemaUrl;
+};
+
+inline opentelemetry::proto::trace::v1::ResourceSpans *addResourceEntry(opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest &request) {
+    return request.add_resource_spans();
+}
+
+inline opentelemetry::proto::metrics::v1::ResourceMetrics *addResourceEntry(opentelemetry::proto::collector::metrics::v1::ExportMetricsServiceRequest &request) {
+    return request.add_resource_metrics();
+}
+
+inline opentelemetry::proto::trace::v1::ScopeSpans *addScopeEntry(opentelemetry::proto::trace::v1::ResourceSpans &resource) {
+    return resource.add_scope_spans();
+}
+
+inline opentelemetry::proto::metrics::v1::ScopeMetrics *addScopeEntry(opentelemetry::proto::metrics::v1::ResourceMetrics &resource) {
+    return resource.add_scope_metrics();
+}
+
+// Builds export request from telemetry held by stage, telemetry of the same resource and scope context is grouped in one entry. Contexts are identified by address
+template <typename Request>
+class ExportRequestBuilder {
+public:
+    using resource_entry_t = std::remove_pointer_t<decltype(addResourceEntry(std::declval<Request &>()))>;
+    using scope_entry_t = std::remove_pointer_t<decltype(addScopeEntry(std::declval<resource_entry_t &>()))>;
+
+    // entry of scope is created with entry of its resource on first use
+    scope_entry_t &getScope(ResourceContext const &resource, ScopeContext const &scope) {
+        auto [resourceEntry, resourceInserted] = resources_.try_emplace(&resource, nullptr);
+        if (resourceInserted) {
+            resourceEntry->second = addResourceEntry(request_);
+            *resourceEntry->second->mutable_resource() = resource.resource;
+            resourceEntry->second->set_schema_url(resource.schemaUrl);
+        }
+        auto [scopeEntry, scopeInserted] = scopes_.try_emplace({&resource, &scope}, nullptr);
+        if (scopeInserted) {
+            scopeEntry->second = addScopeEntry(*resourceEntry->second);
+            *scopeEntry->second->mutable_scope() = scope.scope;
+            scopeEntry->second->set_schema_url(scope.schemaUrl);
+        }
+        return *scopeEntry->second;
+    }
+
+    bool empty() const {
+        return resources_.empty();
+    }
+
+    Request &getRequest() {
+        return request_;
+    }
+
+private:
+    Request request_;
+    std::unordered_map<ResourceContext const *, resource_entry_t *> resources_;
+    std::map<std::pair<ResourceContext const *, ScopeContext const *>, scope_entry_t *> scopes_;
+};
+
+// serializes export request built by stage and passes it to next stage as payload of endpoint
+template <typename Request>
+void sendExportRequest(std::shared_ptr<LoggerInterface> const &logger, transport::HttpTransportAsyncInterface &next, std::string_view stageName, std::size_t endpointHash, Request const &request) {
+    std::string serialized;
+    if (!request.SerializeToString(&serialized)) {
+        ELOG_ERROR(logger, COORDINATOR, "{}: unable to serialize export request of endpoint {}", stageName, endpointHash);
+        return;
+    }
+    ELOG_TRACE(logger, COORDINATOR, "{}: sending export request to endpoint {}, size {}", stageName, endpointHash, serialized.size());
+    next.enqueue(endpointHash, transport::PayloadBuffer::adopt(std::move(serialized)));
+}
+
+} // namespace opentelemetry::php::coordinator
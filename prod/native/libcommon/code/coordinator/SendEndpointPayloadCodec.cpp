@@ -0,0 +1,27 @@
+#include "SendEndpointPayloadCodec.h"
+
+#include <cstring>
+
+namespace opentelemetry::php::coordinator {
+
+std::span<std::byte const> SendEndpointPayloadCodec::encodeHeader(header_t &header, uint64_t endpointHash, std::size_t payloadSize) {
+    FrameHeader frameHeader{magic, 0, endpointHash, payloadSize};
+    std::memcpy(header.data(), &frameHeader, sizeof(frameHeader));
+    return header;
+}
+
+std::optional<SendEndpointPayloadCodec::Decoded> SendEndpointPayloadCodec::decode(transport::PayloadBuffer const &message) {
+    if (message.size() < headerSize) {
+        return std::nullopt;
+    }
+
+    FrameHeader frameHeader;
+    std::memcpy(&frameHeader, message.data(), sizeof(frameHeader));
+    if (frameHeader.magic != magic || frameHeader.payloadSize != message.size() - headerSize) {
+        return std::nullopt;
+    }
+
+    return Decoded{frameHeader.endpointHash, message.subbuffer(headerSize, frameHeader.payloadSize)};
+}
+
+} // namespace opentelemetry::php::coordinator
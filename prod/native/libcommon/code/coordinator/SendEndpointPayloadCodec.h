@@ -0,0 +1,44 @@
+#pragma once
+
+#include "transport/PayloadBuffer.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace opentelemetry::php::coordinator {
+
+// Binary framing of payloads sent by workers to coordinator, used instead of SEND_ENDPOINT_PAYLOAD CoordinatorCommand. Frame is a fixed size header
+// followed by raw payload bytes, so sender passes payload to ChunkedMessageProcessor as separate segment and receiver references payload inside received message buffer
+// without parsing. Header starts with zero byte, which is never a valid protobuf tag, so frames and protobuf encoded control commands can't be confused.
+// Workers and coordinator run the same binary, native byte order is used
+class SendEndpointPayloadCodec {
+public:
+    static constexpr std::array<std::byte, 4> magic{std::byte{0x00}, std::byte{'O'}, std::byte{'T'}, std::byte{'P'}};
+
+    struct FrameHeader {
+        std::array<std::byte, 4> magic;
+        uint32_t reserved;
+        uint64_t endpointHash;
+        uint64_t payloadSize;
+    };
+    static_assert(sizeof(FrameHeader) == 24);
+
+    static constexpr std::size_t headerSize = sizeof(FrameHeader);
+    using header_t = std::array<std::byte, headerSize>;
+
+    struct Decoded {
+        uint64_t endpointHash = 0;
+        transport::PayloadBuffer payload;
+    };
+
+    // returns header which has to be sent before payload
+    static std::span<std::byte const> encodeHeader(header_t &header, uint64_t endpointHash, std::size_t payloadSize);
+
+    // returns std::nullopt if message is not payload frame. Returned payload shares message storage
+    static std::optional<Decoded> decode(transport::PayloadBuffer const &message);
+};
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace opentelemetry::php::coordinator {
+
+// futex word lives in memory shared between processes, so private futex operations (used also by std::atomic::wait) can't be used.
+// Unlike process shared mutex, nothing is left locked when process dies while waiting or waking
+inline void futexWait(std::atomic<uint32_t> *word, uint32_t expected, std::chrono::nanoseconds timeout) {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word has to be plain 32 bit integer");
+    struct timespec ts;
+    ts.tv_sec = std::chrono::duration_cast<std::chrono::seconds>(timeout).count();
+    ts.tv_nsec = (timeout - std::chrono::seconds(ts.tv_sec)).count();
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+inline void futexWake(std::atomic<uint32_t> *word, int waiters = 1) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE, waiters, nullptr, nullptr, 0);
+}
+
+inline void futexWakeAll(std::atomic<uint32_t> *word) {
+    futexWake(word, INT_MAX);
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,243 @@
+#include "SpanMetricsStage.h"
+#include "transport/OtlpEndpoint.h"
+
+#include "opentelemetry/proto/collector/trace/v1/trace_service.pb.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::coordinator {
+
+using opentelemetry::proto::collector::metrics::v1::ExportMetricsServiceRequest;
+using opentelemetry::proto::common::v1::KeyValue;
+using opentelemetry::proto::trace::v1::Span;
+using opentelemetry::proto::trace::v1::Status;
+
+namespace {
+
+KeyValue makeAttribute(std::string_view key, std::string_view value) {
+    KeyValue attribute;
+    attribute.set_key(std::string(key));
+    attribute.mutable_value()->set_string_value(std::string(value));
+    return attribute;
+}
+
+uint64_t getUnixTimeNano() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+void SpanMetricsStage::initializeConnection(std::string endpointUrl, std::size_t endpointHash, std::string contentType, enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, transport::HttpEndpointSSLOptions sslOptions, transport::PayloadCompression compression) {
+    auto signal = transport::getEndpointSignal(endpointUrl);
+    if (signal == "metrics"sv && transport::isOtlpProtobufEndpoint(signal, contentType)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        metricsEndpointHash_ = endpointHash;
+    }
+    CoordinatorPipelineStage::initializeConnection(std::move(endpointUrl), endpointHash, std::move(contentType), endpointHeaders, timeout, maxRetries, retryDelay, std::move(sslOptions), compression);
+}
+
+void SpanMetricsStage::processPayload(std::size_t endpointHash, transport::PayloadBuffer payload) {
+    if (!config_->get()->coordinator_span_metrics_enabled) {
+        next_->enqueue(endpointHash, std::move(payload));
+        return;
+    }
+
+    opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest request;
+    if (!request.ParseFromArray(payload.data(), static_cast<int>(payload.size()))) {
+        ELOG_WARNING(logger_, COORDINATOR, "SpanMetricsStage: unable to parse trace export request of endpoint {}, size {}", endpointHash, payload.size());
+        next_->enqueue(endpointHash, std::move(payload));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        updateConfiguration();
+
+        for (auto const &resourceSpans : request.resource_spans()) {
+            std::shared_ptr<ResourceContext const> resourceContext;
+            std::string resourceKey;
+
+            for (auto const &scopeSpans : resourceSpans.scope_spans()) {
+                for (auto const &span : scopeSpans.spans()) {
+                    if (span.kind() != Span::SPAN_KIND_SERVER && span.kind() != Span::SPAN_KIND_CLIENT) {
+                        continue;
+                    }
+
+                    if (!resourceContext) {
+                        ResourceContext context{resourceSpans.resource(), resourceSpans.schema_url()};
+                        auto attributes = context.resource.mutable_attributes();
+                        attributes->erase(std::remove_if(attributes->begin(), attributes->end(), [this](auto const &attribute) { return ignoredResourceAttributes_.contains(attribute.key()); }), attributes->end());
+                        appendKeyPart(resourceKey, context.resource.SerializeAsString());
+                        appendKeyPart(resourceKey, context.schemaUrl);
+                        // resource is registered only together with its first stream, so spans rejected by streams limit don't grow resources
+                        auto resource = resources_.find(resourceKey);
+                        resourceContext = resource != resources_.end() ? resource->second : std::make_shared<ResourceContext const>(std::move(context));
+                    }
+
+                    std::vector<KeyValue> attributes{makeAttribute("span.name"sv, span.name()), makeAttribute("span.kind"sv, Span::SpanKind_Name(span.kind())), makeAttribute("status.code"sv, Status::StatusCode_Name(span.status().code()))};
+                    for (auto const &dimension : dimensions_) {
+                        auto found = std::ranges::find_if(span.attributes(), [&dimension](auto const &attribute) { return attribute.key() == dimension; });
+                        if (found != span.attributes().end()) {
+                            attributes.push_back(*found);
+                        }
+                    }
+
+                    std::string streamKey = resourceKey;
+                    for (auto const &attribute : attributes) {
+                        appendKeyPart(streamKey, attribute.SerializeAsString());
+                    }
+
+                    auto stream = streams_.find(streamKey);
+                    if (stream == streams_.end()) {
+                        if (streams_.size() >= maxStreams) {
+                            continue;
+                        }
+                        resources_.try_emplace(resourceKey, resourceContext);
+                        stream = streams_.emplace(std::move(streamKey), Stream{resourceContext, std::move(attributes), getUnixTimeNano()}).first;
+                    }
+
+                    double duration = span.end_time_unix_nano() > span.start_time_unix_nano() ? static_cast<double>(span.end_time_unix_nano() - span.start_time_unix_nano()) / 1'000'000.0 : 0;
+                    auto &s = stream->second;
+                    s.durationMin = s.calls == 0 ? duration : std::min(s.durationMin, duration);
+                    s.durationMax = s.calls == 0 ? duration : std::max(s.durationMax, duration);
+                    s.calls++;
+                    s.durationSum += duration;
+                    s.bucketCounts[std::distance(durationBounds.begin(), std::ranges::lower_bound(durationBounds, duration))]++;
+                    s.updated = true;
+                    s.idleIntervals = 0;
+                }
+            }
+        }
+    }
+
+    next_->enqueue(endpointHash, std::move(payload));
+}
+
+void SpanMetricsStage::onTimer(time_point_t now) {
+    std::optional<std::pair<std::size_t, ExportMetricsServiceRequest>> request;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (now - lastExportTime_ < config_->get()->coordinator_span_metrics_interval) {
+            return;
+        }
+        lastExportTime_ = now;
+        request = collect();
+        evictIdleStreams();
+    }
+    send(std::move(request));
+}
+
+void SpanMetricsStage::onFlush() {
+    std::optional<std::pair<std::size_t, ExportMetricsServiceRequest>> request;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        request = collect();
+    }
+    send(std::move(request));
+}
+
+std::optional<std::pair<std::size_t, ExportMetricsServiceRequest>> SpanMetricsStage::collect() {
+    if (!metricsEndpointHash_.has_value()) {
+        if (!streams_.empty()) {
+            ELOG_DEBUG(logger_, COORDINATOR, "SpanMetricsStage: no OTLP protobuf metrics endpoint established yet, {} span metrics streams kept", streams_.size());
+        }
+        return std::nullopt;
+    }
+
+    using namespace opentelemetry::proto::metrics::v1;
+    static ScopeContext const spanMetricsScope = []() {
+        ScopeContext scope;
+        scope.scope.set_name(std::string(scopeName));
+        return scope;
+    }();
+    ExportRequestBuilder<ExportMetricsServiceRequest> builder;
+
+    auto now = getUnixTimeNano();
+    for (auto &[key, stream] : streams_) {
+        if (!stream.updated) {
+            continue;
+        }
+        stream.updated = false;
+
+        auto &scopeMetrics = builder.getScope(*stream.resource, spanMetricsScope);
+        if (scopeMetrics.metrics_size() == 0) {
+            auto calls = scopeMetrics.add_metrics();
+            calls->set_name(std::string(callsMetricName));
+            calls->set_unit("{call}");
+            calls->mutable_sum()->set_aggregation_temporality(AggregationTemporality::AGGREGATION_TEMPORALITY_CUMULATIVE);
+            calls->mutable_sum()->set_is_monotonic(true);
+
+            auto duration = scopeMetrics.add_metrics();
+            duration->set_name(std::string(durationMetricName));
+            duration->set_unit("ms");
+            duration->mutable_histogram()->set_aggregation_temporality(AggregationTemporality::AGGREGATION_TEMPORALITY_CUMULATIVE);
+        }
+
+        auto callsPoint = scopeMetrics.mutable_metrics(0)->mutable_sum()->add_data_points();
+        auto durationPoint = scopeMetrics.mutable_metrics(1)->mutable_histogram()->add_data_points();
+        for (auto const &attribute : stream.attributes) {
+            *callsPoint->add_attributes() = attribute;
+            *durationPoint->add_attributes() = attribute;
+        }
+        callsPoint->set_start_time_unix_nano(stream.startTimeUnixNano);
+        callsPoint->set_time_unix_nano(now);
+        callsPoint->set_as_int(static_cast<int64_t>(stream.calls));
+
+        durationPoint->set_start_time_unix_nano(stream.startTimeUnixNano);
+        durationPoint->set_time_unix_nano(now);
+        durationPoint->set_count(stream.calls);
+        durationPoint->set_sum(stream.durationSum);
+        durationPoint->set_min(stream.durationMin);
+        durationPoint->set_max(stream.durationMax);
+        durationPoint->mutable_explicit_bounds()->Add(durationBounds.begin(), durationBounds.end());
+        durationPoint->mutable_bucket_counts()->Add(stream.bucketCounts.begin(), stream.bucketCounts.end());
+    }
+
+    if (builder.empty()) {
+        return std::nullopt;
+    }
+    return std::pair{*metricsEndpointHash_, std::move(builder.getRequest())};
+}
+
+// request is serialized outside of stage lock
+void SpanMetricsStage::send(std::optional<std::pair<std::size_t, ExportMetricsServiceRequest>> request) {
+    if (request.has_value()) {
+        sendExportRequest(logger_, *next_, "SpanMetricsStage"sv, request->first, request->second);
+    }
+}
+
+void SpanMetricsStage::evictIdleStreams() {
+    // streams not exported yet, e.g. while there is no metrics endpoint, are kept
+    std::size_t evicted = 0;
+    for (auto stream = streams_.begin(); stream != streams_.end();) {
+        if (!stream->second.updated && ++stream->second.idleIntervals > streamIdleIntervals) {
+            stream = streams_.erase(stream);
+            evicted++;
+        } else {
+            ++stream;
+        }
+    }
+    if (evicted == 0) {
+        return;
+    }
+    std::erase_if(resources_, [](auto const &entry) { return entry.second.use_count() == 1; });
+    ELOG_DEBUG(logger_, COORDINATOR, "SpanMetricsStage: evicted {} idle span metrics streams, {} streams and {} resources left", evicted, streams_.size(), resources_.size());
+}
+
+void SpanMetricsStage::updateConfiguration() {
+    auto config = config_->get();
+    if (dimensionsConfig_ != config->coordinator_span_metrics_dimensions) {
+        dimensionsConfig_ = config->coordinator_span_metrics_dimensions;
+        dimensions_ = splitList(dimensionsConfig_);
+    }
+    if (ignoredResourceAttributesConfig_ != config->coordinator_metrics_aggregation_ignored_resource_attributes) {
+        ignoredResourceAttributesConfig_ = config->coordinator_metrics_aggregation_ignored_resource_attributes;
+        auto attributes = splitList(ignoredResourceAttributesConfig_);
+        ignoredResourceAttributes_ = {attributes.begin(), attributes.end()};
+    }
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ConfigurationStorage.h"
+#include "CoordinatorPipelineStage.h"
+#include "PipelineStageUtils.h"
+
+#include "opentelemetry/proto/collector/metrics/v1/metrics_service.pb.h"
+#include "opentelemetry/proto/common/v1/common.pb.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace opentelemetry::php::coordinator {
+
+// Derives request rate, error rate and duration (RED) metrics from server and client spans of all workers. Spans are counted before they are sampled,
+// so metrics stay accurate when traces are sampled aggressively. Trace payloads are passed on unchanged.
+// Streams are grouped by resource, span name, span kind, status code and configured span attributes and exported as cumulative OTLP metrics
+// to the metrics endpoint established most recently by workers. Streams which weren't updated for streamIdleIntervals export intervals are dropped with their resources
+class SpanMetricsStage : public CoordinatorPipelineStage {
+public:
+    static constexpr std::size_t maxStreams = 16 * 1024;
+    static constexpr std::size_t streamIdleIntervals = 10;
+    static constexpr std::string_view scopeName = "opentelemetry.php.coordinator.span_metrics";
+    static constexpr std::string_view callsMetricName = "traces.span.metrics.calls";
+    static constexpr std::string_view durationMetricName = "traces.span.metrics.duration";
+    // milliseconds
+    static constexpr std::array<double, 16> durationBounds{2, 4, 6, 8, 10, 50, 100, 200, 400, 800, 1000, 1400, 2000, 5000, 10000, 15000};
+
+    SpanMetricsStage(std::shared_ptr<LoggerInterface> logger, std::shared_ptr<ConfigurationStorage> config, std::shared_ptr<transport::HttpTransportAsyncInterface> next) : CoordinatorPipelineStage(std::move(logger), std::move(next), "traces"), config_(std::move(config)) {
+    }
+
+    void initializeConnection(std::string endpointUrl, std::size_t endpointHash, std::string contentType, enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, transport::HttpEndpointSSLOptions sslOptions, transport::PayloadCompression compression) override;
+
+    std::size_t getStreamsCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return streams_.size();
+    }
+
+    std::size_t getResourcesCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return resources_.size();
+    }
+
+protected:
+    struct Stream {
+        std::shared_ptr<ResourceContext const> resource;
+        std::vector<opentelemetry::proto::common::v1::KeyValue> attributes;
+        uint64_t startTimeUnixNano = 0;
+        uint64_t calls = 0;
+        double durationSum = 0; // milliseconds
+        double durationMin = 0;
+        double durationMax = 0;
+        std::array<uint64_t, durationBounds.size() + 1> bucketCounts{};
+        bool updated = false; // since last export
+        std::size_t idleIntervals = 0; // export intervals since last update
+    };
+
+    void processPayload(std::size_t endpointHash, transport::PayloadBuffer payload) override;
+    void onTimer(time_point_t now) override;
+    void onFlush() override;
+
+    // builds export request of updated streams for metrics endpoint. Called with mutex locked
+    std::optional<std::pair<std::size_t, opentelemetry::proto::collector::metrics::v1::ExportMetricsServiceRequest>> collect();
+    void send(std::optional<std::pair<std::size_t, opentelemetry::proto::collector::metrics::v1::ExportMetricsServiceRequest>> request);
+    // drops exported streams idle for too long and resources no stream refers to. Called with mutex locked
+    void evictIdleStreams();
+    void updateConfiguration();
+
+    std::shared_ptr<ConfigurationStorage> config_;
+
+    mutable std::mutex mutex_;
+    std::optional<std::size_t> metricsEndpointHash_;
+    time_point_t lastExportTime_ = std::chrono::steady_clock::now();
+    std::unordered_map<std::string, Stream> streams_;
+    std::unordered_map<std::string, std::shared_ptr<ResourceContext const>> resources_; // shared by streams of the same resource
+    std::string dimensionsConfig_;
+    std::vector<std::string> dimensions_;
+    std::string ignoredResourceAttributesConfig_;
+    std::unordered_set<std::string> ignoredResourceAttributes_;
+};
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,193 @@
+#include "TailSamplingStage.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::coordinator {
+
+using opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest;
+
+namespace {
+// buffered span is accounted with its serialized size and fixed overhead of containers holding it
+constexpr std::size_t spanOverhead = sizeof(opentelemetry::proto::trace::v1::Span) + 2 * sizeof(void *);
+// once memory limit is exceeded, traces are decided until buffer drops below this part of limit, to not repeat it for every payload
+constexpr std::size_t memoryLimitTargetPercent = 90;
+} // namespace
+
+void TailSamplingStage::processPayload(std::size_t endpointHash, transport::PayloadBuffer payload) {
+    if (!config_->get()->coordinator_tail_sampling_enabled) {
+        next_->enqueue(endpointHash, std::move(payload));
+        return;
+    }
+
+    ExportTraceServiceRequest request;
+    if (!request.ParseFromArray(payload.data(), static_cast<int>(payload.size()))) {
+        ELOG_WARNING(logger_, COORDINATOR, "TailSamplingStage: unable to parse trace export request of endpoint {}, size {}. Sending it unsampled", endpointHash, payload.size());
+        next_->enqueue(endpointHash, std::move(payload));
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto latencyThreshold = std::chrono::duration_cast<std::chrono::nanoseconds>(config_->get()->coordinator_tail_sampling_latency_threshold).count();
+    std::vector<BufferedSpan> output;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &resourceSpans : *request.mutable_resource_spans()) {
+            auto resource = std::make_shared<ResourceContext>(ResourceContext{std::move(*resourceSpans.mutable_resource()), std::move(*resourceSpans.mutable_schema_url())});
+            for (auto &scopeSpans : *resourceSpans.mutable_scope_spans()) {
+                auto scope = std::make_shared<ScopeContext>(ScopeContext{std::move(*scopeSpans.mutable_scope()), std::move(*scopeSpans.mutable_schema_url())});
+                for (auto &span : *scopeSpans.mutable_spans()) {
+                    if (auto decision = decisions_.find(span.trace_id()); decision != decisions_.end()) {
+                        statistics_.lateSpans++;
+                        if (decision->second) {
+                            output.emplace_back(BufferedSpan{endpointHash, resource, scope, std::move(span)});
+                        }
+                        continue;
+                    }
+
+                    auto [trace, inserted] = traces_.try_emplace(span.trace_id());
+                    if (inserted) {
+                        trace->second.firstSpanTime = now;
+                    }
+                    trace->second.error = trace->second.error || span.status().code() == opentelemetry::proto::trace::v1::Status::STATUS_CODE_ERROR;
+                    trace->second.slow = trace->second.slow || (latencyThreshold > 0 && span.end_time_unix_nano() >= span.start_time_unix_nano() && span.end_time_unix_nano() - span.start_time_unix_nano() >= static_cast<uint64_t>(latencyThreshold));
+
+                    std::size_t spanBytes = span.ByteSizeLong() + spanOverhead;
+                    trace->second.bytes += spanBytes;
+                    bufferedBytes_ += spanBytes;
+                    trace->second.spans.emplace_back(BufferedSpan{endpointHash, resource, scope, std::move(span)});
+                }
+            }
+        }
+
+        if (bufferedBytes_ > config_->get()->coordinator_tail_sampling_max_memory) {
+            decideOverMemoryLimit(output);
+        }
+    }
+
+    send(std::move(output));
+}
+
+void TailSamplingStage::onTimer(time_point_t now) {
+    std::vector<BufferedSpan> output;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (traces_.empty()) {
+            return;
+        }
+
+        // sampling was disabled in the meantime, nothing buffered is lost
+        auto config = config_->get();
+        bool enabled = config->coordinator_tail_sampling_enabled;
+        auto decisionWait = config->coordinator_tail_sampling_decision_wait;
+        for (auto trace = traces_.begin(); trace != traces_.end();) {
+            if (!enabled) {
+                std::ranges::move(trace->second.spans, std::back_inserter(output));
+                bufferedBytes_ -= trace->second.bytes;
+                trace = traces_.erase(trace);
+            } else if (now - trace->second.firstSpanTime >= decisionWait) {
+                decide(trace++, output);
+            } else {
+                ++trace;
+            }
+        }
+    }
+
+    send(std::move(output));
+}
+
+void TailSamplingStage::onFlush() {
+    std::vector<BufferedSpan> output;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ELOG_DEBUG(logger_, COORDINATOR, "TailSamplingStage: flush, deciding {} buffered traces", traces_.size());
+        while (!traces_.empty()) {
+            decide(traces_.begin(), output);
+        }
+    }
+    send(std::move(output));
+}
+
+void TailSamplingStage::decide(traces_t::iterator trace, std::vector<BufferedSpan> &output) {
+    bool keep = shouldKeep(trace->first, trace->second);
+    if (keep) {
+        statistics_.tracesKept++;
+        std::ranges::move(trace->second.spans, std::back_inserter(output));
+    } else {
+        statistics_.tracesDropped++;
+    }
+    bufferedBytes_ -= trace->second.bytes;
+
+    auto node = traces_.extract(trace);
+    rememberDecision(std::move(node.key()), keep);
+}
+
+bool TailSamplingStage::shouldKeep(std::string const &traceId, BufferedTrace const &trace) const {
+    if (trace.error || trace.slow) {
+        return true;
+    }
+
+    std::size_t percentage = std::min<std::size_t>(config_->get()->coordinator_tail_sampling_percentage, 100);
+    if (percentage == 0 || traceId.size() < 8) {
+        return percentage == 100;
+    }
+
+    // rightmost bytes of W3C trace id are random, so the same trace is decided the same way by every sampler using trace id
+    uint64_t random = 0;
+    for (auto byte : std::string_view(traceId).substr(traceId.size() - 8)) {
+        random = (random << 8) | static_cast<uint8_t>(byte);
+    }
+    return random % 100 < percentage;
+}
+
+void TailSamplingStage::rememberDecision(std::string traceId, bool keep) {
+    if (decisionsOrder_.size() >= maxRememberedDecisions) {
+        decisions_.erase(decisionsOrder_.front());
+        decisionsOrder_.pop_front();
+    }
+    decisionsOrder_.push_back(traceId);
+    decisions_.insert_or_assign(std::move(traceId), keep);
+}
+
+void TailSamplingStage::decideOverMemoryLimit(std::vector<BufferedSpan> &output) {
+    std::vector<traces_t::iterator> candidates;
+    candidates.reserve(traces_.size());
+    for (auto trace = traces_.begin(); trace != traces_.end(); ++trace) {
+        candidates.push_back(trace);
+    }
+    std::ranges::sort(candidates, [](auto const &a, auto const &b) { return std::tuple(a->second.getPriority(), a->second.firstSpanTime) < std::tuple(b->second.getPriority(), b->second.firstSpanTime); });
+
+    auto limit = config_->get()->coordinator_tail_sampling_max_memory;
+    auto target = limit * memoryLimitTargetPercent / 100;
+    std::size_t decided = 0;
+    for (auto trace : candidates) {
+        if (bufferedBytes_ <= target) {
+            break;
+        }
+        decide(trace, output);
+        decided++;
+    }
+    statistics_.tracesDecidedEarly += decided;
+    ELOG_DEBUG(logger_, COORDINATOR, "TailSamplingStage: buffered spans exceeded {} bytes, {} traces decided early, {} traces still buffered", limit, decided, traces_.size());
+}
+
+void TailSamplingStage::send(std::vector<BufferedSpan> spans) {
+    if (spans.empty()) {
+        return;
+    }
+
+    std::map<std::size_t, ExportRequestBuilder<ExportTraceServiceRequest>> requests;
+    for (auto &span : spans) {
+        *requests[span.endpointHash].getScope(*span.resource, *span.scope).add_spans() = std::move(span.span);
+    }
+
+    for (auto &[endpointHash, request] : requests) {
+        sendExportRequest(logger_, *next_, "TailSamplingStage"sv, endpointHash, request.getRequest());
+    }
+}
+
+} // namespace opentelemetry::php::coordinator
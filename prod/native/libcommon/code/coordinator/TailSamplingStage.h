@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ConfigurationStorage.h"
+#include "CoordinatorPipelineStage.h"
+#include "PipelineStageUtils.h"
+
+#include "opentelemetry/proto/trace/v1/trace.pb.h"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace opentelemetry::php::coordinator {
+
+// Tail-based sampling of traces exported by all workers. Spans of OTLP protobuf trace endpoints are buffered by trace id until decision wait of trace passes,
+// then whole trace is kept if any span has error status, if any span lasted at least latency threshold or if trace id falls into configured percentage.
+// When buffered spans exceed memory limit, decision is made early - traces without error and slow spans first, oldest first.
+// Decisions are remembered for a while, so spans received after decision follow it
+class TailSamplingStage : public CoordinatorPipelineStage {
+public:
+    static constexpr std::size_t maxRememberedDecisions = 64 * 1024;
+
+    struct Statistics {
+        uint64_t tracesKept = 0;
+        uint64_t tracesDropped = 0;
+        uint64_t tracesDecidedEarly = 0; // decided before decision wait passed because of memory limit
+        uint64_t lateSpans = 0; // received after trace decision
+    };
+
+    TailSamplingStage(std::shared_ptr<LoggerInterface> logger, std::shared_ptr<ConfigurationStorage> config, std::shared_ptr<transport::HttpTransportAsyncInterface> next) : CoordinatorPipelineStage(std::move(logger), std::move(next), "traces"), config_(std::move(config)) {
+    }
+
+    Statistics getStatistics() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return statistics_;
+    }
+
+    std::size_t getBufferedBytes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return bufferedBytes_;
+    }
+
+protected:
+    // traces are decided early in order of priority, lowest first
+    enum class Priority { regular, slow, error };
+
+    struct BufferedSpan {
+        std::size_t endpointHash;
+        std::shared_ptr<ResourceContext const> resource;
+        std::shared_ptr<ScopeContext const> scope;
+        opentelemetry::proto::trace::v1::Span span;
+    };
+
+    struct BufferedTrace {
+        time_point_t firstSpanTime;
+        std::vector<BufferedSpan> spans;
+        std::size_t bytes = 0;
+        bool error = false;
+        bool slow = false;
+
+        Priority getPriority() const {
+            return error ? Priority::error : (slow ? Priority::slow : Priority::regular);
+        }
+    };
+
+    using traces_t = std::unordered_map<std::string, BufferedTrace>;
+
+    void processPayload(std::size_t endpointHash, transport::PayloadBuffer payload) override;
+    void onTimer(time_point_t now) override;
+    void onFlush() override;
+
+    // removes trace from buffer, spans of kept trace are moved to output
+    void decide(traces_t::iterator trace, std::vector<BufferedSpan> &output);
+    bool shouldKeep(std::string const &traceId, BufferedTrace const &trace) const;
+    void rememberDecision(std::string traceId, bool keep);
+    void decideOverMemoryLimit(std::vector<BufferedSpan> &output);
+    // re-encodes spans into one export request per endpoint, spans of the same resource and scope are grouped
+    void send(std::vector<BufferedSpan> spans);
+
+    std::shared_ptr<ConfigurationStorage> config_;
+
+    mutable std::mutex mutex_;
+    traces_t traces_;
+    std::size_t bufferedBytes_ = 0;
+    std::unordered_map<std::string, bool> decisions_;
+    std::deque<std::string> decisionsOrder_;
+    Statistics statistics_;
+};
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,125 @@
+#include "WorkerRegistry.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace opentelemetry::php::coordinator {
+
+namespace {
+
+int openPidFd(pid_t processId) {
+#ifdef SYS_pidfd_open
+    return static_cast<int>(::syscall(SYS_pidfd_open, processId, 0));
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+} // namespace
+
+WorkerRegistry::WorkerRegistry(std::shared_ptr<LoggerInterface> logger) : logger_(std::move(logger)), epollFd_(::epoll_create1(EPOLL_CLOEXEC)) {
+    if (epollFd_ < 0) {
+        ELOG_WARNING(logger_, COORDINATOR, "WorkerRegistry: unable to create epoll instance, liveness of workers will be checked with signals. Error: {}", std::strerror(errno));
+    }
+}
+
+WorkerRegistry::~WorkerRegistry() {
+    for (auto const &[processId, pidFd] : workers_) {
+        if (pidFd >= 0) {
+            ::close(pidFd);
+        }
+    }
+    if (epollFd_ >= 0) {
+        ::close(epollFd_);
+    }
+}
+
+void WorkerRegistry::registerWorker(pid_t processId, pid_t parentProcessId) {
+    ELOG_DEBUG(logger_, COORDINATOR, "WorkerRegistry: registering worker with process id {} and parent process id {}", processId, parentProcessId);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (workers_.contains(processId)) {
+        return;
+    }
+
+    int pidFd = epollFd_ >= 0 ? openPidFd(processId) : -1;
+    if (pidFd < 0 && errno == ESRCH) {
+        ELOG_DEBUG(logger_, COORDINATOR, "WorkerRegistry: worker with process id {} exited before it was registered", processId);
+        exitedWorkers_.push_back(processId);
+        return;
+    }
+
+    if (pidFd >= 0) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = static_cast<uint64_t>(processId);
+        if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, pidFd, &event) != 0) {
+            ELOG_DEBUG(logger_, COORDINATOR, "WorkerRegistry: unable to watch worker with process id {}. Error: {}", processId, std::strerror(errno));
+            ::close(pidFd);
+            pidFd = -1;
+        }
+    }
+    workers_.emplace(processId, pidFd);
+}
+
+void WorkerRegistry::unregisterWorker(pid_t processId) {
+    ELOG_DEBUG(logger_, COORDINATOR, "WorkerRegistry: removing worker with process id {}", processId);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto worker = workers_.find(processId); worker != workers_.end()) {
+        removeWorker(worker);
+    }
+}
+
+std::vector<pid_t> WorkerRegistry::collectExitedWorkers() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<pid_t> exited;
+    exited.swap(exitedWorkers_);
+    if (epollFd_ < 0) {
+        return exited;
+    }
+
+    std::array<epoll_event, 64> events;
+    int count = 0;
+    do {
+        count = ::epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), 0);
+        for (int i = 0; i < count; ++i) {
+            auto processId = static_cast<pid_t>(events[i].data.u64);
+            if (auto worker = workers_.find(processId); worker != workers_.end()) {
+                ELOG_DEBUG(logger_, COORDINATOR, "WorkerRegistry: worker with process id {} exited, removing from registry", processId);
+                removeWorker(worker);
+                exited.push_back(processId);
+            }
+        }
+    } while (count == static_cast<int>(events.size()));
+    return exited;
+}
+
+std::vector<pid_t> WorkerRegistry::verifyWorkersAlive() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<pid_t> exited;
+    for (auto it = workers_.begin(); it != workers_.end();) {
+        auto worker = it++;
+        if (worker->second < 0 && ::kill(worker->first, 0) == -1 && errno == ESRCH) {
+            ELOG_DEBUG(logger_, COORDINATOR, "WorkerRegistry: worker with process id {} is not alive, removing from registry", worker->first);
+            exited.push_back(worker->first);
+            removeWorker(worker);
+        }
+    }
+    return exited;
+}
+
+// called with locked mutex
+void WorkerRegistry::removeWorker(std::unordered_map<pid_t, int>::iterator worker) {
+    if (worker->second >= 0) {
+        ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, worker->second, nullptr);
+        ::close(worker->second);
+    }
+    workers_.erase(worker);
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -3,47 +3,35 @@
 #include "LoggerInterface.h"
 #include <cstddef>
 #include <memory>
-#include <unordered_set>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <boost/noncopyable.hpp>
 #include <sys/types.h>
-#include <signal.h>
-#include <errno.h>
 
 namespace opentelemetry::php::coordinator {
 
-class WorkerRegistry {
+// Workers which announced themselves to coordinator. Every worker is watched through its pidfd, all pidfds are registered in single epoll instance,
+// so exited workers are found without a syscall per worker and reported as soon as coordinator polls. Workers which can't be watched
+// (kernel without pidfd support) are checked with kill(pid, 0)
+class WorkerRegistry : public boost::noncopyable {
 public:
-    WorkerRegistry(std::shared_ptr<LoggerInterface> logger) : logger_(std::move(logger)) {
-    }
+    WorkerRegistry(std::shared_ptr<LoggerInterface> logger);
+    ~WorkerRegistry();
 
-    void registerWorker(pid_t processId, pid_t parentProcessId) {
-        ELOG_DEBUG(logger_, COORDINATOR, "WorkerRegistry: registering worker with process id {} and parent process id {}", processId, parentProcessId);
-        std::lock_guard<std::mutex> lock(mutex_);
-        workers_.emplace(processId);
-    }
-
-    void unregisterWorker(pid_t processId) {
-        ELOG_DEBUG(logger_, COORDINATOR, "WorkerRegistry: removing worker with process id {}", processId);
-        std::lock_guard<std::mutex> lock(mutex_);
-        workers_.erase(processId);
-    }
+    void registerWorker(pid_t processId, pid_t parentProcessId);
+    void unregisterWorker(pid_t processId);
 
     bool hasWorker(pid_t processId) const {
         std::lock_guard<std::mutex> lock(mutex_);
         return workers_.find(processId) != workers_.end();
     }
 
-    void verifyWorkersAlive() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (auto it = workers_.begin(); it != workers_.end();) {
-            pid_t pid = *it;
-            if (kill(pid, 0) == -1 && errno == ESRCH) {
-                ELOG_DEBUG(logger_, COORDINATOR, "WorkerRegistry: worker with process id {} is not alive, removing from registry", pid);
-                it = workers_.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
+    // removes workers which exited since last call and returns their process ids. Doesn't block
+    std::vector<pid_t> collectExitedWorkers();
+
+    // removes workers which aren't watched through pidfd and don't exist anymore, returns their process ids
+    std::vector<pid_t> verifyWorkersAlive();
 
     std::size_t getWorkerCount() const {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -51,8 +39,12 @@ public:
     }
 
 private:
+    void removeWorker(std::unordered_map<pid_t, int>::iterator worker);
+
     std::shared_ptr<LoggerInterface> logger_;
-    std::unordered_set<pid_t> workers_;
+    std::unordered_map<pid_t, int> workers_; // process id, pidfd or -1 if worker isn't watched
+    std::vector<pid_t> exitedWorkers_;        // exited before they were watched
+    int epollFd_ = -1;
     mutable std::mutex mutex_;
 };
-}
\ No newline at end of file
+}
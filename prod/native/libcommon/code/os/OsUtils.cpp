@@ -1,4 +1,6 @@
 #include "OsUtils.h"
+#include <exception>
+#include <sstream>
 #include <string>
 
 #include <unistd.h>
@@ -68,4 +70,31 @@ pid_t getParentProcessId() {
 #endif
 }
 
+std::optional<uint64_t> getProcessStartTime(pid_t pid) {
+#ifdef _WINDOWS
+    return std::nullopt;
+#else
+    auto stat = getProcDataToString(("/proc/" + std::to_string(pid) + "/stat").c_str());
+    // process name in second field may contain spaces and parentheses, fields after it are plain numbers
+    auto nameEnd = stat.rfind(')');
+    if (nameEnd == std::string::npos) {
+        return std::nullopt;
+    }
+
+    std::istringstream fields(stat.substr(nameEnd + 1));
+    std::string field;
+    constexpr int startTimeField = 22;
+    for (int index = 3; index <= startTimeField; ++index) {
+        if (!(fields >> field)) {
+            return std::nullopt;
+        }
+    }
+    try {
+        return std::stoull(field);
+    } catch (std::exception const &) {
+        return std::nullopt;
+    }
+#endif
+}
+
 } // namespace opentelemetry::osutils
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <sys/types.h>
 
@@ -12,4 +14,7 @@ pid_t getCurrentProcessId();
 pid_t getCurrentThreadId();
 pid_t getParentProcessId();
 
+// start time of process in clock ticks since boot, nullopt if process doesn't exist. Together with pid identifies process even when pid gets reused
+std::optional<uint64_t> getProcessStartTime(pid_t pid);
+
 }
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace opentelemetry::php::transport {
+
+// Stops sending to an endpoint after consecutive failures. After cooldown single probe request is allowed (half-open) and its result decides if circuit closes or opens again
+class CircuitBreaker {
+public:
+    using clock_t = std::chrono::steady_clock;
+
+    enum class State {
+        closed,
+        open,
+        halfOpen
+    };
+
+    // threshold equal to 0 disables circuit breaker
+    CircuitBreaker(std::size_t threshold, std::chrono::milliseconds cooldown) : threshold_(threshold), cooldown_(cooldown) {
+    }
+
+    // returns true if request can be sent. Transition from open to half-open state takes one probe slot
+    bool tryAcquire(clock_t::time_point now) {
+        switch (state_) {
+            case State::closed:
+                return true;
+            case State::open:
+                if (now < openUntil_) {
+                    return false;
+                }
+                state_ = State::halfOpen;
+                probeInProgress_ = true;
+                return true;
+            case State::halfOpen:
+                if (probeInProgress_) {
+                    return false;
+                }
+                probeInProgress_ = true;
+                return true;
+        }
+        return false;
+    }
+
+    bool isOpen(clock_t::time_point now) const {
+        return state_ == State::open && now < openUntil_;
+    }
+
+    void onSuccess() {
+        state_ = State::closed;
+        consecutiveFailures_ = 0;
+        probeInProgress_ = false;
+    }
+
+    void onFailure(clock_t::time_point now) {
+        consecutiveFailures_++;
+        probeInProgress_ = false;
+        if (threshold_ == 0) {
+            return;
+        }
+        if (state_ == State::halfOpen || consecutiveFailures_ >= threshold_) {
+            state_ = State::open;
+            openUntil_ = now + cooldown_;
+        }
+    }
+
+    // request started with tryAcquire was dropped without result
+    void onAbandoned() {
+        probeInProgress_ = false;
+    }
+
+    State getState() const {
+        return state_;
+    }
+
+    clock_t::time_point getOpenUntil() const {
+        return openUntil_;
+    }
+
+    std::size_t getConsecutiveFailures() const {
+        return consecutiveFailures_;
+    }
+
+    void configure(std::size_t threshold, std::chrono::milliseconds cooldown) {
+        threshold_ = threshold;
+        cooldown_ = cooldown;
+    }
+
+private:
+    std::size_t threshold_ = 0;
+    std::chrono::milliseconds cooldown_;
+    State state_ = State::closed;
+    std::size_t consecutiveFailures_ = 0;
+    bool probeInProgress_ = false;
+    clock_t::time_point openUntil_{};
+};
+
+} // namespace opentelemetry::php::transport
@@ -0,0 +1,87 @@
+#include "CurlMultiSender.h"
+
+#include <stdexcept>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::transport {
+
+CurlMultiSender::CurlMultiSender(std::shared_ptr<LoggerInterface> logger) : log_(std::move(logger)) {
+    multiHandle_ = curl_multi_init();
+    if (!multiHandle_) {
+        throw std::runtime_error("curl_multi_init() failed");
+    }
+}
+
+CurlMultiSender::~CurlMultiSender() {
+    removeAllTransfers();
+    curl_multi_cleanup(multiHandle_);
+}
+
+void CurlMultiSender::addTransfer(CurlSender &sender, std::string const &endpointUrl, struct curl_slist *headers, std::span<std::byte const> payload, std::function<void(std::string_view)> *headerCallback, std::string *responseBuffer, completionCallback_t completionCallback) {
+    sender.prepareTransfer(endpointUrl, headers, payload, headerCallback, responseBuffer);
+
+    CURLMcode res = curl_multi_add_handle(multiHandle_, sender.getHandle());
+    if (res != CURLM_OK) {
+        std::string msg = "addTransfer failed: "s;
+        msg.append(curl_multi_strerror(res));
+        throw std::runtime_error(msg);
+    }
+    transfers_.insert_or_assign(sender.getHandle(), std::move(completionCallback));
+}
+
+void CurlMultiSender::perform(std::chrono::milliseconds maxWait) {
+    int running = 0;
+    curl_multi_perform(multiHandle_, &running);
+
+    CURLMcode res = curl_multi_poll(multiHandle_, nullptr, 0, static_cast<int>(maxWait.count()), nullptr);
+    if (res != CURLM_OK) {
+        ELOG_WARNING(log_, TRANSPORT, "CurlMultiSender::perform curl_multi_poll failed: {}", curl_multi_strerror(res));
+    }
+
+    curl_multi_perform(multiHandle_, &running);
+
+    int messagesLeft = 0;
+    while (CURLMsg *msg = curl_multi_info_read(multiHandle_, &messagesLeft)) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+
+        CURL *handle = msg->easy_handle;
+        CURLcode result = msg->data.result;
+
+        long responseCode = 0;
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
+        curl_multi_remove_handle(multiHandle_, handle);
+
+        auto transfer = transfers_.find(handle);
+        if (transfer == std::end(transfers_)) {
+            continue;
+        }
+
+        // callback can add next transfer for the same handle
+        auto completionCallback = std::move(transfer->second);
+        transfers_.erase(transfer);
+
+        if (result != CURLE_OK) {
+            std::string error = "sendPayload failed: "s;
+            error.append(curl_easy_strerror(result));
+            completionCallback(0, error);
+        } else {
+            completionCallback(static_cast<int16_t>(responseCode), {});
+        }
+    }
+}
+
+void CurlMultiSender::removeAllTransfers() {
+    for (auto const &transfer : transfers_) {
+        curl_multi_remove_handle(multiHandle_, transfer.first);
+    }
+    transfers_.clear();
+}
+
+void CurlMultiSender::wakeup() {
+    curl_multi_wakeup(multiHandle_);
+}
+
+} // namespace opentelemetry::php::transport
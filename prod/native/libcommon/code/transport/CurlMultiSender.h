@@ -0,0 +1,50 @@
+#pragma once
+
+#include "LoggerInterface.h"
+#include "CurlSender.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <curl/curl.h>
+
+#include <boost/noncopyable.hpp>
+
+namespace opentelemetry::php::transport {
+
+// Drives many CurlSender transfers concurrently from a single thread using curl multi interface
+class CurlMultiSender : public boost::noncopyable {
+public:
+    // error is empty when transfer finished on HTTP level, otherwise responseCode is 0 and error holds curl error description
+    using completionCallback_t = std::function<void(int16_t responseCode, std::string_view error)>;
+
+    CurlMultiSender(std::shared_ptr<LoggerInterface> logger);
+    ~CurlMultiSender();
+
+    // sender must not be used by any other transfer until completion callback is called. All pointers must stay valid until then
+    void addTransfer(CurlSender &sender, std::string const &endpointUrl, struct curl_slist *headers, std::span<std::byte const> payload, std::function<void(std::string_view)> *headerCallback, std::string *responseBuffer, completionCallback_t completionCallback);
+
+    // waits up to maxWait for network activity or wakeup() and calls completion callbacks of finished transfers
+    void perform(std::chrono::milliseconds maxWait);
+
+    // aborts all running transfers without calling completion callbacks
+    void removeAllTransfers();
+
+    // interrupts perform() waiting for activity - safe to call from any thread
+    void wakeup();
+
+    std::size_t getTransfersCount() const {
+        return transfers_.size();
+    }
+
+private:
+    std::shared_ptr<LoggerInterface> log_;
+    CURLM *multiHandle_ = nullptr;
+    std::unordered_map<CURL *, completionCallback_t> transfers_;
+};
+
+} // namespace opentelemetry::php::transport
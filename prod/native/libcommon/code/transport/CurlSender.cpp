@@ -35,7 +35,7 @@ static size_t CurlHeaderFunc(char *data, size_t size, size_t nItems, void *heade
     return size * nItems;
 }
 
-CurlSender::CurlSender(std::shared_ptr<LoggerInterface> logger, std::chrono::milliseconds timeout, HttpEndpointSSLOptions const &sslOptions) : log_(std::move(logger)) {
+CurlSender::CurlSender(std::shared_ptr<LoggerInterface> logger, std::chrono::milliseconds timeout, HttpEndpointSSLOptions const &sslOptions, bool http2, std::string const &unixSocketPath) : log_(std::move(logger)) {
 
     handle_ = curl_easy_init();
     if (!handle_) {
@@ -68,6 +68,16 @@ CurlSender::CurlSender(std::shared_ptr<LoggerInterface> logger, std::chrono::mil
     curl_easy_setopt(handle_, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout.count()));
     curl_easy_setopt(handle_, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(timeout.count()));
 
+    if (!unixSocketPath.empty()) {
+        curl_easy_setopt(handle_, CURLOPT_UNIX_SOCKET_PATH, unixSocketPath.c_str());
+    }
+
+    if (http2) {
+        curl_easy_setopt(handle_, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE));
+        // wait for existing connection to multiplex transfer over it instead of opening new one
+        curl_easy_setopt(handle_, CURLOPT_PIPEWAIT, 1L);
+    }
+
     curl_easy_setopt(handle_, CURLOPT_FOLLOWLOCATION, 1L);
     curl_easy_setopt(handle_, CURLOPT_FORBID_REUSE, 0L);
     curl_easy_setopt(handle_, CURLOPT_WRITEFUNCTION, CurlWriteFunc);
@@ -82,7 +92,7 @@ CurlSender::CurlSender(std::shared_ptr<LoggerInterface> logger, std::chrono::mil
     }
 }
 
-int16_t CurlSender::sendPayload(std::string const &endpointUrl, struct curl_slist *headers, std::vector<std::byte> const &payload, std::function<void(std::string_view)> headerCallback, std::string *responseBuffer) const {
+void CurlSender::prepareTransfer(std::string const &endpointUrl, struct curl_slist *headers, std::span<std::byte const> payload, std::function<void(std::string_view)> *headerCallback, std::string *responseBuffer) const {
     curl_easy_setopt(handle_, CURLOPT_URL, endpointUrl.c_str());
     curl_easy_setopt(handle_, CURLOPT_HTTPHEADER, headers);
 
@@ -90,17 +100,17 @@ int16_t CurlSender::sendPayload(std::string const &endpointUrl, struct curl_slis
     curl_easy_setopt(handle_, CURLOPT_POSTFIELDSIZE, payload.size());
     curl_easy_setopt(handle_, CURLOPT_POST, 1L);
 
-    if (responseBuffer) {
-        curl_easy_setopt(handle_, CURLOPT_WRITEDATA, responseBuffer);
-    } else {
-        curl_easy_setopt(handle_, CURLOPT_WRITEDATA, nullptr);
-    }
+    curl_easy_setopt(handle_, CURLOPT_WRITEDATA, responseBuffer);
 
-    if (!headerCallback) {
+    if (!headerCallback || !*headerCallback) {
         curl_easy_setopt(handle_, CURLOPT_HEADERDATA, nullptr);
     } else {
-        curl_easy_setopt(handle_, CURLOPT_HEADERDATA, &headerCallback);
+        curl_easy_setopt(handle_, CURLOPT_HEADERDATA, headerCallback);
     }
+}
+
+int16_t CurlSender::sendPayload(std::string const &endpointUrl, struct curl_slist *headers, std::span<std::byte const> payload, std::function<void(std::string_view)> headerCallback, std::string *responseBuffer) const {
+    prepareTransfer(endpointUrl, headers, payload, &headerCallback, responseBuffer);
 
     CURLcode res = curl_easy_perform(handle_);
     if (res != CURLE_OK) {
@@ -6,6 +6,7 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -17,7 +18,9 @@ namespace opentelemetry::php::transport {
 
 class CurlSender {
 public:
-    CurlSender(std::shared_ptr<LoggerInterface> logger, std::chrono::milliseconds timeout, HttpEndpointSSLOptions const &sslOptions);
+    // http2 - HTTP/2 without upgrade for plain text (h2c) and negotiated with ALPN for TLS connections, required by gRPC
+    // unixSocketPath - connect to AF_UNIX socket instead of host from URL
+    CurlSender(std::shared_ptr<LoggerInterface> logger, std::chrono::milliseconds timeout, HttpEndpointSSLOptions const &sslOptions, bool http2 = false, std::string const &unixSocketPath = {});
 
     CurlSender(CurlSender &&) = delete;
     CurlSender &operator=(CurlSender &&) = delete;
@@ -30,7 +33,14 @@ public:
         }
     }
 
-    int16_t sendPayload(std::string const &endpointUrl, struct curl_slist *headers, std::vector<std::byte> const &payload, std::function<void(std::string_view)> headerCallback, std::string *responseBuffer = nullptr) const;
+    int16_t sendPayload(std::string const &endpointUrl, struct curl_slist *headers, std::span<std::byte const> payload, std::function<void(std::string_view)> headerCallback, std::string *responseBuffer = nullptr) const;
+
+    // configures handle for the next transfer without performing it - used by CurlMultiSender. All pointers must stay valid until transfer is finished
+    void prepareTransfer(std::string const &endpointUrl, struct curl_slist *headers, std::span<std::byte const> payload, std::function<void(std::string_view)> *headerCallback, std::string *responseBuffer) const;
+
+    CURL *getHandle() const {
+        return handle_;
+    }
 
 private:
     CURL *handle_ = nullptr;
@@ -0,0 +1,364 @@
+#include "DiskSpillQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::transport {
+
+namespace {
+
+struct SegmentHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t reserved;
+};
+
+// record is complete when magic is set, it is stored with release order after payload and rest of header. Segment files are preallocated with zeros and never rewritten
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t state;
+    uint64_t endpointHash;
+    uint64_t size;
+};
+
+constexpr uint32_t segmentMagic = 0x4753544F; // "OTSG"
+constexpr uint32_t segmentVersion = 1;
+constexpr uint32_t recordMagic = 0x5053544F; // "OTSP"
+constexpr uint32_t statePending = 1;
+constexpr uint32_t stateConsumed = 2;
+
+constexpr std::string_view segmentPrefix = "segment-"sv;
+constexpr std::string_view segmentSuffix = ".spill"sv;
+
+constexpr std::size_t alignRecord(std::size_t size) {
+    return (size + 7) & ~static_cast<std::size_t>(7);
+}
+
+std::size_t getRecordSize(std::size_t payloadSize) {
+    return alignRecord(sizeof(RecordHeader) + payloadSize);
+}
+
+std::optional<uint64_t> parseSegmentId(std::string const &fileName) {
+    std::string_view name(fileName);
+    if (!name.starts_with(segmentPrefix) || !name.ends_with(segmentSuffix)) {
+        return std::nullopt;
+    }
+    name.remove_prefix(segmentPrefix.size());
+    name.remove_suffix(segmentSuffix.size());
+
+    uint64_t id = 0;
+    auto [ptr, ec] = std::from_chars(name.data(), name.data() + name.size(), id);
+    if (ec != std::errc{} || ptr != name.data() + name.size()) {
+        return std::nullopt;
+    }
+    return id;
+}
+
+uint32_t loadMagic(RecordHeader *header) {
+    return std::atomic_ref<uint32_t>(header->magic).load(std::memory_order_acquire);
+}
+
+std::string getErrorString() {
+    return std::system_category().message(errno);
+}
+
+} // namespace
+
+DiskSpillQueue::DiskSpillQueue(std::shared_ptr<LoggerInterface> log, std::filesystem::path directory, std::size_t maxSize, std::size_t segmentSize) : log_(std::move(log)), directory_(std::move(directory)), maxSize_(maxSize), segmentSize_(std::max(segmentSize, sizeof(SegmentHeader) + getRecordSize(0))) {
+    lockDirectory();
+    try {
+        recoverSegments();
+    } catch (std::filesystem::filesystem_error const &error) {
+        for (auto &[id, segment] : segments_) {
+            closeSegment(segment);
+        }
+        ::close(lockFd_);
+        throw std::runtime_error(std::format("DiskSpillQueue unable to read directory '{}': {}", directory_.string(), error.what()));
+    }
+}
+
+DiskSpillQueue::~DiskSpillQueue() {
+    for (auto &[id, segment] : segments_) {
+        closeSegment(segment);
+    }
+    if (lockFd_ >= 0) {
+        ::close(lockFd_);
+    }
+}
+
+void DiskSpillQueue::lockDirectory() {
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    if (error) {
+        throw std::runtime_error(std::format("DiskSpillQueue unable to create directory '{}': {}", directory_.string(), error.message()));
+    }
+
+    auto lockPath = directory_ / "lock";
+    lockFd_ = ::open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (lockFd_ < 0) {
+        throw std::runtime_error(std::format("DiskSpillQueue unable to open lock file '{}': {}", lockPath.string(), getErrorString()));
+    }
+    if (::flock(lockFd_, LOCK_EX | LOCK_NB) != 0) {
+        auto message = getErrorString();
+        ::close(lockFd_);
+        lockFd_ = -1;
+        throw std::runtime_error(std::format("DiskSpillQueue unable to lock directory '{}', it is probably used by another process: {}", directory_.string(), message));
+    }
+}
+
+void DiskSpillQueue::recoverSegments() {
+    std::vector<std::pair<uint64_t, std::filesystem::path>> files;
+    for (auto const &entry : std::filesystem::directory_iterator(directory_)) {
+        if (auto id = parseSegmentId(entry.path().filename().string()); id.has_value() && entry.is_regular_file()) {
+            files.emplace_back(id.value(), entry.path());
+        }
+    }
+    std::ranges::sort(files);
+
+    for (auto const &[id, path] : files) {
+        nextSegmentId_ = std::max(nextSegmentId_, id + 1);
+
+        Segment segment;
+        segment.path = path;
+        if (!mapSegment(segment, false)) {
+            ELOG_WARNING(log_, TRANSPORT, "DiskSpillQueue ignoring segment '{}', unable to map it: {}", path.string(), getErrorString());
+            continue;
+        }
+
+        auto const *segmentHeader = reinterpret_cast<SegmentHeader const *>(segment.data);
+        if (segment.capacity < sizeof(SegmentHeader) || segmentHeader->magic != segmentMagic || segmentHeader->version != segmentVersion) {
+            ELOG_WARNING(log_, TRANSPORT, "DiskSpillQueue ignoring segment '{}' of unknown format", path.string());
+            closeSegment(segment);
+            continue;
+        }
+
+        std::size_t offset = sizeof(SegmentHeader);
+        while (offset + sizeof(RecordHeader) <= segment.capacity) {
+            auto *header = reinterpret_cast<RecordHeader *>(segment.data + offset);
+            if (loadMagic(header) != recordMagic || header->size > segment.capacity - offset - sizeof(RecordHeader)) {
+                break;
+            }
+            if (header->state == statePending) {
+                pending_[header->endpointHash].push_back({id, offset, static_cast<std::size_t>(header->size)});
+                segment.pendingRecords++;
+            }
+            offset += getRecordSize(header->size);
+        }
+        segment.writeOffset = offset;
+
+        usedBytes_ += segment.capacity;
+        auto it = segments_.emplace(id, std::move(segment)).first;
+        if (it->second.pendingRecords == 0) {
+            removeSegment(it);
+        }
+    }
+
+    if (auto count = getPendingCount(); count > 0) {
+        ELOG_DEBUG(log_, TRANSPORT, "DiskSpillQueue recovered {} payloads from {} segments in '{}'", count, segments_.size(), directory_.string());
+    }
+}
+
+bool DiskSpillQueue::push(uint64_t endpointHash, std::span<std::byte const> payload) {
+    auto recordSize = getRecordSize(payload.size());
+
+    Segment *segment = nullptr;
+    if (activeSegmentId_.has_value()) {
+        auto &active = segments_.at(activeSegmentId_.value());
+        if (active.writeOffset + recordSize <= active.capacity) {
+            segment = &active;
+        }
+    }
+
+    if (!segment) {
+        auto capacity = std::max(segmentSize_, sizeof(SegmentHeader) + recordSize);
+        if (usedBytes_ + capacity > maxSize_) {
+            return false;
+        }
+        segment = createSegment(capacity);
+        if (!segment) {
+            return false;
+        }
+    }
+
+    auto *header = reinterpret_cast<RecordHeader *>(segment->data + segment->writeOffset);
+    if (!payload.empty()) {
+        std::memcpy(segment->data + segment->writeOffset + sizeof(RecordHeader), payload.data(), payload.size());
+    }
+    header->state = statePending;
+    header->endpointHash = endpointHash;
+    header->size = payload.size();
+    std::atomic_ref<uint32_t>(header->magic).store(recordMagic, std::memory_order_release);
+
+    pending_[endpointHash].push_back({activeSegmentId_.value(), segment->writeOffset, payload.size()});
+    segment->writeOffset += recordSize;
+    segment->pendingRecords++;
+    return true;
+}
+
+std::optional<std::size_t> DiskSpillQueue::getFrontSize(uint64_t endpointHash) const {
+    auto it = pending_.find(endpointHash);
+    if (it == pending_.end() || it->second.empty()) {
+        return std::nullopt;
+    }
+    return it->second.front().size;
+}
+
+PayloadBuffer DiskSpillQueue::pop(uint64_t endpointHash, PayloadBufferPool &pool) {
+    auto it = pending_.find(endpointHash);
+    if (it == pending_.end() || it->second.empty()) {
+        return {};
+    }
+
+    auto record = it->second.front();
+    it->second.pop_front();
+    if (it->second.empty()) {
+        pending_.erase(it);
+    }
+
+    auto &segment = segments_.at(record.segmentId);
+    auto payload = pool.copy({segment.data + record.offset + sizeof(RecordHeader), record.size});
+    consume(record);
+    return payload;
+}
+
+std::size_t DiskSpillQueue::drop(uint64_t endpointHash) {
+    auto it = pending_.find(endpointHash);
+    if (it == pending_.end()) {
+        return 0;
+    }
+
+    auto records = std::move(it->second);
+    pending_.erase(it);
+    for (auto const &record : records) {
+        consume(record);
+    }
+    return records.size();
+}
+
+void DiskSpillQueue::consume(RecordRef const &record) {
+    auto segment = segments_.find(record.segmentId);
+    auto *header = reinterpret_cast<RecordHeader *>(segment->second.data + record.offset);
+    header->state = stateConsumed;
+
+    if (--segment->second.pendingRecords == 0) {
+        removeSegment(segment);
+    }
+}
+
+std::size_t DiskSpillQueue::getPendingCount(uint64_t endpointHash) const {
+    auto it = pending_.find(endpointHash);
+    return it == pending_.end() ? 0 : it->second.size();
+}
+
+std::size_t DiskSpillQueue::getPendingCount() const {
+    std::size_t count = 0;
+    for (auto const &[endpointHash, records] : pending_) {
+        count += records.size();
+    }
+    return count;
+}
+
+std::vector<uint64_t> DiskSpillQueue::getPendingEndpoints() const {
+    std::vector<uint64_t> endpoints;
+    endpoints.reserve(pending_.size());
+    for (auto const &[endpointHash, records] : pending_) {
+        endpoints.push_back(endpointHash);
+    }
+    return endpoints;
+}
+
+DiskSpillQueue::Segment *DiskSpillQueue::createSegment(std::size_t capacity) {
+    auto id = nextSegmentId_++;
+
+    Segment segment;
+    segment.path = directory_ / std::format("{}{:020}{}", segmentPrefix, id, segmentSuffix);
+    segment.capacity = capacity;
+    if (!mapSegment(segment, true)) {
+        ELOG_WARNING(log_, TRANSPORT, "DiskSpillQueue unable to create segment '{}' of size {}: {}", segment.path.string(), capacity, getErrorString());
+        std::error_code error;
+        std::filesystem::remove(segment.path, error);
+        return nullptr;
+    }
+
+    auto *header = reinterpret_cast<SegmentHeader *>(segment.data);
+    header->magic = segmentMagic;
+    header->version = segmentVersion;
+    segment.writeOffset = sizeof(SegmentHeader);
+
+    usedBytes_ += capacity;
+    activeSegmentId_ = id;
+    return &segments_.emplace(id, std::move(segment)).first->second;
+}
+
+bool DiskSpillQueue::mapSegment(Segment &segment, bool create) {
+    segment.fd = ::open(segment.path.c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT | O_EXCL : 0), 0600);
+    if (segment.fd < 0) {
+        return false;
+    }
+
+    if (create) {
+        // blocks are allocated upfront, writing to sparse mapping on full disk would end with SIGBUS
+        if (int result = ::posix_fallocate(segment.fd, 0, static_cast<off_t>(segment.capacity)); result != 0) {
+            errno = result;
+            closeSegment(segment);
+            return false;
+        }
+    } else {
+        struct stat st {};
+        if (::fstat(segment.fd, &st) != 0 || st.st_size <= 0) {
+            closeSegment(segment);
+            return false;
+        }
+        segment.capacity = static_cast<std::size_t>(st.st_size);
+    }
+
+    void *data = ::mmap(nullptr, segment.capacity, PROT_READ | PROT_WRITE, MAP_SHARED, segment.fd, 0);
+    if (data == MAP_FAILED) {
+        closeSegment(segment);
+        return false;
+    }
+    segment.data = static_cast<std::byte *>(data);
+    return true;
+}
+
+void DiskSpillQueue::removeSegment(std::map<uint64_t, Segment>::iterator segment) {
+    if (activeSegmentId_ == segment->first) {
+        activeSegmentId_.reset();
+    }
+
+    closeSegment(segment->second);
+    std::error_code error;
+    if (!std::filesystem::remove(segment->second.path, error) && error) {
+        ELOG_WARNING(log_, TRANSPORT, "DiskSpillQueue unable to remove segment '{}': {}", segment->second.path.string(), error.message());
+    }
+    usedBytes_ -= segment->second.capacity;
+    segments_.erase(segment);
+}
+
+void DiskSpillQueue::closeSegment(Segment &segment) {
+    if (segment.data) {
+        ::munmap(segment.data, segment.capacity);
+        segment.data = nullptr;
+    }
+    if (segment.fd >= 0) {
+        ::close(segment.fd);
+        segment.fd = -1;
+    }
+}
+
+} // namespace opentelemetry::php::transport
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "LoggerInterface.h"
+#include "PayloadBuffer.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+namespace opentelemetry::php::transport {
+
+// Append-only queue of payloads stored in memory mapped segment files. Used by HttpTransportAsync for payloads which don't fit into memory budget.
+// Records are returned in order per endpoint. Pending records are recovered from existing segments when queue is opened again, e.g. after coordinator restart.
+// Segment is removed when all its records were popped. Directory is locked, so it can be used only by one process at a time.
+// Not thread safe
+class DiskSpillQueue : public boost::noncopyable {
+public:
+    static constexpr std::size_t defaultSegmentSize = 4 * 1024 * 1024;
+
+    // throws std::runtime_error if directory can't be created, read or locked. Segments which can't be mapped are ignored
+    DiskSpillQueue(std::shared_ptr<LoggerInterface> log, std::filesystem::path directory, std::size_t maxSize, std::size_t segmentSize = defaultSegmentSize);
+    ~DiskSpillQueue();
+
+    // returns false if payload doesn't fit within max size or segment couldn't be created
+    bool push(uint64_t endpointHash, std::span<std::byte const> payload);
+
+    // size of oldest pending payload of endpoint
+    std::optional<std::size_t> getFrontSize(uint64_t endpointHash) const;
+
+    // removes oldest pending payload of endpoint and copies it to buffer from pool. Returns empty buffer if there is no pending payload
+    PayloadBuffer pop(uint64_t endpointHash, PayloadBufferPool &pool);
+
+    // removes all pending payloads of endpoint, returns number of removed payloads
+    std::size_t drop(uint64_t endpointHash);
+
+    std::size_t getPendingCount(uint64_t endpointHash) const;
+    std::size_t getPendingCount() const;
+
+    std::vector<uint64_t> getPendingEndpoints() const;
+
+    // payloads recovered from segments of previous process are pending since this time
+    std::chrono::steady_clock::time_point getOpenedAt() const {
+        return openedAt_;
+    }
+
+    // sum of segment files sizes
+    std::size_t getUsedBytes() const {
+        return usedBytes_;
+    }
+
+    void setMaxSize(std::size_t maxSize) {
+        maxSize_ = maxSize;
+    }
+
+    std::filesystem::path const &getDirectory() const {
+        return directory_;
+    }
+
+private:
+    struct Segment {
+        std::filesystem::path path;
+        int fd = -1;
+        std::byte *data = nullptr;
+        std::size_t capacity = 0;
+        std::size_t writeOffset = 0;
+        std::size_t pendingRecords = 0;
+    };
+
+    struct RecordRef {
+        uint64_t segmentId;
+        std::size_t offset; // offset of record header within segment
+        std::size_t size;
+    };
+
+    void lockDirectory();
+    void recoverSegments();
+    Segment *createSegment(std::size_t minimumCapacity);
+    bool mapSegment(Segment &segment, bool create);
+    void removeSegment(std::map<uint64_t, Segment>::iterator segment);
+    void closeSegment(Segment &segment);
+    void consume(RecordRef const &record);
+
+    std::shared_ptr<LoggerInterface> log_;
+    std::filesystem::path directory_;
+    std::size_t maxSize_;
+    std::size_t segmentSize_;
+    std::size_t usedBytes_ = 0;
+    std::chrono::steady_clock::time_point openedAt_ = std::chrono::steady_clock::now();
+    int lockFd_ = -1;
+    uint64_t nextSegmentId_ = 1;
+    std::optional<uint64_t> activeSegmentId_; // segment new records are appended to. Recovered segments are never appended
+    std::map<uint64_t, Segment> segments_;
+    std::unordered_map<uint64_t, std::deque<RecordRef>> pending_;
+};
+
+} // namespace opentelemetry::php::transport
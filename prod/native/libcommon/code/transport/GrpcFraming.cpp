@@ -0,0 +1,80 @@
+#include "GrpcFraming.h"
+#include "CiCharTraits.h"
+
+#include <charconv>
+#include <cstring>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::transport {
+
+namespace {
+
+enum GrpcStatus : uint32_t {
+    ok = 0,
+    cancelled = 1,
+    unknown = 2,
+    deadlineExceeded = 4,
+    resourceExhausted = 8,
+    aborted = 10,
+    outOfRange = 11,
+    unavailable = 14,
+    dataLoss = 15
+};
+
+} // namespace
+
+bool isGrpcContentType(std::string_view contentType) {
+    auto type = opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>(contentType);
+    auto grpc = opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("application/grpc"sv);
+    return type.starts_with(grpc) && (type.size() == grpc.size() || type[grpc.size()] == '+' || type[grpc.size()] == ';');
+}
+
+PayloadBuffer frameGrpcMessage(PayloadBufferPool &pool, std::span<std::byte const> message, bool compressed) {
+    auto framed = pool.allocate(grpcMessagePrefixSize + message.size());
+    auto size = static_cast<uint32_t>(message.size());
+    framed.data()[0] = std::byte{compressed ? uint8_t{1} : uint8_t{0}};
+    framed.data()[1] = static_cast<std::byte>(size >> 24);
+    framed.data()[2] = static_cast<std::byte>(size >> 16);
+    framed.data()[3] = static_cast<std::byte>(size >> 8);
+    framed.data()[4] = static_cast<std::byte>(size);
+    if (!message.empty()) {
+        std::memcpy(framed.data() + grpcMessagePrefixSize, message.data(), message.size());
+    }
+    return std::move(framed).freeze();
+}
+
+std::optional<uint32_t> parseGrpcStatus(std::string_view value) {
+    while (!value.empty() && value.front() == ' ') {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\r' || value.back() == '\n')) {
+        value.remove_suffix(1);
+    }
+
+    uint32_t status = 0;
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), status);
+    if (value.empty() || ec != std::errc{} || ptr != value.data() + value.size()) {
+        return std::nullopt;
+    }
+    return status;
+}
+
+int16_t getResponseCodeFromGrpcStatus(std::optional<uint32_t> grpcStatus) {
+    switch (grpcStatus.value_or(GrpcStatus::unknown)) {
+        case GrpcStatus::ok:
+            return 200;
+        case GrpcStatus::cancelled:
+        case GrpcStatus::deadlineExceeded:
+        case GrpcStatus::resourceExhausted:
+        case GrpcStatus::aborted:
+        case GrpcStatus::outOfRange:
+        case GrpcStatus::unavailable:
+        case GrpcStatus::dataLoss:
+            return 503;
+        default:
+            return 400;
+    }
+}
+
+} // namespace opentelemetry::php::transport
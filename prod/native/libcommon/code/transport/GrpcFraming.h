@@ -0,0 +1,29 @@
+#pragma once
+
+#include "PayloadBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace opentelemetry::php::transport {
+
+// gRPC message is prefixed with compressed flag and big endian message length
+constexpr std::size_t grpcMessagePrefixSize = 5;
+
+// application/grpc and its subtypes like application/grpc+proto (case insensitive)
+bool isGrpcContentType(std::string_view contentType);
+
+// payload of unary call request - one length-prefixed message
+PayloadBuffer frameGrpcMessage(PayloadBufferPool &pool, std::span<std::byte const> message, bool compressed);
+
+// value of grpc-status header or trailer, nullopt if it is not a valid status code
+std::optional<uint32_t> parseGrpcStatus(std::string_view value);
+
+// maps call outcome to HTTP status code understood by transport retry logic: 200 for OK, 503 for statuses which OTLP allows to retry, 400 for others.
+// Response without grpc-status is treated as UNKNOWN
+int16_t getResponseCodeFromGrpcStatus(std::optional<uint32_t> grpcStatus);
+
+} // namespace opentelemetry::php::transport
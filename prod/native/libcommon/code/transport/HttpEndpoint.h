@@ -1,7 +1,9 @@
 #pragma once
 
 #include "CommonUtils.h"
+#include "GrpcFraming.h"
 #include "HttpEndpointSSLOptions.h"
+#include "PayloadCompression.h"
 
 #include <chrono>
 #include <string>
@@ -22,16 +24,23 @@ public:
     HttpEndpoint(HttpEndpoint const &) = delete;
     HttpEndpoint &operator=(HttpEndpoint const &) = delete;
 
-    HttpEndpoint(std::string endpoint, std::string_view contentType, enpointHeaders_t const &headers, std::size_t maxRetries, std::chrono::milliseconds retryDelay) : endpoint_(std::move(endpoint)), maxRetries_(maxRetries), retryDelay_(retryDelay) {
+    HttpEndpoint(std::string endpoint, std::string_view contentType, enpointHeaders_t const &headers, std::size_t maxRetries, std::chrono::milliseconds retryDelay, PayloadCompression compression = PayloadCompression::none) : endpoint_(std::move(endpoint)), maxRetries_(maxRetries), retryDelay_(retryDelay), compression_(compression), grpc_(isGrpcContentType(contentType)) {
         auto connectionDetails = utils::getConnectionDetailsFromURL(endpoint_);
         if (!connectionDetails) {
             std::string msg = "Unable to parse connection details from endpoint: "s;
             msg.append(endpoint_);
             throw std::runtime_error(msg);
         }
-        connectionId_ = std::hash<std::string>{}(connectionDetails.value());
+        if (auto unixSocket = utils::parseUnixSocketURL(endpoint_); unixSocket.has_value()) {
+            // host is required by HTTP, curl connects to socket regardless of it
+            unixSocketPath_ = std::move(unixSocket->socketPath);
+            requestUrl_ = "http://localhost"s + unixSocket->requestPath;
+        }
+
+        // gRPC endpoints need HTTP/2 handles, they don't share connections with HTTP/1.1 endpoints of the same server
+        connectionId_ = std::hash<std::string>{}(grpc_ ? connectionDetails.value() + "|h2"s : connectionDetails.value());
 
-        fillCurlHeaders(contentType, headers);
+        fillCurlHeaders(contentType, headers, compression);
     }
 
     ~HttpEndpoint() {
@@ -45,6 +54,16 @@ public:
         return endpoint_;
     }
 
+    // URL passed to curl, differs from endpoint for unix socket endpoints
+    std::string const &getRequestUrl() const {
+        return unixSocketPath_.empty() ? endpoint_ : requestUrl_;
+    }
+
+    // empty unless endpoint is unix://<socket path>[:<request path>]
+    std::string const &getUnixSocketPath() const {
+        return unixSocketPath_;
+    }
+
     struct curl_slist *getHeaders() {
         return curlHeaders_;
     }
@@ -65,14 +84,34 @@ public:
         retryDelay_ = retryDelay;
     }
 
+    PayloadCompression getCompression() const {
+        return compression_;
+    }
+
+    // OTLP/gRPC endpoint - payload is sent as length-prefixed message over HTTP/2 and outcome is reported in grpc-status trailer
+    bool isGrpc() const {
+        return grpc_;
+    }
+
 private:
-    void fillCurlHeaders(std::string_view contentType, enpointHeaders_t const &headers) {
+    void fillCurlHeaders(std::string_view contentType, enpointHeaders_t const &headers, PayloadCompression compression) {
         if (!contentType.empty()) {
             std::string cType = "Content-Type: "s;
             cType.append(contentType);
             curlHeaders_ = curl_slist_append(curlHeaders_, cType.c_str());
         }
 
+        if (grpc_) {
+            curlHeaders_ = curl_slist_append(curlHeaders_, "TE: trailers");
+        }
+
+        if (compression != PayloadCompression::none) {
+            // gRPC compresses message inside length-prefixed frame, not HTTP body
+            std::string contentEncoding = grpc_ ? "grpc-encoding: "s : "Content-Encoding: "s;
+            contentEncoding.append(getContentEncoding(compression));
+            curlHeaders_ = curl_slist_append(curlHeaders_, contentEncoding.c_str());
+        }
+
         for (auto const &hdr : headers) {
             std::string header;
             header.append(hdr.first);
@@ -83,8 +122,12 @@ private:
     }
 
     std::string endpoint_;
+    std::string requestUrl_;
+    std::string unixSocketPath_;
     std::size_t maxRetries_ = 1;
     std::chrono::milliseconds retryDelay_ = 0ms;
+    PayloadCompression compression_ = PayloadCompression::none;
+    bool grpc_ = false;
     connectionId_t connectionId_;
     struct curl_slist *curlHeaders_ = nullptr;
     HttpEndpointSSLOptions sslOptions_;
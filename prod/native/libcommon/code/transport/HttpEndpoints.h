@@ -10,6 +10,7 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace opentelemetry::php::transport {
 
@@ -22,16 +23,19 @@ public:
     HttpEndpoints(std::shared_ptr<LoggerInterface> log) : log_(log) {
     }
 
-    bool add(std::string endpointUrl, endpointUrlHash_t endpointHash, std::string contentType, HttpEndpoint::enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, HttpEndpointSSLOptions sslOptions) {
+    bool add(std::string endpointUrl, endpointUrlHash_t endpointHash, std::string contentType, HttpEndpoint::enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, HttpEndpointSSLOptions sslOptions, PayloadCompression compression = PayloadCompression::none) {
         std::lock_guard<std::mutex> lock(mutex_);
-        auto result = endpoints_.try_emplace(endpointHash, std::move(endpointUrl), std::move(contentType), endpointHeaders, maxRetries, retryDelay);
-        if (connections_.try_emplace(result.first->second.getConnectionId(), log_, timeout, sslOptions).second) { // CurlSender
+        auto result = endpoints_.try_emplace(endpointHash, std::move(endpointUrl), std::move(contentType), endpointHeaders, maxRetries, retryDelay, compression);
+        auto connection = connections_.try_emplace(result.first->second.getConnectionId(), timeout, std::move(sslOptions), result.first->second.isGrpc(), result.first->second.getUnixSocketPath());
+        if (connection.second) {
+            connection.first->second.idle.push_back(connection.first->second.createSender(log_));
             ELOG_DEBUG(log_, TRANSPORT, "HttpEndpoints::add endpointUrl '{}' endpointHash: {:X} initialize new connectionId: {:X}", result.first->second.getEndpoint(), endpointHash, result.first->second.getConnectionId());
             return true;
         }
         return false;
     }
 
+    // hands out CurlSender which is not used by any other transfer. It must be returned with releaseConnection
     std::tuple<std::string, curl_slist *, HttpEndpoint::connectionId_t, CurlSender &, std::size_t, std::chrono::milliseconds> getConnection(endpointUrlHash_t endpointHash) {
         std::lock_guard<std::mutex> lock(mutex_);
         auto const &endpoint = endpoints_.find(endpointHash);
@@ -48,11 +52,26 @@ public:
             throw std::runtime_error(stream.str());
         }
 
-        auto &conn = connection->second;
+        auto &pool = connection->second;
+        if (pool.idle.empty()) {
+            pool.idle.push_back(pool.createSender(log_));
+            ELOG_DEBUG(log_, TRANSPORT, "HttpEndpoints::getConnection enpointHash: {:X} connectionId: {:X} created sender, total senders: {}", endpointHash, endpoint->second.getConnectionId(), pool.senders.size());
+        }
+        auto &conn = *pool.idle.back();
+        pool.idle.pop_back();
+
         auto maxRetries = std::max(static_cast<std::size_t>(1), static_cast<std::size_t>(endpoint->second.getMaxRetries()));
         auto retryDelay = endpoint->second.getRetryDelay();
 
-        return {endpoint->second.getEndpoint(), endpoint->second.getHeaders(), endpoint->second.getConnectionId(), conn, maxRetries, retryDelay};
+        return {endpoint->second.getRequestUrl(), endpoint->second.getHeaders(), endpoint->second.getConnectionId(), conn, maxRetries, retryDelay};
+    }
+
+    void releaseConnection(HttpEndpoint::connectionId_t connectionId, CurlSender &sender) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto const &connection = connections_.find(connectionId);
+        if (connection != std::end(connections_)) {
+            connection->second.idle.push_back(&sender);
+        }
     }
 
     void updateRetryDelay(size_t endpointHash, std::chrono::milliseconds retryDelay) {
@@ -67,10 +86,27 @@ public:
     }
 
 protected:
+    // every concurrent transfer needs its own curl handle, handles are reused between transfers to the same server
+    struct ConnectionPool {
+        ConnectionPool(std::chrono::milliseconds timeout, HttpEndpointSSLOptions sslOptions, bool http2, std::string unixSocketPath) : timeout(timeout), sslOptions(std::move(sslOptions)), http2(http2), unixSocketPath(std::move(unixSocketPath)) {
+        }
+
+        CurlSender *createSender(std::shared_ptr<LoggerInterface> const &log) {
+            return senders.emplace_back(std::make_unique<CurlSender>(log, timeout, sslOptions, http2, unixSocketPath)).get();
+        }
+
+        std::chrono::milliseconds timeout;
+        HttpEndpointSSLOptions sslOptions;
+        bool http2 = false;
+        std::string unixSocketPath; // pool is keyed by socket path for unix socket endpoints
+        std::vector<std::unique_ptr<CurlSender>> senders;
+        std::vector<CurlSender *> idle;
+    };
+
     std::shared_ptr<LoggerInterface> log_;
     std::mutex mutex_;
     std::unordered_map<endpointUrlHash_t, HttpEndpoint> endpoints_;
-    std::unordered_map<HttpEndpoint::connectionId_t, CurlSender> connections_;
+    std::unordered_map<HttpEndpoint::connectionId_t, ConnectionPool> connections_;
 };
 
 } // namespace opentelemetry::php::transport
\ No newline at end of file
@@ -5,19 +5,37 @@
 #include "ForkableInterface.h"
 #include "ConfigurationStorage.h"
 #include "CurlSender.h"
+#include "CurlMultiSender.h"
+#include "CircuitBreaker.h"
+#include "DiskSpillQueue.h"
+#include "GrpcFraming.h"
 #include "HttpEndpoints.h"
+#include "OtlpEndpoint.h"
+#include "OtlpRequestMerger.h"
+#include "PayloadBuffer.h"
+#include "PayloadCompression.h"
 #include "CommonUtils.h"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <functional>
+#include <list>
 #include <memory>
-#include <queue>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <set>
 #include <span>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <boost/container_hash/hash.hpp>
 #include <curl/curl.h>
@@ -27,65 +45,208 @@ using namespace std::string_view_literals;
 
 namespace opentelemetry::php::transport {
 
-template <typename CurlSender = CurlSender, typename Endpoints = HttpEndpoints>
+template <typename CurlSender = CurlSender, typename Endpoints = HttpEndpoints, typename MultiSender = CurlMultiSender>
 class HttpTransportAsync : public HttpTransportAsyncInterface, public ForkableInterface, public boost::noncopyable {
     using endpointUrlHash_t = Endpoints::endpointUrlHash_t;
+    using sender_t = std::remove_reference_t<std::tuple_element_t<3, decltype(std::declval<Endpoints &>().getConnection(endpointUrlHash_t{}))>>;
+
+    // time after which sender thread checks shutdown timeout while transfers are in progress
+    static constexpr std::chrono::milliseconds transfersPollInterval = 100ms;
+    static constexpr std::chrono::milliseconds spilledPayloadsTtl = 1h; // spilled payloads of endpoint not initialized for that long after opening spill directory are dropped
+
+    struct Transfer {
+        endpointUrlHash_t endpointHash;
+        PayloadBuffer payload;
+        responseCallback_t callback;
+        std::string endpointUrl;
+        HttpEndpoint::connectionId_t connectionId = 0;
+        sender_t *sender = nullptr;
+        std::size_t maxRetries = 1;
+        std::chrono::milliseconds retryDelay = 0ms;
+        std::size_t retry = 0;
+        std::chrono::steady_clock::time_point retryAt{};
+        std::optional<std::chrono::milliseconds> retryAfter;
+        std::vector<PayloadBuffer> coalescedPayloads; // merged into payload by startPendingTransfers
+        std::vector<uint64_t> sequences;              // flush sequences of payloads carried by transfer
+        std::chrono::steady_clock::time_point enqueuedAt{}; // of the oldest payload carried by transfer
+        PayloadCompression compression = PayloadCompression::none;
+        bool compressed = false;
+        bool grpc = false;
+        bool framed = false; // gRPC length prefix added
+        std::optional<uint32_t> grpcStatus;
+        curl_slist *headers = nullptr;
+        std::string responseBuffer;
+        std::function<void(std::string_view)> headerCallback;
+    };
+
+    struct PayloadsQueue {
+        std::string_view signal; // one of names accepted by OTEL_PHP_ASYNC_TRANSPORT_SIGNALS_PRIORITY, empty if unknown
+        PayloadCompression compression = PayloadCompression::none;
+        bool coalescable = false; // concatenated payloads form valid request
+        bool grpc = false;
+        bool initialized = false; // connection was initialized, spilled payloads can be sent
+        std::deque<std::tuple<PayloadBuffer, responseCallback_t, std::chrono::steady_clock::time_point, uint64_t>> payloads; // payload, callback, enqueue time, flush sequence (0 for replayed payloads)
+        std::size_t byteUsage = 0;
+        uint64_t flushSequence = 0; // payloads up to this sequence are awaited by flush and don't linger
+    };
+
+    // payloads accepted into memory queue get consecutive sequence numbers per endpoint. Flush waits until no sequence up to the last one assigned before the call is pending
+    struct FlushState {
+        uint64_t lastSequence = 0;
+        std::set<uint64_t> pending;                                    // sent, rejected, dropped and spilled payloads are removed
+        std::vector<std::pair<uint64_t, std::function<void()>>> waiters; // flushAsync callbacks with awaited sequence
+    };
+
+    struct EndpointState {
+        EndpointState(std::size_t circuitBreakerThreshold, std::chrono::milliseconds circuitBreakerCooldown) : circuitBreaker(circuitBreakerThreshold, circuitBreakerCooldown) {
+        }
+
+        std::size_t transfersInProgress = 0; // running and waiting for retry
+        std::list<Transfer> retries;         // transfers waiting for retry, sender is kept by transfer
+        CircuitBreaker circuitBreaker;
+    };
 
 public:
     HttpTransportAsync(std::shared_ptr<LoggerInterface> log, std::shared_ptr<ConfigurationStorage> config) : log_(std::move(log)), config_(std::move(config)), endpoints_(log_) {
         CurlInit();
+        multiSender_ = std::make_unique<MultiSender>(log_);
     }
 
     ~HttpTransportAsync() {
         shutdownStart_ = std::chrono::steady_clock::now();
         forceFlushOnDestruction_ = true;
         shutdownThread();
+        abortTransfers();
+        dropRetries();
+        runCompletedFlushCallbacks();
+        multiSender_.reset();
         CurlCleanup();
     }
 
-    void initializeConnection(std::string endpointUrl, endpointUrlHash_t endpointHash, std::string contentType, HttpEndpoint::enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, HttpEndpointSSLOptions sslOptions) override {
-        ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::initializeConnection endpointUrl '{}' enpointHash: {:X} timeout: {}ms retries: {} retry delay: {}ms", endpointUrl, endpointHash, timeout.count(), maxRetries, retryDelay.count());
+    void initializeConnection(std::string endpointUrl, endpointUrlHash_t endpointHash, std::string contentType, HttpEndpoint::enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, HttpEndpointSSLOptions sslOptions, PayloadCompression compression) override {
+        ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::initializeConnection endpointUrl '{}' enpointHash: {:X} timeout: {}ms retries: {} retry delay: {}ms compression: '{}'", endpointUrl, endpointHash, timeout.count(), maxRetries, retryDelay.count(), getContentEncoding(compression));
         ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync::initializeConnection enpointHash '{:X}', SSL options: insecureSkipVerify: {}, caInfo: '{}', cert: '{}', certKey: '{}', certKeyPassword: '{}'", endpointHash, sslOptions.insecureSkipVerify, sslOptions.caInfo, sslOptions.cert, sslOptions.certKey, !sslOptions.certKeyPassword.empty() ? "<redacted>"sv : "");
 
         try {
-            endpoints_.add(std::move(endpointUrl), endpointHash, std::move(contentType), endpointHeaders, timeout, maxRetries, retryDelay, std::move(sslOptions));
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto &queue = payloadsQueues_[endpointHash];
+                queue.signal = getEndpointSignal(endpointUrl);
+                queue.compression = compression;
+                queue.coalescable = isCoalescable(queue.signal, contentType);
+                queue.grpc = isGrpcContentType(contentType);
+                queue.initialized = true;
+                if (auto spillQueue = getSpillQueue(); spillQueue && spillQueue->getPendingCount(endpointHash) > 0) {
+                    ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::initializeConnection enpointHash: {:X} has {} payloads waiting in spill directory", endpointHash, spillQueue->getPendingCount(endpointHash));
+                    payloadsEnqueued_ = true;
+                }
+            }
+            endpoints_.add(std::move(endpointUrl), endpointHash, std::move(contentType), endpointHeaders, timeout, maxRetries, retryDelay, std::move(sslOptions), compression);
             startThread();
+            pauseCondition_.notify_all();
         } catch (std::exception const &error) {
             ELOG_ERROR(log_, TRANSPORT, "HttpTransportAsync::initializeConnection exception '{}'", error.what());
         }
     }
 
-    void enqueue(endpointUrlHash_t endpointHash, std::span<std::byte> payload, responseCallback_t callback = {}) override {
+    struct Statistics {
+        std::size_t queuedBytes = 0;
+        std::size_t queueLimit = 0;
+        uint64_t droppedPayloads = 0; // rejected or evicted from full queue without spilling, or given up after retries
+        uint64_t droppedBytes = 0;
+        uint64_t exportedPayloads = 0;
+        std::chrono::milliseconds exportLatency{0}; // moving average of time from enqueue to successful export
+    };
+
+    Statistics getStatistics() {
+        Statistics statistics;
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync::enqueue enpointHash: {:X} payload size: {}, current queue size {} usage {} bytes", endpointHash, payload.size(), payloadsToSend_.size(), payloadsByteUsage_);
+            statistics.queuedBytes = payloadsByteUsage_;
+        }
+        statistics.queueLimit = config_->get()->max_send_queue_size;
+        statistics.droppedPayloads = droppedPayloads_.load();
+        statistics.droppedBytes = droppedBytes_.load();
+        statistics.exportedPayloads = exportedPayloads_.load();
+        statistics.exportLatency = std::chrono::milliseconds(exportLatencyMs_.load());
+        return statistics;
+    }
 
-            if (payloadsByteUsage_ + payload.size() > config_->get().max_send_queue_size) {
-                ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::enqueue payloadsByteUsageLimit {} reached. Payload will be dropped. enpointHash: {:X} payload size: {}, current queue size {} usage {} bytes", config_->get().max_send_queue_size, endpointHash, payload.size(), payloadsToSend_.size(), payloadsByteUsage_);
-                return;
+    void enqueue(endpointUrlHash_t endpointHash, PayloadBuffer payload, responseCallback_t callback = {}) override {
+        // the only copy of borrowed payload, made before taking the lock
+        payload = payload.retain(*payloadBufferPool_);
+        bool dropped = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto &queue = payloadsQueues_[endpointHash];
+            ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync::enqueue enpointHash: {:X} payload size: {}, endpoint queue size {} usage {} bytes, total usage {} bytes", endpointHash, payload.size(), queue.payloads.size(), queue.byteUsage, payloadsByteUsage_);
+
+            // once endpoint has spilled payloads, new ones are spilled too, so they are sent in order
+            bool spilled = !callback && hasSpilledPayloads(endpointHash) && spillPayload(endpointHash, payload);
+            if (!spilled) {
+                if (!reserveQueueSpace(endpointHash, queue, payload.size())) {
+                    if (callback || !spillPayload(endpointHash, payload)) {
+                        ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::enqueue queue limit reached. Payload will be dropped. enpointHash: {:X} payload size: {}, endpoint queue size {} usage {} bytes, total usage {} bytes, limit {} bytes", endpointHash, payload.size(), queue.payloads.size(), queue.byteUsage, payloadsByteUsage_, config_->get()->max_send_queue_size);
+                        countDroppedPayload(payload.size());
+                        dropped = true;
+                    }
+                } else {
+                    auto size = payload.size();
+                    queue.payloads.emplace_back(std::move(payload), std::move(callback), std::chrono::steady_clock::now(), trackPayload(endpointHash));
+                    queue.byteUsage += size;
+                    payloadsByteUsage_ += size;
+                }
             }
 
-            payloadsToSend_.emplace(endpointHash, std::vector<std::byte>(payload.begin(), payload.end()), callback);
-            payloadsByteUsage_ += payload.size();
+            if (!dropped) {
+                payloadsEnqueued_ = true;
+                if (multiSender_) {
+                    multiSender_->wakeup();
+                }
+            }
+        }
+        // evicted payloads could complete flush
+        runCompletedFlushCallbacks();
+        if (!dropped) {
+            pauseCondition_.notify_all();
         }
-        pauseCondition_.notify_all();
     }
 
     void prefork() final {
         shutdownThread();
 
-        ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::prefork payloads queue size {}", payloadsToSend_.size());
+        ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::prefork payloads queue size {}, transfers in progress {}, waiting for retry {}", getQueuedPayloadsCount(), transfers_.size(), getRetriesCount());
+        abortTransfers();
+        runCompletedFlushCallbacks();
+        multiSender_.reset();
         CurlCleanup();
     }
 
     void postfork([[maybe_unused]] bool child) final {
         CurlInit();
+        multiSender_ = std::make_unique<MultiSender>(log_);
 
-        if (child && !payloadsToSend_.empty()) {
-            ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::postfork child emptying payloads queue. {} will be sent from parent", payloadsToSend_.size());
-            decltype(payloadsToSend_) q;
-            payloadsToSend_.swap(q);
+        if (child && payloadsByteUsage_ > 0) {
+            ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::postfork child emptying payloads queue. {} will be sent from parent", getQueuedPayloadsCount());
+            for (auto &[endpointHash, queue] : payloadsQueues_) {
+                queue.payloads.clear();
+                queue.byteUsage = 0;
+            }
+            payloadsByteUsage_ = 0;
+        }
+        if (child && hasPendingRetries()) {
+            ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::postfork child dropping {} transfers waiting for retry. They will be sent from parent", getRetriesCount());
+            dropRetries();
+        }
+        runCompletedFlushCallbacks();
+        if (child) {
+            payloadBufferPool_->trim();
+            // spill directory stays locked by parent, child doesn't spill
+            spillQueue_.reset();
+            std::lock_guard<std::mutex> lock(flushMutex_);
+            flushStates_.clear();
         }
+        payloadsEnqueued_ = getQueuedPayloadsCount() > 0;
         working_ = true;
         startThread();
         pauseCondition_.notify_all();
@@ -99,6 +260,45 @@ public:
         }
     }
 
+    bool flush(endpointUrlHash_t endpointHash, std::chrono::milliseconds timeout) override {
+        std::unique_lock<std::mutex> lock(flushMutex_);
+        auto sequence = flushStates_[endpointHash].lastSequence;
+        if (isFlushed(endpointHash, sequence)) {
+            return true;
+        }
+        lock.unlock();
+
+        ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::flush enpointHash: {:X} waiting up to {}ms for payloads up to sequence {}", endpointHash, timeout.count(), sequence);
+        requestFlush(endpointHash, sequence);
+
+        lock.lock();
+        if (!flushCondition_.wait_for(lock, timeout, [&]() { return isFlushed(endpointHash, sequence); })) {
+            ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::flush enpointHash: {:X} timeout reached, {} payloads still pending", endpointHash, flushStates_[endpointHash].pending.size());
+            return false;
+        }
+        return true;
+    }
+
+    // non-blocking flush, callback is called once payloads enqueued before the call are flushed. It is called immediately if there is nothing to wait for, otherwise from sender thread
+    void flushAsync(endpointUrlHash_t endpointHash, std::function<void()> callback) {
+        uint64_t sequence = 0;
+        {
+            std::lock_guard<std::mutex> lock(flushMutex_);
+            auto &state = flushStates_[endpointHash];
+            sequence = state.lastSequence;
+            if (!isFlushed(endpointHash, sequence)) {
+                state.waiters.emplace_back(sequence, std::move(callback));
+                callback = {};
+            }
+        }
+
+        if (callback) {
+            callback();
+            return;
+        }
+        requestFlush(endpointHash, sequence);
+    }
+
 protected:
     void startThread() {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -116,6 +316,9 @@ protected:
             }
 
             working_ = false;
+            if (multiSender_) {
+                multiSender_->wakeup();
+            }
         }
         pauseCondition_.notify_all();
 
@@ -132,89 +335,740 @@ protected:
 
         std::unique_lock<std::mutex> lock(mutex_);
         while (working_) {
-            pauseCondition_.wait(lock, [this]() -> bool { return !payloadsToSend_.empty() || !working_; });
+            auto wakeupCondition = [this]() -> bool { return payloadsEnqueued_ || !working_; };
+            if (auto nextTimer = getNextTimerExpiration(); nextTimer.has_value()) {
+                pauseCondition_.wait_until(lock, nextTimer.value(), wakeupCondition);
+            } else {
+                pauseCondition_.wait(lock, wakeupCondition);
+            }
+            payloadsEnqueued_ = false;
 
             if (!working_ && !forceFlushOnDestruction_) {
                 break;
             }
 
             send(lock);
+
+            lock.unlock();
+            runCompletedFlushCallbacks();
+            lock.lock();
         }
     }
 
+    // sends queued payloads and due retries until no transfer is in progress and nothing more can be started now.
+    // Payloads blocked by scheduled retries or open circuit breaker are left for the next timer expiration.
+    // During shutdown flush it waits for scheduled retries until shutdown timeout is reached
     void send(std::unique_lock<std::mutex> &lockedPayloadsMutex) {
-        while (!payloadsToSend_.empty()) {
-            auto [endpointHash, payload, callback] = std::move(payloadsToSend_.front());
-            payloadsToSend_.pop();
-            payloadsByteUsage_ -= payload.size();
-
-            ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync::send enpointHash: {:X} payload size: {}", endpointHash, payload.size());
+        while (true) {
+            startTransfers();
 
-            lockedPayloadsMutex.unlock();
+            if (transfers_.empty()) {
+                if (!forceFlushOnDestruction_ || !hasPendingRetries()) {
+                    break;
+                }
 
-            std::function<void(std::string_view)> headerCallback = [endpointHash, this](std::string_view header) {
-                auto hdr = opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>(header);
-                if (hdr.starts_with(opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("Retry-After: "sv))) {
-                    std::string_view value = header.substr("Retry-After: "sv.length());
+                auto waitUntil = getNextTimerExpiration().value();
+                if (auto shutdownTimeout = config_->get()->async_transport_shutdown_timeout; shutdownTimeout.count() > 0) {
+                    waitUntil = std::min(waitUntil, shutdownStart_ + shutdownTimeout);
+                }
+                pauseCondition_.wait_until(lockedPayloadsMutex, waitUntil);
+            } else {
+                lockedPayloadsMutex.unlock();
+                runCompletedFlushCallbacks();
+                startPendingTransfers();
+                try {
+                    multiSender_->perform(transfersPollInterval);
+                } catch (std::exception const &error) {
+                    ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::send perform exception '{}'", error.what());
+                }
+                lockedPayloadsMutex.lock();
+            }
 
-                    auto retryValue = opentelemetry::utils::parseRetryAfter(value);
-                    if (retryValue.has_value() && retryValue.value().count() > 0) {
-                        ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync::send updating endpoint {:X} retry delay to {}ms", endpointHash, retryValue.value().count());
-                        endpoints_.updateRetryDelay(endpointHash, retryValue.value());
-                    }
+            // it will break sending and emit log if class destructor was triggered, payloads queue is not empty and timeout was set and reached
+            auto shutdownTimeout = forceFlushOnDestruction_ ? config_->get()->async_transport_shutdown_timeout : std::chrono::milliseconds(0);
+            if (forceFlushOnDestruction_ && (getQueuedPayloadsCount() > 0 || !transfers_.empty() || hasPendingRetries()) && shutdownTimeout.count() > 0 && ((std::chrono::steady_clock::now() - shutdownStart_) >= shutdownTimeout)) {
+                auto queued = getQueuedPayloadsCount();
+                std::size_t spilled = 0;
+                for (auto &[endpointHash, queue] : payloadsQueues_) {
+                    spilled += spillQueuedPayloads(endpointHash, queue);
                 }
-            };
+                ELOG_WARNING(log_, TRANSPORT, "Dropping {} payloads, {} transfers in progress and {} transfers waiting for retry because OTEL_PHP_ASYNC_TRANSPORT_SHUTDOWN_TIMEOUT ({}ms) was reached. {} payloads stored in spill directory", queued - spilled, transfers_.size(), getRetriesCount(), shutdownTimeout.count(), spilled);
+                abortTransfers();
+                dropRetries();
+                break;
+            }
+        }
+    }
 
-            try {
-                auto [endpointUrl, headers, connId, conn, maxRetries, retryDelay] = endpoints_.getConnection(endpointHash);
+    // compresses and frames payloads and hands transfers picked by startTransfers to MultiSender. Called by sender thread without locked payloads mutex
+    void startPendingTransfers() {
+        for (auto transfer : transfersToStart_) {
+            if (!transfer->coalescedPayloads.empty()) {
+                transfer->payload = mergePayloads(transfer->coalescedPayloads);
+                transfer->coalescedPayloads.clear();
+            }
+            if (transfer->compression != PayloadCompression::none && !transfer->compressed) {
                 try {
-                    std::size_t retry = 0;
+                    auto size = transfer->payload.size();
+                    transfer->payload = PayloadBuffer::adopt(compressPayload(transfer->compression, transfer->payload));
+                    transfer->compressed = true;
+                    ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync::startPendingTransfers enpointHash: {:X} payload compressed with {} from {} to {} bytes", transfer->endpointHash, getContentEncoding(transfer->compression), size, transfer->payload.size());
+                } catch (std::runtime_error const &error) {
+                    ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::startPendingTransfers dropping payload. enpointHash: {:X} payload size: {} error: '{}'", transfer->endpointHash, transfer->payload.size(), error.what());
+                    getEndpointState(transfer->endpointHash).circuitBreaker.onAbandoned();
+                    countDroppedPayload(transfer->payload.size());
+                    finishTransfer(transfer);
+                    continue;
+                }
+            }
+            if (transfer->grpc && !transfer->framed) {
+                transfer->payload = frameGrpcMessage(*payloadBufferPool_, transfer->payload, transfer->compressed);
+                transfer->framed = true;
+            }
+            startTransfer(transfer);
+        }
+        transfersToStart_.clear();
+    }
 
-                    while (retry < maxRetries) {
-                        std::string responseBuffer;
+    // restarts due retries and moves queued payloads to transfers as long as global and per endpoint concurrency limits and circuit breakers allow.
+    // Picked transfers are started by startPendingTransfers. Called with locked payloads mutex
+    void startTransfers() {
+        auto config = config_->get();
+        auto maxTransfers = std::max(static_cast<std::size_t>(1), config->async_transport_max_concurrent_requests);
+        auto maxEndpointTransfers = std::max(static_cast<std::size_t>(1), config->async_transport_max_concurrent_requests_per_endpoint);
+        auto now = std::chrono::steady_clock::now();
 
-                        auto responseCode = conn.sendPayload(endpointUrl, headers, payload, callback ? headerCallback : std::function<void(std::string_view)>{}, callback ? &responseBuffer : nullptr);
+        for (auto &[endpointHash, state] : endpointsState_) {
+            if (forceFlushOnDestruction_ && state.circuitBreaker.isOpen(now) && !state.retries.empty()) {
+                ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::startTransfers dropping {} transfers waiting for retry, circuit breaker is open for enpointHash: {:X}", state.retries.size(), endpointHash);
+                dropRetries(state);
+                continue;
+            }
 
-                        ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync::send enpointHash: {:X} connectionId: {:X} payload size: {} responseCode {}", endpointHash, connId, payload.size(), static_cast<int>(responseCode));
+            for (auto it = state.retries.begin(); it != state.retries.end() && transfers_.size() < maxTransfers;) {
+                if (it->retryAt > now || !state.circuitBreaker.tryAcquire(now)) {
+                    ++it;
+                    continue;
+                }
+                auto transfer = it++;
+                transfers_.splice(transfers_.end(), state.retries, transfer);
+                transfersToStart_.push_back(transfer);
+            }
+        }
 
-                        if (responseCode >= 200 && responseCode < 300) {
-                            if (callback) {
-                                callback(responseCode, {reinterpret_cast<std::byte *>(responseBuffer.data()), responseBuffer.size()});
-                            }
-                            break;
-                        }
+        if (!forceFlushOnDestruction_) {
+            replaySpilledPayloads(now);
+        }
 
-                        if (responseCode >= 400 && responseCode < 500 && responseCode != 408 && responseCode != 429) {
-                            if (callback) {
-                                callback(responseCode, {reinterpret_cast<std::byte *>(responseBuffer.data()), responseBuffer.size()});
-                            }
-                            std::string msg = "server returned with code "s;
-                            msg.append(std::to_string(responseCode));
-                            throw std::runtime_error(msg);
-                        }
+        for (auto [priority, endpointHash, queue] : getQueuesByPriority()) {
+            auto &state = getEndpointState(endpointHash);
+
+            while (!queue->payloads.empty() && transfers_.size() < maxTransfers) {
+                if (forceFlushOnDestruction_ && state.circuitBreaker.isOpen(now)) {
+                    auto queued = queue->payloads.size();
+                    auto spilled = spillQueuedPayloads(endpointHash, *queue);
+                    ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::startTransfers dropping {} payloads, circuit breaker is open for enpointHash: {:X}. {} payloads stored in spill directory", queued - spilled, endpointHash, spilled);
+                    break;
+                }
+
+                if ((!forceFlushOnDestruction_ && isLingering(*queue, now)) || state.transfersInProgress >= maxEndpointTransfers || !state.circuitBreaker.tryAcquire(now)) {
+                    break;
+                }
+
+                auto &transfer = transfers_.emplace_back(endpointHash, std::move(std::get<0>(queue->payloads.front())), std::move(std::get<1>(queue->payloads.front())));
+                transfer.sequences.push_back(std::get<3>(queue->payloads.front()));
+                transfer.enqueuedAt = std::get<2>(queue->payloads.front());
+                transfer.compression = queue->compression;
+                transfer.grpc = queue->grpc;
+                queue->payloads.pop_front();
+                queue->byteUsage -= transfer.payload.size();
+                payloadsByteUsage_ -= transfer.payload.size();
+
+                auto payloadSize = coalescePayloads(*queue, transfer);
+
+                ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync::startTransfers enpointHash: {:X} priority: {} payload size: {} coalesced payloads: {}", endpointHash, priority, payloadSize, std::max(transfer.coalescedPayloads.size(), static_cast<std::size_t>(1)));
 
-                        retry++;
-                        ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::send enpointHash: {:X} connectionId: {:X} payload size: {} retry {}/{} delay: {} responseCode {}", endpointHash, connId, payload.size(), retry, maxRetries, retryDelay.count(), static_cast<int>(responseCode));
-                        std::this_thread::sleep_for(retryDelay);
+                try {
+                    auto [endpointUrl, headers, connId, conn, maxRetries, retryDelay] = endpoints_.getConnection(endpointHash);
+                    transfer.endpointUrl = std::move(endpointUrl);
+                    transfer.headers = headers;
+                    transfer.connectionId = connId;
+                    transfer.sender = &conn;
+                    transfer.maxRetries = maxRetries;
+                    transfer.retryDelay = retryDelay;
+                } catch (std::runtime_error const &error) {
+                    ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::send {}", error.what());
+                    state.circuitBreaker.onAbandoned();
+                    if (transfer.coalescedPayloads.empty()) {
+                        countDroppedPayload(transfer.payload.size());
+                    }
+                    for (auto const &payload : transfer.coalescedPayloads) {
+                        countDroppedPayload(payload.size());
                     }
-                    ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::send enpointHash: {:X} connectionId: {:X} payload size: {}", endpointHash, connId, payload.size());
-                } catch (std::runtime_error const &e) {
-                    ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::send exception '{}'. enpointHash: {:X} connectionId: {:X} payload size: {}", e.what(), endpointHash, connId, payload.size());
+                    completeSequences(endpointHash, transfer.sequences);
+                    transfers_.pop_back();
+                    continue;
                 }
-            } catch (std::runtime_error const &error) {
-                ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::send {}", error.what());
+
+                transfer.headerCallback = [endpointHash, &transfer, this](std::string_view header) {
+                    auto hdr = opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>(header);
+                    if (hdr.starts_with(opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("Retry-After: "sv))) {
+                        std::string_view value = header.substr("Retry-After: "sv.length());
+
+                        auto retryValue = opentelemetry::utils::parseRetryAfter(value);
+                        if (retryValue.has_value() && retryValue.value().count() > 0) {
+                            transfer.retryAfter = retryValue.value();
+                            if (transfer.callback) {
+                                ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync::send updating endpoint {:X} retry delay to {}ms", endpointHash, retryValue.value().count());
+                                endpoints_.updateRetryDelay(endpointHash, retryValue.value());
+                            }
+                        }
+                    } else if (transfer.grpc && hdr.starts_with(opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("grpc-status:"sv))) {
+                        transfer.grpcStatus = parseGrpcStatus(header.substr("grpc-status:"sv.length()));
+                    } else if (transfer.grpc && hdr.starts_with(opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("grpc-retry-pushback-ms:"sv))) {
+                        // gRPC counterpart of Retry-After
+                        if (auto pushback = parseGrpcStatus(header.substr("grpc-retry-pushback-ms:"sv.length())); pushback.has_value() && pushback.value() > 0) {
+                            transfer.retryAfter = std::chrono::milliseconds(pushback.value());
+                        }
+                    }
+                };
+
+                state.transfersInProgress++;
+                transfersToStart_.push_back(std::prev(transfers_.end()));
             }
+        }
+    }
 
-            lockedPayloadsMutex.lock();
+    // moves following queued payloads to transfer as long as merged request fits OTEL_PHP_ASYNC_TRANSPORT_COALESCE_MAX_SIZE. Returns merged payload size.
+    // Payloads waiting for response are never merged, their callbacks expect response for own request
+    std::size_t coalescePayloads(PayloadsQueue &queue, Transfer &transfer) {
+        auto maxSize = config_->get()->async_transport_coalesce_max_size;
+        auto size = transfer.payload.size();
+        if (!queue.coalescable || transfer.callback) {
+            return size;
+        }
 
-            // it will break sending and emit log if class destructor was triggered, payloads queue is not empty and timeout was set and reached
-            if (forceFlushOnDestruction_ && !payloadsToSend_.empty() && config_->get().async_transport_shutdown_timeout.count() > 0 && ((std::chrono::steady_clock::now() - shutdownStart_) >= config_->get().async_transport_shutdown_timeout)) {
-                ELOG_WARNING(log_, TRANSPORT, "Dropping {} payloads because OTEL_PHP_ASYNC_TRANSPORT_SHUTDOWN_TIMEOUT ({}ms) was reached", payloadsToSend_.size(), config_->get().async_transport_shutdown_timeout.count());
+        while (!queue.payloads.empty() && !std::get<1>(queue.payloads.front())) {
+            auto &next = std::get<0>(queue.payloads.front());
+            if (size + next.size() > maxSize) {
                 break;
             }
+            if (transfer.coalescedPayloads.empty()) {
+                transfer.coalescedPayloads.emplace_back(std::move(transfer.payload));
+            }
+            size += next.size();
+            queue.byteUsage -= next.size();
+            payloadsByteUsage_ -= next.size();
+            transfer.coalescedPayloads.emplace_back(std::move(next));
+            transfer.sequences.push_back(std::get<3>(queue.payloads.front()));
+            queue.payloads.pop_front();
+        }
+        return size;
+    }
+
+    // moves spilled payloads of initialized endpoints back to memory queues while they fit without evicting anything. Called with locked payloads mutex
+    void replaySpilledPayloads(std::chrono::steady_clock::time_point now) {
+        auto spillQueue = getSpillQueue();
+        if (!spillQueue || spillQueue->getPendingCount() == 0) {
+            return;
+        }
+
+        auto totalLimit = config_->get()->max_send_queue_size;
+        auto endpointLimit = getEndpointQueueLimit();
+        for (auto &[endpointHash, queue] : payloadsQueues_) {
+            if (!queue.initialized || getEndpointState(endpointHash).circuitBreaker.isOpen(now)) {
+                continue;
+            }
+
+            while (auto size = spillQueue->getFrontSize(endpointHash)) {
+                if (size.value() > endpointLimit) {
+                    ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::replaySpilledPayloads dropping spilled payload exceeding queue limit. enpointHash: {:X} payload size: {}", endpointHash, size.value());
+                    spillQueue->pop(endpointHash, *payloadBufferPool_);
+                    continue;
+                }
+                if (queue.byteUsage + size.value() > endpointLimit || payloadsByteUsage_ + size.value() > totalLimit) {
+                    break;
+                }
+
+                queue.payloads.emplace_back(spillQueue->pop(endpointHash, *payloadBufferPool_), responseCallback_t{}, now, 0);
+                queue.byteUsage += size.value();
+                payloadsByteUsage_ += size.value();
+                ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync::replaySpilledPayloads enpointHash: {:X} payload size: {}, {} payloads left in spill directory", endpointHash, size.value(), spillQueue->getPendingCount(endpointHash));
+            }
+        }
+
+        // payloads recovered after restart for endpoints which are not used anymore would keep their segments forever
+        if (now - spillQueue->getOpenedAt() > spilledPayloadsTtl) {
+            for (auto endpointHash : spillQueue->getPendingEndpoints()) {
+                if (auto queue = payloadsQueues_.find(endpointHash); queue == payloadsQueues_.end() || !queue->second.initialized) {
+                    auto dropped = spillQueue->drop(endpointHash);
+                    droppedPayloads_ += dropped;
+                    ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::replaySpilledPayloads dropping {} spilled payloads of enpointHash: {:X}, endpoint wasn't initialized within {}ms", dropped, endpointHash, spilledPayloadsTtl.count());
+                }
+            }
         }
     }
 
+    PayloadBuffer mergePayloads(std::vector<PayloadBuffer> const &payloads) {
+        if (config_->get()->async_transport_coalesce_merge_resources) {
+            if (auto merged = mergeOtlpRequests(*payloadBufferPool_, payloads); merged.has_value()) {
+                return std::move(*merged);
+            }
+            ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::mergePayloads unable to merge resources of {} payloads, concatenating them", payloads.size());
+        }
+
+        std::size_t size = 0;
+        for (auto const &payload : payloads) {
+            size += payload.size();
+        }
+
+        auto merged = payloadBufferPool_->allocate(size);
+        std::size_t offset = 0;
+        for (auto const &payload : payloads) {
+            if (!payload.empty()) {
+                std::memcpy(merged.data() + offset, payload.data(), payload.size());
+                offset += payload.size();
+            }
+        }
+        return std::move(merged).freeze();
+    }
+
+    // oldest payload of coalescable queue waits up to OTEL_PHP_ASYNC_TRANSPORT_COALESCE_LINGER for more payloads, unless there is enough of them already to fill request or flush awaits it.
+    // Replayed payloads have sequence 0, they are backlog and never linger
+    bool isLingering(PayloadsQueue const &queue, std::chrono::steady_clock::time_point now) const {
+        return getLingerExpiration(queue).value_or(now) > now;
+    }
+
+    std::optional<std::chrono::steady_clock::time_point> getLingerExpiration(PayloadsQueue const &queue) const {
+        auto config = config_->get();
+        auto linger = config->async_transport_coalesce_linger;
+        if (!queue.coalescable || queue.payloads.empty() || linger.count() <= 0 || queue.byteUsage >= config->async_transport_coalesce_max_size || std::get<3>(queue.payloads.front()) <= queue.flushSequence) {
+            return std::nullopt;
+        }
+        return std::get<2>(queue.payloads.front()) + linger;
+    }
+
+    void startTransfer(std::list<Transfer>::iterator transfer) {
+        transfer->responseBuffer.clear();
+        transfer->retryAfter.reset();
+        transfer->grpcStatus.reset();
+        try {
+            multiSender_->addTransfer(*transfer->sender, transfer->endpointUrl, transfer->headers, transfer->payload, &transfer->headerCallback, transfer->callback ? &transfer->responseBuffer : nullptr, [this, transfer](int16_t responseCode, std::string_view error) { onTransferCompleted(transfer, responseCode, error); });
+        } catch (std::runtime_error const &e) {
+            ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::send exception '{}'. enpointHash: {:X} connectionId: {:X} payload size: {}", e.what(), transfer->endpointHash, transfer->connectionId, transfer->payload.size());
+            getEndpointState(transfer->endpointHash).circuitBreaker.onAbandoned();
+            finishTransfer(transfer);
+        }
+    }
+
+    // called by sender thread from MultiSender::perform without locked payloads mutex
+    void onTransferCompleted(std::list<Transfer>::iterator transfer, int16_t responseCode, std::string_view error) {
+        auto &circuitBreaker = getEndpointState(transfer->endpointHash).circuitBreaker;
+
+        if (!error.empty()) {
+            ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::send exception '{}'. enpointHash: {:X} connectionId: {:X} payload size: {}", error, transfer->endpointHash, transfer->connectionId, transfer->payload.size());
+            onEndpointFailure(transfer->endpointHash, circuitBreaker);
+            finishTransfer(transfer);
+            return;
+        }
+
+        ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync::send enpointHash: {:X} connectionId: {:X} payload size: {} responseCode {}", transfer->endpointHash, transfer->connectionId, transfer->payload.size(), static_cast<int>(responseCode));
+
+        // gRPC call outcome is reported in trailers, HTTP status other than 200 is handled as for OTLP/HTTP
+        if (transfer->grpc && responseCode == 200) {
+            if (transfer->grpcStatus.value_or(1) != 0) {
+                ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::send enpointHash: {:X} connectionId: {:X} grpc-status {}", transfer->endpointHash, transfer->connectionId, transfer->grpcStatus.has_value() ? std::to_string(transfer->grpcStatus.value()) : "missing"s);
+            }
+            responseCode = getResponseCodeFromGrpcStatus(transfer->grpcStatus);
+        }
+
+        if (responseCode >= 200 && responseCode < 300) {
+            circuitBreaker.onSuccess();
+            updateExportLatency(transfer->enqueuedAt);
+            if (transfer->callback) {
+                transfer->callback(responseCode, {reinterpret_cast<std::byte *>(transfer->responseBuffer.data()), transfer->responseBuffer.size()});
+            }
+            finishTransfer(transfer);
+            return;
+        }
+
+        if (responseCode >= 400 && responseCode < 500 && responseCode != 408 && responseCode != 429) {
+            circuitBreaker.onSuccess(); // endpoint is alive, only payload was rejected
+            if (transfer->callback) {
+                transfer->callback(responseCode, {reinterpret_cast<std::byte *>(transfer->responseBuffer.data()), transfer->responseBuffer.size()});
+            }
+            ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync::send exception 'server returned with code {}'. enpointHash: {:X} connectionId: {:X} payload size: {}", static_cast<int>(responseCode), transfer->endpointHash, transfer->connectionId, transfer->payload.size());
+            finishTransfer(transfer);
+            return;
+        }
+
+        onEndpointFailure(transfer->endpointHash, circuitBreaker);
+
+        transfer->retry++;
+        if (transfer->retry >= transfer->maxRetries) {
+            ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::send dropping payload after {} retries. enpointHash: {:X} connectionId: {:X} payload size: {} responseCode {}", transfer->retry, transfer->endpointHash, transfer->connectionId, transfer->payload.size(), static_cast<int>(responseCode));
+            countDroppedPayload(transfer->payload.size());
+            finishTransfer(transfer);
+            return;
+        }
+
+        scheduleRetry(transfer);
+        ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::send enpointHash: {:X} connectionId: {:X} payload size: {} retry {}/{} scheduled in: {}ms responseCode {}", transfer->endpointHash, transfer->connectionId, transfer->payload.size(), transfer->retry, transfer->maxRetries, std::chrono::duration_cast<std::chrono::milliseconds>(transfer->retryAt - std::chrono::steady_clock::now()).count(), static_cast<int>(responseCode));
+    }
+
+    void onEndpointFailure(endpointUrlHash_t endpointHash, CircuitBreaker &circuitBreaker) {
+        bool wasOpen = circuitBreaker.getState() == CircuitBreaker::State::open;
+        circuitBreaker.onFailure(std::chrono::steady_clock::now());
+        if (!wasOpen && circuitBreaker.getState() == CircuitBreaker::State::open) {
+            ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync circuit breaker opened for enpointHash: {:X} after {} consecutive failures. Sending paused for {}ms", endpointHash, circuitBreaker.getConsecutiveFailures(), config_->get()->async_transport_circuit_breaker_cooldown.count());
+        }
+    }
+
+    // moves transfer to endpoint retry queue. Retry-After returned by server takes precedence over exponential backoff
+    void scheduleRetry(std::list<Transfer>::iterator transfer) {
+        auto delay = transfer->retryAfter.has_value() ? transfer->retryAfter.value() : opentelemetry::utils::getRetryBackoffDelay(transfer->retryDelay, transfer->retry, config_->get()->async_transport_max_retry_delay, jitterDistribution_(random_));
+        transfer->retryAt = std::chrono::steady_clock::now() + delay;
+
+        auto &state = getEndpointState(transfer->endpointHash);
+        state.retries.splice(state.retries.end(), transfers_, transfer);
+    }
+
+    void countDroppedPayload(std::size_t size) {
+        droppedPayloads_++;
+        droppedBytes_ += size;
+    }
+
+    // exponential moving average, retried transfers count with the whole time since enqueue
+    void updateExportLatency(std::chrono::steady_clock::time_point enqueuedAt) {
+        exportedPayloads_++;
+        if (enqueuedAt == std::chrono::steady_clock::time_point{}) {
+            return;
+        }
+        auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - enqueuedAt).count();
+        auto average = exportLatencyMs_.load();
+        exportLatencyMs_ = average == 0 ? latency : (average * 7 + latency) / 8;
+    }
+
+    void finishTransfer(std::list<Transfer>::iterator transfer) {
+        endpoints_.releaseConnection(transfer->connectionId, *transfer->sender);
+        getEndpointState(transfer->endpointHash).transfersInProgress--;
+        completeSequences(transfer->endpointHash, transfer->sequences);
+        transfers_.erase(transfer);
+    }
+
+    void abortTransfers() {
+        if (transfers_.empty()) {
+            return;
+        }
+
+        if (multiSender_) {
+            multiSender_->removeAllTransfers();
+        }
+        for (auto const &transfer : transfers_) {
+            endpoints_.releaseConnection(transfer.connectionId, *transfer.sender);
+            auto &state = getEndpointState(transfer.endpointHash);
+            state.transfersInProgress--;
+            state.circuitBreaker.onAbandoned();
+            completeSequences(transfer.endpointHash, transfer.sequences);
+        }
+        transfers_.clear();
+    }
+
+    void dropRetries(EndpointState &state) {
+        for (auto const &transfer : state.retries) {
+            endpoints_.releaseConnection(transfer.connectionId, *transfer.sender);
+            state.transfersInProgress--;
+            completeSequences(transfer.endpointHash, transfer.sequences);
+        }
+        state.retries.clear();
+    }
+
+    void dropRetries() {
+        for (auto &[endpointHash, state] : endpointsState_) {
+            dropRetries(state);
+        }
+    }
+
+    // assigns flush sequence to payload accepted into memory queue. Called with locked payloads mutex
+    uint64_t trackPayload(endpointUrlHash_t endpointHash) {
+        std::lock_guard<std::mutex> lock(flushMutex_);
+        auto &state = flushStates_[endpointHash];
+        state.pending.insert(++state.lastSequence);
+        return state.lastSequence;
+    }
+
+    // removes payloads which left transport from pending ones and wakes flush callers. flushAsync callbacks which aren't waiting anymore are collected,
+    // callers can hold payloads mutex, so callbacks are called later by runCompletedFlushCallbacks
+    void completeSequences(endpointUrlHash_t endpointHash, std::span<uint64_t const> sequences) {
+        {
+            std::lock_guard<std::mutex> lock(flushMutex_);
+            auto found = flushStates_.find(endpointHash);
+            if (found == flushStates_.end()) {
+                return;
+            }
+            for (auto sequence : sequences) {
+                found->second.pending.erase(sequence);
+            }
+            std::erase_if(found->second.waiters, [&](auto &waiter) {
+                if (!isFlushed(endpointHash, waiter.first)) {
+                    return false;
+                }
+                completedFlushCallbacks_.emplace_back(std::move(waiter.second));
+                return true;
+            });
+        }
+        flushCondition_.notify_all();
+    }
+
+    // must be called without locked payloads mutex, callbacks can take other locks or use transport
+    void runCompletedFlushCallbacks() {
+        std::vector<std::function<void()>> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(flushMutex_);
+            callbacks.swap(completedFlushCallbacks_);
+        }
+        for (auto const &callback : callbacks) {
+            callback();
+        }
+    }
+
+    // called with locked flush mutex
+    bool isFlushed(endpointUrlHash_t endpointHash, uint64_t sequence) const {
+        auto found = flushStates_.find(endpointHash);
+        return found == flushStates_.end() || found->second.pending.empty() || *found->second.pending.begin() > sequence;
+    }
+
+    // stops lingering of awaited payloads and wakes sender thread
+    void requestFlush(endpointUrlHash_t endpointHash, uint64_t sequence) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto &queue = payloadsQueues_[endpointHash];
+            queue.flushSequence = std::max(queue.flushSequence, sequence);
+            payloadsEnqueued_ = true;
+            if (multiSender_) {
+                multiSender_->wakeup();
+            }
+        }
+        pauseCondition_.notify_all();
+    }
+
+    bool hasPendingRetries() const {
+        return std::ranges::any_of(endpointsState_, [](auto const &state) { return !state.second.retries.empty(); });
+    }
+
+    std::size_t getRetriesCount() const {
+        std::size_t count = 0;
+        for (auto const &[endpointHash, state] : endpointsState_) {
+            count += state.retries.size();
+        }
+        return count;
+    }
+
+    // earliest time when scheduled retry becomes due, open circuit breaker allows probing again or lingering payloads have to be sent
+    std::optional<std::chrono::steady_clock::time_point> getNextTimerExpiration() const {
+        auto now = std::chrono::steady_clock::now();
+        std::optional<std::chrono::steady_clock::time_point> next;
+        auto update = [&next](std::chrono::steady_clock::time_point timePoint) {
+            if (!next.has_value() || timePoint < next.value()) {
+                next = timePoint;
+            }
+        };
+
+        for (auto const &[endpointHash, state] : endpointsState_) {
+            bool open = state.circuitBreaker.isOpen(now);
+            if (open) {
+                update(state.circuitBreaker.getOpenUntil());
+            }
+            for (auto const &transfer : state.retries) {
+                update(open ? std::max(transfer.retryAt, state.circuitBreaker.getOpenUntil()) : transfer.retryAt);
+            }
+        }
+
+        for (auto const &[endpointHash, queue] : payloadsQueues_) {
+            if (auto lingerExpiration = getLingerExpiration(queue); lingerExpiration.has_value()) {
+                update(lingerExpiration.value());
+            }
+        }
+        return next;
+    }
+
+    // makes room for payload within endpoint and total queue budgets. When total budget is exceeded, oldest payloads of lower priority endpoints are evicted first.
+    // Own oldest payloads are evicted only with drop_oldest overflow policy, otherwise new payload is rejected
+    bool reserveQueueSpace(endpointUrlHash_t endpointHash, PayloadsQueue &queue, std::size_t size) {
+        auto config = config_->get();
+        auto totalLimit = config->max_send_queue_size;
+        auto endpointLimit = getEndpointQueueLimit();
+        bool dropOldest = opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>(std::string_view(config->async_transport_queue_overflow_policy)) == opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("drop_oldest"sv);
+
+        if (size > endpointLimit || (!dropOldest && queue.byteUsage + size > endpointLimit)) {
+            return false;
+        }
+        while (queue.byteUsage + size > endpointLimit) {
+            evictOldestPayload(endpointHash, queue);
+        }
+
+        if (payloadsByteUsage_ + size <= totalLimit) {
+            return true;
+        }
+
+        auto priority = getQueuePriority(queue);
+        std::size_t evictable = dropOldest ? queue.byteUsage : 0;
+        for (auto const &[hash, other] : payloadsQueues_) {
+            if (getQueuePriority(other) > priority) {
+                evictable += other.byteUsage;
+            }
+        }
+        if (payloadsByteUsage_ - evictable + size > totalLimit) {
+            return false;
+        }
+
+        while (payloadsByteUsage_ + size > totalLimit) {
+            auto victimHash = endpointHash;
+            PayloadsQueue *victim = &queue;
+            auto victimPriority = priority;
+            for (auto &[hash, other] : payloadsQueues_) {
+                if (auto otherPriority = getQueuePriority(other); !other.payloads.empty() && otherPriority > victimPriority) {
+                    victimHash = hash;
+                    victim = &other;
+                    victimPriority = otherPriority;
+                }
+            }
+            evictOldestPayload(victimHash, *victim);
+        }
+        return true;
+    }
+
+    std::size_t getEndpointQueueLimit() const {
+        auto config = config_->get();
+        auto totalLimit = config->max_send_queue_size;
+        return config->async_transport_endpoint_queue_size > 0 ? std::min(config->async_transport_endpoint_queue_size, totalLimit) : totalLimit;
+    }
+
+    // evicted payload is spilled to disk if possible
+    void evictOldestPayload(endpointUrlHash_t endpointHash, PayloadsQueue &queue) {
+        auto &[payload, callback, enqueuedAt, sequence] = queue.payloads.front();
+        auto size = payload.size();
+        auto evictedSequence = sequence;
+        bool spilled = !callback && spillPayload(endpointHash, payload);
+        ELOG_DEBUG(log_, TRANSPORT, "HttpTransportAsync::enqueue evicting oldest payload of enpointHash: {:X} payload size: {}, endpoint queue size {} usage {} bytes, spilled: {}", endpointHash, size, queue.payloads.size(), queue.byteUsage, spilled);
+        if (!spilled) {
+            countDroppedPayload(size);
+        }
+        queue.payloads.pop_front();
+        queue.byteUsage -= size;
+        payloadsByteUsage_ -= size;
+        completeSequences(endpointHash, {&evictedSequence, 1});
+    }
+
+    // opens spill queue when OTEL_PHP_ASYNC_TRANSPORT_SPILL_DIRECTORY is set or changed. Directory which couldn't be opened isn't retried until configuration changes
+    DiskSpillQueue *getSpillQueue() {
+        auto config = config_->get();
+        auto const &directory = config->async_transport_spill_directory;
+        if (directory != spillDirectory_) {
+            spillQueue_.reset();
+            spillDirectory_ = directory;
+            if (!directory.empty()) {
+                try {
+                    spillQueue_ = std::make_unique<DiskSpillQueue>(log_, directory, config->async_transport_spill_max_size);
+                } catch (std::runtime_error const &error) {
+                    ELOG_WARNING(log_, TRANSPORT, "HttpTransportAsync spilling payloads to disk disabled: '{}'", error.what());
+                }
+            }
+        }
+        if (spillQueue_) {
+            spillQueue_->setMaxSize(config->async_transport_spill_max_size);
+        }
+        return spillQueue_.get();
+    }
+
+    bool hasSpilledPayloads(endpointUrlHash_t endpointHash) {
+        auto spillQueue = getSpillQueue();
+        return spillQueue && spillQueue->getPendingCount(endpointHash) > 0;
+    }
+
+    // payloads which wouldn't fit into endpoint queue are never spilled, they couldn't be replayed
+    bool spillPayload(endpointUrlHash_t endpointHash, PayloadBuffer const &payload) {
+        auto spillQueue = getSpillQueue();
+        if (!spillQueue || payload.size() > getEndpointQueueLimit() || !spillQueue->push(endpointHash, payload)) {
+            return false;
+        }
+        ELOG_TRACE(log_, TRANSPORT, "HttpTransportAsync payload spilled to disk. enpointHash: {:X} payload size: {}, spilled payloads {}, spill usage {} bytes", endpointHash, payload.size(), spillQueue->getPendingCount(endpointHash), spillQueue->getUsedBytes());
+        return true;
+    }
+
+    // empties endpoint queue, payloads without response callback are spilled to disk. Returns number of spilled payloads
+    std::size_t spillQueuedPayloads(endpointUrlHash_t endpointHash, PayloadsQueue &queue) {
+        std::size_t spilled = 0;
+        std::vector<uint64_t> sequences;
+        for (auto const &[payload, callback, enqueuedAt, sequence] : queue.payloads) {
+            if (!callback && spillPayload(endpointHash, payload)) {
+                spilled++;
+            }
+            sequences.push_back(sequence);
+        }
+        payloadsByteUsage_ -= queue.byteUsage;
+        queue.byteUsage = 0;
+        queue.payloads.clear();
+        completeSequences(endpointHash, sequences);
+        return spilled;
+    }
+
+    // lower value means higher priority. Endpoints of unknown signal type come last
+    std::size_t getQueuePriority(PayloadsQueue const &queue) {
+        auto config = config_->get();
+        if (signalsPriorityConfig_ != config->async_transport_signals_priority) {
+            signalsPriorityConfig_ = config->async_transport_signals_priority;
+            signalsPriority_.clear();
+            for (auto signal : std::views::split(std::string_view(signalsPriorityConfig_), ',')) {
+                auto name = opentelemetry::utils::trim(std::string_view(signal.begin(), signal.end()));
+                if (!name.empty()) {
+                    signalsPriority_.emplace_back(name);
+                }
+            }
+        }
+
+        auto found = std::ranges::find_if(signalsPriority_, [&queue](std::string const &signal) { return opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>(std::string_view(signal)) == opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>(queue.signal); });
+        return static_cast<std::size_t>(std::distance(signalsPriority_.begin(), found));
+    }
+
+    std::vector<std::tuple<std::size_t, endpointUrlHash_t, PayloadsQueue *>> getQueuesByPriority() {
+        std::vector<std::tuple<std::size_t, endpointUrlHash_t, PayloadsQueue *>> queues;
+        for (auto &[endpointHash, queue] : payloadsQueues_) {
+            if (!queue.payloads.empty()) {
+                queues.emplace_back(getQueuePriority(queue), endpointHash, &queue);
+            }
+        }
+        std::ranges::sort(queues, [](auto const &a, auto const &b) { return std::get<0>(a) < std::get<0>(b); });
+        return queues;
+    }
+
+    std::size_t getQueuedPayloadsCount() const {
+        std::size_t count = 0;
+        for (auto const &[endpointHash, queue] : payloadsQueues_) {
+            count += queue.payloads.size();
+        }
+        return count;
+    }
+
+    static std::string_view getEndpointSignal(std::string_view endpointUrl) {
+        return transport::getEndpointSignal(endpointUrl);
+    }
+
+    // merged OTLP protobuf export requests are valid requests, JSON documents and OpAMP messages can't be concatenated.
+    // gRPC payloads are merged before they are framed
+    static bool isCoalescable(std::string_view signal, std::string_view contentType) {
+        return isOtlpProtobufEndpoint(signal, contentType);
+    }
+
+    EndpointState &getEndpointState(endpointUrlHash_t endpointHash) {
+        auto config = config_->get();
+        auto [it, inserted] = endpointsState_.try_emplace(endpointHash, config->async_transport_circuit_breaker_threshold, config->async_transport_circuit_breaker_cooldown);
+        if (!inserted) {
+            it->second.circuitBreaker.configure(config->async_transport_circuit_breaker_threshold, config->async_transport_circuit_breaker_cooldown);
+        }
+        return it->second;
+    }
+
     void CurlInit() {
         auto curlInitResult = curl_global_init(CURL_GLOBAL_ALL);
         if (curlInitResult != CURLE_OK) {
@@ -229,14 +1083,39 @@ protected:
     std::shared_ptr<LoggerInterface> log_;
     std::shared_ptr<ConfigurationStorage> config_;
     Endpoints endpoints_;
+    std::shared_ptr<PayloadBufferPool> payloadBufferPool_ = std::make_shared<PayloadBufferPool>();
     std::mutex mutex_;
-    std::queue<std::tuple<endpointUrlHash_t, std::vector<std::byte>, responseCallback_t>> payloadsToSend_;
+    std::unordered_map<endpointUrlHash_t, PayloadsQueue> payloadsQueues_;
     std::size_t payloadsByteUsage_ = 0;
+    std::string signalsPriorityConfig_;
+    std::vector<std::string> signalsPriority_;
+    std::unique_ptr<DiskSpillQueue> spillQueue_;
+    std::string spillDirectory_; // directory spill queue was opened for
+
+    // taken after payloads mutex when both are needed
+    std::mutex flushMutex_;
+    std::condition_variable flushCondition_;
+    std::unordered_map<endpointUrlHash_t, FlushState> flushStates_;
+    std::vector<std::function<void()>> completedFlushCallbacks_; // flushAsync callbacks waiting to be called without locked payloads mutex
+
+    // owned by sender thread
+    std::unique_ptr<MultiSender> multiSender_;
+    std::list<Transfer> transfers_;
+    std::vector<typename std::list<Transfer>::iterator> transfersToStart_;
+    std::unordered_map<endpointUrlHash_t, EndpointState> endpointsState_;
+    std::minstd_rand random_{std::random_device{}()};
+    std::uniform_real_distribution<double> jitterDistribution_{0.0, 1.0};
 
     std::unique_ptr<std::thread> thread_;
     std::condition_variable pauseCondition_;
     bool working_ = true;
+    bool payloadsEnqueued_ = false;
     std::atomic_bool forceFlushOnDestruction_ = false;
+
+    std::atomic<uint64_t> droppedPayloads_ = 0;
+    std::atomic<uint64_t> droppedBytes_ = 0;
+    std::atomic<uint64_t> exportedPayloads_ = 0;
+    std::atomic<int64_t> exportLatencyMs_ = 0; // updated by sender thread only
     std::chrono::time_point<std::chrono::steady_clock> shutdownStart_;
 };
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "HttpEndpointSSLOptions.h"
+#include "PayloadBuffer.h"
+#include "PayloadCompression.h"
 
 #include <chrono>
 #include <cstddef>
@@ -20,9 +22,12 @@ public:
 
     virtual ~HttpTransportAsyncInterface() = default;
 
-    virtual void initializeConnection(std::string endpointUrl, std::size_t endpointHash, std::string contentType, enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, HttpEndpointSSLOptions sslOptions) = 0;
-    virtual void enqueue(std::size_t endpointHash, std::span<std::byte> payload, responseCallback_t callback = {}) = 0;
+    virtual void initializeConnection(std::string endpointUrl, std::size_t endpointHash, std::string contentType, enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, HttpEndpointSSLOptions sslOptions, PayloadCompression compression) = 0;
+    // payload may be borrowed (see PayloadBuffer::borrow), implementation must retain it if it is kept after return
+    virtual void enqueue(std::size_t endpointHash, PayloadBuffer payload, responseCallback_t callback = {}) = 0;
     virtual void updateRetryDelay(size_t endpointHash, std::chrono::milliseconds retryDelay) = 0;
+    // waits until payloads enqueued for endpoint before the call are sent, rejected, dropped or stored in spill directory. Returns false if timeout was reached first
+    virtual bool flush(std::size_t endpointHash, std::chrono::milliseconds timeout) = 0;
 };
 
 } // namespace opentelemetry::php::transport
\ No newline at end of file
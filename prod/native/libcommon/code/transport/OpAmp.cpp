@@ -14,18 +14,19 @@ using namespace std::literals;
 namespace opentelemetry::php::transport {
 
 void OpAmp::startCommunication() {
-    if (config_->get().opamp_endpoint.empty()) {
+    auto config = config_->get();
+    if (config->opamp_endpoint.empty()) {
         ELOG_DEBUG(log_, OPAMP, "disabled");
         return;
     }
 
-    auto opampHeaders = opentelemetry::utils::parseUrlEncodedKeyValueString(config_->get().opamp_headers);
+    auto opampHeaders = opentelemetry::utils::parseUrlEncodedKeyValueString(config->opamp_headers);
     std::vector<std::pair<std::string_view, std::string_view>> endpointHeaders;
     for (const auto &[k, v] : opampHeaders) {
         endpointHeaders.push_back(std::pair<std::string_view, std::string_view>(k, v));
     }
 
-    std::string endpointUrl = config_->get().opamp_endpoint;
+    std::string endpointUrl = config->opamp_endpoint;
 
     auto url = opentelemetry::utils::parseUrl(endpointUrl);
     if (url.has_value()) {
@@ -41,8 +42,8 @@ void OpAmp::startCommunication() {
     }
 
     endpointHash_ = std::hash<std::string>{}(endpointUrl);
-    heartbeatInterval_ = config_->get().opamp_heartbeat_interval;
-    pollingInterval_ = config_->get().opamp_polling_interval;
+    heartbeatInterval_ = config->opamp_heartbeat_interval;
+    pollingInterval_ = config->opamp_polling_interval;
 
     ELOG_DEBUG(log_, OPAMP, "Agent UID: '{}', endpoint: '{}', endpoint hash: '{:X}', heartbeat interval: {}ms, polling interval: {}ms", boost::uuids::to_string(agentUid_), endpointUrl, endpointHash_, heartbeatInterval_.load().count(), pollingInterval_.load().count());
     for (auto const &[k, v] : endpointHeaders) {
@@ -50,14 +51,14 @@ void OpAmp::startCommunication() {
     }
 
     opentelemetry::php::transport::HttpEndpointSSLOptions sslOptions;
-    sslOptions.insecureSkipVerify = config_->get().opamp_insecure;
-    sslOptions.caInfo = config_->get().opamp_certificate;
-    sslOptions.cert = config_->get().opamp_client_certificate;
-    sslOptions.certKey = config_->get().opamp_client_key;
-    sslOptions.certKeyPassword = config_->get().opamp_client_keypass;
+    sslOptions.insecureSkipVerify = config->opamp_insecure;
+    sslOptions.caInfo = config->opamp_certificate;
+    sslOptions.cert = config->opamp_client_certificate;
+    sslOptions.certKey = config->opamp_client_key;
+    sslOptions.certKeyPassword = config->opamp_client_keypass;
     ELOG_TRACE(log_, OPAMP, "OpAmp endpoint hash '{:X}' SSL options: insecureSkipVerify: {}, caInfo: '{}', cert: '{}', certKey: '{}', certKeyPassword: '{}'", endpointHash_, sslOptions.insecureSkipVerify, sslOptions.caInfo, sslOptions.cert, sslOptions.certKey, !sslOptions.certKeyPassword.empty() ? "<redacted>"sv : "");
 
-    transport_->initializeConnection(endpointUrl, endpointHash_, "application/x-protobuf"s, endpointHeaders, config_->get().opamp_send_timeout, config_->get().opamp_send_max_retries, config_->get().opamp_send_retry_delay, sslOptions);
+    transport_->initializeConnection(endpointUrl, endpointHash_, "application/x-protobuf"s, endpointHeaders, config->opamp_send_timeout, config->opamp_send_max_retries, config->opamp_send_retry_delay, sslOptions, PayloadCompression::none);
     startThread();
     try {
         sendInitialAgentToServer();
@@ -165,7 +166,7 @@ void OpAmp::sendInitialAgentToServer() {
         }
     };
 
-    transport_->enqueue(endpointHash_, {reinterpret_cast<std::byte *>(payload.data()), payload.length()}, callback);
+    transport_->enqueue(endpointHash_, PayloadBuffer::adopt(std::move(payload)), callback);
 }
 
 void OpAmp::sendHeartbeat() {
@@ -193,7 +194,7 @@ void OpAmp::sendHeartbeat() {
             self->handleServerToAgent(reinterpret_cast<const char *>(data.data()), data.size_bytes());
         }
     };
-    transport_->enqueue(endpointHash_, {reinterpret_cast<std::byte *>(payload.data()), payload.length()}, callback);
+    transport_->enqueue(endpointHash_, PayloadBuffer::adopt(std::move(payload)), callback);
 }
 
 } // namespace opentelemetry::php::transport
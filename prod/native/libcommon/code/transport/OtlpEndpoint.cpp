@@ -0,0 +1,35 @@
+#include "OtlpEndpoint.h"
+#include "CiCharTraits.h"
+#include "GrpcFraming.h"
+
+#include <array>
+#include <utility>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::transport {
+
+std::string_view getEndpointSignal(std::string_view endpointUrl) {
+    static constexpr std::array<std::pair<std::string_view, std::string_view>, 7> signalPaths{{{"/v1/opamp"sv, "opamp"sv}, {"/v1/traces"sv, "traces"sv}, {"/v1/metrics"sv, "metrics"sv}, {"/v1/logs"sv, "logs"sv}, {".TraceService/Export"sv, "traces"sv}, {".MetricsService/Export"sv, "metrics"sv}, {".LogsService/Export"sv, "logs"sv}}};
+
+    auto path = endpointUrl.substr(0, endpointUrl.find_first_of("?#"sv));
+    while (path.ends_with('/')) {
+        path.remove_suffix(1);
+    }
+    for (auto const &[suffix, signal] : signalPaths) {
+        if (path.ends_with(suffix)) {
+            return signal;
+        }
+    }
+    return {};
+}
+
+bool isOtlpProtobufEndpoint(std::string_view signal, std::string_view contentType) {
+    if (signal.empty() || signal == "opamp"sv) {
+        return false;
+    }
+    auto type = opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>(contentType);
+    return type.starts_with(opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("application/x-protobuf"sv)) || (isGrpcContentType(contentType) && !type.contains(opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("json"sv)));
+}
+
+} // namespace opentelemetry::php::transport
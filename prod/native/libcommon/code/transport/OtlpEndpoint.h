@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string_view>
+
+namespace opentelemetry::php::transport {
+
+// recognizes OTLP/HTTP signal paths, OTLP/gRPC service methods and OpAMP endpoint. Returns "traces", "metrics", "logs", "opamp" or empty string
+std::string_view getEndpointSignal(std::string_view endpointUrl);
+
+// payloads of endpoint are serialized OTLP Export*ServiceRequest messages (OTLP/HTTP protobuf or OTLP/gRPC before framing), so they can be decoded, merged or split
+bool isOtlpProtobufEndpoint(std::string_view signal, std::string_view contentType);
+
+} // namespace opentelemetry::php::transport
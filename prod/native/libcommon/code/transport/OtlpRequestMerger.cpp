@@ -0,0 +1,185 @@
+#include "OtlpRequestMerger.h"
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+namespace opentelemetry::php::transport {
+
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::io::CodedOutputStream;
+using google::protobuf::internal::WireFormatLite;
+
+namespace {
+
+constexpr int resourceEntriesFieldNumber = 1;
+constexpr int resourceFieldNumber = 1;
+constexpr int scopeEntriesFieldNumber = 2;
+constexpr int schemaUrlFieldNumber = 3;
+
+struct ResourceEntry {
+    std::optional<std::span<std::byte const>> resource;
+    std::optional<std::span<std::byte const>> schemaUrl;
+    std::vector<std::span<std::byte const>> scopeEntries; // complete fields including tag and length
+};
+
+std::size_t getLengthDelimitedFieldSize(int fieldNumber, std::size_t length) {
+    return CodedOutputStream::VarintSize32(WireFormatLite::MakeTag(fieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED)) + CodedOutputStream::VarintSize64(length) + length;
+}
+
+std::size_t getEntrySize(ResourceEntry const &entry) {
+    std::size_t size = 0;
+    if (entry.resource) {
+        size += getLengthDelimitedFieldSize(resourceFieldNumber, entry.resource->size());
+    }
+    for (auto const &scopeEntry : entry.scopeEntries) {
+        size += scopeEntry.size();
+    }
+    if (entry.schemaUrl) {
+        size += getLengthDelimitedFieldSize(schemaUrlFieldNumber, entry.schemaUrl->size());
+    }
+    return size;
+}
+
+uint8_t *writeLengthDelimitedField(uint8_t *out, int fieldNumber, std::span<std::byte const> value) {
+    out = CodedOutputStream::WriteVarint32ToArray(WireFormatLite::MakeTag(fieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED), out);
+    out = CodedOutputStream::WriteVarint64ToArray(value.size(), out);
+    if (!value.empty()) {
+        std::memcpy(out, value.data(), value.size());
+    }
+    return out + value.size();
+}
+
+// reads length delimited field value, input must be positioned after tag
+std::optional<std::span<std::byte const>> readLengthDelimited(CodedInputStream &input, std::span<std::byte const> buffer) {
+    uint32_t length = 0;
+    if (!input.ReadVarint32(&length)) {
+        return std::nullopt;
+    }
+    auto offset = static_cast<std::size_t>(input.CurrentPosition());
+    if (!input.Skip(static_cast<int>(length))) {
+        return std::nullopt;
+    }
+    return buffer.subspan(offset, length);
+}
+
+std::optional<ResourceEntry> parseResourceEntry(std::span<std::byte const> buffer) {
+    CodedInputStream input(reinterpret_cast<uint8_t const *>(buffer.data()), static_cast<int>(buffer.size()));
+    ResourceEntry entry;
+
+    while (true) {
+        auto fieldOffset = static_cast<std::size_t>(input.CurrentPosition());
+        uint32_t tag = input.ReadTag();
+        if (tag == 0) {
+            break;
+        }
+        if (WireFormatLite::GetTagWireType(tag) != WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+            return std::nullopt;
+        }
+
+        auto value = readLengthDelimited(input, buffer);
+        if (!value) {
+            return std::nullopt;
+        }
+
+        switch (WireFormatLite::GetTagFieldNumber(tag)) {
+            case resourceFieldNumber:
+                entry.resource = value;
+                break;
+            case scopeEntriesFieldNumber:
+                entry.scopeEntries.emplace_back(buffer.subspan(fieldOffset, static_cast<std::size_t>(input.CurrentPosition()) - fieldOffset));
+                break;
+            case schemaUrlFieldNumber:
+                entry.schemaUrl = value;
+                break;
+            default:
+                return std::nullopt;
+        }
+    }
+
+    if (!input.ConsumedEntireMessage()) {
+        return std::nullopt;
+    }
+    return entry;
+}
+
+std::string getEntryKey(ResourceEntry const &entry) {
+    // presence flags keep absent and empty fields apart
+    std::string key;
+    key.push_back(entry.resource ? '1' : '0');
+    key.push_back(entry.schemaUrl ? '1' : '0');
+    if (entry.resource) {
+        auto size = entry.resource->size();
+        key.append(reinterpret_cast<char const *>(&size), sizeof(size));
+        key.append(reinterpret_cast<char const *>(entry.resource->data()), entry.resource->size());
+    }
+    if (entry.schemaUrl) {
+        key.append(reinterpret_cast<char const *>(entry.schemaUrl->data()), entry.schemaUrl->size());
+    }
+    return key;
+}
+
+} // namespace
+
+std::optional<PayloadBuffer> mergeOtlpRequests(PayloadBufferPool &pool, std::span<PayloadBuffer const> payloads) {
+    std::vector<ResourceEntry> entries;
+    std::unordered_map<std::string, std::size_t> entriesByKey;
+
+    for (auto const &payload : payloads) {
+        std::span<std::byte const> buffer = payload;
+        CodedInputStream input(reinterpret_cast<uint8_t const *>(buffer.data()), static_cast<int>(buffer.size()));
+        while (uint32_t tag = input.ReadTag()) {
+            if (WireFormatLite::GetTagFieldNumber(tag) != resourceEntriesFieldNumber || WireFormatLite::GetTagWireType(tag) != WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+                return std::nullopt;
+            }
+            auto value = readLengthDelimited(input, buffer);
+            if (!value) {
+                return std::nullopt;
+            }
+            auto entry = parseResourceEntry(*value);
+            if (!entry) {
+                return std::nullopt;
+            }
+
+            auto [it, inserted] = entriesByKey.try_emplace(getEntryKey(*entry), entries.size());
+            if (inserted) {
+                entries.emplace_back(std::move(*entry));
+            } else {
+                auto &scopeEntries = entries[it->second].scopeEntries;
+                scopeEntries.insert(scopeEntries.end(), entry->scopeEntries.begin(), entry->scopeEntries.end());
+            }
+        }
+        if (!input.ConsumedEntireMessage()) {
+            return std::nullopt;
+        }
+    }
+
+    std::size_t size = 0;
+    for (auto const &entry : entries) {
+        size += getLengthDelimitedFieldSize(resourceEntriesFieldNumber, getEntrySize(entry));
+    }
+
+    auto merged = pool.allocate(size);
+    auto *out = reinterpret_cast<uint8_t *>(merged.data());
+    for (auto const &entry : entries) {
+        out = CodedOutputStream::WriteVarint32ToArray(WireFormatLite::MakeTag(resourceEntriesFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED), out);
+        out = CodedOutputStream::WriteVarint64ToArray(getEntrySize(entry), out);
+        if (entry.resource) {
+            out = writeLengthDelimitedField(out, resourceFieldNumber, *entry.resource);
+        }
+        for (auto const &scopeEntry : entry.scopeEntries) {
+            std::memcpy(out, scopeEntry.data(), scopeEntry.size());
+            out += scopeEntry.size();
+        }
+        if (entry.schemaUrl) {
+            out = writeLengthDelimitedField(out, schemaUrlFieldNumber, *entry.schemaUrl);
+        }
+    }
+    return std::move(merged).freeze();
+}
+
+} // namespace opentelemetry::php::transport
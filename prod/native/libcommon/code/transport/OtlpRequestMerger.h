@@ -0,0 +1,16 @@
+#pragma once
+
+#include "PayloadBuffer.h"
+
+#include <optional>
+#include <span>
+
+namespace opentelemetry::php::transport {
+
+// Merges serialized OTLP Export{Trace,Metrics,Logs}ServiceRequest messages at protobuf wire level. Resource{Spans,Metrics,Logs} entries with byte identical
+// resource and schema_url are joined into single entry holding scope entries of all of them, so resource of many workers is sent once per request.
+// All signals share field numbers: request.resource_* = 1, resource_*.resource = 1, resource_*.scope_* = 2, resource_*.schema_url = 3.
+// Returns std::nullopt if any payload contains field it doesn't know, caller can still concatenate payloads
+std::optional<PayloadBuffer> mergeOtlpRequests(PayloadBufferPool &pool, std::span<PayloadBuffer const> payloads);
+
+} // namespace opentelemetry::php::transport
@@ -0,0 +1,136 @@
+#include "PayloadBuffer.h"
+
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace opentelemetry::php::transport {
+
+PayloadBuffer PayloadBuffer::adopt(std::vector<std::byte> &&data) {
+    auto owner = std::make_shared<std::vector<std::byte>>(std::move(data));
+    auto size = owner->size();
+    return {std::shared_ptr<std::byte const>(owner, owner->data()), size};
+}
+
+PayloadBuffer PayloadBuffer::adopt(std::string &&data) {
+    auto owner = std::make_shared<std::string>(std::move(data));
+    auto size = owner->size();
+    return {std::shared_ptr<std::byte const>(owner, reinterpret_cast<std::byte const *>(owner->data())), size};
+}
+
+PayloadBuffer PayloadBuffer::borrow(std::span<std::byte const> data) {
+    // aliasing constructor with empty owner - pointer without control block
+    return {std::shared_ptr<std::byte const>(std::shared_ptr<void>(), data.data()), data.size()};
+}
+
+PayloadBuffer PayloadBuffer::retain(PayloadBufferPool &pool) const {
+    if (!isBorrowed()) {
+        return *this;
+    }
+    return pool.copy(*this);
+}
+
+PayloadBuffer PayloadBuffer::subbuffer(std::size_t offset, std::size_t count) const {
+    if (offset > size_ || count > size_ - offset) {
+        throw std::out_of_range("PayloadBuffer::subbuffer range exceeds buffer size");
+    }
+    return {std::shared_ptr<std::byte const>(data_, data_.get() + offset), count};
+}
+
+void WritablePayloadBuffer::shrink(std::size_t size) {
+    if (size > size_) {
+        throw std::out_of_range("WritablePayloadBuffer::shrink size exceeds buffer size");
+    }
+    size_ = size;
+}
+
+PayloadBuffer WritablePayloadBuffer::freeze() && {
+    auto size = size_;
+    size_ = 0;
+    return {std::move(data_), size};
+}
+
+WritablePayloadBuffer PayloadBufferPool::allocate(std::size_t size) {
+    if (size > maxBlockSize) {
+        return {std::shared_ptr<std::byte>(new std::byte[size], std::default_delete<std::byte[]>()), size};
+    }
+
+    auto sizeClass = getSizeClass(size);
+    std::unique_ptr<std::byte[]> block;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &freeBlocks = freeBlocks_[sizeClass];
+        if (!freeBlocks.empty()) {
+            block = std::move(freeBlocks.back());
+            freeBlocks.pop_back();
+            pooledBytes_ -= getBlockSize(sizeClass);
+        }
+    }
+    if (!block) {
+        block = std::make_unique_for_overwrite<std::byte[]>(getBlockSize(sizeClass));
+    }
+
+    std::shared_ptr<std::byte> data(block.release(), [pool = weak_from_this(), sizeClass](std::byte *ptr) {
+        if (auto owner = pool.lock(); owner) {
+            owner->release(sizeClass, ptr);
+        } else {
+            delete[] ptr;
+        }
+    });
+    return {std::move(data), size};
+}
+
+PayloadBuffer PayloadBufferPool::copy(std::span<std::byte const> data) {
+    auto buffer = allocate(data.size());
+    if (!data.empty()) {
+        std::memcpy(buffer.data(), data.data(), data.size());
+    }
+    return std::move(buffer).freeze();
+}
+
+void PayloadBufferPool::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &freeBlocks : freeBlocks_) {
+        freeBlocks.clear();
+    }
+    pooledBytes_ = 0;
+}
+
+std::size_t PayloadBufferPool::getPooledBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pooledBytes_;
+}
+
+std::size_t PayloadBufferPool::getPooledBlocksCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t count = 0;
+    for (auto const &freeBlocks : freeBlocks_) {
+        count += freeBlocks.size();
+    }
+    return count;
+}
+
+std::size_t PayloadBufferPool::getSizeClass(std::size_t size) {
+    if (size <= minBlockSize) {
+        return 0;
+    }
+    return static_cast<std::size_t>(std::bit_width(size - 1) - std::bit_width(minBlockSize - 1));
+}
+
+std::size_t PayloadBufferPool::getBlockSize(std::size_t sizeClass) {
+    return minBlockSize << sizeClass;
+}
+
+void PayloadBufferPool::release(std::size_t sizeClass, std::byte *block) {
+    std::unique_ptr<std::byte[]> owned(block);
+    auto blockSize = getBlockSize(sizeClass);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pooledBytes_ + blockSize > maxPooledBytes_) {
+        return;
+    }
+    freeBlocks_[sizeClass].emplace_back(std::move(owned));
+    pooledBytes_ += blockSize;
+}
+
+} // namespace opentelemetry::php::transport
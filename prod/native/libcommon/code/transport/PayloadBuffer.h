@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace opentelemetry::php::transport {
+
+class PayloadBufferPool;
+
+// Refcounted, immutable payload bytes. Copies share the same storage, so payload can be handed over between queues, transfers and retries without copying the data.
+// Storage is freed or returned to its PayloadBufferPool when the last copy is destroyed
+class PayloadBuffer {
+public:
+    PayloadBuffer() = default;
+    PayloadBuffer(std::shared_ptr<std::byte const> data, std::size_t size) : data_(std::move(data)), size_(size) {
+    }
+
+    // takes ownership of container storage without copying bytes
+    static PayloadBuffer adopt(std::vector<std::byte> &&data);
+    static PayloadBuffer adopt(std::string &&data);
+
+    // non owning view, valid only as long as the viewed memory. Use retain() before storing it beyond the current call
+    static PayloadBuffer borrow(std::span<std::byte const> data);
+
+    std::byte const *data() const noexcept {
+        return data_.get();
+    }
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    bool isBorrowed() const noexcept {
+        return data_ && data_.use_count() == 0;
+    }
+
+    operator std::span<std::byte const>() const noexcept {
+        return {data_.get(), size_};
+    }
+
+    // returns this buffer if it owns its storage, otherwise copies viewed bytes to storage taken from pool
+    PayloadBuffer retain(PayloadBufferPool &pool) const;
+
+    // part of this buffer sharing the same storage
+    PayloadBuffer subbuffer(std::size_t offset, std::size_t count) const;
+
+private:
+    std::shared_ptr<std::byte const> data_;
+    std::size_t size_ = 0;
+};
+
+// Storage taken from PayloadBufferPool, filled once by producer and then frozen into PayloadBuffer
+class WritablePayloadBuffer {
+public:
+    WritablePayloadBuffer() = default;
+
+    std::byte *data() noexcept {
+        return data_.get();
+    }
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    // shrinks buffer to number of bytes actually written
+    void shrink(std::size_t size);
+
+    PayloadBuffer freeze() &&;
+
+private:
+    friend class PayloadBufferPool;
+    WritablePayloadBuffer(std::shared_ptr<std::byte> data, std::size_t size) : data_(std::move(data)), size_(size) {
+    }
+
+    std::shared_ptr<std::byte> data_;
+    std::size_t size_ = 0;
+};
+
+// Power of two size classes of payload storage blocks. Released blocks are kept for reuse up to maxPooledBytes, so multi-megabyte batches
+// don't go through the allocator (and mmap/munmap) on every enqueue. Blocks bigger than maxBlockSize are not pooled.
+// Pool must be created by std::make_shared, blocks released after pool destruction are freed
+class PayloadBufferPool : public std::enable_shared_from_this<PayloadBufferPool> {
+public:
+    static constexpr std::size_t minBlockSize = 4 * 1024;
+    static constexpr std::size_t maxBlockSize = 16 * 1024 * 1024;
+    static constexpr std::size_t defaultMaxPooledBytes = 32 * 1024 * 1024;
+
+    explicit PayloadBufferPool(std::size_t maxPooledBytes = defaultMaxPooledBytes) : maxPooledBytes_(maxPooledBytes) {
+    }
+
+    WritablePayloadBuffer allocate(std::size_t size);
+    PayloadBuffer copy(std::span<std::byte const> data);
+
+    // drops all pooled blocks
+    void trim();
+
+    std::size_t getPooledBytes() const;
+    std::size_t getPooledBlocksCount() const;
+
+private:
+    static constexpr std::size_t sizeClassesCount = 13; // 4KB - 16MB
+
+    static std::size_t getSizeClass(std::size_t size);
+    static std::size_t getBlockSize(std::size_t sizeClass);
+
+    void release(std::size_t sizeClass, std::byte *block);
+
+    mutable std::mutex mutex_;
+    std::array<std::vector<std::unique_ptr<std::byte[]>>, sizeClassesCount> freeBlocks_;
+    std::size_t maxPooledBytes_;
+    std::size_t pooledBytes_ = 0;
+};
+
+} // namespace opentelemetry::php::transport
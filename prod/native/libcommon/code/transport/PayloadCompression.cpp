@@ -0,0 +1,91 @@
+#include "PayloadCompression.h"
+#include "CiCharTraits.h"
+
+#include <stdexcept>
+#include <string>
+#include <zlib.h>
+#include <zstd.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::transport {
+
+namespace {
+
+std::vector<std::byte> compressGzip(std::span<std::byte const> payload) {
+    z_stream stream{};
+    // windowBits 15 + 16 makes zlib write gzip header and trailer instead of zlib wrapper
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("gzip compression initialization failed");
+    }
+
+    std::vector<std::byte> output(deflateBound(&stream, payload.size()));
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<std::byte *>(payload.data()));
+    stream.avail_in = static_cast<uInt>(payload.size());
+    stream.next_out = reinterpret_cast<Bytef *>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    int result = deflate(&stream, Z_FINISH);
+    if (result != Z_STREAM_END) {
+        std::string msg = "gzip compression failed: "s;
+        msg.append(stream.msg ? stream.msg : std::to_string(result));
+        deflateEnd(&stream);
+        throw std::runtime_error(msg);
+    }
+    deflateEnd(&stream);
+
+    output.resize(stream.total_out);
+    return output;
+}
+
+std::vector<std::byte> compressZstd(std::span<std::byte const> payload) {
+    std::vector<std::byte> output(ZSTD_compressBound(payload.size()));
+    size_t result = ZSTD_compress(output.data(), output.size(), payload.data(), payload.size(), ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(result)) {
+        std::string msg = "zstd compression failed: "s;
+        msg.append(ZSTD_getErrorName(result));
+        throw std::runtime_error(msg);
+    }
+
+    output.resize(result);
+    return output;
+}
+
+} // namespace
+
+std::optional<PayloadCompression> parsePayloadCompression(std::string_view value) {
+    auto compression = opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>(value);
+    if (compression.empty() || compression == opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("none"sv)) {
+        return PayloadCompression::none;
+    } else if (compression == opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("gzip"sv)) {
+        return PayloadCompression::gzip;
+    } else if (compression == opentelemetry::utils::traits_cast<opentelemetry::utils::CiCharTraits>("zstd"sv)) {
+        return PayloadCompression::zstd;
+    }
+    return std::nullopt;
+}
+
+std::string_view getContentEncoding(PayloadCompression compression) {
+    switch (compression) {
+        case PayloadCompression::gzip:
+            return "gzip"sv;
+        case PayloadCompression::zstd:
+            return "zstd"sv;
+        default:
+            return {};
+    }
+}
+
+std::vector<std::byte> compressPayload(PayloadCompression compression, std::span<std::byte const> payload) {
+    switch (compression) {
+        case PayloadCompression::none:
+            return {payload.begin(), payload.end()};
+        case PayloadCompression::gzip:
+            return compressGzip(payload);
+        case PayloadCompression::zstd:
+            return compressZstd(payload);
+    }
+    throw std::runtime_error("unknown compression");
+}
+
+} // namespace opentelemetry::php::transport
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace opentelemetry::php::transport {
+
+enum class PayloadCompression : uint8_t {
+    none,
+    gzip,
+    zstd
+};
+
+// accepts values of OTEL_EXPORTER_OTLP_COMPRESSION (case insensitive). Empty value means none
+std::optional<PayloadCompression> parsePayloadCompression(std::string_view value);
+
+// value of Content-Encoding header, empty for none
+std::string_view getContentEncoding(PayloadCompression compression);
+
+// throws std::runtime_error if compression failed
+std::vector<std::byte> compressPayload(PayloadCompression compression, std::span<std::byte const> payload);
+
+} // namespace opentelemetry::php::transport
@@ -168,6 +168,27 @@ TEST_F(CommonUtilsTest, getConnectionDetailsFromURL) {
     ASSERT_NE(getConnectionDetailsFromURL("https://localhost").value_or(""), "http://localhost"s);
     ASSERT_EQ(getConnectionDetailsFromURL("localhost"), std::nullopt);
     ASSERT_EQ(getConnectionDetailsFromURL("ftp:://localhost"), std::nullopt);
+
+    ASSERT_EQ(getConnectionDetailsFromURL("unix:///run/otelcol.sock").value_or(""), "unix:///run/otelcol.sock"s);
+    ASSERT_EQ(getConnectionDetailsFromURL("unix:///run/otelcol.sock:/v1/traces").value_or(""), "unix:///run/otelcol.sock"s);
+    ASSERT_EQ(getConnectionDetailsFromURL("unix://relative.sock"), std::nullopt);
+}
+
+TEST_F(CommonUtilsTest, parseUnixSocketURL) {
+    auto parsed = parseUnixSocketURL("unix:///run/otelcol.sock:/v1/traces?tenant=a");
+    ASSERT_TRUE(parsed.has_value());
+    ASSERT_EQ(parsed->socketPath, "/run/otelcol.sock"s);
+    ASSERT_EQ(parsed->requestPath, "/v1/traces?tenant=a"s);
+
+    parsed = parseUnixSocketURL("unix:///run/otelcol.sock");
+    ASSERT_TRUE(parsed.has_value());
+    ASSERT_EQ(parsed->socketPath, "/run/otelcol.sock"s);
+    ASSERT_EQ(parsed->requestPath, "/"s);
+
+    ASSERT_FALSE(parseUnixSocketURL("http://localhost/v1/traces").has_value());
+    ASSERT_FALSE(parseUnixSocketURL("unix:///run/otelcol.sock:v1/traces").has_value());
+    ASSERT_FALSE(parseUnixSocketURL("unix:///").has_value());
+    ASSERT_FALSE(parseUnixSocketURL("unix://").has_value());
 }
 
 TEST_F(CommonUtilsTest, parseLogFeatures_Empty) {
@@ -348,5 +369,22 @@ TEST_F(CommonUtilsTest, parseRetryAfter_httpDateInThePastReturnsZero) {
     ASSERT_TRUE(result.has_value());
     EXPECT_EQ(result.value(), std::chrono::milliseconds(0));
 }
+
+TEST_F(CommonUtilsTest, getRetryBackoffDelay_growsExponentially) {
+    EXPECT_EQ(getRetryBackoffDelay(100ms, 1, 10s, 0.0), 100ms);
+    EXPECT_EQ(getRetryBackoffDelay(100ms, 2, 10s, 0.0), 200ms);
+    EXPECT_EQ(getRetryBackoffDelay(100ms, 4, 10s, 0.0), 800ms);
+}
+
+TEST_F(CommonUtilsTest, getRetryBackoffDelay_limitedToMaxDelay) {
+    EXPECT_EQ(getRetryBackoffDelay(100ms, 10, 1s, 0.0), 1s);
+    EXPECT_EQ(getRetryBackoffDelay(100ms, 1000, 30s, 0.0), 30s);
+}
+
+TEST_F(CommonUtilsTest, getRetryBackoffDelay_jitterReducesDelayUpToHalf) {
+    EXPECT_EQ(getRetryBackoffDelay(100ms, 2, 10s, 0.5), 150ms);
+    EXPECT_EQ(getRetryBackoffDelay(100ms, 2, 10s, 1.0), 100ms);
+    EXPECT_EQ(getRetryBackoffDelay(0ms, 3, 10s, 0.5), 0ms);
+}
 }
 
@@ -1,4 +1,5 @@
 #include "ConfigurationManager.h"
+#include "CommonUtils.h"
 
 #include "Logger.h"
 #include <string_view>
@@ -96,6 +97,12 @@ TEST_F(ConfigurationManagerTest, getOptionValue) {
 
     ASSERT_EQ(std::get<bool>(cfg_.getOptionValue("enabled"sv, snapshot)), false);
     ASSERT_TRUE(std::holds_alternative<std::nullopt_t>(cfg_.getOptionValue("unknown"sv, snapshot)));
+
+    // string value doesn't refer to snapshot
+    auto held = std::make_unique<ConfigurationSnapshot>(snapshot);
+    auto policy = cfg_.getOptionValue("async_transport_queue_overflow_policy"sv, *held);
+    held.reset();
+    ASSERT_EQ(std::get<std::string>(policy), "drop_newest");
 }
 
 TEST_F(ConfigurationManagerTest, getConfigFromEnvVar_NativeOtelOptions) {
@@ -179,4 +186,55 @@ TEST_F(ConfigurationManagerTest, iniOptionTakesPrecedenceOverEnvVar) {
     ASSERT_EQ(snapshot.OTEL_PHP_BOOTSTRAP_PHP_PART_FILE, "some_value");
 }
 
+TEST_F(ConfigurationManagerTest, removedValueRestoresDefault) {
+    EXPECT_CALL(*optionValueProviderMock_, getIniOptionValue(::testing::_)).Times(::testing::AnyNumber()).WillRepeatedly(::testing::Return(std::nullopt));
+    EXPECT_CALL(*optionValueProviderMock_, getEnvironmentOptionValue(::testing::_)).Times(::testing::AnyNumber()).WillRepeatedly(::testing::Return(std::nullopt));
+    EXPECT_CALL(*optionValueProviderMock_, getDynamicOptionValue(::testing::_)).Times(::testing::AnyNumber()).WillRepeatedly(::testing::Return(std::nullopt));
+    EXPECT_CALL(*optionValueProviderMock_, getDynamicOptionValue("enabled")).Times(::testing::Exactly(4)).WillOnce(::testing::Return("off")).WillOnce(::testing::Return("off")).WillOnce(::testing::Return(std::nullopt)).WillOnce(::testing::Return("off")).RetiresOnSaturation();
+    EXPECT_CALL(*optionValueProviderMock_, getDynamicOptionValue("bootstrap_php_part_file")).Times(::testing::Exactly(4)).WillRepeatedly(::testing::Return("some_value")).RetiresOnSaturation();
+    EXPECT_CALL(*optionValueProviderMock_, update(::testing::_)).Times(::testing::Exactly(4));
+
+    ConfigurationSnapshot snapshot;
+    cfg_.update({});
+    cfg_.updateIfChanged(snapshot);
+    ASSERT_FALSE(snapshot.enabled);
+
+    // unchanged raw values keep values parsed before
+    cfg_.update({});
+    cfg_.updateIfChanged(snapshot);
+    ASSERT_FALSE(snapshot.enabled);
+    ASSERT_EQ(snapshot.OTEL_PHP_BOOTSTRAP_PHP_PART_FILE, "some_value");
+
+    cfg_.update({});
+    cfg_.updateIfChanged(snapshot);
+    ASSERT_EQ(snapshot.enabled, ConfigurationSnapshot().enabled);
+
+    cfg_.update({});
+    cfg_.updateIfChanged(snapshot);
+    ASSERT_FALSE(snapshot.enabled);
+    ASSERT_EQ(snapshot.OTEL_PHP_BOOTSTRAP_PHP_PART_FILE, "some_value");
+}
+
+TEST_F(ConfigurationManagerTest, optionRegistry) {
+    static_assert(ConfigurationManager::findOptionMetadata("enabled"sv)->envName == "OTEL_PHP_ENABLED"sv);
+    static_assert(ConfigurationManager::findOptionMetadata("unknown"sv) == nullptr);
+
+    for (auto const &option : ConfigurationManager::getOptionMetadata()) {
+        ASSERT_EQ(ConfigurationManager::findOptionMetadata(option.name), &option);
+        if (option.otelNativeOption) {
+            ASSERT_EQ(option.iniName, option.name);
+            ASSERT_EQ(option.envName, option.name);
+        } else {
+            ASSERT_EQ(option.iniName, utils::getIniName(option.name));
+            ASSERT_EQ(option.envName, utils::getEnvName(option.name));
+        }
+        ASSERT_EQ(option.envName.data()[option.envName.size()], '\0');
+    }
+
+    auto secret = ConfigurationManager::findOptionMetadata("OTEL_EXPORTER_OTLP_CLIENT_KEYPASS"sv);
+    ASSERT_NE(secret, nullptr);
+    ASSERT_TRUE(secret->secret);
+    ASSERT_TRUE(secret->otelNativeOption);
+}
+
 } // namespace opentelemetry::php
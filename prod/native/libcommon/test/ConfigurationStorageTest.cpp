@@ -0,0 +1,64 @@
+#include "ConfigurationStorage.h"
+
+#include <gtest/gtest.h>
+
+namespace opentelemetry::php {
+
+class ConfigurationStorageTest : public ::testing::Test {
+protected:
+    bool configUpdater(ConfigurationSnapshot &cfg) {
+        updaterCalls_++;
+        if (cfg.revision == configForUpdate_.revision) {
+            return false;
+        }
+        cfg = configForUpdate_;
+        return true;
+    }
+
+    ConfigurationSnapshot configForUpdate_;
+    std::size_t updaterCalls_ = 0;
+    ConfigurationStorage config_{[this](ConfigurationSnapshot &cfg) { return configUpdater(cfg); }, [this]() { return configForUpdate_.revision; }};
+};
+
+TEST_F(ConfigurationStorageTest, updateSkippedWhileRevisionNotChanged) {
+    config_.update();
+    ASSERT_EQ(updaterCalls_, 0u);
+
+    std::size_t notifications = 0;
+    config_.addConfigUpdateWatcher([&](ConfigurationSnapshot const &cfg) {
+        notifications++;
+        ASSERT_EQ(cfg.revision, 2u);
+    });
+
+    configForUpdate_.revision = 2;
+    configForUpdate_.enabled = false;
+    config_.update();
+    config_.update();
+    ASSERT_EQ(updaterCalls_, 1u);
+    ASSERT_EQ(notifications, 1u);
+    ASSERT_EQ(config_->revision, 2u);
+    ASSERT_FALSE(config_.get(&ConfigurationSnapshot::enabled));
+}
+
+TEST_F(ConfigurationStorageTest, heldSnapshotIsNotModifiedByUpdate) {
+    configForUpdate_.revision = 1;
+    configForUpdate_.enabled = true;
+    config_.update();
+
+    auto held = config_.get();
+    ASSERT_EQ(held, config_.get());
+
+    configForUpdate_.revision = 2;
+    configForUpdate_.enabled = false;
+    config_.update();
+    ASSERT_NE(held, config_.get());
+
+    configForUpdate_.revision = 3;
+    config_.update();
+    ASSERT_EQ(held->revision, 1u);
+    ASSERT_TRUE(held->enabled);
+    ASSERT_EQ(config_->revision, 3u);
+    ASSERT_FALSE(config_->enabled);
+}
+
+} // namespace opentelemetry::php
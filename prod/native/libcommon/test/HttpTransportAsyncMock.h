@@ -0,0 +1,16 @@
+#pragma once
+
+#include "transport/HttpTransportAsyncInterface.h"
+#include <gmock/gmock.h>
+
+namespace opentelemetry::php::test {
+
+class HttpTransportAsyncMock : public transport::HttpTransportAsyncInterface {
+public:
+    MOCK_METHOD(void, initializeConnection, (std::string endpointUrl, std::size_t endpointHash, std::string contentType, enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, transport::HttpEndpointSSLOptions sslOptions, transport::PayloadCompression compression), (override));
+    MOCK_METHOD(void, enqueue, (std::size_t endpointHash, transport::PayloadBuffer payload, responseCallback_t callback), (override));
+    MOCK_METHOD(void, updateRetryDelay, (size_t endpointHash, std::chrono::milliseconds retryDelay), (override));
+    MOCK_METHOD(bool, flush, (std::size_t endpointHash, std::chrono::milliseconds timeout), (override));
+};
+
+} // namespace opentelemetry::php::test
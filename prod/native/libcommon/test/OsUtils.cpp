@@ -3,7 +3,10 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <cstdlib>
 #include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <string_view>
 
@@ -19,5 +22,18 @@ TEST(OsUtilsTest, getProcessEnvironment) {
     ASSERT_NE(osutils::getProcessEnvironment().find("PATH="), std::string::npos);
 }
 
+TEST(OsUtilsTest, getProcessStartTime) {
+    auto startTime = osutils::getProcessStartTime(getpid());
+    ASSERT_TRUE(startTime.has_value());
+    ASSERT_EQ(osutils::getProcessStartTime(getpid()), startTime);
+
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        std::_Exit(0);
+    }
+    waitpid(pid, nullptr, 0);
+    ASSERT_FALSE(osutils::getProcessStartTime(pid).has_value());
+}
 
 } // namespace opentelemetry::osutils
\ No newline at end of file
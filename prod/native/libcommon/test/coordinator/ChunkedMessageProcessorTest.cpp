@@ -3,6 +3,8 @@
 #include "coordinator/CoordinatorSharedDataQueue.h"
 #include "gmock/gmock.h"
 #include <algorithm>
+#include <array>
+#include <cstring>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -23,6 +25,8 @@ public:
     FRIEND_TEST(ChunkedMessageProcessorTest, ShortPayloadIsImmediatelyProcessedUponReception);
     FRIEND_TEST(ChunkedMessageProcessorTest, LongerPayloadIsStoredUntilCompleteUponReception);
     FRIEND_TEST(ChunkedMessageProcessorTest, cleanupAbandonedMessagesRemovesPartialMessage);
+    FRIEND_TEST(ChunkedMessageProcessorTest, releasedSenderMessagesAreDroppedAfterItsRecordsAreConsumed);
+    FRIEND_TEST(ChunkedMessageProcessorTest, sendPayload_largeMessageInSingleRecord);
 };
 
 class ChunkedMessageProcessorTest : public ::testing::Test {
@@ -39,14 +43,15 @@ public:
 protected:
     ::testing::StrictMock<ChunkedMessageProcessorActionsMock> mock_;
     std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
-    std::shared_ptr<CoordinatorSharedDataQueue> sharedDataQueue_ = std::make_shared<CoordinatorSharedDataQueue>(log_);
+    std::shared_ptr<CoordinatorSharedDataQueue> sharedDataQueue_ = std::make_shared<CoordinatorSharedDataQueue>(log_, CoordinatorSharedDataQueue::minCapacity);
+    std::size_t maxChunkSize_ = sharedDataQueue_->getMaxRecordSize() - sizeof(CoordinatorPayloadHeader);
     std::shared_ptr<TestableChunkedMessageProcessor> processor_{std::make_shared<TestableChunkedMessageProcessor>(log_, sharedDataQueue_, [&](const std::span<const std::byte> data) { mock_.processReceivedMessage(data); })};
 };
 
 TEST_F(ChunkedMessageProcessorTest, sendPayload) {
-    std::string testPayload(17000, 'A');
+    std::string testPayload(40000, 'A');
 
-    ASSERT_GT(testPayload.size(), CoordinatorSharedDataQueue::maxMqPayloadSize);
+    ASSERT_GT(testPayload.size(), sharedDataQueue_->getMaxRecordSize());
     EXPECT_TRUE(processor_->sendPayload(testPayload));
 
     EXPECT_CALL(mock_, processReceivedMessage(::testing::_)).Times(1).WillOnce(::testing::WithArgs<0>(::testing::Invoke([&](std::span<const std::byte> data) {
@@ -54,15 +59,12 @@ TEST_F(ChunkedMessageProcessorTest, sendPayload) {
         ASSERT_TRUE(std::ranges::equal(data, std::as_bytes(std::span<const char>(testPayload.data(), testPayload.size()))));
     })));
 
-    char buffer[CoordinatorSharedDataQueue::maxMqPayloadSize];
-    while (processor_->tryReceiveMessage(buffer, CoordinatorSharedDataQueue::maxMqPayloadSize))
+    while (processor_->tryReceiveMessage(std::chrono::milliseconds(0)))
         ;
 }
 
 TEST_F(ChunkedMessageProcessorTest, sendPayload_maxPayloadDataSize) {
-    std::string testPayload(sizeof(CoordinatorPayload::payload), 'A');
-
-    ASSERT_EQ(testPayload.size(), sizeof(CoordinatorPayload::payload));
+    std::string testPayload(maxChunkSize_, 'A');
     EXPECT_TRUE(processor_->sendPayload(testPayload));
 
     EXPECT_CALL(mock_, processReceivedMessage(::testing::_)).Times(1).WillOnce(::testing::WithArgs<0>(::testing::Invoke([&](std::span<const std::byte> data) {
@@ -70,15 +72,12 @@ TEST_F(ChunkedMessageProcessorTest, sendPayload_maxPayloadDataSize) {
         ASSERT_TRUE(std::ranges::equal(data, std::as_bytes(std::span<const char>(testPayload.data(), testPayload.size()))));
     })));
 
-    char buffer[CoordinatorSharedDataQueue::maxMqPayloadSize];
-    while (processor_->tryReceiveMessage(buffer, CoordinatorSharedDataQueue::maxMqPayloadSize))
+    while (processor_->tryReceiveMessage(std::chrono::milliseconds(0)))
         ;
 }
 
 TEST_F(ChunkedMessageProcessorTest, sendPayload_maxPayloadDataSizePlusOne) {
-    std::string testPayload(sizeof(CoordinatorPayload::payload) + 1, 'A');
-
-    ASSERT_EQ(testPayload.size(), sizeof(CoordinatorPayload::payload) + 1);
+    std::string testPayload(maxChunkSize_ + 1, 'A');
     EXPECT_TRUE(processor_->sendPayload(testPayload));
 
     EXPECT_CALL(mock_, processReceivedMessage(::testing::_)).Times(1).WillOnce(::testing::WithArgs<0>(::testing::Invoke([&](std::span<const std::byte> data) {
@@ -86,8 +85,7 @@ TEST_F(ChunkedMessageProcessorTest, sendPayload_maxPayloadDataSizePlusOne) {
         ASSERT_TRUE(std::ranges::equal(data, std::as_bytes(std::span<const char>(testPayload.data(), testPayload.size()))));
     })));
 
-    char buffer[CoordinatorSharedDataQueue::maxMqPayloadSize];
-    while (processor_->tryReceiveMessage(buffer, CoordinatorSharedDataQueue::maxMqPayloadSize))
+    while (processor_->tryReceiveMessage(std::chrono::milliseconds(0)))
         ;
 }
 
@@ -101,8 +99,7 @@ TEST_F(ChunkedMessageProcessorTest, sendPayload_smallSingleChunk) {
         ASSERT_TRUE(std::ranges::equal(data, std::as_bytes(std::span<const char>(testPayload.data(), testPayload.size()))));
     })));
 
-    char buffer[CoordinatorSharedDataQueue::maxMqPayloadSize];
-    while (processor_->tryReceiveMessage(buffer, CoordinatorSharedDataQueue::maxMqPayloadSize))
+    while (processor_->tryReceiveMessage(std::chrono::milliseconds(0)))
         ;
 }
 
@@ -113,33 +110,71 @@ TEST_F(ChunkedMessageProcessorTest, sendPayload_emptyPayload) {
 
     EXPECT_CALL(mock_, processReceivedMessage(::testing::_)).Times(0);
 
-    char buffer[CoordinatorSharedDataQueue::maxMqPayloadSize];
-    while (processor_->tryReceiveMessage(buffer, CoordinatorSharedDataQueue::maxMqPayloadSize))
+    while (processor_->tryReceiveMessage(std::chrono::milliseconds(0)))
+        ;
+}
+
+TEST_F(ChunkedMessageProcessorTest, sendPayload_segments) {
+    std::string header = "header";
+    std::string empty;
+    std::string payload(maxChunkSize_ + 7, 'B');
+    std::array<std::span<const std::byte>, 3> segments{std::as_bytes(std::span(header)), std::as_bytes(std::span(empty)), std::as_bytes(std::span(payload))};
+
+    EXPECT_TRUE(processor_->sendPayload(segments));
+
+    std::string expected = header + payload;
+    EXPECT_CALL(mock_, processReceivedMessage(::testing::_)).Times(1).WillOnce(::testing::WithArgs<0>(::testing::Invoke([&](std::span<const std::byte> data) {
+        EXPECT_EQ(data.size(), expected.size());
+        ASSERT_TRUE(std::ranges::equal(data, std::as_bytes(std::span<const char>(expected.data(), expected.size()))));
+    })));
+
+    while (processor_->tryReceiveMessage(std::chrono::milliseconds(0)))
         ;
 }
 
+TEST_F(ChunkedMessageProcessorTest, sendPayload_largeMessageInSingleRecord) {
+    auto queue = std::make_shared<CoordinatorSharedDataQueue>(log_, 4 * 1024 * 1024);
+    TestableChunkedMessageProcessor processor(log_, queue, [&](const std::span<const std::byte> data) { mock_.processReceivedMessage(data); });
+
+    std::string testPayload(1024 * 1024, 'C');
+    EXPECT_TRUE(processor.sendPayload(testPayload));
+    EXPECT_EQ(queue->getUsedBytes(), (testPayload.size() + sizeof(CoordinatorPayloadHeader) + 16 + 15) & ~std::size_t(15));
+
+    EXPECT_CALL(mock_, processReceivedMessage(::testing::_)).Times(1).WillOnce(::testing::WithArgs<0>(::testing::Invoke([&](std::span<const std::byte> data) {
+        EXPECT_EQ(data.size(), testPayload.size());
+        // single record message is not stored for reassembly
+        EXPECT_TRUE(processor.recievedMessages_.empty());
+    })));
+
+    EXPECT_TRUE(processor.tryReceiveMessage(std::chrono::milliseconds(0)));
+    EXPECT_FALSE(processor.tryReceiveMessage(std::chrono::milliseconds(0)));
+}
+
+static std::vector<std::byte> makeRecord(CoordinatorPayloadHeader const &header, std::size_t dataSize) {
+    std::vector<std::byte> record(sizeof(header) + dataSize, std::byte{1});
+    std::memcpy(record.data(), &header, sizeof(header));
+    return record;
+}
+
 TEST_F(ChunkedMessageProcessorTest, cleanupAbandonedMessagesRemovesPartialMessage) {
-    constexpr size_t capacity = sizeof(CoordinatorPayload::payload);
-    size_t totalSize = capacity * 2 + 10; // message needing 3 chunks
-    // std::vector<std::byte> data(totalSize, std::byte{1});
+    size_t totalSize = maxChunkSize_ * 2 + 10; // message needing 3 chunks
 
-    CoordinatorPayload chunk;
+    CoordinatorPayloadHeader chunk;
     chunk.senderProcessId = 1;
     chunk.msgId = 777;
     chunk.payloadTotalSize = totalSize;
     chunk.payloadOffset = 0;
-    chunk.payload.fill(std::byte{1});
 
     ASSERT_TRUE(processor_->recievedMessages_.empty());
 
-    EXPECT_NO_THROW(processor_->processReceivedChunk(&chunk, sizeof(CoordinatorPayload)));
+    EXPECT_NO_THROW(processor_->processReceivedChunk(makeRecord(chunk, maxChunkSize_)));
 
     ASSERT_EQ(processor_->recievedMessages_.size(), 1u);
 
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
 
     chunk.senderProcessId = 2;
-    EXPECT_NO_THROW(processor_->processReceivedChunk(&chunk, sizeof(CoordinatorPayload)));
+    EXPECT_NO_THROW(processor_->processReceivedChunk(makeRecord(chunk, maxChunkSize_)));
 
     auto now = std::chrono::steady_clock::now();
     processor_->cleanupAbandonedMessages(now, std::chrono::milliseconds(9)); // should cleanup only first message at first attempt
@@ -151,28 +186,68 @@ TEST_F(ChunkedMessageProcessorTest, cleanupAbandonedMessagesRemovesPartialMessag
     ASSERT_TRUE(processor_->recievedMessages_.empty());
 }
 
+TEST_F(ChunkedMessageProcessorTest, releasedSenderMessagesAreDroppedAfterItsRecordsAreConsumed) {
+    CoordinatorPayloadHeader chunk;
+    chunk.senderProcessId = 1;
+    chunk.msgId = 777;
+    chunk.payloadTotalSize = maxChunkSize_ * 2 + 10;
+    chunk.payloadOffset = 0;
+
+    EXPECT_NO_THROW(processor_->processReceivedChunk(makeRecord(chunk, maxChunkSize_)));
+    chunk.msgId = 778;
+    EXPECT_NO_THROW(processor_->processReceivedChunk(makeRecord(chunk, maxChunkSize_)));
+    chunk.senderProcessId = 2;
+    EXPECT_NO_THROW(processor_->processReceivedChunk(makeRecord(chunk, maxChunkSize_)));
+
+    // last chunk of message 777 is still in queue when sender exit is noticed
+    chunk.senderProcessId = 1;
+    chunk.msgId = 777;
+    chunk.payloadOffset = maxChunkSize_;
+    auto secondChunk = makeRecord(chunk, maxChunkSize_);
+    std::span<const std::byte> segment(secondChunk);
+    ASSERT_TRUE(sharedDataQueue_->enqueueMessage({&segment, 1}));
+    chunk.payloadOffset = maxChunkSize_ * 2;
+    auto lastChunk = makeRecord(chunk, 10);
+    segment = lastChunk;
+    ASSERT_TRUE(sharedDataQueue_->enqueueMessage({&segment, 1}));
+
+    processor_->releaseSender(1);
+    processor_->releaseSender(3);
+    ASSERT_EQ(processor_->dropReleasedSenders(), 0u);
+    ASSERT_EQ(processor_->recievedMessages_[1].size(), 2u);
+
+    EXPECT_CALL(mock_, processReceivedMessage(::testing::_)).Times(1).WillOnce(::testing::WithArgs<0>(::testing::Invoke([&](std::span<const std::byte> data) { EXPECT_EQ(data.size(), chunk.payloadTotalSize); })));
+    ASSERT_EQ(processor_->receiveMessages(std::chrono::milliseconds(0)), 2u);
+
+    ASSERT_EQ(processor_->dropReleasedSenders(), 1u);
+    ASSERT_EQ(processor_->recievedMessages_.size(), 1u);
+    ASSERT_TRUE(processor_->recievedMessages_.contains(2));
+    ASSERT_TRUE(processor_->releasedSenders_.empty());
+}
+
 TEST_F(ChunkedMessageProcessorTest, processReceivedChunkWithInvalidSize) {
-    CoordinatorPayload chunk;
+    CoordinatorPayloadHeader chunk;
     chunk.senderProcessId = getpid();
     chunk.msgId = 1;
     chunk.payloadTotalSize = 100;
     chunk.payloadOffset = 0;
 
     // Size smaller than header
-    EXPECT_THROW(processor_->processReceivedChunk(&chunk, offsetof(CoordinatorPayload, payload) - 1), std::runtime_error);
+    auto record = makeRecord(chunk, 0);
+    EXPECT_THROW(processor_->processReceivedChunk(std::span<const std::byte>(record).first(sizeof(chunk) - 1)), std::runtime_error);
 }
 
 TEST_F(ChunkedMessageProcessorTest, processReceivedChunkWithMismatchedOffset) {
-    CoordinatorPayload chunk;
+    CoordinatorPayloadHeader chunk;
     chunk.senderProcessId = getpid();
     chunk.msgId = 1;
     chunk.payloadTotalSize = 10000;
     chunk.payloadOffset = 0;
 
-    processor_->processReceivedChunk(&chunk, sizeof(CoordinatorPayload));
+    processor_->processReceivedChunk(makeRecord(chunk, 4000));
 
     // Send chunk with wrong offset (not sequential)
     chunk.payloadOffset = 8000; // skipping chunks
-    EXPECT_THROW(processor_->processReceivedChunk(&chunk, sizeof(CoordinatorPayload)), std::runtime_error);
+    EXPECT_THROW(processor_->processReceivedChunk(makeRecord(chunk, 1000)), std::runtime_error);
+}
 }
-}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "coordinator/CoordinatorConfigurationProvider.h"
+#include "Logger.h"
+
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace opentelemetry::php::coordinator {
+
+class CoordinatorConfigurationProviderTest : public ::testing::Test {
+protected:
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    CoordinatorConfigurationProvider provider_{log_};
+};
+
+TEST_F(CoordinatorConfigurationProviderTest, workerReceivesFilesStoredByCoordinator) {
+    ASSERT_FALSE(provider_.triggerUpdateIfChanged());
+
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        provider_.storeConfigFiles({{"a", "first"}, {"b", "second"}});
+        _exit(0);
+    }
+    int exitStatus = 0;
+    waitpid(pid, &exitStatus, 0);
+    ASSERT_EQ(WEXITSTATUS(exitStatus), 0);
+
+    CoordinatorConfigurationProvider::configFiles_t received;
+    std::size_t notifications = 0;
+    provider_.addConfigUpdateWatcher([&](CoordinatorConfigurationProvider::configFiles_t const &files) {
+        received = files;
+        notifications++;
+    });
+
+    ASSERT_TRUE(provider_.triggerUpdateIfChanged());
+    ASSERT_FALSE(provider_.triggerUpdateIfChanged());
+    ASSERT_EQ(notifications, 1u);
+    ASSERT_EQ(received, (CoordinatorConfigurationProvider::configFiles_t{{"a", "first"}, {"b", "second"}}));
+}
+
+TEST_F(CoordinatorConfigurationProviderTest, onlyChangedContentUpdatesWorkers) {
+    CoordinatorConfigurationProvider::configFiles_t received;
+    std::size_t notifications = 0;
+    provider_.addConfigUpdateWatcher([&](CoordinatorConfigurationProvider::configFiles_t const &files) {
+        received = files;
+        notifications++;
+    });
+
+    provider_.storeConfigFiles({{"a", "first"}, {"b", "second"}});
+    ASSERT_TRUE(provider_.triggerUpdateIfChanged());
+    ASSERT_EQ(notifications, 1u);
+
+    // same content is not distributed again
+    provider_.storeConfigFiles({{"a", "first"}, {"b", "second"}});
+    ASSERT_FALSE(provider_.triggerUpdateIfChanged());
+    ASSERT_EQ(notifications, 1u);
+
+    provider_.storeConfigFiles({{"a", "first"}, {"b", "changed"}});
+    provider_.storeConfigFiles({{"c", "third"}});
+    ASSERT_TRUE(provider_.triggerUpdateIfChanged());
+    ASSERT_EQ(notifications, 2u);
+    ASSERT_EQ(received, (CoordinatorConfigurationProvider::configFiles_t{{"a", "first"}, {"b", "changed"}, {"c", "third"}}));
+    ASSERT_EQ(provider_.getConfiguration(), received);
+}
+
+} // namespace opentelemetry::php::coordinator
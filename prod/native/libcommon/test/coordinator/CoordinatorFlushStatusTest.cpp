@@ -0,0 +1,51 @@
+#include "coordinator/CoordinatorFlushStatus.h"
+#include "Logger.h"
+
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::coordinator {
+
+class CoordinatorFlushStatusTest : public ::testing::Test {
+protected:
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    CoordinatorFlushStatus flushStatus_{log_};
+};
+
+TEST_F(CoordinatorFlushStatusTest, waitTimesOutWithoutAcknowledgement) {
+    auto requestId = flushStatus_.beginRequest();
+    ASSERT_EQ(flushStatus_.beginRequest(), requestId + 1);
+
+    flushStatus_.markCompleted(requestId + 1);
+    ASSERT_FALSE(flushStatus_.waitForCompletion(requestId, 20ms));
+    ASSERT_TRUE(flushStatus_.waitForCompletion(requestId + 1, 0ms));
+
+    // slot reused by later request
+    flushStatus_.markCompleted(requestId + 1 + CoordinatorFlushStatus::slotsCount);
+    ASSERT_FALSE(flushStatus_.waitForCompletion(requestId + 1, 0ms));
+}
+
+TEST_F(CoordinatorFlushStatusTest, acknowledgementFromOtherProcess) {
+    auto requestId = flushStatus_.beginRequest();
+
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        std::this_thread::sleep_for(50ms);
+        flushStatus_.markCompleted(requestId);
+        _exit(0);
+    }
+
+    ASSERT_TRUE(flushStatus_.waitForCompletion(requestId, 5s));
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+} // namespace opentelemetry::php::coordinator
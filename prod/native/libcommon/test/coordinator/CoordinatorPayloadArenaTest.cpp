@@ -0,0 +1,187 @@
+#include "coordinator/CoordinatorPayloadArena.h"
+#include "coordinator/CoordinatorTelemetrySignalsSender.h"
+#include "coordinator/proto/CoordinatorCommands.pb.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace opentelemetry::php::coordinator {
+
+class CoordinatorPayloadArenaTest : public ::testing::Test {
+protected:
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    std::shared_ptr<CoordinatorPayloadArena> arena_ = std::make_shared<CoordinatorPayloadArena>(log_, 8 * CoordinatorPayloadArena::slabSize);
+};
+
+TEST_F(CoordinatorPayloadArenaTest, adoptedPayloadReleasesSlabs) {
+    std::string data(CoordinatorPayloadArena::slabSize + 1, 'a');
+
+    auto allocation = arena_->allocate(data.size());
+    ASSERT_TRUE(allocation.has_value());
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 2u);
+    std::memcpy(arena_->getData(*allocation).data(), data.data(), data.size());
+
+    // not handed over yet
+    ASSERT_FALSE(arena_->adopt(*allocation).has_value());
+    arena_->handOver(*allocation);
+
+    auto payload = arena_->adopt(*allocation);
+    ASSERT_TRUE(payload.has_value());
+    ASSERT_EQ(std::string(reinterpret_cast<const char *>(payload->data()), payload->size()), data);
+
+    auto part = payload->subbuffer(10, 20);
+    payload.reset();
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 2u);
+    part = {};
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 0u);
+}
+
+TEST_F(CoordinatorPayloadArenaTest, allocationFailsWhenNoContiguousSlabs) {
+    ASSERT_FALSE(arena_->allocate(0).has_value());
+    ASSERT_FALSE(arena_->allocate(arena_->getCapacity() + 1).has_value());
+
+    std::vector<CoordinatorPayloadArena::Allocation> allocations;
+    for (int i = 0; i < 4; ++i) {
+        auto allocation = arena_->allocate(2 * CoordinatorPayloadArena::slabSize);
+        ASSERT_TRUE(allocation.has_value());
+        allocations.push_back(*allocation);
+    }
+    ASSERT_FALSE(arena_->allocate(1).has_value());
+
+    // two free slabs, but not adjacent
+    arena_->release(allocations[0]);
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 6u);
+    allocations[2].size = CoordinatorPayloadArena::slabSize;
+    arena_->release(allocations[2]);
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 5u);
+
+    ASSERT_FALSE(arena_->allocate(3 * CoordinatorPayloadArena::slabSize).has_value());
+    auto allocation = arena_->allocate(2 * CoordinatorPayloadArena::slabSize);
+    ASSERT_TRUE(allocation.has_value());
+    ASSERT_EQ(allocation->offset, allocations[0].offset);
+}
+
+TEST_F(CoordinatorPayloadArenaTest, invalidDescriptorsAreRejected) {
+    auto allocation = arena_->allocate(100);
+    ASSERT_TRUE(allocation.has_value());
+    arena_->handOver(*allocation);
+
+    ASSERT_FALSE(arena_->adopt({allocation->offset + 1, 100}).has_value());
+    ASSERT_FALSE(arena_->adopt({allocation->offset, 0}).has_value());
+    ASSERT_FALSE(arena_->adopt({allocation->offset, CoordinatorPayloadArena::slabSize + 1}).has_value());
+    ASSERT_FALSE(arena_->adopt({arena_->getCapacity(), 1}).has_value());
+    ASSERT_FALSE(arena_->adopt({0, SIZE_MAX}).has_value());
+    ASSERT_TRUE(arena_->adopt(*allocation).has_value());
+}
+
+TEST_F(CoordinatorPayloadArenaTest, slabsOfExitedWorkerAreReclaimed) {
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // worker dies while filling first allocation, second one is handed over to coordinator
+        auto abandoned = arena_->allocate(3 * CoordinatorPayloadArena::slabSize);
+        auto handedOver = arena_->allocate(100);
+        if (!abandoned || !handedOver) {
+            std::_Exit(1);
+        }
+        std::memset(arena_->getData(*handedOver).data(), 'w', 100);
+        arena_->handOver(*handedOver);
+        std::_Exit(0);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 4u);
+    ASSERT_EQ(arena_->reclaimAbandoned(pid + 1), 0u);
+    ASSERT_EQ(arena_->reclaimAbandoned(pid), 3u);
+    ASSERT_EQ(arena_->reclaimAbandoned(), 0u);
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 1u);
+
+    auto payload = arena_->adopt({3 * CoordinatorPayloadArena::slabSize, 100});
+    ASSERT_TRUE(payload.has_value());
+    ASSERT_EQ(std::string(reinterpret_cast<const char *>(payload->data()), payload->size()), std::string(100, 'w'));
+}
+
+TEST_F(CoordinatorPayloadArenaTest, restartedCoordinatorReclaimsSlabsOfPreviousGeneration) {
+    auto adopted = arena_->allocate(2 * CoordinatorPayloadArena::slabSize);
+    auto waiting = arena_->allocate(100);
+    ASSERT_TRUE(adopted.has_value());
+    ASSERT_TRUE(waiting.has_value());
+    arena_->handOver(*adopted);
+    arena_->handOver(*waiting);
+
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // coordinator dies while transport still holds adopted payload, descriptor of second one is still in queue
+        arena_->beginCoordinatorGeneration();
+        auto payload = arena_->adopt(*adopted);
+        std::_Exit(payload.has_value() && !arena_->adopt(*adopted).has_value() ? 0 : 1);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 3u);
+    ASSERT_EQ(arena_->reclaimAbandoned(), 0u);
+    ASSERT_EQ(arena_->beginCoordinatorGeneration(), 2u);
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 1u);
+
+    auto payload = arena_->adopt(*waiting);
+    ASSERT_TRUE(payload.has_value());
+    payload.reset();
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 0u);
+}
+
+TEST_F(CoordinatorPayloadArenaTest, senderPassesLargePayloadsThroughArena) {
+    std::vector<std::string> sent;
+    bool queueAvailable = true;
+    CoordinatorTelemetrySignalsSender sender(log_, [&](std::span<const std::span<const std::byte>> segments) {
+        std::string message;
+        for (auto const &segment : segments) {
+            message.append(reinterpret_cast<const char *>(segment.data()), segment.size());
+        }
+        sent.emplace_back(std::move(message));
+        return queueAvailable;
+    }, nullptr, arena_);
+
+    std::string small(CoordinatorPayloadArena::minPayloadSize - 1, 's');
+    std::string large(CoordinatorPayloadArena::minPayloadSize, 'l');
+
+    sender.enqueue(123, transport::PayloadBuffer::borrow(std::as_bytes(std::span(small))));
+    ASSERT_EQ(sent.size(), 1u);
+    ASSERT_GT(sent[0].size(), small.size());
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 0u);
+
+    sender.enqueue(123, transport::PayloadBuffer::borrow(std::as_bytes(std::span(large))));
+    ASSERT_EQ(sent.size(), 2u);
+    CoordinatorCommand command;
+    ASSERT_TRUE(command.ParseFromString(sent[1]));
+    ASSERT_EQ(command.type(), CoordinatorCommand::SEND_ENDPOINT_ARENA_PAYLOAD);
+    ASSERT_EQ(command.send_endpoint_arena_payload().endpoint_hash(), 123u);
+
+    auto payload = arena_->adopt({command.send_endpoint_arena_payload().offset(), command.send_endpoint_arena_payload().size()});
+    ASSERT_TRUE(payload.has_value());
+    ASSERT_EQ(std::string(reinterpret_cast<const char *>(payload->data()), payload->size()), large);
+    payload.reset();
+
+    // descriptor couldn't be sent, slabs are released and payload goes through queue
+    queueAvailable = false;
+    sender.enqueue(123, transport::PayloadBuffer::borrow(std::as_bytes(std::span(large))));
+    ASSERT_EQ(sent.size(), 4u);
+    ASSERT_EQ(arena_->getUsedSlabsCount(), 0u);
+    ASSERT_GT(sent[3].size(), large.size());
+}
+
+} // namespace opentelemetry::php::coordinator
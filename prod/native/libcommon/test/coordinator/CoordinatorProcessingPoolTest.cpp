@@ -0,0 +1,93 @@
+#include "coordinator/CoordinatorProcessingPool.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::coordinator {
+
+class CoordinatorProcessingPoolTest : public ::testing::Test {
+protected:
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    CoordinatorProcessingPool pool_{log_, 4};
+};
+
+TEST_F(CoordinatorProcessingPoolTest, tasksRunInlineUntilStarted) {
+    auto callerThread = std::this_thread::get_id();
+    std::thread::id taskThread;
+    pool_.submit([&]() { taskThread = std::this_thread::get_id(); });
+    ASSERT_EQ(taskThread, callerThread);
+
+    bool barrierReached = false;
+    pool_.submitBarrier([&]() { barrierReached = true; });
+    ASSERT_TRUE(barrierReached);
+}
+
+TEST_F(CoordinatorProcessingPoolTest, barrierWaitsForEarlierTasks) {
+    pool_.start(3);
+    ASSERT_EQ(pool_.getStartedThreadsCount(), 3u);
+
+    std::atomic<std::size_t> processed = 0;
+    std::promise<void> unblock;
+    auto unblocked = unblock.get_future().share();
+
+    // rings are smaller than number of tasks, producer has to wait for slow threads
+    for (std::size_t i = 0; i < 100; ++i) {
+        pool_.submit([&, unblocked]() {
+            unblocked.wait();
+            processed.fetch_add(1);
+        });
+        if (i == 10) {
+            unblock.set_value();
+        }
+    }
+
+    std::promise<std::size_t> processedAtBarrier;
+    pool_.submitBarrier([&]() { processedAtBarrier.set_value(processed.load()); });
+    auto result = processedAtBarrier.get_future();
+    ASSERT_EQ(result.wait_for(5s), std::future_status::ready);
+    ASSERT_EQ(result.get(), 100u);
+
+    pool_.submit([&]() { processed.fetch_add(1); });
+    pool_.stop();
+    ASSERT_EQ(processed.load(), 101u);
+    ASSERT_EQ(pool_.getStartedThreadsCount(), 0u);
+}
+
+TEST_F(CoordinatorProcessingPoolTest, tasksOfTheSameKeyKeepOrder) {
+    pool_.start(3);
+
+    constexpr std::size_t keysCount = 5;
+    std::array<std::vector<std::size_t>, keysCount> processed;
+    for (std::size_t i = 0; i < 200; ++i) {
+        auto key = i % keysCount;
+        pool_.submit(key, [&processed, key, i]() {
+            if (i % 7 == 0) {
+                std::this_thread::sleep_for(1ms);
+            }
+            processed[key].push_back(i);
+        });
+    }
+    pool_.stop();
+
+    for (std::size_t key = 0; key < keysCount; ++key) {
+        ASSERT_EQ(processed[key].size(), 40u);
+        ASSERT_TRUE(std::is_sorted(processed[key].begin(), processed[key].end()));
+    }
+}
+
+TEST_F(CoordinatorProcessingPoolTest, threadsCountIsLimited) {
+    ASSERT_EQ(CoordinatorProcessingPool::getThreadsCount(3), 3u);
+    ASSERT_EQ(CoordinatorProcessingPool::getThreadsCount(1000), CoordinatorProcessingPool::maxThreadsCount);
+    ASSERT_GE(CoordinatorProcessingPool::getThreadsCount(0), 1u);
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,284 @@
+#include "coordinator/CoordinatorSharedDataQueue.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::coordinator {
+
+class TestableCoordinatorSharedDataQueue : public CoordinatorSharedDataQueue {
+public:
+    using CoordinatorSharedDataQueue::CoordinatorSharedDataQueue;
+
+    FRIEND_TEST(CoordinatorSharedDataQueueTest, skipsRecordAbandonedByDeadWriter);
+    FRIEND_TEST(CoordinatorSharedDataQueueTest, skipsRecordOfWriterWhosePidWasReused);
+    FRIEND_TEST(CoordinatorSharedDataQueueTest, reservationOfWriterDeadBeforeHeaderIsSkipped);
+};
+
+class CoordinatorSharedDataQueueTest : public ::testing::Test {
+protected:
+    bool enqueue(std::string const &data) {
+        std::array<std::span<const std::byte>, 1> segments{std::as_bytes(std::span(data))};
+        return queue_.enqueueMessage(segments);
+    }
+
+    std::vector<std::string> receiveAll() {
+        std::vector<std::string> records;
+        while (queue_.tryReceiveMessage([&](std::span<const std::byte> record) { records.emplace_back(reinterpret_cast<const char *>(record.data()), record.size()); }, 0ms))
+            ;
+        return records;
+    }
+
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    TestableCoordinatorSharedDataQueue queue_{log_, CoordinatorSharedDataQueue::minCapacity};
+};
+
+TEST_F(CoordinatorSharedDataQueueTest, segmentsAreJoinedIntoSingleRecord) {
+    std::string header = "header:";
+    std::string empty;
+    std::string payload = "payload";
+    std::array<std::span<const std::byte>, 3> segments{std::as_bytes(std::span(header)), std::as_bytes(std::span(empty)), std::as_bytes(std::span(payload))};
+
+    ASSERT_TRUE(queue_.enqueueMessage(segments));
+    ASSERT_EQ(receiveAll(), std::vector<std::string>{"header:payload"});
+    ASSERT_EQ(queue_.getUsedBytes(), 0u);
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, recordsWrapAroundRingEnd) {
+    std::string record(queue_.getCapacity() / 3, 'x');
+    for (int i = 0; i < 10; ++i) {
+        record[0] = static_cast<char>('a' + i);
+        ASSERT_TRUE(enqueue(record)) << i;
+        ASSERT_TRUE(enqueue("small")) << i;
+        auto received = receiveAll();
+        ASSERT_EQ(received.size(), 2u) << i;
+        ASSERT_EQ(received[0], record);
+        ASSERT_EQ(received[1], "small");
+        ASSERT_EQ(queue_.getUsedBytes(), 0u);
+    }
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, rejectsRecordsWhenFullOrTooLarge) {
+    ASSERT_FALSE(enqueue(std::string(queue_.getMaxRecordSize() + 1, 'x')));
+    ASSERT_TRUE(enqueue(std::string(queue_.getMaxRecordSize(), 'x')));
+    ASSERT_TRUE(enqueue(std::string(queue_.getMaxRecordSize(), 'y')));
+    ASSERT_FALSE(enqueue("z"));
+
+    auto received = receiveAll();
+    ASSERT_EQ(received.size(), 2u);
+    ASSERT_EQ(received[1], std::string(queue_.getMaxRecordSize(), 'y'));
+    ASSERT_TRUE(enqueue("z"));
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, receiveWaitsForRecord) {
+    std::thread producer([&]() {
+        std::this_thread::sleep_for(20ms);
+        enqueue("late");
+    });
+
+    std::string received;
+    ASSERT_TRUE(queue_.tryReceiveMessage([&](std::span<const std::byte> record) { received.assign(reinterpret_cast<const char *>(record.data()), record.size()); }, 5s));
+    producer.join();
+    ASSERT_EQ(received, "late");
+    ASSERT_FALSE(queue_.tryReceiveMessage([](std::span<const std::byte>) {}, 0ms));
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, receiveMessagesDrainsAllRecordsInOneWakeup) {
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(enqueue(std::string(100, 'a' + i)));
+    }
+    auto usedBytes = queue_.getUsedBytes();
+
+    std::vector<std::string> received;
+    ASSERT_EQ(queue_.receiveMessages([&](std::span<const std::byte> record) { received.emplace_back(reinterpret_cast<const char *>(record.data()), record.size()); }, 0ms), 5u);
+    ASSERT_EQ(received.size(), 5u);
+    ASSERT_EQ(received[4], std::string(100, 'e'));
+    ASSERT_EQ(queue_.receiveMessages([](std::span<const std::byte>) {}, 0ms), 0u);
+
+    ASSERT_TRUE(enqueue("single"));
+    ASSERT_EQ(queue_.receiveMessages([](std::span<const std::byte>) {}, 0ms), 1u);
+
+    auto statistics = queue_.getStatistics();
+    ASSERT_EQ(statistics.wakeups, 2u);
+    ASSERT_EQ(statistics.records, 6u);
+    ASSERT_EQ(statistics.maxRecordsPerWakeup, 5u);
+    ASSERT_EQ(statistics.highWaterMark, usedBytes);
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, producerInOtherProcessWakesUpConsumer) {
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        std::this_thread::sleep_for(100ms);
+        std::_Exit(enqueue("wakeup") ? 0 : 1);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string received;
+    ASSERT_EQ(queue_.receiveMessages([&](std::span<const std::byte> record) { received.assign(reinterpret_cast<const char *>(record.data()), record.size()); }, 30s), 1u);
+    // woken up by producer, not by timeout
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 10s);
+    ASSERT_EQ(received, "wakeup");
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, notifyConsumerInterruptsWait) {
+    std::thread notifier([&]() {
+        std::this_thread::sleep_for(50ms);
+        queue_.notifyConsumer();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(queue_.receiveMessages([](std::span<const std::byte>) {}, 30s), 0u);
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 10s);
+    notifier.join();
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, exceptionInCallbackConsumesRecord) {
+    ASSERT_TRUE(enqueue("first"));
+    ASSERT_TRUE(enqueue("second"));
+    ASSERT_TRUE(queue_.tryReceiveMessage([](std::span<const std::byte>) { throw std::runtime_error("failed"); }, 0ms));
+    ASSERT_EQ(receiveAll(), std::vector<std::string>{"second"});
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, multipleProducersKeepPerProducerOrder) {
+    constexpr int producersCount = 4;
+    constexpr int recordsPerProducer = 2000;
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < producersCount; ++producer) {
+        producers.emplace_back([&, producer]() {
+            for (int i = 0; i < recordsPerProducer;) {
+                std::string record = std::to_string(producer) + ":" + std::to_string(i) + ":" + std::string(i % 300, 'p');
+                if (enqueue(record)) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::array<int, producersCount> expected{};
+    int received = 0;
+    while (received < producersCount * recordsPerProducer) {
+        ASSERT_TRUE(queue_.tryReceiveMessage([&](std::span<const std::byte> data) {
+            std::string record(reinterpret_cast<const char *>(data.data()), data.size());
+            auto producer = std::stoi(record);
+            auto i = std::stoi(record.substr(record.find(':') + 1));
+            ASSERT_EQ(i, expected[producer]);
+            ASSERT_EQ(record.size() - record.rfind(':') - 1, static_cast<std::size_t>(i % 300));
+            expected[producer]++;
+        }, 5s));
+        received++;
+    }
+
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    ASSERT_EQ(queue_.getUsedBytes(), 0u);
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, recordFromForkedProcess) {
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        std::string record(queue_.getMaxRecordSize(), 'f');
+        std::_Exit(enqueue(record) ? 0 : 1);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    ASSERT_EQ(receiveAll(), std::vector<std::string>{std::string(queue_.getMaxRecordSize(), 'f')});
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, skipsRecordAbandonedByDeadWriter) {
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        std::_Exit(0);
+    }
+    waitpid(pid, nullptr, 0);
+
+    // simulate worker which reserved record and died before commit
+    auto tail = queue_.header_->tail.load();
+    auto record = queue_.getRecordHeader(tail);
+    record->writerProcessId = pid;
+    record->state.store(CoordinatorSharedDataQueue::makeRecordState(tail, 100, CoordinatorSharedDataQueue::stateReserved));
+    queue_.header_->tail.store(tail + CoordinatorSharedDataQueue::getRecordSize(100));
+
+    ASSERT_TRUE(enqueue("committed"));
+    ASSERT_EQ(receiveAll(), std::vector<std::string>{"committed"});
+    ASSERT_EQ(queue_.getUsedBytes(), 0u);
+
+    // record reserved by live process blocks consumer until it is committed
+    tail = queue_.header_->tail.load();
+    record = queue_.getRecordHeader(tail);
+    record->writerProcessId = getpid();
+    record->writerStartTime = static_cast<uint32_t>(CoordinatorSharedDataQueue::getCurrentProcessIdentity());
+    record->state.store(CoordinatorSharedDataQueue::makeRecordState(tail, 0, CoordinatorSharedDataQueue::stateReserved));
+    queue_.header_->tail.store(tail + CoordinatorSharedDataQueue::getRecordSize(0));
+
+    ASSERT_TRUE(enqueue("blocked"));
+    ASSERT_TRUE(receiveAll().empty());
+    record->state.store(CoordinatorSharedDataQueue::makeRecordState(tail, 0, CoordinatorSharedDataQueue::stateCommitted));
+    ASSERT_EQ(receiveAll(), (std::vector<std::string>{"", "blocked"}));
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, skipsRecordOfWriterWhosePidWasReused) {
+    // pid of this process with different start time is process which reused pid of dead writer
+    auto tail = queue_.header_->tail.load();
+    auto record = queue_.getRecordHeader(tail);
+    record->writerProcessId = getpid();
+    record->writerStartTime = static_cast<uint32_t>(CoordinatorSharedDataQueue::getCurrentProcessIdentity()) + 1;
+    record->state.store(CoordinatorSharedDataQueue::makeRecordState(tail, 100, CoordinatorSharedDataQueue::stateReserved));
+    queue_.header_->tail.store(tail + CoordinatorSharedDataQueue::getRecordSize(100));
+
+    ASSERT_TRUE(enqueue("committed"));
+    ASSERT_EQ(receiveAll(), std::vector<std::string>{"committed"});
+    ASSERT_EQ(queue_.getUsedBytes(), 0u);
+}
+
+TEST_F(CoordinatorSharedDataQueueTest, reservationOfWriterDeadBeforeHeaderIsSkipped) {
+    // stale committed header from previous round of the ring is not taken for header of reserved record
+    auto tail = queue_.header_->tail.load();
+    queue_.getRecordHeader(tail)->state.store(CoordinatorSharedDataQueue::makeRecordState(tail - queue_.getCapacity(), 0, CoordinatorSharedDataQueue::stateCommitted));
+
+    // simulate worker which reserved record and died before it wrote record header
+    queue_.header_->tail.store(tail + CoordinatorSharedDataQueue::getRecordSize(1000));
+
+    ASSERT_TRUE(enqueue("first"));
+    ASSERT_TRUE(enqueue("second"));
+    ASSERT_TRUE(receiveAll().empty());
+
+    queue_.abandonedReservationTimeout_ = 0ms;
+    ASSERT_EQ(receiveAll(), (std::vector<std::string>{"first", "second"}));
+    ASSERT_EQ(queue_.getUsedBytes(), 0u);
+
+    // reservation without any record behind it
+    tail = queue_.header_->tail.load();
+    queue_.header_->tail.store(tail + CoordinatorSharedDataQueue::getRecordSize(100));
+    ASSERT_TRUE(receiveAll().empty());
+    ASSERT_EQ(queue_.getUsedBytes(), 0u);
+    ASSERT_TRUE(enqueue("third"));
+    ASSERT_EQ(receiveAll(), std::vector<std::string>{"third"});
+}
+
+} // namespace opentelemetry::php::coordinator
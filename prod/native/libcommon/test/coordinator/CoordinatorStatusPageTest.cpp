@@ -0,0 +1,57 @@
+#include "coordinator/CoordinatorStatusPage.h"
+#include "Logger.h"
+
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace opentelemetry::php::coordinator {
+
+class CoordinatorStatusPageTest : public ::testing::Test {
+protected:
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    CoordinatorStatusPage statusPage_{log_};
+};
+
+TEST_F(CoordinatorStatusPageTest, levelFollowsFillAndDrops) {
+    ASSERT_EQ(CoordinatorStatusPage::getLevel(10, 49, false), CoordinatorStatusPage::Level::normal);
+    ASSERT_EQ(CoordinatorStatusPage::getLevel(10, 0, true), CoordinatorStatusPage::Level::elevated);
+    ASSERT_EQ(CoordinatorStatusPage::getLevel(50, 0, false), CoordinatorStatusPage::Level::elevated);
+    ASSERT_EQ(CoordinatorStatusPage::getLevel(0, 90, false), CoordinatorStatusPage::Level::critical);
+    ASSERT_EQ(CoordinatorStatusPage::getLevelName(CoordinatorStatusPage::Level::critical), "critical");
+}
+
+TEST_F(CoordinatorStatusPageTest, statusPublishedByOtherProcess) {
+    ASSERT_EQ(statusPage_.read().updatedAtUnixMs, 0u);
+
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        CoordinatorStatusPage::Status status;
+        status.updatedAtUnixMs = 1000;
+        status.level = CoordinatorStatusPage::Level::elevated;
+        status.queueFillPercent = 60;
+        status.droppedPayloads = 3;
+        status.exportLatencyMs = 25;
+        status.workerSendFailures = 100; // not published, counted by workers
+        statusPage_.publish(status);
+        statusPage_.recordWorkerSendFailure();
+        _exit(0);
+    }
+
+    int exitStatus = 0;
+    waitpid(pid, &exitStatus, 0);
+    ASSERT_EQ(WEXITSTATUS(exitStatus), 0);
+
+    statusPage_.recordWorkerSendFailure();
+
+    auto status = statusPage_.read();
+    ASSERT_EQ(status.updatedAtUnixMs, 1000u);
+    ASSERT_EQ(status.level, CoordinatorStatusPage::Level::elevated);
+    ASSERT_EQ(status.queueFillPercent, 60u);
+    ASSERT_EQ(status.droppedPayloads, 3u);
+    ASSERT_EQ(status.exportLatencyMs, 25u);
+    ASSERT_EQ(status.workerSendFailures, 2u);
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,121 @@
+#include "coordinator/CoordinatorSupervisor.h"
+#include "Logger.h"
+
+#include <chrono>
+#include <optional>
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::coordinator {
+
+class CoordinatorSupervisorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(::pipe(pipe_), 0);
+    }
+
+    void TearDown() override {
+        ::close(pipe_[0]);
+        ::close(pipe_[1]);
+    }
+
+    // coordinator reports its pid and pid of its parent
+    void reportCoordinator(pid_t parentProcessId) {
+        pid_t processIds[2] = {getpid(), parentProcessId};
+        [[maybe_unused]] auto written = ::write(pipe_[1], processIds, sizeof(processIds));
+    }
+
+    std::optional<std::pair<pid_t, pid_t>> readCoordinator(std::chrono::milliseconds timeout = 10s) {
+        pollfd fd{pipe_[0], POLLIN, 0};
+        if (::poll(&fd, 1, static_cast<int>(timeout.count())) != 1) {
+            return std::nullopt;
+        }
+        pid_t processIds[2] = {};
+        if (::read(pipe_[0], processIds, sizeof(processIds)) != sizeof(processIds)) {
+            return std::nullopt;
+        }
+        return std::make_pair(processIds[0], processIds[1]);
+    }
+
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    std::shared_ptr<CoordinatorStatusPage> statusPage_ = std::make_shared<CoordinatorStatusPage>(log_);
+    int pipe_[2] = {-1, -1};
+};
+
+TEST_F(CoordinatorSupervisorTest, exitedCoordinatorIsForkedAgainBySupervisorProcess) {
+    CoordinatorSupervisor supervisor(log_, statusPage_, [this](pid_t parentProcessId) {
+        // coordinator waits until it is killed
+        reportCoordinator(parentProcessId);
+        pause();
+        _exit(0);
+    }, {10ms, 1s, 5});
+
+    auto supervisorProcessId = supervisor.start();
+    ASSERT_GT(supervisorProcessId, 0);
+
+    auto first = readCoordinator();
+    ASSERT_TRUE(first.has_value());
+    ASSERT_EQ(first->second, supervisorProcessId);
+    ASSERT_EQ(statusPage_->read().coordinatorRestarts, 0u);
+
+    kill(first->first, SIGKILL);
+
+    auto second = readCoordinator();
+    ASSERT_TRUE(second.has_value());
+    ASSERT_NE(second->first, first->first);
+    ASSERT_EQ(second->second, supervisorProcessId);
+    ASSERT_EQ(statusPage_->read().coordinatorRestarts, 1u);
+
+    supervisor.stop();
+    ASSERT_EQ(kill(second->first, 0), 0); // coordinator outlives its supervisor
+    kill(second->first, SIGKILL);
+}
+
+TEST_F(CoordinatorSupervisorTest, supervisionIsGivenUpAfterMaxRestarts) {
+    CoordinatorSupervisor supervisor(log_, statusPage_, [this](pid_t parentProcessId) {
+        reportCoordinator(parentProcessId);
+        _exit(1);
+    }, {1ms, 1s, 3});
+
+    auto supervisorProcessId = supervisor.start();
+    ASSERT_GT(supervisorProcessId, 0);
+
+    // first coordinator and its 3 restarts
+    for (int coordinator = 0; coordinator < 4; ++coordinator) {
+        ASSERT_TRUE(readCoordinator().has_value()) << coordinator;
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(supervisorProcessId, &status, 0), supervisorProcessId);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    ASSERT_FALSE(readCoordinator(100ms).has_value());
+    ASSERT_EQ(statusPage_->read().coordinatorRestarts, 3u);
+}
+
+TEST(CoordinatorSupervisorRestartDelayTest, delayGrowsExponentiallyUntilCoordinatorRunsLongEnough) {
+    CoordinatorRestartPolicy policy{100ms, 1s, 10};
+
+    auto delay = CoordinatorSupervisor::getRestartDelay(policy, 0ms, 0ms);
+    ASSERT_EQ(delay, 100ms);
+    delay = CoordinatorSupervisor::getRestartDelay(policy, delay, 10ms);
+    ASSERT_EQ(delay, 200ms);
+    delay = CoordinatorSupervisor::getRestartDelay(policy, delay, 10ms);
+    ASSERT_EQ(delay, 400ms);
+    delay = CoordinatorSupervisor::getRestartDelay(policy, delay, 10ms);
+    ASSERT_EQ(delay, 800ms);
+    delay = CoordinatorSupervisor::getRestartDelay(policy, delay, 10ms);
+    ASSERT_EQ(delay, 1s);
+    delay = CoordinatorSupervisor::getRestartDelay(policy, delay, 10ms);
+    ASSERT_EQ(delay, 1s);
+
+    // stable coordinator starts backoff over
+    ASSERT_EQ(CoordinatorSupervisor::getRestartDelay(policy, delay, 1s), 100ms);
+}
+
+} // namespace opentelemetry::php::coordinator
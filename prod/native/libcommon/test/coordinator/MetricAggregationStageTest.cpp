@@ -0,0 +1,202 @@
+#include "coordinator/MetricAggregationStage.h"
+#include "ConfigurationStorage.h"
+#include "HttpTransportAsyncMock.h"
+#include "Logger.h"
+
+#include "opentelemetry/proto/collector/metrics/v1/metrics_service.pb.h"
+
+#include <string>
+#include <vector>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+using ::testing::_;
+
+namespace opentelemetry::php::coordinator {
+
+using opentelemetry::proto::collector::metrics::v1::ExportMetricsServiceRequest;
+using opentelemetry::proto::metrics::v1::AggregationTemporality;
+using opentelemetry::proto::metrics::v1::Metric;
+using transport::PayloadBuffer;
+
+class MetricAggregationStageTest : public ::testing::Test {
+public:
+    MetricAggregationStageTest() {
+        configForUpdate_.coordinator_metrics_aggregation_enabled = true;
+        config_->update();
+
+        EXPECT_CALL(*next_, initializeConnection(_, _, _, _, _, _, _, _, _)).Times(::testing::AnyNumber());
+        stage_.initializeConnection("http://localhost:4318/v1/metrics", metricsEndpoint, "application/x-protobuf", {}, 1s, 1, 1s, {}, transport::PayloadCompression::none);
+    }
+
+protected:
+    static constexpr std::size_t metricsEndpoint = 1;
+
+    static Metric *addMetric(ExportMetricsServiceRequest &request, int pid, std::string name) {
+        auto resourceMetrics = request.add_resource_metrics();
+        auto serviceName = resourceMetrics->mutable_resource()->add_attributes();
+        serviceName->set_key("service.name");
+        serviceName->mutable_value()->set_string_value("test");
+        auto processId = resourceMetrics->mutable_resource()->add_attributes();
+        processId->set_key("process.pid");
+        processId->mutable_value()->set_int_value(pid);
+        auto scopeMetrics = resourceMetrics->add_scope_metrics();
+        scopeMetrics->mutable_scope()->set_name("scope");
+        auto metric = scopeMetrics->add_metrics();
+        metric->set_name(std::move(name));
+        return metric;
+    }
+
+    static PayloadBuffer makeCounter(int pid, std::string const &route, int64_t value) {
+        ExportMetricsServiceRequest request;
+        auto sum = addMetric(request, pid, "requests")->mutable_sum();
+        sum->set_aggregation_temporality(AggregationTemporality::AGGREGATION_TEMPORALITY_DELTA);
+        sum->set_is_monotonic(true);
+        auto point = sum->add_data_points();
+        auto attribute = point->add_attributes();
+        attribute->set_key("http.route");
+        attribute->mutable_value()->set_string_value(route);
+        point->set_start_time_unix_nano(1000 + pid);
+        point->set_time_unix_nano(2000 + pid);
+        point->set_as_int(value);
+        return serialize(request);
+    }
+
+    static PayloadBuffer makeHistogramAndGauge(int pid, double value) {
+        ExportMetricsServiceRequest request;
+        auto histogram = addMetric(request, pid, "duration")->mutable_histogram();
+        histogram->set_aggregation_temporality(AggregationTemporality::AGGREGATION_TEMPORALITY_DELTA);
+        auto point = histogram->add_data_points();
+        point->add_explicit_bounds(10);
+        point->add_bucket_counts(value < 10 ? 1 : 0);
+        point->add_bucket_counts(value < 10 ? 0 : 1);
+        point->set_count(1);
+        point->set_sum(value);
+        point->set_min(value);
+        point->set_max(value);
+        addMetric(request, pid, "memory")->mutable_gauge()->add_data_points()->set_as_int(pid);
+        return serialize(request);
+    }
+
+    static PayloadBuffer serialize(ExportMetricsServiceRequest const &request) {
+        std::string serialized;
+        request.SerializeToString(&serialized);
+        return PayloadBuffer::adopt(std::move(serialized));
+    }
+
+    static ExportMetricsServiceRequest parse(PayloadBuffer const &payload) {
+        ExportMetricsServiceRequest request;
+        EXPECT_TRUE(request.ParseFromArray(payload.data(), static_cast<int>(payload.size())));
+        return request;
+    }
+
+    bool configUpdater(opentelemetry::php::ConfigurationSnapshot &cfg) {
+        cfg = configForUpdate_;
+        return true;
+    }
+
+    opentelemetry::php::ConfigurationSnapshot configForUpdate_;
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    std::shared_ptr<ConfigurationStorage> config_ = std::make_shared<ConfigurationStorage>([this](opentelemetry::php::ConfigurationSnapshot &cfg) { return configUpdater(cfg); });
+    std::shared_ptr<test::HttpTransportAsyncMock> next_ = std::make_shared<test::HttpTransportAsyncMock>();
+    MetricAggregationStage stage_{log_, config_, next_};
+};
+
+TEST_F(MetricAggregationStageTest, aggregatesDeltaSumsOfWorkersIntoCumulativeStream) {
+    EXPECT_CALL(*next_, enqueue(_, _, _)).Times(0);
+    stage_.enqueue(metricsEndpoint, makeCounter(1, "/a", 2));
+    stage_.enqueue(metricsEndpoint, makeCounter(2, "/a", 3));
+    stage_.enqueue(metricsEndpoint, makeCounter(2, "/b", 1));
+    ASSERT_EQ(stage_.getStreamsCount(), 2u);
+
+    // interval not passed yet
+    stage_.processTimers(std::chrono::steady_clock::now());
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+
+    ExportMetricsServiceRequest exported;
+    EXPECT_CALL(*next_, enqueue(metricsEndpoint, _, _)).WillOnce([&](std::size_t, PayloadBuffer payload, auto) { exported = parse(payload); });
+    stage_.processTimers(std::chrono::steady_clock::now() + 61s);
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+
+    ASSERT_EQ(exported.resource_metrics_size(), 1);
+    auto const &resourceMetrics = exported.resource_metrics(0);
+    ASSERT_EQ(resourceMetrics.resource().attributes_size(), 1);
+    ASSERT_EQ(resourceMetrics.resource().attributes(0).key(), "service.name");
+    ASSERT_EQ(resourceMetrics.scope_metrics_size(), 1);
+    ASSERT_EQ(resourceMetrics.scope_metrics(0).metrics_size(), 1);
+    auto const &sum = resourceMetrics.scope_metrics(0).metrics(0).sum();
+    ASSERT_EQ(sum.aggregation_temporality(), AggregationTemporality::AGGREGATION_TEMPORALITY_CUMULATIVE);
+    ASSERT_TRUE(sum.is_monotonic());
+    ASSERT_EQ(sum.data_points_size(), 2);
+    for (auto const &point : sum.data_points()) {
+        if (point.attributes(0).value().string_value() == "/a") {
+            ASSERT_EQ(point.as_int(), 5);
+            ASSERT_EQ(point.start_time_unix_nano(), 1001u);
+            ASSERT_EQ(point.time_unix_nano(), 2002u);
+        } else {
+            ASSERT_EQ(point.as_int(), 1);
+        }
+    }
+
+    // cumulative stream keeps its value, only updated streams are exported
+    stage_.enqueue(metricsEndpoint, makeCounter(3, "/a", 4));
+    EXPECT_CALL(*next_, enqueue(metricsEndpoint, _, _)).WillOnce([&](std::size_t, PayloadBuffer payload, auto) { exported = parse(payload); });
+    stage_.flushPipeline();
+    ASSERT_EQ(exported.resource_metrics(0).scope_metrics(0).metrics(0).sum().data_points_size(), 1);
+    ASSERT_EQ(exported.resource_metrics(0).scope_metrics(0).metrics(0).sum().data_points(0).as_int(), 9);
+    ASSERT_EQ(stage_.getStreamsCount(), 2u);
+}
+
+TEST_F(MetricAggregationStageTest, mergesHistogramsAndPassesThroughGauges) {
+    configForUpdate_.coordinator_metrics_aggregation_temporality = "delta";
+    config_->update();
+
+    std::vector<ExportMetricsServiceRequest> passedThrough;
+    EXPECT_CALL(*next_, enqueue(metricsEndpoint, _, _)).Times(2).WillRepeatedly([&](std::size_t, PayloadBuffer payload, auto) { passedThrough.push_back(parse(payload)); });
+    stage_.enqueue(metricsEndpoint, makeHistogramAndGauge(1, 5));
+    stage_.enqueue(metricsEndpoint, makeHistogramAndGauge(2, 50));
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+
+    ASSERT_EQ(passedThrough.size(), 2u);
+    for (auto const &request : passedThrough) {
+        ASSERT_EQ(request.resource_metrics_size(), 1);
+        ASSERT_EQ(request.resource_metrics(0).resource().attributes_size(), 2);
+        ASSERT_EQ(request.resource_metrics(0).scope_metrics(0).metrics_size(), 1);
+        ASSERT_TRUE(request.resource_metrics(0).scope_metrics(0).metrics(0).has_gauge());
+    }
+
+    ExportMetricsServiceRequest exported;
+    EXPECT_CALL(*next_, enqueue(metricsEndpoint, _, _)).WillOnce([&](std::size_t, PayloadBuffer payload, auto) { exported = parse(payload); });
+    stage_.processTimers(std::chrono::steady_clock::now() + 61s);
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+
+    auto const &histogram = exported.resource_metrics(0).scope_metrics(0).metrics(0).histogram();
+    ASSERT_EQ(histogram.aggregation_temporality(), AggregationTemporality::AGGREGATION_TEMPORALITY_DELTA);
+    ASSERT_EQ(histogram.data_points_size(), 1);
+    auto const &point = histogram.data_points(0);
+    ASSERT_EQ(point.count(), 2u);
+    ASSERT_EQ(point.sum(), 55);
+    ASSERT_EQ(point.min(), 5);
+    ASSERT_EQ(point.max(), 50);
+    ASSERT_EQ(point.bucket_counts(0), 1u);
+    ASSERT_EQ(point.bucket_counts(1), 1u);
+
+    // delta streams start again after export
+    ASSERT_EQ(stage_.getStreamsCount(), 0u);
+    ASSERT_EQ(stage_.getStatistics().aggregatedDataPoints, 2u);
+    ASSERT_EQ(stage_.getStatistics().passedThroughDataPoints, 2u);
+    ASSERT_EQ(stage_.getStatistics().exportedDataPoints, 1u);
+}
+
+TEST_F(MetricAggregationStageTest, disabledAggregationPassesPayloadsThrough) {
+    configForUpdate_.coordinator_metrics_aggregation_enabled = false;
+    config_->update();
+
+    auto payload = makeCounter(1, "/a", 1);
+    EXPECT_CALL(*next_, enqueue(metricsEndpoint, _, _)).WillOnce([&](std::size_t, PayloadBuffer sent, auto) { ASSERT_EQ(sent.data(), payload.data()); });
+    stage_.enqueue(metricsEndpoint, payload);
+    ASSERT_EQ(stage_.getStreamsCount(), 0u);
+}
+
+} // namespace opentelemetry::php::coordinator
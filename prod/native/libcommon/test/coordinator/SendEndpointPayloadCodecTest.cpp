@@ -0,0 +1,59 @@
+#include "coordinator/SendEndpointPayloadCodec.h"
+#include "coordinator/proto/CoordinatorCommands.pb.h"
+
+#include <string>
+#include <gtest/gtest.h>
+
+namespace opentelemetry::php::coordinator {
+
+static std::string encode(uint64_t endpointHash, std::string const &payload) {
+    SendEndpointPayloadCodec::header_t header;
+    auto encodedHeader = SendEndpointPayloadCodec::encodeHeader(header, endpointHash, payload.size());
+    return std::string(reinterpret_cast<char const *>(encodedHeader.data()), encodedHeader.size()) + payload;
+}
+
+TEST(SendEndpointPayloadCodecTest, frameIsNotValidCommand) {
+    for (auto size : {0ul, 1ul, 100000ul}) {
+        CoordinatorCommand command;
+        ASSERT_FALSE(command.ParseFromString(encode(0xABCDEF, std::string(size, 'p')))) << "size " << size;
+    }
+}
+
+TEST(SendEndpointPayloadCodecTest, decodeReferencesPayloadInMessage) {
+    std::string payload(5000, 'x');
+    auto message = transport::PayloadBuffer::adopt(encode(0xFFFFFFFFFFFFFFFFul, payload));
+
+    auto decoded = SendEndpointPayloadCodec::decode(message);
+    ASSERT_TRUE(decoded.has_value());
+    ASSERT_EQ(decoded->endpointHash, 0xFFFFFFFFFFFFFFFFul);
+    ASSERT_EQ(decoded->payload.size(), payload.size());
+    ASSERT_EQ(decoded->payload.data(), message.data() + SendEndpointPayloadCodec::headerSize);
+}
+
+TEST(SendEndpointPayloadCodecTest, decodeEmptyPayload) {
+    auto decoded = SendEndpointPayloadCodec::decode(transport::PayloadBuffer::adopt(encode(5, "")));
+    ASSERT_TRUE(decoded.has_value());
+    ASSERT_EQ(decoded->endpointHash, 5ul);
+    ASSERT_TRUE(decoded->payload.empty());
+}
+
+TEST(SendEndpointPayloadCodecTest, decodeIgnoresCommands) {
+    CoordinatorCommand command;
+    command.set_type(CoordinatorCommand::WORKER_STARTED);
+    command.mutable_worker_started()->set_process_id(123);
+    ASSERT_FALSE(SendEndpointPayloadCodec::decode(transport::PayloadBuffer::adopt(command.SerializeAsString())).has_value());
+
+    command.set_type(CoordinatorCommand::SEND_ENDPOINT_PAYLOAD);
+    command.mutable_send_endpoint_payload()->set_endpoint_hash(5);
+    command.mutable_send_endpoint_payload()->set_payload(std::string(100, 'x'));
+    ASSERT_FALSE(SendEndpointPayloadCodec::decode(transport::PayloadBuffer::adopt(command.SerializeAsString())).has_value());
+}
+
+TEST(SendEndpointPayloadCodecTest, decodeRejectsTruncatedMessage) {
+    auto message = encode(5, std::string(100, 'x'));
+    message.resize(message.size() - 1);
+    ASSERT_FALSE(SendEndpointPayloadCodec::decode(transport::PayloadBuffer::adopt(std::move(message))).has_value());
+    ASSERT_FALSE(SendEndpointPayloadCodec::decode(transport::PayloadBuffer::adopt(std::string(10, '\0'))).has_value());
+}
+
+} // namespace opentelemetry::php::coordinator
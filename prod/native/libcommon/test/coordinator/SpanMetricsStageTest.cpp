@@ -0,0 +1,182 @@
+#include "coordinator/SpanMetricsStage.h"
+#include "ConfigurationStorage.h"
+#include "HttpTransportAsyncMock.h"
+#include "Logger.h"
+
+#include "opentelemetry/proto/collector/metrics/v1/metrics_service.pb.h"
+#include "opentelemetry/proto/collector/trace/v1/trace_service.pb.h"
+
+#include <string>
+#include <vector>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+using ::testing::_;
+
+namespace opentelemetry::php::coordinator {
+
+using opentelemetry::proto::collector::metrics::v1::ExportMetricsServiceRequest;
+using opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest;
+using opentelemetry::proto::trace::v1::Span;
+using transport::PayloadBuffer;
+
+class SpanMetricsStageTest : public ::testing::Test {
+public:
+    SpanMetricsStageTest() {
+        configForUpdate_.coordinator_span_metrics_enabled = true;
+        configForUpdate_.coordinator_span_metrics_dimensions = "http.route";
+        config_->update();
+
+        EXPECT_CALL(*next_, initializeConnection(_, _, _, _, _, _, _, _, _)).Times(::testing::AnyNumber());
+        stage_.initializeConnection("http://localhost:4318/v1/traces", tracesEndpoint, "application/x-protobuf", {}, 1s, 1, 1s, {}, transport::PayloadCompression::none);
+    }
+
+protected:
+    static constexpr std::size_t tracesEndpoint = 1;
+    static constexpr std::size_t metricsEndpoint = 2;
+
+    struct SpanSpec {
+        Span::SpanKind kind;
+        std::string route;
+        std::chrono::milliseconds duration;
+        bool error = false;
+    };
+
+    static PayloadBuffer makeRequest(int pid, std::vector<SpanSpec> const &spans) {
+        ExportTraceServiceRequest request;
+        auto resourceSpans = request.add_resource_spans();
+        auto serviceName = resourceSpans->mutable_resource()->add_attributes();
+        serviceName->set_key("service.name");
+        serviceName->mutable_value()->set_string_value("test");
+        auto processId = resourceSpans->mutable_resource()->add_attributes();
+        processId->set_key("process.pid");
+        processId->mutable_value()->set_int_value(pid);
+        auto scopeSpans = resourceSpans->add_scope_spans();
+        for (auto const &spec : spans) {
+            auto span = scopeSpans->add_spans();
+            span->set_name("GET");
+            span->set_kind(spec.kind);
+            span->set_start_time_unix_nano(1'000'000'000);
+            span->set_end_time_unix_nano(1'000'000'000 + std::chrono::duration_cast<std::chrono::nanoseconds>(spec.duration).count());
+            auto route = span->add_attributes();
+            route->set_key("http.route");
+            route->mutable_value()->set_string_value(spec.route);
+            auto other = span->add_attributes();
+            other->set_key("http.request.header.x");
+            other->mutable_value()->set_string_value(std::to_string(pid));
+            if (spec.error) {
+                span->mutable_status()->set_code(opentelemetry::proto::trace::v1::Status::STATUS_CODE_ERROR);
+            }
+        }
+        std::string serialized;
+        request.SerializeToString(&serialized);
+        return PayloadBuffer::adopt(std::move(serialized));
+    }
+
+    static std::string getAttribute(auto const &point, std::string_view key) {
+        for (auto const &attribute : point.attributes()) {
+            if (attribute.key() == key) {
+                return attribute.value().string_value();
+            }
+        }
+        return {};
+    }
+
+    bool configUpdater(opentelemetry::php::ConfigurationSnapshot &cfg) {
+        cfg = configForUpdate_;
+        return true;
+    }
+
+    opentelemetry::php::ConfigurationSnapshot configForUpdate_;
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    std::shared_ptr<ConfigurationStorage> config_ = std::make_shared<ConfigurationStorage>([this](opentelemetry::php::ConfigurationSnapshot &cfg) { return configUpdater(cfg); });
+    std::shared_ptr<test::HttpTransportAsyncMock> next_ = std::make_shared<test::HttpTransportAsyncMock>();
+    SpanMetricsStage stage_{log_, config_, next_};
+};
+
+TEST_F(SpanMetricsStageTest, countsServerAndClientSpansOfAllWorkers) {
+    auto first = makeRequest(1, {{Span::SPAN_KIND_SERVER, "/a", 5ms}, {Span::SPAN_KIND_INTERNAL, "/a", 5ms}, {Span::SPAN_KIND_CLIENT, "/a", 30ms}});
+    auto second = makeRequest(2, {{Span::SPAN_KIND_SERVER, "/a", 500ms, true}, {Span::SPAN_KIND_SERVER, "/a", 20000ms}});
+
+    // trace payloads are passed on unchanged
+    EXPECT_CALL(*next_, enqueue(tracesEndpoint, _, _)).Times(2).WillRepeatedly([&](std::size_t, PayloadBuffer sent, auto) { ASSERT_TRUE(sent.data() == first.data() || sent.data() == second.data()); });
+    stage_.enqueue(tracesEndpoint, first);
+    stage_.enqueue(tracesEndpoint, second);
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+    ASSERT_EQ(stage_.getStreamsCount(), 3u);
+
+    // there is no metrics endpoint yet, streams are kept
+    EXPECT_CALL(*next_, enqueue(_, _, _)).Times(0);
+    stage_.processTimers(std::chrono::steady_clock::now() + 61s);
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+
+    stage_.initializeConnection("http://localhost:4318/v1/metrics", metricsEndpoint, "application/x-protobuf", {}, 1s, 1, 1s, {}, transport::PayloadCompression::none);
+
+    ExportMetricsServiceRequest exported;
+    EXPECT_CALL(*next_, enqueue(metricsEndpoint, _, _)).WillOnce([&](std::size_t, PayloadBuffer payload, auto) { ASSERT_TRUE(exported.ParseFromArray(payload.data(), static_cast<int>(payload.size()))); });
+    stage_.processTimers(std::chrono::steady_clock::now() + 122s);
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+
+    // process.pid is ignored, so both workers share resource
+    ASSERT_EQ(exported.resource_metrics_size(), 1);
+    ASSERT_EQ(exported.resource_metrics(0).resource().attributes_size(), 1);
+    auto const &metrics = exported.resource_metrics(0).scope_metrics(0).metrics();
+    ASSERT_EQ(metrics.size(), 2);
+    ASSERT_EQ(metrics[0].name(), SpanMetricsStage::callsMetricName);
+    ASSERT_EQ(metrics[1].name(), SpanMetricsStage::durationMetricName);
+    ASSERT_EQ(metrics[0].sum().data_points_size(), 3);
+    ASSERT_EQ(metrics[1].histogram().data_points_size(), 3);
+
+    for (int i = 0; i < 3; ++i) {
+        auto const &calls = metrics[0].sum().data_points(i);
+        auto const &duration = metrics[1].histogram().data_points(i);
+        ASSERT_EQ(getAttribute(calls, "http.route"), "/a");
+        ASSERT_EQ(getAttribute(calls, "http.request.header.x"), "");
+        ASSERT_EQ(calls.attributes_size(), duration.attributes_size());
+        ASSERT_EQ(static_cast<uint64_t>(calls.as_int()), duration.count());
+
+        if (getAttribute(calls, "span.kind") == "SPAN_KIND_CLIENT") {
+            ASSERT_EQ(calls.as_int(), 1);
+            ASSERT_EQ(duration.bucket_counts(5), 1u); // (10, 50]
+        } else if (getAttribute(calls, "status.code") == "STATUS_CODE_ERROR") {
+            ASSERT_EQ(calls.as_int(), 1);
+            ASSERT_EQ(duration.sum(), 500);
+        } else {
+            ASSERT_EQ(calls.as_int(), 2);
+            ASSERT_EQ(duration.min(), 5);
+            ASSERT_EQ(duration.max(), 20000);
+            ASSERT_EQ(duration.bucket_counts(2), 1u); // (4, 6]
+            ASSERT_EQ(duration.bucket_counts(SpanMetricsStage::durationBounds.size()), 1u);
+        }
+    }
+
+    // nothing new to export
+    EXPECT_CALL(*next_, enqueue(_, _, _)).Times(0);
+    stage_.flushPipeline();
+}
+
+TEST_F(SpanMetricsStageTest, idleStreamsAndResourcesAreEvicted) {
+    stage_.initializeConnection("http://localhost:4318/v1/metrics", metricsEndpoint, "application/x-protobuf", {}, 1s, 1, 1s, {}, transport::PayloadCompression::none);
+
+    EXPECT_CALL(*next_, enqueue(tracesEndpoint, _, _)).Times(1);
+    stage_.enqueue(tracesEndpoint, makeRequest(1, {{Span::SPAN_KIND_SERVER, "/a", 5ms}}));
+    ASSERT_EQ(stage_.getStreamsCount(), 1u);
+    ASSERT_EQ(stage_.getResourcesCount(), 1u);
+
+    EXPECT_CALL(*next_, enqueue(metricsEndpoint, _, _)).Times(1);
+    auto now = std::chrono::steady_clock::now();
+    for (std::size_t interval = 1; interval <= SpanMetricsStage::streamIdleIntervals; ++interval) {
+        stage_.processTimers(now + interval * 61s);
+    }
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+    ASSERT_EQ(stage_.getStreamsCount(), 1u);
+    ASSERT_EQ(stage_.getResourcesCount(), 1u);
+
+    EXPECT_CALL(*next_, enqueue(_, _, _)).Times(0);
+    stage_.processTimers(now + (SpanMetricsStage::streamIdleIntervals + 1) * 61s);
+    ASSERT_EQ(stage_.getStreamsCount(), 0u);
+    ASSERT_EQ(stage_.getResourcesCount(), 0u);
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,180 @@
+#include "coordinator/TailSamplingStage.h"
+#include "ConfigurationStorage.h"
+#include "HttpTransportAsyncMock.h"
+#include "Logger.h"
+
+#include "opentelemetry/proto/collector/trace/v1/trace_service.pb.h"
+
+#include <set>
+#include <string>
+#include <vector>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+using ::testing::_;
+
+namespace opentelemetry::php::coordinator {
+
+using opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest;
+using transport::PayloadBuffer;
+
+class TailSamplingStageTest : public ::testing::Test {
+public:
+    TailSamplingStageTest() {
+        configForUpdate_.coordinator_tail_sampling_enabled = true;
+        configForUpdate_.coordinator_tail_sampling_percentage = 0;
+        configForUpdate_.coordinator_tail_sampling_latency_threshold = 100ms;
+        configForUpdate_.coordinator_tail_sampling_decision_wait = 1s;
+        config_->update();
+
+        EXPECT_CALL(*next_, initializeConnection(_, _, _, _, _, _, _, _, _)).Times(::testing::AnyNumber());
+        stage_.initializeConnection("http://localhost:4318/v1/traces", tracesEndpoint, "application/x-protobuf", {}, 1s, 1, 1s, {}, transport::PayloadCompression::none);
+        stage_.initializeConnection("http://localhost:4318/v1/metrics", metricsEndpoint, "application/x-protobuf", {}, 1s, 1, 1s, {}, transport::PayloadCompression::none);
+    }
+
+protected:
+    static constexpr std::size_t tracesEndpoint = 1;
+    static constexpr std::size_t metricsEndpoint = 2;
+
+    struct SpanSpec {
+        std::string traceId;
+        std::string name;
+        std::chrono::milliseconds duration = 1ms;
+        bool error = false;
+    };
+
+    static PayloadBuffer makeRequest(std::vector<SpanSpec> const &spans) {
+        ExportTraceServiceRequest request;
+        auto resourceSpans = request.add_resource_spans();
+        auto attribute = resourceSpans->mutable_resource()->add_attributes();
+        attribute->set_key("service.name");
+        attribute->mutable_value()->set_string_value("test");
+        auto scopeSpans = resourceSpans->add_scope_spans();
+        scopeSpans->mutable_scope()->set_name("scope");
+        for (auto const &spec : spans) {
+            auto span = scopeSpans->add_spans();
+            span->set_trace_id(spec.traceId);
+            span->set_name(spec.name);
+            span->set_start_time_unix_nano(1'000'000'000);
+            span->set_end_time_unix_nano(1'000'000'000 + std::chrono::duration_cast<std::chrono::nanoseconds>(spec.duration).count());
+            if (spec.error) {
+                span->mutable_status()->set_code(opentelemetry::proto::trace::v1::Status::STATUS_CODE_ERROR);
+            }
+        }
+        std::string serialized;
+        request.SerializeToString(&serialized);
+        return PayloadBuffer::adopt(std::move(serialized));
+    }
+
+    static std::set<std::string> getSpanNames(PayloadBuffer const &payload) {
+        ExportTraceServiceRequest request;
+        EXPECT_TRUE(request.ParseFromArray(payload.data(), static_cast<int>(payload.size())));
+        std::set<std::string> names;
+        for (auto const &resourceSpans : request.resource_spans()) {
+            EXPECT_EQ(resourceSpans.resource().attributes(0).value().string_value(), "test");
+            for (auto const &scopeSpans : resourceSpans.scope_spans()) {
+                EXPECT_EQ(scopeSpans.scope().name(), "scope");
+                for (auto const &span : scopeSpans.spans()) {
+                    names.insert(span.name());
+                }
+            }
+        }
+        return names;
+    }
+
+    static std::string traceId(char id) {
+        return std::string(15, '\0') + id;
+    }
+
+    bool configUpdater(opentelemetry::php::ConfigurationSnapshot &cfg) {
+        cfg = configForUpdate_;
+        return true;
+    }
+
+    opentelemetry::php::ConfigurationSnapshot configForUpdate_;
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    std::shared_ptr<ConfigurationStorage> config_ = std::make_shared<ConfigurationStorage>([this](opentelemetry::php::ConfigurationSnapshot &cfg) { return configUpdater(cfg); });
+    std::shared_ptr<test::HttpTransportAsyncMock> next_ = std::make_shared<test::HttpTransportAsyncMock>();
+    TailSamplingStage stage_{log_, config_, next_};
+};
+
+TEST_F(TailSamplingStageTest, otherEndpointsPassThrough) {
+    auto payload = makeRequest({{traceId(1), "a"}});
+    EXPECT_CALL(*next_, enqueue(metricsEndpoint, _, _)).WillOnce([&](std::size_t, PayloadBuffer sent, auto) { ASSERT_EQ(sent.data(), payload.data()); });
+    stage_.enqueue(metricsEndpoint, payload);
+
+    configForUpdate_.coordinator_tail_sampling_enabled = false;
+    config_->update();
+    EXPECT_CALL(*next_, enqueue(tracesEndpoint, _, _)).WillOnce([&](std::size_t, PayloadBuffer sent, auto) { ASSERT_EQ(sent.data(), payload.data()); });
+    stage_.enqueue(tracesEndpoint, payload);
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+
+    ASSERT_EQ(stage_.getBufferedBytes(), 0u);
+}
+
+TEST_F(TailSamplingStageTest, keepsTracesWithErrorsAndSlowSpans) {
+    EXPECT_CALL(*next_, enqueue(_, _, _)).Times(0);
+    stage_.enqueue(tracesEndpoint, makeRequest({{traceId(1), "error-root"}, {traceId(2), "slow-root"}, {traceId(3), "regular-root"}}));
+    stage_.enqueue(tracesEndpoint, makeRequest({{traceId(1), "error-child", 1ms, true}, {traceId(2), "slow-child", 200ms}, {traceId(3), "regular-child"}}));
+    ASSERT_GT(stage_.getBufferedBytes(), 0u);
+
+    // decision wait not passed yet
+    stage_.processTimers(std::chrono::steady_clock::now());
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+
+    EXPECT_CALL(*next_, enqueue(tracesEndpoint, _, _)).WillOnce([](std::size_t, PayloadBuffer sent, auto) { ASSERT_EQ(getSpanNames(sent), (std::set<std::string>{"error-root", "error-child", "slow-root", "slow-child"})); });
+    stage_.processTimers(std::chrono::steady_clock::now() + 2s);
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+
+    ASSERT_EQ(stage_.getBufferedBytes(), 0u);
+    ASSERT_EQ(stage_.getStatistics().tracesKept, 2u);
+    ASSERT_EQ(stage_.getStatistics().tracesDropped, 1u);
+
+    // late spans follow decision of their trace
+    EXPECT_CALL(*next_, enqueue(tracesEndpoint, _, _)).WillOnce([](std::size_t, PayloadBuffer sent, auto) { ASSERT_EQ(getSpanNames(sent), (std::set<std::string>{"error-late"})); });
+    stage_.enqueue(tracesEndpoint, makeRequest({{traceId(1), "error-late"}, {traceId(3), "regular-late"}}));
+    ASSERT_EQ(stage_.getStatistics().lateSpans, 2u);
+    ASSERT_EQ(stage_.getBufferedBytes(), 0u);
+}
+
+TEST_F(TailSamplingStageTest, memoryLimitDecidesRegularTracesFirst) {
+    EXPECT_CALL(*next_, enqueue(_, _, _)).Times(0);
+    stage_.enqueue(tracesEndpoint, makeRequest({{traceId(1), "error", 1ms, true}}));
+    stage_.enqueue(tracesEndpoint, makeRequest({{traceId(2), "regular"}}));
+    auto twoTraces = stage_.getBufferedBytes();
+
+    configForUpdate_.coordinator_tail_sampling_max_memory = twoTraces * 5 / 4;
+    config_->update();
+
+    // third trace exceeds limit, oldest regular trace is dropped although error trace is older
+    stage_.enqueue(tracesEndpoint, makeRequest({{traceId(3), "regular"}}));
+    ASSERT_EQ(stage_.getStatistics().tracesDecidedEarly, 1u);
+    ASSERT_EQ(stage_.getStatistics().tracesDropped, 1u);
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+
+    EXPECT_CALL(*next_, enqueue(tracesEndpoint, _, _)).WillOnce([](std::size_t, PayloadBuffer sent, auto) { ASSERT_EQ(getSpanNames(sent), (std::set<std::string>{"error"})); });
+    stage_.processTimers(std::chrono::steady_clock::now() + 2s);
+    ASSERT_EQ(stage_.getStatistics().tracesDropped, 2u);
+}
+
+TEST_F(TailSamplingStageTest, flushDoesNotForceDecisionOfBufferedTraces) {
+    configForUpdate_.coordinator_tail_sampling_percentage = 100;
+    config_->update();
+
+    EXPECT_CALL(*next_, enqueue(_, _, _)).Times(0);
+    stage_.enqueue(tracesEndpoint, makeRequest({{traceId(1), "a"}, {traceId(2), "b"}}));
+
+    // flush requested by worker covers only payloads already passed to transport
+    EXPECT_CALL(*next_, flush(tracesEndpoint, std::chrono::milliseconds(1000))).WillOnce(::testing::Return(true));
+    ASSERT_TRUE(stage_.flush(tracesEndpoint, 1s));
+    ASSERT_EQ(stage_.getStatistics().tracesKept, 0u);
+    ::testing::Mock::VerifyAndClearExpectations(next_.get());
+
+    // coordinator exit decides everything buffered
+    EXPECT_CALL(*next_, enqueue(tracesEndpoint, _, _)).WillOnce([](std::size_t, PayloadBuffer sent, auto) { ASSERT_EQ(getSpanNames(sent), (std::set<std::string>{"a", "b"})); });
+    stage_.flushPipeline();
+    ASSERT_EQ(stage_.getStatistics().tracesKept, 2u);
+}
+
+} // namespace opentelemetry::php::coordinator
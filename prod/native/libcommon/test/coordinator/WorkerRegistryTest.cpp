@@ -0,0 +1,76 @@
+#include "coordinator/WorkerRegistry.h"
+#include "Logger.h"
+
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::coordinator {
+
+class WorkerRegistryTest : public ::testing::Test {
+protected:
+    pid_t forkWorker() {
+        auto pid = fork();
+        if (pid == 0) {
+            pause();
+            _exit(0);
+        }
+        return pid;
+    }
+
+    std::vector<pid_t> waitForExitedWorkers() {
+        for (auto deadline = std::chrono::steady_clock::now() + 5s; std::chrono::steady_clock::now() < deadline; std::this_thread::sleep_for(1ms)) {
+            if (auto exited = registry_.collectExitedWorkers(); !exited.empty()) {
+                return exited;
+            }
+        }
+        return {};
+    }
+
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    WorkerRegistry registry_{log_};
+};
+
+TEST_F(WorkerRegistryTest, exitedWorkerIsReported) {
+    auto exiting = forkWorker();
+    auto running = forkWorker();
+    ASSERT_GT(exiting, 0);
+    ASSERT_GT(running, 0);
+
+    registry_.registerWorker(exiting, getpid());
+    registry_.registerWorker(running, getpid());
+    ASSERT_EQ(registry_.getWorkerCount(), 2u);
+    ASSERT_TRUE(registry_.collectExitedWorkers().empty());
+
+    kill(exiting, SIGKILL);
+    waitpid(exiting, nullptr, 0);
+
+    ASSERT_EQ(waitForExitedWorkers(), std::vector<pid_t>{exiting});
+    ASSERT_FALSE(registry_.hasWorker(exiting));
+    ASSERT_TRUE(registry_.hasWorker(running));
+    ASSERT_TRUE(registry_.verifyWorkersAlive().empty());
+
+    registry_.unregisterWorker(running);
+    ASSERT_EQ(registry_.getWorkerCount(), 0u);
+    kill(running, SIGKILL);
+    waitpid(running, nullptr, 0);
+    ASSERT_TRUE(registry_.collectExitedWorkers().empty());
+}
+
+TEST_F(WorkerRegistryTest, workerExitedBeforeRegistrationIsReported) {
+    auto pid = forkWorker();
+    ASSERT_GT(pid, 0);
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+
+    registry_.registerWorker(pid, getpid());
+    ASSERT_FALSE(registry_.hasWorker(pid));
+    ASSERT_EQ(registry_.collectExitedWorkers(), std::vector<pid_t>{pid});
+}
+
+} // namespace opentelemetry::php::coordinator
@@ -0,0 +1,83 @@
+#include "transport/CircuitBreaker.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::transport {
+
+class CircuitBreakerTest : public ::testing::Test {
+protected:
+    CircuitBreaker::clock_t::time_point now_ = CircuitBreaker::clock_t::now();
+};
+
+TEST_F(CircuitBreakerTest, opensAfterThresholdConsecutiveFailures) {
+    CircuitBreaker breaker(3, 10s);
+
+    breaker.onFailure(now_);
+    breaker.onFailure(now_);
+    ASSERT_EQ(breaker.getState(), CircuitBreaker::State::closed);
+    ASSERT_TRUE(breaker.tryAcquire(now_));
+
+    breaker.onFailure(now_);
+    ASSERT_EQ(breaker.getState(), CircuitBreaker::State::open);
+    ASSERT_TRUE(breaker.isOpen(now_));
+    ASSERT_FALSE(breaker.tryAcquire(now_ + 5s));
+    ASSERT_EQ(breaker.getOpenUntil(), now_ + 10s);
+}
+
+TEST_F(CircuitBreakerTest, successResetsFailuresCounter) {
+    CircuitBreaker breaker(2, 10s);
+
+    breaker.onFailure(now_);
+    breaker.onSuccess();
+    breaker.onFailure(now_);
+    ASSERT_EQ(breaker.getState(), CircuitBreaker::State::closed);
+    ASSERT_EQ(breaker.getConsecutiveFailures(), 1ul);
+}
+
+TEST_F(CircuitBreakerTest, halfOpenAllowsSingleProbe) {
+    CircuitBreaker breaker(1, 10s);
+    breaker.onFailure(now_);
+
+    ASSERT_TRUE(breaker.tryAcquire(now_ + 10s));
+    ASSERT_EQ(breaker.getState(), CircuitBreaker::State::halfOpen);
+    ASSERT_FALSE(breaker.tryAcquire(now_ + 10s));
+
+    breaker.onSuccess();
+    ASSERT_EQ(breaker.getState(), CircuitBreaker::State::closed);
+    ASSERT_TRUE(breaker.tryAcquire(now_ + 10s));
+    ASSERT_TRUE(breaker.tryAcquire(now_ + 10s));
+}
+
+TEST_F(CircuitBreakerTest, failedProbeOpensAgain) {
+    CircuitBreaker breaker(3, 10s);
+    breaker.onFailure(now_);
+    breaker.onFailure(now_);
+    breaker.onFailure(now_);
+
+    ASSERT_TRUE(breaker.tryAcquire(now_ + 11s));
+    breaker.onFailure(now_ + 12s);
+    ASSERT_EQ(breaker.getState(), CircuitBreaker::State::open);
+    ASSERT_EQ(breaker.getOpenUntil(), now_ + 22s);
+}
+
+TEST_F(CircuitBreakerTest, abandonedProbeCanBeRetried) {
+    CircuitBreaker breaker(1, 10s);
+    breaker.onFailure(now_);
+
+    ASSERT_TRUE(breaker.tryAcquire(now_ + 10s));
+    breaker.onAbandoned();
+    ASSERT_TRUE(breaker.tryAcquire(now_ + 10s));
+}
+
+TEST_F(CircuitBreakerTest, zeroThresholdNeverOpens) {
+    CircuitBreaker breaker(0, 10s);
+    for (int i = 0; i < 100; ++i) {
+        breaker.onFailure(now_);
+    }
+    ASSERT_EQ(breaker.getState(), CircuitBreaker::State::closed);
+    ASSERT_TRUE(breaker.tryAcquire(now_));
+}
+
+} // namespace opentelemetry::php::transport
@@ -0,0 +1,165 @@
+#include "transport/DiskSpillQueue.h"
+#include "Logger.h"
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+namespace opentelemetry::php::transport {
+
+class DiskSpillQueueTest : public ::testing::Test {
+public:
+    DiskSpillQueueTest() {
+        static std::atomic_size_t counter = 0;
+        directory_ = std::filesystem::temp_directory_path() / ("otel_spill_test_" + std::to_string(::getpid()) + "_" + std::to_string(counter++));
+    }
+
+    ~DiskSpillQueueTest() {
+        std::error_code error;
+        std::filesystem::remove_all(directory_, error);
+    }
+
+protected:
+    static std::vector<std::byte> makePayload(std::size_t size, uint8_t value) {
+        return std::vector<std::byte>(size, std::byte{value});
+    }
+
+    std::size_t countSegmentFiles() const {
+        std::size_t count = 0;
+        for (auto const &entry : std::filesystem::directory_iterator(directory_)) {
+            if (entry.path().extension() == ".spill") {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    std::shared_ptr<LoggerInterface> log_ = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    std::shared_ptr<PayloadBufferPool> pool_ = std::make_shared<PayloadBufferPool>();
+    std::filesystem::path directory_;
+};
+
+TEST_F(DiskSpillQueueTest, popsPayloadsInOrderPerEndpoint) {
+    DiskSpillQueue queue(log_, directory_, 1024 * 1024, 4096);
+
+    ASSERT_TRUE(queue.push(1, makePayload(100, 1)));
+    ASSERT_TRUE(queue.push(2, makePayload(200, 2)));
+    ASSERT_TRUE(queue.push(1, makePayload(300, 3)));
+    ASSERT_EQ(queue.getPendingCount(), 3ul);
+    ASSERT_EQ(queue.getPendingCount(1), 2ul);
+
+    ASSERT_EQ(queue.getFrontSize(1).value(), 100ul);
+    auto payload = queue.pop(1, *pool_);
+    ASSERT_EQ(payload.size(), 100ul);
+    ASSERT_EQ(payload.data()[0], std::byte{1});
+
+    payload = queue.pop(1, *pool_);
+    ASSERT_EQ(payload.size(), 300ul);
+    ASSERT_EQ(payload.data()[299], std::byte{3});
+
+    ASSERT_FALSE(queue.getFrontSize(1).has_value());
+    ASSERT_TRUE(queue.pop(1, *pool_).empty());
+    ASSERT_EQ(queue.getFrontSize(2).value(), 200ul);
+}
+
+TEST_F(DiskSpillQueueTest, recoversPendingPayloadsAfterReopen) {
+    {
+        DiskSpillQueue queue(log_, directory_, 1024 * 1024, 4096);
+        for (uint8_t i = 1; i <= 5; ++i) {
+            ASSERT_TRUE(queue.push(7, makePayload(1000, i)));
+        }
+        queue.pop(7, *pool_);
+        queue.pop(7, *pool_);
+    }
+
+    DiskSpillQueue queue(log_, directory_, 1024 * 1024, 4096);
+    ASSERT_EQ(queue.getPendingCount(7), 3ul);
+    for (uint8_t i = 3; i <= 5; ++i) {
+        auto payload = queue.pop(7, *pool_);
+        ASSERT_EQ(payload.size(), 1000ul);
+        ASSERT_EQ(payload.data()[0], std::byte{i});
+    }
+
+    // recovered segments aren't appended, new ones are created after them
+    ASSERT_TRUE(queue.push(7, makePayload(10, 6)));
+    ASSERT_EQ(queue.pop(7, *pool_).data()[0], std::byte{6});
+}
+
+TEST_F(DiskSpillQueueTest, removesSegmentsWithoutPendingPayloads) {
+    DiskSpillQueue queue(log_, directory_, 1024 * 1024, 4096);
+    for (uint8_t i = 0; i < 6; ++i) {
+        ASSERT_TRUE(queue.push(1, makePayload(1500, i)));
+    }
+    ASSERT_EQ(countSegmentFiles(), 3ul);
+    ASSERT_EQ(queue.getUsedBytes(), 3 * 4096ul);
+
+    queue.pop(1, *pool_);
+    queue.pop(1, *pool_);
+    ASSERT_EQ(countSegmentFiles(), 2ul);
+
+    while (queue.getPendingCount(1) > 0) {
+        queue.pop(1, *pool_);
+    }
+    ASSERT_EQ(countSegmentFiles(), 0ul);
+    ASSERT_EQ(queue.getUsedBytes(), 0ul);
+}
+
+TEST_F(DiskSpillQueueTest, respectsMaxSize) {
+    DiskSpillQueue queue(log_, directory_, 8192, 4096);
+    ASSERT_TRUE(queue.push(1, makePayload(3000, 1)));
+    ASSERT_TRUE(queue.push(1, makePayload(3000, 2)));
+    ASSERT_FALSE(queue.push(1, makePayload(3000, 3)));
+    ASSERT_FALSE(queue.push(1, makePayload(10000, 4)));
+    ASSERT_EQ(queue.getPendingCount(1), 2ul);
+
+    queue.pop(1, *pool_);
+    ASSERT_TRUE(queue.push(1, makePayload(3000, 3)));
+
+    queue.setMaxSize(20000);
+    ASSERT_TRUE(queue.push(1, makePayload(10000, 4)));
+    ASSERT_EQ(queue.getPendingCount(1), 3ul);
+}
+
+TEST_F(DiskSpillQueueTest, directoryIsLockedByOneInstance) {
+    DiskSpillQueue queue(log_, directory_, 8192);
+    ASSERT_THROW(DiskSpillQueue(log_, directory_, 8192), std::runtime_error);
+}
+
+TEST_F(DiskSpillQueueTest, ignoresUnknownSegments) {
+    std::filesystem::create_directories(directory_);
+    {
+        std::FILE *file = std::fopen((directory_ / "segment-00000000000000000003.spill").c_str(), "w");
+        std::fputs("garbage which isn't segment", file);
+        std::fclose(file);
+    }
+
+    DiskSpillQueue queue(log_, directory_, 1024 * 1024, 4096);
+    ASSERT_EQ(queue.getPendingCount(), 0ul);
+    ASSERT_TRUE(queue.push(1, makePayload(10, 1)));
+    ASSERT_TRUE(std::filesystem::exists(directory_ / "segment-00000000000000000004.spill"));
+}
+
+TEST_F(DiskSpillQueueTest, dropRemovesPendingPayloadsOfEndpoint) {
+    {
+        DiskSpillQueue queue(log_, directory_, 1024 * 1024, 4096);
+        ASSERT_TRUE(queue.push(1, makePayload(1500, 1)));
+        ASSERT_TRUE(queue.push(2, makePayload(1500, 2)));
+        ASSERT_TRUE(queue.push(1, makePayload(1500, 3)));
+    }
+
+    DiskSpillQueue queue(log_, directory_, 1024 * 1024, 4096);
+    ASSERT_EQ(queue.getPendingEndpoints().size(), 2ul);
+    ASSERT_EQ(queue.drop(1), 2ul);
+    ASSERT_EQ(queue.drop(1), 0ul);
+    ASSERT_EQ(queue.getPendingEndpoints(), std::vector<uint64_t>{2});
+    ASSERT_EQ(countSegmentFiles(), 1ul);
+
+    ASSERT_EQ(queue.drop(2), 1ul);
+    ASSERT_EQ(countSegmentFiles(), 0ul);
+    ASSERT_EQ(queue.getUsedBytes(), 0ul);
+}
+
+} // namespace opentelemetry::php::transport
@@ -0,0 +1,58 @@
+#include "transport/GrpcFraming.h"
+
+#include <cstring>
+#include <string>
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::transport {
+
+TEST(GrpcFramingTest, isGrpcContentType) {
+    ASSERT_TRUE(isGrpcContentType("application/grpc"sv));
+    ASSERT_TRUE(isGrpcContentType("Application/GRPC+proto"sv));
+    ASSERT_TRUE(isGrpcContentType("application/grpc; charset=utf-8"sv));
+    ASSERT_FALSE(isGrpcContentType("application/grpc-web"sv));
+    ASSERT_FALSE(isGrpcContentType("application/x-protobuf"sv));
+    ASSERT_FALSE(isGrpcContentType(""sv));
+}
+
+TEST(GrpcFramingTest, frameGrpcMessage) {
+    auto pool = std::make_shared<PayloadBufferPool>();
+    std::string message(300, 'm');
+
+    auto framed = frameGrpcMessage(*pool, std::as_bytes(std::span(message)), false);
+    ASSERT_EQ(framed.size(), grpcMessagePrefixSize + 300);
+    ASSERT_EQ(framed.data()[0], std::byte{0});
+    ASSERT_EQ(framed.data()[1], std::byte{0});
+    ASSERT_EQ(framed.data()[2], std::byte{0});
+    ASSERT_EQ(framed.data()[3], std::byte{1});
+    ASSERT_EQ(framed.data()[4], std::byte{44});
+    ASSERT_EQ(std::memcmp(framed.data() + grpcMessagePrefixSize, message.data(), message.size()), 0);
+
+    auto compressed = frameGrpcMessage(*pool, {}, true);
+    ASSERT_EQ(compressed.size(), grpcMessagePrefixSize);
+    ASSERT_EQ(compressed.data()[0], std::byte{1});
+    ASSERT_EQ(compressed.data()[4], std::byte{0});
+}
+
+TEST(GrpcFramingTest, parseGrpcStatus) {
+    ASSERT_EQ(parseGrpcStatus("0"sv), 0u);
+    ASSERT_EQ(parseGrpcStatus(" 14"sv), 14u);
+    ASSERT_EQ(parseGrpcStatus("3\r\n"sv), 3u);
+    ASSERT_FALSE(parseGrpcStatus(""sv).has_value());
+    ASSERT_FALSE(parseGrpcStatus("ok"sv).has_value());
+    ASSERT_FALSE(parseGrpcStatus("-1"sv).has_value());
+}
+
+TEST(GrpcFramingTest, getResponseCodeFromGrpcStatus) {
+    ASSERT_EQ(getResponseCodeFromGrpcStatus(0), 200);
+    ASSERT_EQ(getResponseCodeFromGrpcStatus(14), 503); // UNAVAILABLE
+    ASSERT_EQ(getResponseCodeFromGrpcStatus(4), 503);  // DEADLINE_EXCEEDED
+    ASSERT_EQ(getResponseCodeFromGrpcStatus(8), 503);  // RESOURCE_EXHAUSTED
+    ASSERT_EQ(getResponseCodeFromGrpcStatus(3), 400);  // INVALID_ARGUMENT
+    ASSERT_EQ(getResponseCodeFromGrpcStatus(16), 400); // UNAUTHENTICATED
+    ASSERT_EQ(getResponseCodeFromGrpcStatus(std::nullopt), 400);
+}
+
+} // namespace opentelemetry::php::transport
@@ -0,0 +1,245 @@
+#include "transport/CurlSender.h"
+#include "transport/GrpcFraming.h"
+#include "transport/HttpEndpoint.h"
+#include "Logger.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::transport {
+
+// Stand-in for OTLP/gRPC collector - plain text HTTP/2 with prior knowledge (h2c) on loopback. Connections are served one after another, every
+// request stream gets 200 response with empty gRPC message and grpc-status trailer taken from the configured list. Request headers are not decoded,
+// HPACK of responses uses only static table and literals without Huffman coding
+class H2cGrpcServer {
+public:
+    struct Request {
+        std::string data;
+    };
+
+    explicit H2cGrpcServer(std::deque<uint32_t> grpcStatuses) : grpcStatuses_(std::move(grpcStatuses)) {
+        listenSocket_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (listenSocket_ < 0 || ::bind(listenSocket_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(listenSocket_, 1) != 0 || ::getsockname(listenSocket_, reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+            throw std::runtime_error("H2cGrpcServer: unable to listen on loopback");
+        }
+        port_ = ntohs(address.sin_port);
+        thread_ = std::thread([this]() { serve(); });
+    }
+
+    ~H2cGrpcServer() {
+        ::shutdown(listenSocket_, SHUT_RDWR);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (connection_ >= 0) {
+                ::shutdown(connection_, SHUT_RDWR);
+            }
+        }
+        thread_.join();
+        ::close(listenSocket_);
+    }
+
+    uint16_t getPort() const {
+        return port_;
+    }
+
+    // request is stored before it is responded
+    std::vector<Request> getRequests() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_;
+    }
+
+    std::size_t getPrefacesCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return prefacesCount_;
+    }
+
+private:
+    static constexpr uint8_t frameData = 0x0;
+    static constexpr uint8_t frameHeaders = 0x1;
+    static constexpr uint8_t frameSettings = 0x4;
+    static constexpr uint8_t frameGoAway = 0x7;
+    static constexpr uint8_t flagEndStream = 0x1;
+    static constexpr uint8_t flagAck = 0x1;
+    static constexpr uint8_t flagEndHeaders = 0x4;
+
+    static bool readExactly(int connection, void *buffer, std::size_t size) {
+        auto data = static_cast<char *>(buffer);
+        while (size > 0) {
+            auto received = ::recv(connection, data, size, 0);
+            if (received <= 0) {
+                return false;
+            }
+            data += received;
+            size -= received;
+        }
+        return true;
+    }
+
+    static void writeFrame(int connection, uint8_t type, uint8_t flags, uint32_t streamId, std::string_view payload) {
+        std::string frame;
+        frame.push_back(static_cast<char>((payload.size() >> 16) & 0xff));
+        frame.push_back(static_cast<char>((payload.size() >> 8) & 0xff));
+        frame.push_back(static_cast<char>(payload.size() & 0xff));
+        frame.push_back(static_cast<char>(type));
+        frame.push_back(static_cast<char>(flags));
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            frame.push_back(static_cast<char>((streamId >> shift) & 0xff));
+        }
+        frame.append(payload);
+        ::send(connection, frame.data(), frame.size(), MSG_NOSIGNAL);
+    }
+
+    // literal header field without indexing, new name
+    static void appendLiteralHeader(std::string &block, std::string_view name, std::string_view value) {
+        block.push_back(0x00);
+        block.push_back(static_cast<char>(name.size()));
+        block.append(name);
+        block.push_back(static_cast<char>(value.size()));
+        block.append(value);
+    }
+
+    static void respond(int connection, uint32_t streamId, uint32_t grpcStatus) {
+        std::string headers;
+        headers.push_back(static_cast<char>(0x88)); // :status 200 from static table
+        appendLiteralHeader(headers, "content-type"sv, "application/grpc"sv);
+        writeFrame(connection, frameHeaders, flagEndHeaders, streamId, headers);
+
+        writeFrame(connection, frameData, 0, streamId, "\0\0\0\0\0"sv); // empty ExportServiceResponse
+
+        std::string trailers;
+        appendLiteralHeader(trailers, "grpc-status"sv, std::to_string(grpcStatus));
+        writeFrame(connection, frameHeaders, flagEndHeaders | flagEndStream, streamId, trailers);
+    }
+
+    void serveConnection(int connection) {
+        std::string preface(24, '\0');
+        if (!readExactly(connection, preface.data(), preface.size()) || preface != "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"sv) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++prefacesCount_;
+        }
+        writeFrame(connection, frameSettings, 0, 0, {});
+
+        std::unordered_map<uint32_t, std::string> streams;
+        uint8_t header[9];
+        while (readExactly(connection, header, sizeof(header))) {
+            std::size_t length = (header[0] << 16) | (header[1] << 8) | header[2];
+            uint8_t type = header[3];
+            uint8_t flags = header[4];
+            uint32_t streamId = ((header[5] & 0x7f) << 24) | (header[6] << 16) | (header[7] << 8) | header[8];
+            std::string payload(length, '\0');
+            if (!readExactly(connection, payload.data(), length)) {
+                return;
+            }
+
+            if (type == frameSettings && !(flags & flagAck)) {
+                writeFrame(connection, frameSettings, flagAck, 0, {});
+            } else if (type == frameHeaders) {
+                streams[streamId];
+            } else if (type == frameData) {
+                streams[streamId].append(payload);
+            } else if (type == frameGoAway) {
+                return;
+            }
+
+            if ((type == frameHeaders || type == frameData) && (flags & flagEndStream)) {
+                uint32_t grpcStatus = 0;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    requests_.push_back(Request{std::move(streams[streamId])});
+                    if (!grpcStatuses_.empty()) {
+                        grpcStatus = grpcStatuses_.front();
+                        grpcStatuses_.pop_front();
+                    }
+                }
+                streams.erase(streamId);
+                respond(connection, streamId, grpcStatus);
+            }
+        }
+    }
+
+    void serve() {
+        for (;;) {
+            int connection = ::accept(listenSocket_, nullptr, nullptr);
+            if (connection < 0) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                connection_ = connection;
+            }
+            serveConnection(connection);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                connection_ = -1;
+            }
+            ::close(connection);
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::deque<uint32_t> grpcStatuses_;
+    int listenSocket_ = -1;
+    int connection_ = -1;
+    uint16_t port_ = 0;
+    std::size_t prefacesCount_ = 0;
+    std::vector<Request> requests_;
+    std::thread thread_;
+};
+
+// every call uses own sender and so own connection - libcurl 7.88 fails to open next stream on reused prior knowledge connection
+TEST(GrpcH2cTest, unaryExportCallsOverPriorKnowledgeConnections) {
+    auto log = std::make_shared<opentelemetry::php::Logger>(std::vector<std::shared_ptr<LoggerSinkInterface>>());
+    H2cGrpcServer server({0, 14, 3});
+
+    HttpEndpoint endpoint("http://127.0.0.1:"s + std::to_string(server.getPort()) + "/opentelemetry.proto.collector.trace.v1.TraceService/Export"s, "application/grpc"sv, {}, 3, 100ms);
+    ASSERT_TRUE(endpoint.isGrpc());
+
+    auto pool = std::make_shared<PayloadBufferPool>();
+    std::string message = "serialized ExportTraceServiceRequest"s;
+    auto framed = frameGrpcMessage(*pool, std::as_bytes(std::span(message)), false);
+
+    std::vector<int16_t> responseCodes;
+    for (int call = 0; call < 3; ++call) {
+        CurlSender sender(log, 5s, {}, endpoint.isGrpc());
+        std::optional<uint32_t> grpcStatus;
+        auto responseCode = sender.sendPayload(endpoint.getRequestUrl(), endpoint.getHeaders(), {framed.data(), framed.size()}, [&grpcStatus](std::string_view header) {
+            if (header.starts_with("grpc-status:"sv)) {
+                grpcStatus = parseGrpcStatus(header.substr("grpc-status:"sv.length()));
+            }
+        });
+        ASSERT_EQ(responseCode, 200);
+        responseCodes.push_back(getResponseCodeFromGrpcStatus(grpcStatus));
+    }
+
+    ASSERT_EQ(server.getPrefacesCount(), 3u);
+    auto requests = server.getRequests();
+    ASSERT_EQ(requests.size(), 3u);
+    for (auto const &request : requests) {
+        ASSERT_EQ(request.data, std::string(reinterpret_cast<char const *>(framed.data()), framed.size()));
+    }
+    // OK, UNAVAILABLE which is retried and INVALID_ARGUMENT which is not
+    ASSERT_EQ(responseCodes, (std::vector<int16_t>{200, 503, 400}));
+}
+
+} // namespace opentelemetry::php::transport
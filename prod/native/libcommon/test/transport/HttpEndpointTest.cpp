@@ -48,4 +48,37 @@ TEST(HttpEndpointTest, MissingContentType) {
     ASSERT_EQ(cheaders, nullptr);
 }
 
-} // namespace opentelemetry::php::transport
\ No newline at end of file
+TEST(HttpEndpointTest, ContentEncodingHeader) {
+    HttpEndpoint::enpointHeaders_t headers = {};
+    HttpEndpoint endpoint("https://localhost/traces", "super-trace", headers, 10, 1s, PayloadCompression::gzip);
+
+    ASSERT_EQ(endpoint.getCompression(), PayloadCompression::gzip);
+
+    auto cheaders = endpoint.getHeaders();
+    ASSERT_NE(cheaders, nullptr);
+    ASSERT_STREQ(cheaders->data, "Content-Type: super-trace");
+    ASSERT_NE(cheaders->next, nullptr);
+    ASSERT_STREQ(cheaders->next->data, "Content-Encoding: gzip");
+    ASSERT_EQ(cheaders->next->next, nullptr);
+}
+
+TEST(HttpEndpointTest, GrpcHeaders) {
+    HttpEndpoint::enpointHeaders_t headers = {};
+    HttpEndpoint endpoint("http://localhost:4317/opentelemetry.proto.collector.trace.v1.TraceService/Export", "application/grpc", headers, 10, 1s, PayloadCompression::gzip);
+    HttpEndpoint httpEndpoint("http://localhost:4317/v1/traces", "application/x-protobuf", headers, 10, 1s);
+
+    ASSERT_TRUE(endpoint.isGrpc());
+    ASSERT_FALSE(httpEndpoint.isGrpc());
+    ASSERT_NE(endpoint.getConnectionId(), httpEndpoint.getConnectionId());
+
+    auto cheaders = endpoint.getHeaders();
+    ASSERT_NE(cheaders, nullptr);
+    ASSERT_STREQ(cheaders->data, "Content-Type: application/grpc");
+    ASSERT_NE(cheaders->next, nullptr);
+    ASSERT_STREQ(cheaders->next->data, "TE: trailers");
+    ASSERT_NE(cheaders->next->next, nullptr);
+    ASSERT_STREQ(cheaders->next->next->data, "grpc-encoding: gzip");
+    ASSERT_EQ(cheaders->next->next->next, nullptr);
+}
+
+} // namespace opentelemetry::php::transport
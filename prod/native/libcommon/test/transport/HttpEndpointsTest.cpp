@@ -40,6 +40,8 @@ public:
     FRIEND_TEST(HttpEndpointsTests, add_parseError);
     FRIEND_TEST(HttpEndpointsTests, add_SameServer);
     FRIEND_TEST(HttpEndpointsTests, getConnection);
+    FRIEND_TEST(HttpEndpointsTests, getConnectionReusesReleasedSender);
+    FRIEND_TEST(HttpEndpointsTests, unixSocketEndpointsArePooledBySocketPath);
 };
 
 TEST_F(HttpEndpointsTests, add_parseError) {
@@ -87,4 +89,47 @@ TEST_F(HttpEndpointsTests, getConnection) {
     ASSERT_NE(connId, connId3);
 }
 
-} // namespace opentelemetry::php::transport
\ No newline at end of file
+TEST_F(HttpEndpointsTests, getConnectionReusesReleasedSender) {
+    HttpEndpoint::enpointHeaders_t cheaders;
+    TestableHttpEndpoints endpoints(log_);
+
+    HttpEndpointSSLOptions options;
+    endpoints.add("http://local/traces", 1234, "some-type", cheaders, 100ms, 3, 100ms, options);
+
+    auto [endpointUrl, headers, connId, conn, maxRetries, retryDelay] = endpoints.getConnection(1234);
+    auto [endpointUrl2, headers2, connId2, conn2, maxRetries2, retryDelay2] = endpoints.getConnection(1234);
+
+    ASSERT_EQ(connId, connId2);
+    ASSERT_NE(&conn, &conn2);
+    ASSERT_EQ(endpoints.connections_.at(connId).senders.size(), 2u);
+
+    endpoints.releaseConnection(connId, conn);
+    auto [endpointUrl3, headers3, connId3, conn3, maxRetries3, retryDelay3] = endpoints.getConnection(1234);
+    ASSERT_EQ(&conn, &conn3);
+    ASSERT_EQ(endpoints.connections_.at(connId).senders.size(), 2u);
+}
+
+TEST_F(HttpEndpointsTests, unixSocketEndpointsArePooledBySocketPath) {
+    HttpEndpoint::enpointHeaders_t cheaders;
+    TestableHttpEndpoints endpoints(log_);
+
+    HttpEndpointSSLOptions options;
+    endpoints.add("unix:///run/otelcol.sock:/v1/traces", 1234, "some-type", cheaders, 100ms, 3, 100ms, options);
+    endpoints.add("unix:///run/otelcol.sock:/v1/metrics", 5678, "some-type", cheaders, 100ms, 3, 100ms, options);
+    endpoints.add("unix:///run/other.sock:/v1/logs", 9898, "some-type", cheaders, 100ms, 3, 100ms, options);
+    ASSERT_EQ(endpoints.connections_.size(), 2u);
+
+    auto [endpointUrl, headers, connId, conn, maxRetries, retryDelay] = endpoints.getConnection(1234);
+    ASSERT_EQ(endpointUrl, "http://localhost/v1/traces");
+    ASSERT_EQ(endpoints.connections_.at(connId).unixSocketPath, "/run/otelcol.sock");
+
+    auto [endpointUrl2, headers2, connId2, conn2, maxRetries2, retryDelay2] = endpoints.getConnection(5678);
+    ASSERT_EQ(endpointUrl2, "http://localhost/v1/metrics");
+    ASSERT_EQ(connId, connId2);
+
+    auto [endpointUrl3, headers3, connId3, conn3, maxRetries3, retryDelay3] = endpoints.getConnection(9898);
+    ASSERT_NE(connId, connId3);
+    ASSERT_EQ(endpoints.connections_.at(connId3).unixSocketPath, "/run/other.sock");
+}
+
+} // namespace opentelemetry::php::transport
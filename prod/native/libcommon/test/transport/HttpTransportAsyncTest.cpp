@@ -3,10 +3,14 @@
 #include "transport/HttpTransportAsync.h"
 #include "Logger.h"
 
+#include <deque>
+#include <filesystem>
+#include <map>
 #include <tuple>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <pthread.h>
+#include <unistd.h>
 
 namespace opentelemetry::php::transport {
 
@@ -15,7 +19,7 @@ public:
     CurlSenderMock(std::shared_ptr<LoggerInterface> logger, std::chrono::milliseconds timeout, bool verifyCert) {
     }
 
-    MOCK_METHOD(int16_t, sendPayload, (std::string const &endpointUrl, struct curl_slist *headers, std::vector<std::byte> const &payload, std::function<void(std::string_view)> headerCallback, std::string *responseBuffer), (const));
+    MOCK_METHOD(int16_t, sendPayload, (std::string const &endpointUrl, struct curl_slist *headers, std::span<std::byte const> payload, std::function<void(std::string_view)> headerCallback, std::string *responseBuffer), (const));
 };
 
 class HttpEndpointsMock : public boost::noncopyable {
@@ -25,15 +29,75 @@ public:
     HttpEndpointsMock(std::shared_ptr<LoggerInterface> logger) {
     }
 
-    MOCK_METHOD(bool, add, (std::string endpointUrl, endpointUrlHash_t endpointHash, std::string contentType, HttpEndpoint::enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, HttpEndpointSSLOptions sslOptions));
+    MOCK_METHOD(bool, add, (std::string endpointUrl, endpointUrlHash_t endpointHash, std::string contentType, HttpEndpoint::enpointHeaders_t const &endpointHeaders, std::chrono::milliseconds timeout, std::size_t maxRetries, std::chrono::milliseconds retryDelay, HttpEndpointSSLOptions sslOptions, PayloadCompression compression));
     MOCK_METHOD((std::tuple<std::string, curl_slist *, HttpEndpoint::connectionId_t, CurlSenderMock &, std::size_t, std::chrono::milliseconds>), getConnection, (std::size_t endpointHash));
+    MOCK_METHOD(void, releaseConnection, (HttpEndpoint::connectionId_t connectionId, CurlSenderMock &sender));
     MOCK_METHOD(void, updateRetryDelay, (size_t endpointHash, std::chrono::milliseconds retryDelay));
 };
 
-class TestableHttpTransportAsync : public HttpTransportAsync<::testing::StrictMock<CurlSenderMock>, ::testing::StrictMock<HttpEndpointsMock>> {
+// performs transfers synchronously through CurlSenderMock::sendPayload, one transfer per perform() call
+class CurlMultiSenderFake : public boost::noncopyable {
+public:
+    using completionCallback_t = CurlMultiSender::completionCallback_t;
+
+    CurlMultiSenderFake(std::shared_ptr<LoggerInterface> logger) {
+    }
+
+    void addTransfer(CurlSenderMock &sender, std::string const &endpointUrl, struct curl_slist *headers, std::span<std::byte const> payload, std::function<void(std::string_view)> *headerCallback, std::string *responseBuffer, completionCallback_t completionCallback) {
+        transfers_.emplace_back(endpointUrl, [&sender, endpointUrl, headers, payload, headerCallback, responseBuffer]() { return sender.sendPayload(endpointUrl, headers, payload, headerCallback ? *headerCallback : std::function<void(std::string_view)>{}, responseBuffer); }, std::move(completionCallback));
+
+        maxTransfersInProgress_ = std::max(maxTransfersInProgress_, transfers_.size());
+        auto inProgressForUrl = std::ranges::count_if(transfers_, [&endpointUrl](auto const &transfer) { return std::get<0>(transfer) == endpointUrl; });
+        maxTransfersInProgressPerUrl_[endpointUrl] = std::max(maxTransfersInProgressPerUrl_[endpointUrl], static_cast<std::size_t>(inProgressForUrl));
+    }
+
+    void perform(std::chrono::milliseconds maxWait) {
+        if (transfers_.empty()) {
+            return;
+        }
+        auto [endpointUrl, send, completionCallback] = std::move(transfers_.front());
+        transfers_.pop_front();
+
+        int16_t responseCode = 0;
+        try {
+            responseCode = send();
+        } catch (std::runtime_error const &error) {
+            completionCallback(0, error.what());
+            return;
+        }
+        completionCallback(responseCode, {});
+    }
+
+    void removeAllTransfers() {
+        transfers_.clear();
+    }
+
+    void wakeup() {
+    }
+
+    std::size_t getTransfersCount() const {
+        return transfers_.size();
+    }
+
+    std::deque<std::tuple<std::string, std::function<int16_t()>, completionCallback_t>> transfers_;
+    std::size_t maxTransfersInProgress_ = 0;
+    std::map<std::string, std::size_t> maxTransfersInProgressPerUrl_;
+};
+
+class TestableHttpTransportAsync : public HttpTransportAsync<::testing::StrictMock<CurlSenderMock>, ::testing::StrictMock<HttpEndpointsMock>, CurlMultiSenderFake> {
 public:
     template <typename... Args>
-    TestableHttpTransportAsync(Args &&...args) : HttpTransportAsync<::testing::StrictMock<CurlSenderMock>, ::testing::StrictMock<HttpEndpointsMock>>(std::forward<Args>(args)...) {
+    TestableHttpTransportAsync(Args &&...args) : HttpTransportAsync<::testing::StrictMock<CurlSenderMock>, ::testing::StrictMock<HttpEndpointsMock>, CurlMultiSenderFake>(std::forward<Args>(args)...) {
+    }
+
+    // sends like asyncSender does - waits for scheduled retries and calls send again until nothing is left
+    void sendUntilDone(std::unique_lock<std::mutex> &lock) {
+        send(lock);
+        while (hasPendingRetries()) {
+            std::this_thread::sleep_until(getNextTimerExpiration().value());
+            send(lock);
+        }
+        runCompletedFlushCallbacks();
     }
 
 private:
@@ -47,6 +111,28 @@ private:
     FRIEND_TEST(HttpTransportAsyncTest, enqueueAndSendRetryUntilMaxRetriesAndDropPayload);
     FRIEND_TEST(HttpTransportAsyncTest, enqueueAndSendNoRetryOnClientError);
     FRIEND_TEST(HttpTransportAsyncTest, destructorSendTimeout);
+    FRIEND_TEST(HttpTransportAsyncTest, sendRespectsConcurrencyLimits);
+    FRIEND_TEST(HttpTransportAsyncTest, sendTransportErrorDropsPayload);
+    FRIEND_TEST(HttpTransportAsyncTest, retryDoesNotBlockOtherEndpoints);
+    FRIEND_TEST(HttpTransportAsyncTest, retryHonorsRetryAfter);
+    FRIEND_TEST(HttpTransportAsyncTest, circuitBreakerPausesEndpointAfterConsecutiveFailures);
+    FRIEND_TEST(HttpTransportAsyncTest, getEndpointSignal);
+    FRIEND_TEST(HttpTransportAsyncTest, enqueueDropOldestPolicy);
+    FRIEND_TEST(HttpTransportAsyncTest, enqueueDropNewestPolicy);
+    FRIEND_TEST(HttpTransportAsyncTest, enqueueEvictsLowerPriorityPayloads);
+    FRIEND_TEST(HttpTransportAsyncTest, sendServesHigherPriorityEndpointsFirst);
+    FRIEND_TEST(HttpTransportAsyncTest, sendCompressesPayload);
+    FRIEND_TEST(HttpTransportAsyncTest, payloadsOfUnknownEndpointAreCountedAsDropped);
+    FRIEND_TEST(HttpTransportAsyncTest, enqueueKeepsOwnedPayloadAndCopiesBorrowed);
+    FRIEND_TEST(HttpTransportAsyncTest, sendCoalescesQueuedPayloads);
+    FRIEND_TEST(HttpTransportAsyncTest, sendMergesResourcesOfCoalescedPayloads);
+    FRIEND_TEST(HttpTransportAsyncTest, sendWaitsForCoalesceLinger);
+    FRIEND_TEST(HttpTransportAsyncTest, isCoalescable);
+    FRIEND_TEST(HttpTransportAsyncTest, enqueueSpillsOverflowAndReplaysInOrder);
+    FRIEND_TEST(HttpTransportAsyncTest, destructorSpillsPayloadsForOpenCircuit);
+    FRIEND_TEST(HttpTransportAsyncTest, sendGrpcFramesPayloadAndRetriesOnStatus);
+    FRIEND_TEST(HttpTransportAsyncTest, flushWaitsForPayloadsEnqueuedBeforeCall);
+    FRIEND_TEST(HttpTransportAsyncTest, flushCompletesForDroppedPayloads);
 };
 
 class HttpTransportAsyncTest : public ::testing::Test {
@@ -76,35 +162,35 @@ TEST_F(HttpTransportAsyncTest, enqueue) {
     TestableHttpTransportAsync transport_{log_, config_};
 
     std::vector<std::byte> data(120);
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 0ul);
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 1ul);
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 0ul);
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 1ul);
 }
 
 TEST_F(HttpTransportAsyncTest, enqueueOverLimit) {
     HttpEndpoint::enpointHeaders_t headers;
     TestableHttpTransportAsync transport_{log_, config_};
 
-    auto limit = config_->get().max_send_queue_size;
+    auto limit = config_->get()->max_send_queue_size;
     std::vector<std::byte> data(limit / 4);
 
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 0ul);
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 1ul);
-
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 2ul);
-
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 3ul);
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 4ul);
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 4ul);
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 0ul);
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 1ul);
+
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 2ul);
+
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 3ul);
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 4ul);
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 4ul);
 }
 
 TEST_F(HttpTransportAsyncTest, enqueueAndSend) {
@@ -113,9 +199,9 @@ TEST_F(HttpTransportAsyncTest, enqueueAndSend) {
 
     std::vector<std::byte> data(1024);
 
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 0ul);
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 1ul);
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 0ul);
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 1ul);
 
     CurlSenderMock sender(log_, 100ms, false);
 
@@ -123,12 +209,13 @@ TEST_F(HttpTransportAsyncTest, enqueueAndSend) {
         std::mutex mutex;
         std::unique_lock<std::mutex> lock(mutex);
 
+        EXPECT_CALL(transport_.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
         EXPECT_CALL(transport_.endpoints_, getConnection(1234)).Times(1).WillRepeatedly(::testing::Return(::testing::ByMove(std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(2), 100ms))));
         EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(::testing::AnyNumber()).WillRepeatedly(::testing::Return(200));
         transport_.send(lock);
     }
 
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 0ul);
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 0ul);
 }
 
 TEST_F(HttpTransportAsyncTest, enqueueAndSendWithResponseCallback) {
@@ -145,9 +232,9 @@ TEST_F(HttpTransportAsyncTest, enqueueAndSendWithResponseCallback) {
         ASSERT_EQ(data.size(), 0ul);
     };
 
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 0ul);
-    transport_.enqueue(1234, {data.begin(), data.end()}, callback);
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 1ul);
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 0ul);
+    transport_.enqueue(1234, PayloadBuffer::borrow(data), callback);
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 1ul);
 
     CurlSenderMock sender(log_, 100ms, false);
 
@@ -155,13 +242,14 @@ TEST_F(HttpTransportAsyncTest, enqueueAndSendWithResponseCallback) {
         std::mutex mutex;
         std::unique_lock<std::mutex> lock(mutex);
 
+        EXPECT_CALL(transport_.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
         EXPECT_CALL(transport_.endpoints_, getConnection(1234)).Times(1).WillRepeatedly(::testing::Return(::testing::ByMove(std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(2), 100ms))));
         EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(::testing::AnyNumber()).WillRepeatedly(::testing::Return(200));
         transport_.send(lock);
     }
 
     ASSERT_TRUE(callbackCalled);
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 0ul);
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 0ul);
 }
 
 TEST_F(HttpTransportAsyncTest, enqueueAndSendRetry) {
@@ -170,25 +258,26 @@ TEST_F(HttpTransportAsyncTest, enqueueAndSendRetry) {
 
     std::vector<std::byte> data(1024);
 
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 0ul);
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 1ul);
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 0ul);
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 1ul);
 
     CurlSenderMock sender(log_, 100ms, false);
     {
         std::mutex mutex;
         std::unique_lock<std::mutex> lock(mutex);
 
+        EXPECT_CALL(transport_.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
         EXPECT_CALL(transport_.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Return(::testing::ByMove(std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(2), 100ms))));
 
         ::testing::InSequence s;
         EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Return(429));
         EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Return(200));
 
-        transport_.send(lock);
+        transport_.sendUntilDone(lock);
     }
 
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 0ul);
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 0ul);
 }
 
 TEST_F(HttpTransportAsyncTest, enqueueAndSendRetryUntilMaxRetriesAndDropPayload) {
@@ -200,20 +289,21 @@ TEST_F(HttpTransportAsyncTest, enqueueAndSendRetryUntilMaxRetriesAndDropPayload)
 
     std::vector<std::byte> data(1024);
 
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 0ul);
-    transport_.enqueue(1234, {data.begin(), data.end()});
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 1ul);
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 0ul);
+    transport_.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 1ul);
 
     {
         std::mutex mutex;
         std::unique_lock<std::mutex> lock(mutex);
 
+        EXPECT_CALL(transport_.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
         EXPECT_CALL(transport_.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Return(::testing::ByMove(std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(maxReties), 100ms))));
         EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(maxReties).WillRepeatedly(::testing::Return(429));
-        transport_.send(lock);
+        transport_.sendUntilDone(lock);
     }
 
-    ASSERT_EQ(transport_.payloadsToSend_.size(), 0ul);
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 0ul);
 }
 
 TEST_F(HttpTransportAsyncTest, enqueueAndSendNoRetryOnClientError) {
@@ -222,11 +312,12 @@ TEST_F(HttpTransportAsyncTest, enqueueAndSendNoRetryOnClientError) {
     CurlSenderMock sender(log_, 100ms, false);
 
     std::vector<std::byte> data(1024);
-    ASSERT_EQ(transport.payloadsToSend_.size(), 0ul);
-    transport.enqueue(1234, {data.begin(), data.end()});
-    ASSERT_EQ(transport.payloadsToSend_.size(), 1ul);
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 1ul);
 
     {
+        EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
         EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Return(::testing::ByMove(std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms))));
         EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Return(400));
 
@@ -235,7 +326,7 @@ TEST_F(HttpTransportAsyncTest, enqueueAndSendNoRetryOnClientError) {
         transport.send(lock);
     }
 
-    ASSERT_EQ(transport.payloadsToSend_.size(), 0ul);
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
 }
 
 TEST_F(HttpTransportAsyncTest, destructorSendTimeout) {
@@ -250,22 +341,635 @@ TEST_F(HttpTransportAsyncTest, destructorSendTimeout) {
 
         HttpEndpointSSLOptions sslOptions;
 
-        EXPECT_CALL(transport.endpoints_, add("http://local/traces", 1234u, "some-type", headers, 100ms, 3, 100ms, ::testing::_)).Times(1).WillRepeatedly(::testing::Return(true));
-        transport.initializeConnection("http://local/traces", 1234u, "some-type", headers, 100ms, 3, 100ms, sslOptions);
+        EXPECT_CALL(transport.endpoints_, add("http://local/traces", 1234u, "some-type", headers, 100ms, 3, 100ms, ::testing::_, PayloadCompression::none)).Times(1).WillRepeatedly(::testing::Return(true));
+        transport.initializeConnection("http://local/traces", 1234u, "some-type", headers, 100ms, 3, 100ms, sslOptions, PayloadCompression::none);
 
         std::this_thread::sleep_for(5ms); // give thread a bit of time to go into sleep condition
 
-        EXPECT_CALL(transport.endpoints_, getConnection(1234u)).WillRepeatedly(::testing::Return(::testing::ByMove(std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms))));
+        EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(::testing::AnyNumber());
+        EXPECT_CALL(transport.endpoints_, getConnection(1234u)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
 
         EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(::testing::Exactly(1)).WillRepeatedly(::testing::DoAll(::testing::Invoke([]() { std::this_thread::sleep_for(10ms); }), ::testing::Return(200)));
 
         // We're enqueuing 4 payloads, but sending will take at least 10ms. The destructor timeout is set for 5ms, so only the first payload will be sent. Times(::testing::Exactly(1)) will do the job and will fail if it tries to send any further payloads.
         std::vector<std::byte> data(1024);
-        transport.enqueue(1234, {data.begin(), data.end()});
-        transport.enqueue(1234, {data.begin(), data.end()});
-        transport.enqueue(1234, {data.begin(), data.end()});
-        transport.enqueue(1234, {data.begin(), data.end()});
+        transport.enqueue(1234, PayloadBuffer::borrow(data));
+        transport.enqueue(1234, PayloadBuffer::borrow(data));
+        transport.enqueue(1234, PayloadBuffer::borrow(data));
+        transport.enqueue(1234, PayloadBuffer::borrow(data));
+    }
+}
+
+TEST_F(HttpTransportAsyncTest, sendRespectsConcurrencyLimits) {
+    configForUpdate_.async_transport_max_concurrent_requests = 3;
+    configForUpdate_.async_transport_max_concurrent_requests_per_endpoint = 2;
+    config_->update();
+
+    TestableHttpTransportAsync transport_{log_, config_};
+    CurlSenderMock sender(log_, 100ms, false);
+
+    std::vector<std::byte> data(1024);
+    for (int i = 0; i < 4; ++i) {
+        transport_.enqueue(1234, PayloadBuffer::borrow(data));
+        transport_.enqueue(5678, PayloadBuffer::borrow(data));
+    }
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 8ul);
+
+    {
+        EXPECT_CALL(transport_.endpoints_, getConnection(1234)).Times(4).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
+        EXPECT_CALL(transport_.endpoints_, getConnection(5678)).Times(4).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/logs"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
+        EXPECT_CALL(transport_.endpoints_, releaseConnection(900, ::testing::_)).Times(8);
+        EXPECT_CALL(sender, sendPayload(::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(8).WillRepeatedly(::testing::Return(200));
+
+        std::mutex mutex;
+        std::unique_lock<std::mutex> lock(mutex);
+        transport_.send(lock);
+    }
+
+    ASSERT_EQ(transport_.getQueuedPayloadsCount(), 0ul);
+    ASSERT_EQ(transport_.transfers_.size(), 0ul);
+    ASSERT_EQ(transport_.multiSender_->maxTransfersInProgress_, 3ul);
+    ASSERT_EQ(transport_.multiSender_->maxTransfersInProgressPerUrl_["http://local/traces"], 2ul);
+    ASSERT_EQ(transport_.multiSender_->maxTransfersInProgressPerUrl_["http://local/logs"], 2ul);
+}
+
+TEST_F(HttpTransportAsyncTest, sendTransportErrorDropsPayload) {
+    TestableHttpTransportAsync transport{log_, config_};
+    CurlSenderMock sender(log_, 100ms, false);
+
+    std::vector<std::byte> data(1024);
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+
+    {
+        EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Return(::testing::ByMove(std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms))));
+        EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
+        EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Throw(std::runtime_error("sendPayload failed: Couldn't connect to server")));
+
+        std::mutex mutex;
+        std::unique_lock<std::mutex> lock(mutex);
+        transport.send(lock);
+    }
+
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
+    ASSERT_EQ(transport.transfers_.size(), 0ul);
+}
+
+TEST_F(HttpTransportAsyncTest, retryDoesNotBlockOtherEndpoints) {
+    TestableHttpTransportAsync transport{log_, config_};
+    CurlSenderMock sender(log_, 100ms, false);
+
+    std::vector<std::byte> data(1024);
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+    transport.enqueue(5678, PayloadBuffer::borrow(data));
+
+    EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 10s); }));
+    EXPECT_CALL(transport.endpoints_, getConnection(5678)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/logs"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 10s); }));
+    EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(2);
+    EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Return(503));
+    EXPECT_CALL(sender, sendPayload("http://local/logs", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Return(200));
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::mutex mutex;
+        std::unique_lock<std::mutex> lock(mutex);
+        transport.send(lock);
+    }
+
+    // retry of traces payload is scheduled in at least 5s (10s delay with jitter) and doesn't stall sending
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 1s);
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
+    ASSERT_EQ(transport.transfers_.size(), 0ul);
+    ASSERT_EQ(transport.endpointsState_.at(1234).retries.size(), 1ul);
+    ASSERT_EQ(transport.endpointsState_.at(1234).transfersInProgress, 1ul);
+    ASSERT_GE(transport.getNextTimerExpiration().value() - start, 5s);
+}
+
+TEST_F(HttpTransportAsyncTest, retryHonorsRetryAfter) {
+    TestableHttpTransportAsync transport{log_, config_};
+    CurlSenderMock sender(log_, 100ms, false);
+
+    std::vector<std::byte> data(1024);
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+
+    EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
+    EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
+    EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Invoke([](std::string const &, curl_slist *, std::span<std::byte const>, std::function<void(std::string_view)> headerCallback, std::string *) -> int16_t {
+        headerCallback("Retry-After: 5"sv);
+        return 429;
+    }));
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::mutex mutex;
+        std::unique_lock<std::mutex> lock(mutex);
+        transport.send(lock);
+    }
+
+    ASSERT_EQ(transport.endpointsState_.at(1234).retries.size(), 1ul);
+    ASSERT_GE(transport.getNextTimerExpiration().value() - start, 5s);
+}
+
+TEST_F(HttpTransportAsyncTest, circuitBreakerPausesEndpointAfterConsecutiveFailures) {
+    configForUpdate_.async_transport_max_concurrent_requests_per_endpoint = 1;
+    configForUpdate_.async_transport_circuit_breaker_threshold = 2;
+    configForUpdate_.async_transport_circuit_breaker_cooldown = 10s;
+    config_->update();
+
+    TestableHttpTransportAsync transport{log_, config_};
+    CurlSenderMock sender(log_, 100ms, false);
+
+    std::vector<std::byte> data(1024);
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+
+    EXPECT_CALL(transport.endpoints_, getConnection(1234)).Times(2).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(1), 100ms); }));
+    EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(2);
+    EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(2).WillRepeatedly(::testing::Return(503));
+
+    {
+        std::mutex mutex;
+        std::unique_lock<std::mutex> lock(mutex);
+        transport.send(lock);
+    }
+
+    // third payload waits in queue until circuit breaker allows probe request
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 1ul);
+    ASSERT_EQ(transport.endpointsState_.at(1234).circuitBreaker.getState(), CircuitBreaker::State::open);
+    ASSERT_TRUE(transport.getNextTimerExpiration().has_value());
+}
+
+TEST_F(HttpTransportAsyncTest, getEndpointSignal) {
+    ASSERT_EQ(TestableHttpTransportAsync::getEndpointSignal("http://localhost:4318/v1/traces"), "traces"sv);
+    ASSERT_EQ(TestableHttpTransportAsync::getEndpointSignal("https://collector/otlp/v1/metrics/"), "metrics"sv);
+    ASSERT_EQ(TestableHttpTransportAsync::getEndpointSignal("http://localhost:4318/v1/logs?tenant=a"), "logs"sv);
+    ASSERT_EQ(TestableHttpTransportAsync::getEndpointSignal("http://localhost:4320/v1/opamp"), "opamp"sv);
+    ASSERT_EQ(TestableHttpTransportAsync::getEndpointSignal("http://localhost:4317/opentelemetry.proto.collector.trace.v1.TraceService/Export"), "traces"sv);
+    ASSERT_EQ(TestableHttpTransportAsync::getEndpointSignal("http://localhost:4317/opentelemetry.proto.collector.logs.v1.LogsService/Export"), "logs"sv);
+    ASSERT_EQ(TestableHttpTransportAsync::getEndpointSignal("http://localhost:4318/custom"), ""sv);
+}
+
+TEST_F(HttpTransportAsyncTest, enqueueDropOldestPolicy) {
+    configForUpdate_.async_transport_endpoint_queue_size = 3 * 1024;
+    configForUpdate_.async_transport_queue_overflow_policy = "drop_oldest";
+    config_->update();
+
+    TestableHttpTransportAsync transport{log_, config_};
+
+    for (uint8_t i = 0; i < 5; ++i) {
+        std::vector<std::byte> data(1024, std::byte{i});
+        transport.enqueue(1234, PayloadBuffer::borrow(data));
+    }
+
+    auto const &queue = transport.payloadsQueues_.at(1234);
+    ASSERT_EQ(queue.payloads.size(), 3ul);
+    ASSERT_EQ(queue.byteUsage, 3 * 1024ul);
+    ASSERT_EQ(transport.payloadsByteUsage_, 3 * 1024ul);
+    ASSERT_EQ(std::get<0>(queue.payloads.front()).data()[0], std::byte{2});
+    ASSERT_EQ(std::get<0>(queue.payloads.back()).data()[0], std::byte{4});
+}
+
+TEST_F(HttpTransportAsyncTest, enqueueDropNewestPolicy) {
+    configForUpdate_.async_transport_endpoint_queue_size = 3 * 1024;
+    config_->update();
+
+    TestableHttpTransportAsync transport{log_, config_};
+
+    for (uint8_t i = 0; i < 5; ++i) {
+        std::vector<std::byte> data(1024, std::byte{i});
+        transport.enqueue(1234, PayloadBuffer::borrow(data));
+    }
+
+    auto const &queue = transport.payloadsQueues_.at(1234);
+    ASSERT_EQ(queue.payloads.size(), 3ul);
+    ASSERT_EQ(std::get<0>(queue.payloads.front()).data()[0], std::byte{0});
+    ASSERT_EQ(std::get<0>(queue.payloads.back()).data()[0], std::byte{2});
+}
+
+TEST_F(HttpTransportAsyncTest, enqueueEvictsLowerPriorityPayloads) {
+    configForUpdate_.max_send_queue_size = 4 * 1024;
+    config_->update();
+
+    TestableHttpTransportAsync transport{log_, config_};
+    transport.payloadsQueues_[1].signal = "logs"sv;
+    transport.payloadsQueues_[2].signal = "traces"sv;
+
+    std::vector<std::byte> data(1024);
+    for (int i = 0; i < 5; ++i) {
+        transport.enqueue(1, PayloadBuffer::borrow(data));
     }
+    ASSERT_EQ(transport.payloadsQueues_.at(1).payloads.size(), 4ul);
+
+    // traces take space of the oldest logs
+    transport.enqueue(2, PayloadBuffer::borrow(data));
+    transport.enqueue(2, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport.payloadsQueues_.at(1).payloads.size(), 2ul);
+    ASSERT_EQ(transport.payloadsQueues_.at(2).payloads.size(), 2ul);
+
+    // logs can't evict traces
+    transport.enqueue(1, PayloadBuffer::borrow(data));
+    ASSERT_EQ(transport.payloadsQueues_.at(1).payloads.size(), 2ul);
+    ASSERT_EQ(transport.payloadsByteUsage_, 4 * 1024ul);
+}
+
+TEST_F(HttpTransportAsyncTest, sendServesHigherPriorityEndpointsFirst) {
+    configForUpdate_.async_transport_max_concurrent_requests = 1;
+    configForUpdate_.async_transport_signals_priority = "traces, logs";
+    config_->update();
+
+    TestableHttpTransportAsync transport{log_, config_};
+    CurlSenderMock sender(log_, 100ms, false);
+    transport.payloadsQueues_[1].signal = "logs"sv;
+    transport.payloadsQueues_[2].signal = "traces"sv;
+
+    std::vector<std::byte> data(1024);
+    transport.enqueue(1, PayloadBuffer::borrow(data));
+    transport.enqueue(1, PayloadBuffer::borrow(data));
+    transport.enqueue(2, PayloadBuffer::borrow(data));
+    transport.enqueue(2, PayloadBuffer::borrow(data));
+
+    EXPECT_CALL(transport.endpoints_, getConnection(1)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/v1/logs"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
+    EXPECT_CALL(transport.endpoints_, getConnection(2)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/v1/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
+    EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(4);
+    {
+        ::testing::InSequence s;
+        EXPECT_CALL(sender, sendPayload("http://local/v1/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(2).WillRepeatedly(::testing::Return(200));
+        EXPECT_CALL(sender, sendPayload("http://local/v1/logs", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(2).WillRepeatedly(::testing::Return(200));
+    }
+
+    std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex);
+    transport.send(lock);
+
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
+}
+
+TEST_F(HttpTransportAsyncTest, sendCompressesPayload) {
+    TestableHttpTransportAsync transport{log_, config_};
+    CurlSenderMock sender(log_, 100ms, false);
+    transport.payloadsQueues_[1234].compression = PayloadCompression::gzip;
+
+    std::vector<std::byte> data(64 * 1024, std::byte{'a'});
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+
+    EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
+    EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
+    EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Invoke([](std::string const &, curl_slist *, std::span<std::byte const> payload, std::function<void(std::string_view)>, std::string *) -> int16_t {
+        EXPECT_LT(payload.size(), 1024ul);
+        EXPECT_EQ(payload[0], std::byte{0x1f}); // gzip magic
+        EXPECT_EQ(payload[1], std::byte{0x8b});
+        return 200;
+    }));
+
+    std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex);
+    transport.send(lock);
+
+    ASSERT_EQ(transport.transfers_.size(), 0ul);
+}
+
+TEST_F(HttpTransportAsyncTest, payloadsOfUnknownEndpointAreCountedAsDropped) {
+    TestableHttpTransportAsync transport{log_, config_};
+
+    std::vector<std::byte> data(100);
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+
+    EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Throw(std::runtime_error("HttpEndpoints enpointHash: 4d2 not found")));
+
+    std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex);
+    transport.send(lock);
+
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
+    auto statistics = transport.getStatistics();
+    ASSERT_EQ(statistics.droppedPayloads, 2u);
+    ASSERT_EQ(statistics.droppedBytes, 200u);
+}
+
+TEST_F(HttpTransportAsyncTest, enqueueKeepsOwnedPayloadAndCopiesBorrowed) {
+    TestableHttpTransportAsync transport{log_, config_};
+
+    auto owned = PayloadBuffer::adopt(std::vector<std::byte>(1024, std::byte{1}));
+    auto ownedData = owned.data();
+    transport.enqueue(1234, owned);
+
+    {
+        std::vector<std::byte> borrowed(1024, std::byte{2});
+        transport.enqueue(1234, PayloadBuffer::borrow(borrowed));
+        ASSERT_NE(std::get<0>(transport.payloadsQueues_.at(1234).payloads.back()).data(), borrowed.data());
+    }
+
+    auto const &queue = transport.payloadsQueues_.at(1234);
+    ASSERT_EQ(queue.payloads.size(), 2ul);
+    ASSERT_EQ(std::get<0>(queue.payloads.front()).data(), ownedData);
+    ASSERT_EQ(std::get<0>(queue.payloads.back()).size(), 1024ul);
+    ASSERT_EQ(std::get<0>(queue.payloads.back()).data()[1023], std::byte{2});
+}
+
+TEST_F(HttpTransportAsyncTest, isCoalescable) {
+    ASSERT_TRUE(TestableHttpTransportAsync::isCoalescable("traces"sv, "application/x-protobuf"sv));
+    ASSERT_TRUE(TestableHttpTransportAsync::isCoalescable("logs"sv, "Application/X-Protobuf"sv));
+    ASSERT_FALSE(TestableHttpTransportAsync::isCoalescable("metrics"sv, "application/json"sv));
+    ASSERT_FALSE(TestableHttpTransportAsync::isCoalescable("opamp"sv, "application/x-protobuf"sv));
+    ASSERT_FALSE(TestableHttpTransportAsync::isCoalescable(""sv, "application/x-protobuf"sv));
+    ASSERT_TRUE(TestableHttpTransportAsync::isCoalescable("traces"sv, "application/grpc"sv));
+    ASSERT_FALSE(TestableHttpTransportAsync::isCoalescable("traces"sv, "application/grpc+json"sv));
+}
+
+TEST_F(HttpTransportAsyncTest, sendCoalescesQueuedPayloads) {
+    configForUpdate_.async_transport_coalesce_max_size = 2500;
+    config_->update();
+
+    TestableHttpTransportAsync transport{log_, config_};
+    CurlSenderMock sender(log_, 100ms, false);
+    transport.payloadsQueues_[1234].coalescable = true;
+
+    for (uint8_t i = 1; i <= 3; ++i) {
+        std::vector<std::byte> data(1000, std::byte{i});
+        transport.enqueue(1234, PayloadBuffer::borrow(data));
+    }
+
+    EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
+    EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(2);
+
+    ::testing::InSequence sequence;
+    EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Invoke([](std::string const &, curl_slist *, std::span<std::byte const> payload, std::function<void(std::string_view)>, std::string *) -> int16_t {
+        EXPECT_EQ(payload.size(), 2000ul);
+        EXPECT_EQ(payload[999], std::byte{1});
+        EXPECT_EQ(payload[1000], std::byte{2});
+        return 200;
+    }));
+    EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Invoke([](std::string const &, curl_slist *, std::span<std::byte const> payload, std::function<void(std::string_view)>, std::string *) -> int16_t {
+        EXPECT_EQ(payload.size(), 1000ul);
+        EXPECT_EQ(payload[0], std::byte{3});
+        return 200;
+    }));
+
+    std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex);
+    transport.send(lock);
+
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
+    ASSERT_EQ(transport.payloadsByteUsage_, 0ul);
+}
+
+TEST_F(HttpTransportAsyncTest, sendMergesResourcesOfCoalescedPayloads) {
+    TestableHttpTransportAsync transport{log_, config_};
+    CurlSenderMock sender(log_, 100ms, false);
+    transport.payloadsQueues_[1234].coalescable = true;
+
+    // ExportTraceServiceRequest{resource_spans{resource, scope_spans}} of two workers sharing resource
+    std::string resource = "\x0a\x04host";
+    std::string worker1 = "\x0a\x10" + resource + "\x12\x06scope1" + "\x12\x00"s;
+    std::string worker2 = "\x0a\x10" + resource + "\x12\x06scope2" + "\x12\x00"s;
+    transport.enqueue(1234, PayloadBuffer::borrow(std::as_bytes(std::span(worker1))));
+    transport.enqueue(1234, PayloadBuffer::borrow(std::as_bytes(std::span(worker2))));
+
+    EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
+    EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
+    EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Invoke([&](std::string const &, curl_slist *, std::span<std::byte const> payload, std::function<void(std::string_view)>, std::string *) -> int16_t {
+        std::string expected = "\x0a\x1a" + resource + "\x12\x06scope1" + "\x12\x00"s + "\x12\x06scope2" + "\x12\x00"s;
+        EXPECT_EQ(std::string(reinterpret_cast<char const *>(payload.data()), payload.size()), expected);
+        return 200;
+    }));
+
+    std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex);
+    transport.send(lock);
+
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
+}
+
+TEST_F(HttpTransportAsyncTest, sendWaitsForCoalesceLinger) {
+    configForUpdate_.async_transport_coalesce_max_size = 4096;
+    configForUpdate_.async_transport_coalesce_linger = 10s;
+    config_->update();
+
+    TestableHttpTransportAsync transport{log_, config_};
+    transport.payloadsQueues_[1234].coalescable = true;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::byte> data(1024);
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+
+    std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex);
+    transport.send(lock);
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 1ul);
+    ASSERT_GE(transport.getNextTimerExpiration().value() - start, 10s);
+
+    // queue holding enough data for full request is sent without waiting
+    CurlSenderMock sender(log_, 100ms, false);
+    EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
+    EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
+    EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Return(200));
+
+    for (int i = 0; i < 3; ++i) {
+        transport.enqueue(1234, PayloadBuffer::borrow(data));
+    }
+    transport.send(lock);
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
+}
+
+TEST_F(HttpTransportAsyncTest, enqueueSpillsOverflowAndReplaysInOrder) {
+    auto directory = std::filesystem::temp_directory_path() / ("otel_spill_transport_test_" + std::to_string(::getpid()));
+    configForUpdate_.max_send_queue_size = 2048;
+    configForUpdate_.async_transport_spill_directory = directory.string();
+    config_->update();
+
+    {
+        TestableHttpTransportAsync transport{log_, config_};
+        transport.payloadsQueues_[1234].initialized = true;
+
+        for (uint8_t i = 1; i <= 4; ++i) {
+            std::vector<std::byte> data(1024, std::byte{i});
+            transport.enqueue(1234, PayloadBuffer::borrow(data));
+        }
+        ASSERT_EQ(transport.getQueuedPayloadsCount(), 2ul);
+        ASSERT_EQ(transport.spillQueue_->getPendingCount(1234), 2ul);
+
+        // payload waiting for response is never spilled
+        std::vector<std::byte> data(1024);
+        transport.enqueue(1234, PayloadBuffer::borrow(data), [](int16_t, std::span<std::byte>) {});
+        ASSERT_EQ(transport.getQueuedPayloadsCount(), 2ul);
+        ASSERT_EQ(transport.spillQueue_->getPendingCount(1234), 2ul);
+
+        CurlSenderMock sender(log_, 100ms, false);
+        EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
+        EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(4);
+
+        std::vector<std::byte> sent;
+        EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(4).WillRepeatedly(::testing::Invoke([&sent](std::string const &, curl_slist *, std::span<std::byte const> payload, std::function<void(std::string_view)>, std::string *) -> int16_t {
+            sent.push_back(payload[0]);
+            return 200;
+        }));
+
+        std::mutex mutex;
+        std::unique_lock<std::mutex> lock(mutex);
+        transport.send(lock);
+
+        ASSERT_EQ(sent, (std::vector<std::byte>{std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}}));
+        ASSERT_EQ(transport.spillQueue_->getPendingCount(), 0ul);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_F(HttpTransportAsyncTest, destructorSpillsPayloadsForOpenCircuit) {
+    auto directory = std::filesystem::temp_directory_path() / ("otel_spill_transport_test_" + std::to_string(::getpid()));
+    configForUpdate_.async_transport_spill_directory = directory.string();
+    configForUpdate_.async_transport_circuit_breaker_threshold = 1;
+    configForUpdate_.async_transport_circuit_breaker_cooldown = 10s;
+    config_->update();
+
+    {
+        TestableHttpTransportAsync transport{log_, config_};
+        transport.getEndpointState(1234).circuitBreaker.onFailure(std::chrono::steady_clock::now());
+
+        for (uint8_t i = 1; i <= 3; ++i) {
+            std::vector<std::byte> data(100, std::byte{i});
+            transport.enqueue(1234, PayloadBuffer::borrow(data));
+        }
+        ASSERT_EQ(transport.getQueuedPayloadsCount(), 3ul);
+
+        // flush done by sender thread on destruction
+        transport.forceFlushOnDestruction_ = true;
+        std::mutex mutex;
+        std::unique_lock<std::mutex> lock(mutex);
+        transport.send(lock);
+        ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
+    }
+
+    // payloads are kept for next process using the directory
+    DiskSpillQueue spillQueue(log_, directory, 1024 * 1024);
+    ASSERT_EQ(spillQueue.getPendingCount(1234), 3ul);
+    auto pool = std::make_shared<PayloadBufferPool>();
+    for (uint8_t i = 1; i <= 3; ++i) {
+        ASSERT_EQ(spillQueue.pop(1234, *pool).data()[0], std::byte{i});
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_F(HttpTransportAsyncTest, sendGrpcFramesPayloadAndRetriesOnStatus) {
+    TestableHttpTransportAsync transport{log_, config_};
+    CurlSenderMock sender(log_, 100ms, false);
+    transport.payloadsQueues_[1234].grpc = true;
+
+    std::vector<std::byte> data(1000, std::byte{7});
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+
+    EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/opentelemetry.proto.collector.trace.v1.TraceService/Export"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 1ms); }));
+    EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
+
+    auto expectFramed = [](std::span<std::byte const> payload) {
+        EXPECT_EQ(payload.size(), grpcMessagePrefixSize + 1000);
+        EXPECT_EQ(payload[0], std::byte{0});
+        EXPECT_EQ(payload[3], std::byte{0x03});
+        EXPECT_EQ(payload[4], std::byte{0xE8});
+        EXPECT_EQ(payload[grpcMessagePrefixSize], std::byte{7});
+    };
+
+    ::testing::InSequence sequence;
+    // UNAVAILABLE reported in trailers of HTTP 200 response is retried
+    EXPECT_CALL(sender, sendPayload(::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Invoke([&expectFramed](std::string const &, curl_slist *, std::span<std::byte const> payload, std::function<void(std::string_view)> headerCallback, std::string *) -> int16_t {
+        expectFramed(payload);
+        headerCallback("content-type: application/grpc"sv);
+        headerCallback("grpc-status: 14"sv);
+        return 200;
+    }));
+    EXPECT_CALL(sender, sendPayload(::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Invoke([&expectFramed](std::string const &, curl_slist *, std::span<std::byte const> payload, std::function<void(std::string_view)> headerCallback, std::string *) -> int16_t {
+        expectFramed(payload);
+        headerCallback("grpc-status: 0"sv);
+        return 200;
+    }));
+
+    std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex);
+    transport.sendUntilDone(lock);
+
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
+    ASSERT_FALSE(transport.hasPendingRetries());
+}
+
+TEST_F(HttpTransportAsyncTest, flushWaitsForPayloadsEnqueuedBeforeCall) {
+    configForUpdate_.async_transport_coalesce_max_size = 4096;
+    configForUpdate_.async_transport_coalesce_linger = 10s;
+    config_->update();
+
+    TestableHttpTransportAsync transport{log_, config_};
+    transport.payloadsQueues_[1234].coalescable = true;
+    ASSERT_TRUE(transport.flush(1234, 0ms));
+
+    std::vector<std::byte> data(1000);
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_FALSE(transport.flush(1234, 10ms));
+    ASSERT_TRUE(transport.flush(4321, 0ms));
+
+    bool flushed = false;
+    transport.flushAsync(1234, [&flushed]() { flushed = true; });
+    ASSERT_FALSE(flushed);
+    ASSERT_EQ(transport.payloadsQueues_[1234].flushSequence, 2ul);
+
+    // payload enqueued after flush call isn't awaited and still lingers
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+
+    CurlSenderMock sender(log_, 100ms, false);
+    EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(3), 100ms); }));
+    EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(1);
+    EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1).WillOnce(::testing::Invoke([](std::string const &, curl_slist *, std::span<std::byte const> payload, std::function<void(std::string_view)>, std::string *) -> int16_t {
+        EXPECT_EQ(payload.size(), 3000ul);
+        return 200;
+    }));
+
+    std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex);
+    transport.sendUntilDone(lock);
+
+    ASSERT_TRUE(flushed);
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 0ul);
+    ASSERT_TRUE(transport.flush(1234, 0ms));
+}
+
+TEST_F(HttpTransportAsyncTest, flushCompletesForDroppedPayloads) {
+    configForUpdate_.async_transport_endpoint_queue_size = 2048;
+    configForUpdate_.async_transport_queue_overflow_policy = "drop_oldest";
+    config_->update();
+
+    TestableHttpTransportAsync transport{log_, config_};
+
+    std::vector<std::byte> data(1024);
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+
+    bool flushed = false;
+    transport.flushAsync(1234, [&]() {
+        // called after payloads mutex was released
+        ASSERT_TRUE(transport.mutex_.try_lock());
+        transport.mutex_.unlock();
+        flushed = true;
+    });
+
+    // evicted payload is no longer awaited
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+    transport.enqueue(1234, PayloadBuffer::borrow(data));
+    ASSERT_TRUE(flushed);
+    ASSERT_EQ(transport.getQueuedPayloadsCount(), 2ul);
+
+    flushed = false;
+    transport.flushAsync(1234, [&flushed]() { flushed = true; });
+
+    // payloads dropped after last retry are flushed as well
+    CurlSenderMock sender(log_, 100ms, false);
+    EXPECT_CALL(transport.endpoints_, getConnection(1234)).WillRepeatedly(::testing::Invoke([&sender](std::size_t) { return std::make_tuple("http://local/traces"s, static_cast<curl_slist *>(nullptr), HttpEndpoint::connectionId_t(900), std::ref(sender), static_cast<std::size_t>(1), 100ms); }));
+    EXPECT_CALL(transport.endpoints_, releaseConnection(900, ::testing::_)).Times(2);
+    EXPECT_CALL(sender, sendPayload("http://local/traces", ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(2).WillRepeatedly(::testing::Return(503));
+
+    std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex);
+    transport.sendUntilDone(lock);
+
+    ASSERT_TRUE(flushed);
+    ASSERT_TRUE(transport.flush(1234, 0ms));
 }
 
-} // namespace opentelemetry::php::transport
\ No newline at end of file
+} // namespace opentelemetry::php::transport
@@ -14,9 +14,10 @@ namespace opentelemetry::php::transport {
 
 class MockHttpTransportAsync : public HttpTransportAsyncInterface {
 public:
-    MOCK_METHOD(void, initializeConnection, (std::string, std::size_t, std::string, enpointHeaders_t const &, std::chrono::milliseconds, std::size_t, std::chrono::milliseconds, HttpEndpointSSLOptions), (override));
-    MOCK_METHOD(void, enqueue, (std::size_t, std::span<std::byte>, responseCallback_t), (override));
+    MOCK_METHOD(void, initializeConnection, (std::string, std::size_t, std::string, enpointHeaders_t const &, std::chrono::milliseconds, std::size_t, std::chrono::milliseconds, HttpEndpointSSLOptions, PayloadCompression), (override));
+    MOCK_METHOD(void, enqueue, (std::size_t, PayloadBuffer, responseCallback_t), (override));
     MOCK_METHOD(void, updateRetryDelay, (size_t, std::chrono::milliseconds), (override));
+    MOCK_METHOD(bool, flush, (std::size_t, std::chrono::milliseconds), (override));
 };
 
 class MockPhpBridge : public opentelemetry::php::PhpBridgeInterface {
@@ -141,7 +142,7 @@ TEST_F(OpAmpTest, RemoveAllConfigUpdateWatchers) {
 TEST_F(OpAmpTest, EmptyEndpointDoesNotStartThread) {
     auto opamp = createOpAmp();
 
-    EXPECT_CALL(*transport_, initializeConnection(::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(0);
+    EXPECT_CALL(*transport_, initializeConnection(::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(0);
     EXPECT_CALL(*transport_, enqueue(::testing::_, ::testing::_, ::testing::_)).Times(0);
 
     opamp->startCommunication();
@@ -178,9 +179,9 @@ TEST_F(OpAmpTest, HeartbeatSentAtIntervals) {
     std::atomic_int enqueueCount = 0;
 
     // Allow any number of enqueue calls, count them
-    EXPECT_CALL(*transport_, initializeConnection(::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1);
+    EXPECT_CALL(*transport_, initializeConnection(::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1);
     EXPECT_CALL(*transport_, enqueue(::testing::_, ::testing::_, ::testing::_))
-        .WillRepeatedly([&enqueueCount](std::size_t, std::span<std::byte>, MockHttpTransportAsync::responseCallback_t) {
+        .WillRepeatedly([&enqueueCount](std::size_t, PayloadBuffer, MockHttpTransportAsync::responseCallback_t) {
             enqueueCount++;
         });
 
@@ -209,9 +210,9 @@ TEST_F(OpAmpTest, HeartbeatRespectsUpdatedInterval) {
 
     std::atomic_int enqueueCount = 0;
 
-    EXPECT_CALL(*transport_, initializeConnection(::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1);
+    EXPECT_CALL(*transport_, initializeConnection(::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1);
     EXPECT_CALL(*transport_, enqueue(::testing::_, ::testing::_, ::testing::_))
-        .WillRepeatedly([&enqueueCount](std::size_t, std::span<std::byte>, MockHttpTransportAsync::responseCallback_t) {
+        .WillRepeatedly([&enqueueCount](std::size_t, PayloadBuffer, MockHttpTransportAsync::responseCallback_t) {
             enqueueCount++;
         });
 
@@ -248,9 +249,9 @@ TEST_F(OpAmpTest, SeparateHeartbeatAndPollingIntervals) {
 
     std::atomic_int enqueueCount = 0;
 
-    EXPECT_CALL(*transport_, initializeConnection(::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1);
+    EXPECT_CALL(*transport_, initializeConnection(::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(1);
     EXPECT_CALL(*transport_, enqueue(::testing::_, ::testing::_, ::testing::_))
-        .WillRepeatedly([&enqueueCount](std::size_t, std::span<std::byte>, MockHttpTransportAsync::responseCallback_t) {
+        .WillRepeatedly([&enqueueCount](std::size_t, PayloadBuffer, MockHttpTransportAsync::responseCallback_t) {
             enqueueCount++;
         });
 
@@ -0,0 +1,79 @@
+#include "transport/OtlpRequestMerger.h"
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+namespace opentelemetry::php::transport {
+
+namespace {
+
+// length delimited protobuf field, values used in tests are shorter than 128 bytes
+std::string field(int fieldNumber, std::string const &value) {
+    return std::string(1, static_cast<char>(fieldNumber << 3 | 2)) + static_cast<char>(value.size()) + value;
+}
+
+std::string resourceSpans(std::string const &resource, std::vector<std::string> const &scopes, std::string const &schemaUrl = {}) {
+    std::string entry = field(1, resource);
+    for (auto const &scope : scopes) {
+        entry += field(2, scope);
+    }
+    if (!schemaUrl.empty()) {
+        entry += field(3, schemaUrl);
+    }
+    return field(1, entry);
+}
+
+PayloadBuffer toBuffer(std::string data) {
+    return PayloadBuffer::adopt(std::move(data));
+}
+
+std::string toString(PayloadBuffer const &buffer) {
+    return {reinterpret_cast<char const *>(buffer.data()), buffer.size()};
+}
+
+} // namespace
+
+class OtlpRequestMergerTest : public ::testing::Test {
+protected:
+    std::shared_ptr<PayloadBufferPool> pool_ = std::make_shared<PayloadBufferPool>();
+};
+
+TEST_F(OtlpRequestMergerTest, entriesWithSameResourceAreJoined) {
+    std::vector<PayloadBuffer> payloads{toBuffer(resourceSpans("host=a", {"scope1"})), toBuffer(resourceSpans("host=b", {"scope2"}) + resourceSpans("host=a", {"scope3", "scope4"})), toBuffer(resourceSpans("host=a", {"scope5"}, "schema"))};
+
+    auto merged = mergeOtlpRequests(*pool_, payloads);
+    ASSERT_TRUE(merged.has_value());
+    ASSERT_EQ(toString(*merged), resourceSpans("host=a", {"scope1", "scope3", "scope4"}) + resourceSpans("host=b", {"scope2"}) + resourceSpans("host=a", {"scope5"}, "schema"));
+}
+
+TEST_F(OtlpRequestMergerTest, emptyPayloadsAndEntriesWithoutResource) {
+    std::string withoutResource = field(1, field(2, "scope1"));
+    std::vector<PayloadBuffer> payloads{toBuffer(""), toBuffer(withoutResource), toBuffer(field(1, field(2, "scope2"))), toBuffer(resourceSpans("", {"scope3"}))};
+
+    auto merged = mergeOtlpRequests(*pool_, payloads);
+    ASSERT_TRUE(merged.has_value());
+    // empty resource is present, so it differs from missing one
+    ASSERT_EQ(toString(*merged), field(1, field(2, "scope1") + field(2, "scope2")) + resourceSpans("", {"scope3"}));
+
+    std::vector<PayloadBuffer> empty{toBuffer("")};
+    merged = mergeOtlpRequests(*pool_, empty);
+    ASSERT_TRUE(merged.has_value());
+    ASSERT_TRUE(merged->empty());
+}
+
+TEST_F(OtlpRequestMergerTest, unknownFieldsPreventMerging) {
+    std::vector<PayloadBuffer> unknownTopLevelField{toBuffer(resourceSpans("host=a", {"scope1"})), toBuffer(field(2, "unknown"))};
+    ASSERT_FALSE(mergeOtlpRequests(*pool_, unknownTopLevelField).has_value());
+
+    std::vector<PayloadBuffer> unknownEntryField{toBuffer(field(1, field(1, "host=a") + field(4, "unknown")))};
+    ASSERT_FALSE(mergeOtlpRequests(*pool_, unknownEntryField).has_value());
+
+    std::vector<PayloadBuffer> notProtobuf{toBuffer("payload1")};
+    ASSERT_FALSE(mergeOtlpRequests(*pool_, notProtobuf).has_value());
+
+    std::vector<PayloadBuffer> truncated{toBuffer(resourceSpans("host=a", {"scope1"}).substr(0, 5))};
+    ASSERT_FALSE(mergeOtlpRequests(*pool_, truncated).has_value());
+}
+
+} // namespace opentelemetry::php::transport
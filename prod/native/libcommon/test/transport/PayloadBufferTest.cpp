@@ -0,0 +1,109 @@
+#include "transport/PayloadBuffer.h"
+
+#include <cstring>
+#include <string>
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::transport {
+
+TEST(PayloadBufferTest, adoptDoesNotCopy) {
+    std::vector<std::byte> data(100, std::byte{7});
+    auto dataPtr = data.data();
+
+    auto buffer = PayloadBuffer::adopt(std::move(data));
+    ASSERT_EQ(buffer.data(), dataPtr);
+    ASSERT_EQ(buffer.size(), 100ul);
+    ASSERT_FALSE(buffer.isBorrowed());
+
+    std::string text(1000, 'x');
+    auto textPtr = text.data();
+    auto textBuffer = PayloadBuffer::adopt(std::move(text));
+    ASSERT_EQ(reinterpret_cast<char const *>(textBuffer.data()), textPtr);
+}
+
+TEST(PayloadBufferTest, copiesShareStorage) {
+    auto buffer = PayloadBuffer::adopt(std::vector<std::byte>(100));
+    auto copy = buffer;
+    ASSERT_EQ(copy.data(), buffer.data());
+
+    auto part = buffer.subbuffer(10, 20);
+    ASSERT_EQ(part.data(), buffer.data() + 10);
+    ASSERT_EQ(part.size(), 20ul);
+
+    ASSERT_THROW(buffer.subbuffer(90, 11), std::out_of_range);
+}
+
+TEST(PayloadBufferTest, borrowedIsCopiedOnRetain) {
+    auto pool = std::make_shared<PayloadBufferPool>();
+    std::string text = "payload";
+    auto borrowed = PayloadBuffer::borrow(std::as_bytes(std::span(text)));
+    ASSERT_TRUE(borrowed.isBorrowed());
+
+    auto retained = borrowed.retain(*pool);
+    ASSERT_FALSE(retained.isBorrowed());
+    ASSERT_NE(retained.data(), borrowed.data());
+    ASSERT_EQ(std::memcmp(retained.data(), text.data(), text.size()), 0);
+
+    auto retainedAgain = retained.retain(*pool);
+    ASSERT_EQ(retainedAgain.data(), retained.data());
+}
+
+TEST(PayloadBufferTest, poolReusesReleasedBlocks) {
+    auto pool = std::make_shared<PayloadBufferPool>();
+
+    std::byte const *first = nullptr;
+    {
+        auto buffer = pool->allocate(5000);
+        first = buffer.data();
+        auto frozen = std::move(buffer).freeze();
+        ASSERT_EQ(frozen.size(), 5000ul);
+        ASSERT_EQ(pool->getPooledBlocksCount(), 0ul);
+    }
+    ASSERT_EQ(pool->getPooledBlocksCount(), 1ul);
+    ASSERT_EQ(pool->getPooledBytes(), 8192ul);
+
+    auto buffer = pool->allocate(8000);
+    ASSERT_EQ(buffer.data(), first);
+    ASSERT_EQ(pool->getPooledBlocksCount(), 0ul);
+
+    auto smaller = pool->allocate(100);
+    ASSERT_NE(smaller.data(), first);
+}
+
+TEST(PayloadBufferTest, poolLimitsPooledBytes) {
+    auto pool = std::make_shared<PayloadBufferPool>(16 * 1024);
+    {
+        auto a = pool->allocate(8 * 1024);
+        auto b = pool->allocate(8 * 1024);
+        auto c = pool->allocate(8 * 1024);
+    }
+    ASSERT_EQ(pool->getPooledBlocksCount(), 2ul);
+    ASSERT_EQ(pool->getPooledBytes(), 16 * 1024ul);
+
+    pool->trim();
+    ASSERT_EQ(pool->getPooledBytes(), 0ul);
+}
+
+TEST(PayloadBufferTest, oversizedBlocksAreNotPooled) {
+    auto pool = std::make_shared<PayloadBufferPool>(64 * 1024 * 1024);
+    {
+        auto buffer = pool->allocate(PayloadBufferPool::maxBlockSize + 1);
+        ASSERT_EQ(buffer.size(), PayloadBufferPool::maxBlockSize + 1);
+    }
+    ASSERT_EQ(pool->getPooledBlocksCount(), 0ul);
+}
+
+TEST(PayloadBufferTest, bufferOutlivesPool) {
+    PayloadBuffer buffer;
+    {
+        auto pool = std::make_shared<PayloadBufferPool>();
+        std::string text = "data";
+        buffer = pool->copy(std::as_bytes(std::span(text)));
+    }
+    ASSERT_EQ(buffer.size(), 4ul);
+    ASSERT_EQ(std::memcmp(buffer.data(), "data", 4), 0);
+}
+
+} // namespace opentelemetry::php::transport
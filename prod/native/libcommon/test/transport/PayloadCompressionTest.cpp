@@ -0,0 +1,81 @@
+#include "transport/PayloadCompression.h"
+
+#include <string>
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+using namespace std::literals;
+
+namespace opentelemetry::php::transport {
+
+static std::string gunzip(std::span<std::byte const> data) {
+    z_stream stream{};
+    EXPECT_EQ(inflateInit2(&stream, 15 + 16), Z_OK);
+
+    std::string output(1024 * 1024, '\0');
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<std::byte *>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    EXPECT_EQ(inflate(&stream, Z_FINISH), Z_STREAM_END);
+    output.resize(stream.total_out);
+    inflateEnd(&stream);
+    return output;
+}
+
+TEST(PayloadCompressionTest, parsePayloadCompression) {
+    ASSERT_EQ(parsePayloadCompression(""), PayloadCompression::none);
+    ASSERT_EQ(parsePayloadCompression("none"), PayloadCompression::none);
+    ASSERT_EQ(parsePayloadCompression("gzip"), PayloadCompression::gzip);
+    ASSERT_EQ(parsePayloadCompression("GZIP"), PayloadCompression::gzip);
+    ASSERT_EQ(parsePayloadCompression("zstd"), PayloadCompression::zstd);
+    ASSERT_FALSE(parsePayloadCompression("brotli").has_value());
+}
+
+TEST(PayloadCompressionTest, getContentEncoding) {
+    ASSERT_EQ(getContentEncoding(PayloadCompression::none), ""sv);
+    ASSERT_EQ(getContentEncoding(PayloadCompression::gzip), "gzip"sv);
+    ASSERT_EQ(getContentEncoding(PayloadCompression::zstd), "zstd"sv);
+}
+
+TEST(PayloadCompressionTest, gzipRoundTrip) {
+    std::string text;
+    for (int i = 0; i < 1000; ++i) {
+        text.append("span name, span attributes, resource attributes;");
+    }
+    std::span<std::byte const> payload(reinterpret_cast<std::byte const *>(text.data()), text.size());
+
+    auto compressed = compressPayload(PayloadCompression::gzip, payload);
+    ASSERT_LT(compressed.size(), text.size() / 10);
+    ASSERT_EQ(gunzip(compressed), text);
+}
+
+TEST(PayloadCompressionTest, gzipEmptyPayload) {
+    auto compressed = compressPayload(PayloadCompression::gzip, {});
+    ASSERT_FALSE(compressed.empty());
+    ASSERT_EQ(gunzip(compressed), ""s);
+}
+
+TEST(PayloadCompressionTest, noneCopiesPayload) {
+    std::string text = "payload";
+    std::span<std::byte const> payload(reinterpret_cast<std::byte const *>(text.data()), text.size());
+
+    auto result = compressPayload(PayloadCompression::none, payload);
+    ASSERT_EQ(std::string(reinterpret_cast<char const *>(result.data()), result.size()), text);
+}
+
+TEST(PayloadCompressionTest, zstdCompressesPayload) {
+    std::string text(4096, 'x');
+    std::span<std::byte const> payload(reinterpret_cast<std::byte const *>(text.data()), text.size());
+
+    auto compressed = compressPayload(PayloadCompression::zstd, payload);
+    ASSERT_LT(compressed.size(), text.size());
+    // zstd frame magic number
+    ASSERT_EQ(compressed[0], std::byte{0x28});
+    ASSERT_EQ(compressed[1], std::byte{0xb5});
+    ASSERT_EQ(compressed[2], std::byte{0x2f});
+    ASSERT_EQ(compressed[3], std::byte{0xfd});
+}
+
+} // namespace opentelemetry::php::transport
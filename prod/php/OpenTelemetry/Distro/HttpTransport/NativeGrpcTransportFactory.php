@@ -0,0 +1,36 @@
+<?php
+
+declare(strict_types=1);
+
+namespace OpenTelemetry\Distro\HttpTransport;
+
+use OpenTelemetry\Distro\PhpPartFacade;
+use OpenTelemetry\Distro\PhpPartVersion;
+use OpenTelemetry\SDK\Common\Export\TransportFactoryInterface;
+
+/**
+ * OTLP/gRPC transport sending protobuf payloads as unary calls over HTTP/2 from the extension, doesn't require grpc extension
+ */
+class NativeGrpcTransportFactory implements TransportFactoryInterface
+{
+    private const WIRE_CONTENT_TYPE = 'application/grpc';
+
+    #[\Override]
+    public function create(
+        string $endpoint,
+        string $contentType = 'application/x-protobuf',
+        array $headers = [],
+        mixed $compression = null,
+        float $timeout = 10.,
+        int $retryDelay = 100,
+        int $maxRetries = 3,
+        ?string $cacert = null,
+        ?string $cert = null,
+        ?string $key = null
+    ): NativeHttpTransport {
+        $vendor = PhpPartFacade::getVendorCustomizations();
+        $headers['User-Agent'] = ($vendor !== null ? $vendor->getUserAgentString() : null)
+            ?? ("otlp-grpc-php-distro/" . PhpPartVersion::VALUE);
+        return new NativeHttpTransport($endpoint, $contentType, $headers, $compression, $timeout, $retryDelay, $maxRetries, $cacert, $cert, $key, self::WIRE_CONTENT_TYPE);
+    }
+}
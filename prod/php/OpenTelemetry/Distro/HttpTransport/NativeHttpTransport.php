@@ -18,14 +18,17 @@ final class NativeHttpTransport implements TransportInterface
 {
     private string $endpoint;
     private string $contentType;
+    private int $flushTimeoutMs;
 
     /**
      * @param array<string,string|string[]> $headers
+     * @param string|string[]|null $compression
+     * @param ?string $wireContentType Content type sent to endpoint if it differs from payload content type, e.g. application/grpc for protobuf payloads sent over OTLP/gRPC
      *
      * @noinspection PhpUnusedParameterInspection
      *
-     * Parameters $compression, $cacert, $cert and $key are unused so constructor.unusedParameter is mentioned 4 times below
-     * @phpstan-ignore constructor.unusedParameter, constructor.unusedParameter, constructor.unusedParameter, constructor.unusedParameter
+     * Parameters $cacert, $cert and $key are unused so constructor.unusedParameter is mentioned 3 times below
+     * @phpstan-ignore constructor.unusedParameter, constructor.unusedParameter, constructor.unusedParameter
      */
     public function __construct(
         string $endpoint,
@@ -37,16 +40,30 @@ final class NativeHttpTransport implements TransportInterface
         int $maxRetries = 3,
         ?string $cacert = null,
         ?string $cert = null,
-        ?string $key = null
+        ?string $key = null,
+        ?string $wireContentType = null
     ) {
         $this->endpoint = $endpoint;
         $this->contentType = $contentType;
+        $this->flushTimeoutMs = (int)($timeout * 1000);
 
         /**
          * Use fully qualified names for functions implemented by the extension to make sure scoper correctly detects them
          * @noinspection PhpUnnecessaryFullyQualifiedNameInspection
          */
-        \OpenTelemetry\Distro\HttpTransport\initialize($endpoint, $contentType, $headers, $timeout, $retryDelay, $maxRetries);
+        \OpenTelemetry\Distro\HttpTransport\initialize($endpoint, $wireContentType ?? $contentType, $headers, $timeout, $retryDelay, $maxRetries, self::normalizeCompression($compression));
+    }
+
+    /**
+     * Payloads are compressed by the extension on the sending thread, only the first of multiple compression methods is used
+     */
+    private static function normalizeCompression(mixed $compression): ?string
+    {
+        if (is_array($compression)) {
+            $compression = $compression[array_key_first($compression)] ?? null;
+        }
+
+        return is_string($compression) ? $compression : null;
     }
 
     public function contentType(): string
@@ -68,13 +85,34 @@ final class NativeHttpTransport implements TransportInterface
         return new CompletedFuture(null);
     }
 
+    /**
+     * Payloads are sent by the extension, shutdown waits for those enqueued so far only when the process ends with the script.
+     * Long-lived SAPIs (FPM, Apache) call shutdown at the end of every request, there the extension keeps sending in the background
+     * and waits for its queue when the worker process exits
+     */
     public function shutdown(?CancellationInterface $cancellation = null): bool
     {
-        return true;
+        if (!self::isProcessEndingAtShutdown(php_sapi_name())) {
+            return true;
+        }
+
+        return $this->forceFlush($cancellation);
+    }
+
+    private static function isProcessEndingAtShutdown(string $sapiName): bool
+    {
+        return in_array($sapiName, ['cli', 'phpdbg', 'embed'], true);
     }
 
+    /**
+     * Waits until payloads enqueued so far are sent, dropped or spilled to disk by the extension, at most for the transport timeout
+     */
     public function forceFlush(?CancellationInterface $cancellation = null): bool
     {
-        return true;
+        /**
+         * Use fully qualified names for functions implemented by the extension to make sure scoper correctly detects them
+         * @noinspection PhpUnnecessaryFullyQualifiedNameInspection
+         */
+        return \OpenTelemetry\Distro\HttpTransport\flush($this->endpoint, $this->flushTimeoutMs);
     }
 }
@@ -12,6 +12,7 @@ use OpenTelemetry\API\Trace\SpanKind;
 use OpenTelemetry\API\Trace\StatusCode;
 use OpenTelemetry\Context\Context;
 use OpenTelemetry\Context\ContextStorageScopeInterface;
+use OpenTelemetry\Distro\HttpTransport\NativeGrpcTransportFactory;
 use OpenTelemetry\Distro\HttpTransport\NativeHttpTransportFactory;
 use OpenTelemetry\Distro\InferredSpans\InferredSpans;
 use OpenTelemetry\Distro\Log\LogBackend;
@@ -273,6 +274,7 @@ final class PhpPartFacade
         }
 
         Registry::registerTransportFactory('http', NativeHttpTransportFactory::class, true);
+        Registry::registerTransportFactory('grpc', NativeGrpcTransportFactory::class, true);
     }
 
     private static function registerOtelLogWriter(): void
@@ -0,0 +1,37 @@
+<?php
+
+declare(strict_types=1);
+
+namespace OTelDistroTests\UnitTests;
+
+use OpenTelemetry\Distro\HttpTransport\NativeHttpTransport;
+use OTelDistroTests\Util\TestCaseBase;
+use ReflectionMethod;
+
+final class NativeHttpTransportUnitTest extends TestCaseBase
+{
+    /**
+     * @return iterable<string, array{string, bool}>
+     */
+    public static function dataProviderForTestShutdownWaitsOnlyWhenProcessEnds(): iterable
+    {
+        yield 'FPM' => ['fpm-fcgi', false];
+        yield 'Apache' => ['apache2handler', false];
+        yield 'FastCGI' => ['cgi-fcgi', false];
+        yield 'CLI' => ['cli', true];
+        yield 'phpdbg' => ['phpdbg', true];
+    }
+
+    /**
+     * Exercises private NativeHttpTransport::isProcessEndingAtShutdown() via Reflection - the SAPI of the test process is always CLI.
+     * FPM worker calls shutdown at the end of every request, waiting there for the endpoint flush would add up to the transport timeout to each of them
+     *
+     * @dataProvider dataProviderForTestShutdownWaitsOnlyWhenProcessEnds
+     */
+    public function testShutdownWaitsOnlyWhenProcessEnds(string $sapiName, bool $expectedToWait): void
+    {
+        $isProcessEndingAtShutdown = new ReflectionMethod(NativeHttpTransport::class, 'isProcessEndingAtShutdown');
+        $isProcessEndingAtShutdown->setAccessible(true);
+        self::assertSame($expectedToWait, $isProcessEndingAtShutdown->invoke(null, $sapiName));
+    }
+}
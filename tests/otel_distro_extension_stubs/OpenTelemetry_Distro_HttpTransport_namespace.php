@@ -16,6 +16,7 @@ function initialize(
     float $timeout,
     int $retryDelay,
     int $maxRetries,
+    ?string $compression = null,
 ): void {
 }
 
@@ -25,3 +26,14 @@ function initialize(
 function enqueue(string $endpoint, string $payload): void
 {
 }
+
+/**
+ * This function is implemented by the extension
+ *
+ * Waits until payloads enqueued for endpoint are sent, rejected, dropped or stored in spill directory.
+ * Returns false if timeout was reached first
+ */
+function flush(string $endpoint, int $timeoutMs): bool
+{
+    return true;
+}
@@ -19,6 +19,19 @@ function get_remote_configuration(): ?array // @phpstan-ignore return.unusedType
     return ['dummy file name' => 'dummy file content (JSON)'];
 }
 
+/**
+ * This function is implemented by the extension
+ *
+ * Returns backpressure status of coordinator process or null if it is not available yet.
+ * Level is one of 'normal', 'elevated' or 'critical'
+ *
+ * @return ?array<string, int|string>
+ */
+function get_coordinator_status(): ?array // @phpstan-ignore return.unusedType
+{
+    return ['level' => 'normal'];
+}
+
 /**
  * This function is implemented by the extension
  *